@@ -0,0 +1,257 @@
+// Per-call overhead of the FFI hot paths against a local mock server
+//
+// Usage: ./supabase_c_bench [iterations] [max_threads] [rows]
+//
+// Every operation runs at 1, 2, 4, ... max_threads threads sharing one client.
+// Each thread first warms its connection, then times `iterations` calls. The
+// report lists throughput, latency percentiles and heap allocations per call
+// (glibc only, counted by wrapping malloc/calloc/realloc).
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../include/supabase.h"
+#include "mock_server.h"
+
+#define RESULT_CAPACITY (256 * 1024)
+#define WARMUP_CALLS 32
+
+// Allocation counting
+
+static atomic_ulong allocations;
+static atomic_bool counting;
+
+#ifdef __GLIBC__
+#define ALLOCATIONS_COUNTED 1
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+static inline void count_allocation(void) {
+    if (atomic_load_explicit(&counting, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    }
+}
+
+void* malloc(size_t size) {
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    count_allocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    count_allocation();
+    return __libc_realloc(ptr, size);
+}
+#else
+#define ALLOCATIONS_COUNTED 0
+#endif
+
+// Operations
+
+typedef SupabaseError (*Operation)(SupabaseClient* client, char* result);
+
+static SupabaseError op_select(SupabaseClient* client, char* result) {
+    return supabase_database_select(client, "bench", "*", result, RESULT_CAPACITY);
+}
+
+static SupabaseError op_select_buffer(SupabaseClient* client, char* result) {
+    (void)result;
+    SupabaseBuffer* buffer = NULL;
+    SupabaseError error = supabase_database_select_buffer(client, "bench", "*", &buffer);
+    supabase_buffer_free(buffer);
+    return error;
+}
+
+static SupabaseError op_insert(SupabaseClient* client, char* result) {
+    return supabase_database_insert(client, "bench",
+                                    "{\"name\":\"bench\",\"score\":1.5,\"active\":true}", result,
+                                    RESULT_CAPACITY);
+}
+
+static SupabaseError op_functions_invoke(SupabaseClient* client, char* result) {
+    return supabase_functions_invoke(client, "bench", "{\"n\":1}", result, RESULT_CAPACITY);
+}
+
+static SupabaseError op_storage_list_buckets(SupabaseClient* client, char* result) {
+    return supabase_storage_list_buckets(client, result, RESULT_CAPACITY);
+}
+
+static const struct {
+    const char* name;
+    Operation run;
+} OPERATIONS[] = {
+    {"database_select", op_select},
+    {"database_select_buffer", op_select_buffer},
+    {"database_insert", op_insert},
+    {"functions_invoke", op_functions_invoke},
+    {"storage_list_buckets", op_storage_list_buckets},
+};
+
+// Runner
+
+typedef struct {
+    SupabaseClient* client;
+    Operation run;
+    size_t iterations;
+    pthread_barrier_t* ready;
+    pthread_barrier_t* done;
+    uint64_t* latencies_ns;
+    size_t failures;
+} Worker;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void* run_worker(void* arg) {
+    Worker* worker = arg;
+    char* result = malloc(RESULT_CAPACITY);
+
+    for (size_t i = 0; i < WARMUP_CALLS; i++) {
+        worker->run(worker->client, result);
+    }
+
+    pthread_barrier_wait(worker->ready);
+    for (size_t i = 0; i < worker->iterations; i++) {
+        uint64_t start = now_ns();
+        if (worker->run(worker->client, result) != SUPABASE_SUCCESS) {
+            worker->failures++;
+        }
+        worker->latencies_ns[i] = now_ns() - start;
+    }
+    pthread_barrier_wait(worker->done);
+
+    free(result);
+    return NULL;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint64_t* sorted, size_t count, double q) {
+    size_t index = (size_t)(q * (double)(count - 1) + 0.5);
+    return (double)sorted[index] / 1000.0;
+}
+
+static int bench(SupabaseClient* client, const char* name, Operation run, size_t threads,
+                 size_t iterations) {
+    size_t total = threads * iterations;
+    uint64_t* latencies = malloc(total * sizeof(uint64_t));
+    Worker* workers = calloc(threads, sizeof(Worker));
+    pthread_t* handles = calloc(threads, sizeof(pthread_t));
+    pthread_barrier_t ready;
+    pthread_barrier_t done;
+    if (latencies == NULL || workers == NULL || handles == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return -1;
+    }
+    pthread_barrier_init(&ready, NULL, (unsigned)threads + 1);
+    pthread_barrier_init(&done, NULL, (unsigned)threads + 1);
+
+    for (size_t t = 0; t < threads; t++) {
+        workers[t] = (Worker){
+            .client = client,
+            .run = run,
+            .iterations = iterations,
+            .ready = &ready,
+            .done = &done,
+            .latencies_ns = latencies + t * iterations,
+        };
+        pthread_create(&handles[t], NULL, run_worker, &workers[t]);
+    }
+
+    // Only the timed section is counted; the workers' setup and the main
+    // thread's bookkeeping stay outside it
+    pthread_barrier_wait(&ready);
+    atomic_store(&allocations, 0);
+    atomic_store(&counting, true);
+    uint64_t start = now_ns();
+    pthread_barrier_wait(&done);
+    uint64_t elapsed = now_ns() - start;
+    atomic_store(&counting, false);
+    unsigned long allocated = atomic_load(&allocations);
+
+    size_t failures = 0;
+    for (size_t t = 0; t < threads; t++) {
+        pthread_join(handles[t], NULL);
+        failures += workers[t].failures;
+    }
+    pthread_barrier_destroy(&ready);
+    pthread_barrier_destroy(&done);
+
+    qsort(latencies, total, sizeof(uint64_t), compare_u64);
+    double throughput = (double)total / ((double)elapsed / 1e9);
+    printf("%-24s %7zu %11.0f %9.1f %9.1f %9.1f %9.1f ", name, threads, throughput,
+           percentile_us(latencies, total, 0.50), percentile_us(latencies, total, 0.99),
+           percentile_us(latencies, total, 0.999), (double)latencies[total - 1] / 1000.0);
+    if (ALLOCATIONS_COUNTED) {
+        printf("%11.1f", (double)allocated / (double)total);
+    } else {
+        printf("%11s", "n/a");
+    }
+    printf(" %8zu\n", failures);
+
+    free(latencies);
+    free(workers);
+    free(handles);
+    return failures == 0 ? 0 : -1;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000;
+    size_t max_threads = argc > 2 ? strtoul(argv[2], NULL, 10) : 8;
+    size_t rows = argc > 3 ? strtoul(argv[3], NULL, 10) : 100;
+    if (iterations == 0 || max_threads == 0) {
+        fprintf(stderr, "usage: %s [iterations] [max_threads] [rows]\n", argv[0]);
+        return 2;
+    }
+
+    int port = mock_server_start(rows);
+    if (port < 0) {
+        fprintf(stderr, "failed to start mock server\n");
+        return 1;
+    }
+    char url[64];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d", port);
+
+    SupabaseClient* client = supabase_client_new(url, "bench-anon-key");
+    if (client == NULL) {
+        char error[256];
+        supabase_get_last_error(error, sizeof(error));
+        fprintf(stderr, "failed to create client: %s\n", error);
+        return 1;
+    }
+
+    printf("mock server %s, %zu rows, %zu calls per thread\n\n", url, rows, iterations);
+    printf("%-24s %7s %11s %9s %9s %9s %9s %11s %8s\n", "operation", "threads", "calls/s",
+           "p50 us", "p99 us", "p999 us", "max us", "allocs/call", "failures");
+
+    int status = 0;
+    for (size_t op = 0; op < sizeof(OPERATIONS) / sizeof(OPERATIONS[0]); op++) {
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            if (bench(client, OPERATIONS[op].name, OPERATIONS[op].run, threads, iterations) != 0) {
+                status = 1;
+            }
+        }
+    }
+
+    supabase_client_free(client);
+    return status;
+}
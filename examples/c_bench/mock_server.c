@@ -0,0 +1,191 @@
+#define _GNU_SOURCE
+
+#include "mock_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define REQUEST_CAPACITY (1 << 20)
+#define ROWS_CAPACITY (1 << 20)
+
+static char rows_body[ROWS_CAPACITY];
+static size_t rows_body_len;
+static int listen_fd = -1;
+
+static const char BUCKETS_BODY[] =
+    "[{\"id\":\"bench\",\"name\":\"bench\",\"owner\":null,\"public\":false,"
+    "\"file_size_limit\":null,\"allowed_mime_types\":null,"
+    "\"created_at\":\"2025-01-01T00:00:00Z\",\"updated_at\":\"2025-01-01T00:00:00Z\"}]";
+static const char FUNCTION_BODY[] = "{\"ok\":true}";
+
+static int write_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n <= 0) {
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int respond(int fd, const char* status, const char* prefix, const char* body,
+                   size_t body_len, const char* suffix) {
+    size_t prefix_len = strlen(prefix);
+    size_t suffix_len = strlen(suffix);
+    char head[256];
+    int head_len = snprintf(head, sizeof(head),
+                            "HTTP/1.1 %s\r\ncontent-type: application/json\r\n"
+                            "content-length: %zu\r\n\r\n",
+                            status, prefix_len + body_len + suffix_len);
+    if (write_all(fd, head, (size_t)head_len) != 0 || write_all(fd, prefix, prefix_len) != 0 ||
+        write_all(fd, body, body_len) != 0) {
+        return -1;
+    }
+    return write_all(fd, suffix, suffix_len);
+}
+
+static size_t content_length(const char* head, size_t head_len) {
+    const char* line = head;
+    const char* end = head + head_len;
+    while (line < end) {
+        const char* next = memchr(line, '\n', (size_t)(end - line));
+        if (next == NULL) {
+            break;
+        }
+        if (strncasecmp(line, "content-length:", 15) == 0) {
+            return (size_t)strtoull(line + 15, NULL, 10);
+        }
+        line = next + 1;
+    }
+    return 0;
+}
+
+static void* serve_connection(void* arg) {
+    int fd = (int)(intptr_t)arg;
+    static _Thread_local char request[REQUEST_CAPACITY];
+    size_t filled = 0;
+
+    for (;;) {
+        char* head_end = NULL;
+        while ((head_end = memmem(request, filled, "\r\n\r\n", 4)) == NULL) {
+            ssize_t n = read(fd, request + filled, REQUEST_CAPACITY - filled);
+            if (n <= 0) {
+                close(fd);
+                return NULL;
+            }
+            filled += (size_t)n;
+        }
+
+        size_t head_len = (size_t)(head_end - request) + 4;
+        size_t body_len = content_length(request, head_len);
+        if (head_len + body_len > REQUEST_CAPACITY) {
+            break;
+        }
+        while (filled < head_len + body_len) {
+            ssize_t n = read(fd, request + filled, REQUEST_CAPACITY - filled);
+            if (n <= 0) {
+                close(fd);
+                return NULL;
+            }
+            filled += (size_t)n;
+        }
+
+        const char* body = request + head_len;
+        int status;
+        if (strncmp(request, "GET /rest/v1/", 13) == 0) {
+            status = respond(fd, "200 OK", "", rows_body, rows_body_len, "");
+        } else if (strncmp(request, "POST /rest/v1/", 14) == 0) {
+            status = respond(fd, "201 Created", "[", body, body_len, "]");
+        } else if (strncmp(request, "POST /functions/v1/", 19) == 0) {
+            status = respond(fd, "200 OK", "", FUNCTION_BODY, sizeof(FUNCTION_BODY) - 1, "");
+        } else if (strncmp(request, "GET /storage/v1/bucket", 22) == 0) {
+            status = respond(fd, "200 OK", "", BUCKETS_BODY, sizeof(BUCKETS_BODY) - 1, "");
+        } else {
+            status = respond(fd, "404 Not Found", "", "{}", 2, "");
+        }
+        if (status != 0) {
+            break;
+        }
+
+        // Keep any pipelined bytes of the next request
+        size_t consumed = head_len + body_len;
+        memmove(request, request + consumed, filled - consumed);
+        filled -= consumed;
+    }
+
+    close(fd);
+    return NULL;
+}
+
+static void* accept_loop(void* arg) {
+    (void)arg;
+    for (;;) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, serve_connection, (void*)(intptr_t)fd) != 0) {
+            close(fd);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+    return NULL;
+}
+
+int mock_server_start(size_t rows) {
+    size_t len = 0;
+    rows_body[len++] = '[';
+    for (size_t i = 0; i < rows; i++) {
+        int n = snprintf(rows_body + len, ROWS_CAPACITY - len,
+                         "%s{\"id\":%zu,\"name\":\"row-%zu\",\"score\":%zu.5,\"active\":true}",
+                         i == 0 ? "" : ",", i + 1, i + 1, i * 7);
+        if (n < 0 || (size_t)n >= ROWS_CAPACITY - len - 1) {
+            return -1;
+        }
+        len += (size_t)n;
+    }
+    rows_body[len++] = ']';
+    rows_body_len = len;
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        return -1;
+    }
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    socklen_t address_len = sizeof(address);
+    if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listen_fd, 128) != 0 ||
+        getsockname(listen_fd, (struct sockaddr*)&address, &address_len) != 0) {
+        close(listen_fd);
+        return -1;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, accept_loop, NULL) != 0) {
+        close(listen_fd);
+        return -1;
+    }
+    pthread_detach(thread);
+    return ntohs(address.sin_port);
+}
@@ -0,0 +1,19 @@
+#ifndef SUPABASE_MOCK_SERVER_H
+#define SUPABASE_MOCK_SERVER_H
+
+#include <stddef.h>
+
+// Minimal keep-alive HTTP/1.1 server answering the Supabase routes the benchmark
+// calls with canned responses. Handlers do not allocate, so every allocation the
+// benchmark counts comes from the client side of the FFI boundary.
+//
+//   GET  /rest/v1/<table>     -> `rows` JSON rows
+//   POST /rest/v1/<table>     -> the request body wrapped in an array
+//   POST /functions/v1/<name> -> {"ok":true}
+//   GET  /storage/v1/bucket   -> one bucket
+//   anything else             -> 404
+
+// Start listening on 127.0.0.1 with an ephemeral port; returns the port or -1
+int mock_server_start(size_t rows);
+
+#endif
@@ -171,6 +171,21 @@ async fn main() -> Result<(), Box<dyn std::error::Error>> {
             println!("   ℹ️  Streaming functions not available on WASM");
         }
         println!();
+
+        // Example 1.5: Fan-out invocation (native only)
+        #[cfg(not(target_arch = "wasm32"))]
+        {
+            println!("🌐 Fan-out Invocation:");
+            let payloads = (0..20).map(|id| json!({ "item_id": id }));
+            let results = client.functions().invoke_many("demo-function", payloads, 8).await;
+            let succeeded = results.iter().filter(|result| result.is_ok()).count();
+            println!(
+                "   ✅ {} of {} invocations succeeded (8 in flight at a time)",
+                succeeded,
+                results.len()
+            );
+        }
+        println!();
     }
 
     #[cfg(not(feature = "functions"))]
@@ -200,6 +215,7 @@ async fn main() -> Result<(), Box<dyn std::error::Error>> {
             default_ttl: Duration::from_secs(600),
             enable_compression: true,
             cache_success_only: true,
+            max_bytes: 16 * 1024 * 1024,
         };
 
         // Example 2.1: Connection Pooling
@@ -86,6 +86,8 @@ async fn main() -> std::result::Result<(), Box<dyn std::error::Error>> {
         max_retries: 3,
         retry_delay: 1000, // 1 second
         verify_checksums: true,
+        max_concurrent_parts: 4,
+        checkpoint_file: None,
     };
 
     let _progress_callback = Arc::new(|uploaded: u64, total: u64| {
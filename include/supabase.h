@@ -11,6 +11,13 @@ extern "C" {
 
 // Forward declarations
 typedef struct SupabaseClient SupabaseClient;
+typedef struct SupabaseRequest SupabaseRequest;
+typedef struct SupabaseRuntime SupabaseRuntime;
+typedef struct SupabaseBuffer SupabaseBuffer;
+typedef struct SupabaseQuery SupabaseQuery;
+typedef struct SupabaseCursor SupabaseCursor;
+typedef struct SupabaseBatch SupabaseBatch;
+typedef struct SupabaseRealtimeSubscription SupabaseRealtimeSubscription;
 
 // Enhanced error codes
 typedef enum {
@@ -30,6 +37,76 @@ typedef enum {
 SupabaseClient* supabase_client_new(const char* url, const char* key);
 void supabase_client_free(SupabaseClient* client);
 
+// Shared runtimes
+//
+// Clients created with supabase_client_new_with_runtime share the runtime's
+// worker threads; clients with the same key also share one HTTP connection pool.
+// Pass 0 to keep tokio's default thread counts. Clients keep the runtime alive,
+// so the runtime handle may be freed before them.
+SupabaseRuntime* supabase_runtime_new(size_t worker_threads, size_t max_blocking_threads);
+void supabase_runtime_free(SupabaseRuntime* runtime);
+SupabaseClient* supabase_client_new_with_runtime(
+    SupabaseRuntime* runtime,
+    const char* url,
+    const char* key
+);
+
+// Connection settings
+//
+// A zeroed SupabaseClientConfig keeps every default. runtime may be NULL to
+// give the client its own runtime; config may be NULL. With
+// warm_up_connections set, creation blocks until that many connections have
+// been opened to the REST, Storage, Functions and Auth endpoints; a failed
+// warm-up does not fail creation. Clients on one runtime share a connection
+// pool (and its TLS session cache) only when key and settings match.
+//
+// accept_encodings offers compressed responses, decoded as they are read;
+// request_encoding compresses JSON request bodies of 1 KiB or more. Both apply
+// to the REST, Storage and Functions modules.
+typedef enum {
+    SUPABASE_HTTP_NEGOTIATE = 0,
+    SUPABASE_HTTP1_ONLY = 1,
+    SUPABASE_HTTP2_PRIOR_KNOWLEDGE = 2
+} SupabaseHttpVersion;
+
+typedef enum {
+    SUPABASE_ACCEPT_GZIP = 1,
+    SUPABASE_ACCEPT_DEFLATE = 2,
+    SUPABASE_ACCEPT_ZSTD = 4
+} SupabaseAcceptEncoding;
+
+typedef enum {
+    SUPABASE_ENCODING_NONE = 0,
+    SUPABASE_ENCODING_GZIP = 1,
+    SUPABASE_ENCODING_DEFLATE = 2,
+    SUPABASE_ENCODING_ZSTD = 3
+} SupabaseContentEncoding;
+
+typedef struct {
+    uint32_t timeout_seconds;           // default 60
+    uint32_t connect_timeout_seconds;   // default 10
+    SupabaseHttpVersion http_version;   // default HTTP/2 via ALPN, else HTTP/1.1
+    bool http2_adaptive_window;
+    uint32_t pool_max_idle_per_host;    // default unlimited
+    uint32_t pool_idle_timeout_seconds; // default 90
+    uint32_t tcp_keepalive_seconds;     // default off
+    uint32_t dns_cache_ttl_seconds;     // default off
+    uint32_t warm_up_connections;       // default none
+    uint32_t accept_encodings;          // SupabaseAcceptEncoding flags, default none
+    uint32_t request_encoding;          // SupabaseContentEncoding, default none
+} SupabaseClientConfig;
+
+SupabaseClient* supabase_client_new_with_config(
+    SupabaseRuntime* runtime,
+    const char* url,
+    const char* key,
+    const SupabaseClientConfig* config
+);
+
+// Re-open pooled connections, e.g. after an idle period longer than the pool's
+// idle timeout; fails only if no warm-up request got a response
+SupabaseError supabase_client_warm_up(SupabaseClient* client, uint32_t connections);
+
 // Authentication
 SupabaseError supabase_auth_sign_in(
     SupabaseClient* client,
@@ -47,6 +124,22 @@ SupabaseError supabase_auth_sign_up(
     size_t result_len
 );
 
+// Background session refresh; refresh_ahead_seconds == 0 selects 300
+SupabaseError supabase_auth_start_auto_refresh(SupabaseClient* client, uint32_t refresh_ahead_seconds);
+void supabase_auth_stop_auto_refresh(SupabaseClient* client);
+
+// Current access token, read without blocking on a refresh in progress
+SupabaseError supabase_auth_access_token(SupabaseClient* client, char* result, size_t result_len);
+
+// Verify an access token locally, writing its claims as JSON; repeat tokens
+// are answered from a cache keyed by the token hash
+SupabaseError supabase_auth_verify_token(
+    SupabaseClient* client,
+    const char* token,
+    char* result,
+    size_t result_len
+);
+
 // Database operations
 SupabaseError supabase_database_select(
     SupabaseClient* client,
@@ -64,6 +157,127 @@ SupabaseError supabase_database_insert(
     size_t result_len
 );
 
+// Bulk load (POSIX only)
+//
+// Reads newline-delimited JSON rows from fd to the end (fd is not closed) and
+// inserts them in chunks of chunk_size rows with up to max_concurrent_chunks
+// requests in flight (0 selects the defaults: 1000 rows, 4 chunks). Only one
+// chunk per request is held in memory and rows are not echoed back. Rejected
+// chunks don't stop the load: *out holds {"rows_loaded", "chunks",
+// "failures": [{"chunk", "first_row", "rows", "error"}]}.
+SupabaseError supabase_database_bulk_load_fd(
+    SupabaseClient* client,
+    const char* table,
+    int fd,
+    size_t chunk_size,
+    size_t max_concurrent_chunks,
+    bool upsert,
+    SupabaseBuffer** out
+);
+
+// Query builder
+//
+// Mirrors the Rust QueryBuilder. The first execute (or bind/url call) freezes
+// the query and precomputes its URL; after that only filter values can change,
+// through supabase_query_bind. Filters are numbered from 0 in the order they
+// were added. Operators use PostgREST codes ("eq", "gt", "ilike", "in", ...).
+SupabaseQuery* supabase_query_new(SupabaseClient* client, const char* table);
+SupabaseError supabase_query_select(SupabaseQuery* query, const char* columns);
+SupabaseError supabase_query_filter(
+    SupabaseQuery* query,
+    const char* column,
+    const char* op,
+    const char* value
+);
+SupabaseError supabase_query_in(
+    SupabaseQuery* query,
+    const char* column,
+    const char* const* values,
+    size_t count
+);
+SupabaseError supabase_query_order(SupabaseQuery* query, const char* column, bool ascending);
+SupabaseError supabase_query_limit(SupabaseQuery* query, uint32_t limit);
+SupabaseError supabase_query_offset(SupabaseQuery* query, uint32_t offset);
+SupabaseError supabase_query_single(SupabaseQuery* query);
+// Cache responses for ttl_ms; stale entries are revalidated via ETag when available
+SupabaseError supabase_query_cached(SupabaseQuery* query, uint64_t ttl_ms);
+// Share executions with identical queries already in flight on the same client
+SupabaseError supabase_query_coalesce(SupabaseQuery* query);
+SupabaseError supabase_query_inner_join(
+    SupabaseQuery* query,
+    const char* foreign_table,
+    const char* foreign_columns
+);
+SupabaseError supabase_query_left_join(
+    SupabaseQuery* query,
+    const char* foreign_table,
+    const char* foreign_columns
+);
+SupabaseError supabase_query_bind(SupabaseQuery* query, size_t slot, const char* value);
+SupabaseError supabase_query_url(SupabaseQuery* query, char* result, size_t result_len);
+SupabaseError supabase_query_execute(SupabaseQuery* query, SupabaseBuffer** out);
+void supabase_query_free(SupabaseQuery* query);
+
+// Keyset pagination
+//
+// Pages through the query's rows in ascending key_column order, requesting each
+// page with key_column > last key seen instead of an offset, so every page
+// costs the server the same. key_column must be unique, selected and not
+// otherwise filtered on; the query must not have been executed or bound yet.
+// While the caller processes a page the next one is already being fetched.
+// supabase_cursor_next sets *out to NULL (and returns SUPABASE_SUCCESS) after
+// the last page.
+SupabaseCursor* supabase_query_paginate(SupabaseQuery* query, const char* key_column, uint32_t page_size);
+SupabaseError supabase_cursor_next(SupabaseCursor* cursor, SupabaseBuffer** out);
+void supabase_cursor_free(SupabaseCursor* cursor);
+
+// Batched operations (requires the `performance` feature, enabled by default)
+//
+// Single-row inserts into the same table are merged into bulk inserts; other
+// operations run concurrently, lowest priority value first. The queue flushes itself
+// when max_batch_size operations are queued or flush_interval_ms elapses. 0
+// keeps the defaults (50 operations, 100 ms, 8 requests in flight).
+// supabase_batch_flush returns a JSON array of {id, status, data, error}
+// covering every operation completed since the previous flush.
+SupabaseBatch* supabase_batch_new(
+    SupabaseClient* client,
+    size_t max_batch_size,
+    uint32_t flush_interval_ms,
+    size_t max_in_flight
+);
+SupabaseError supabase_batch_add(
+    SupabaseBatch* batch,
+    const char* id,
+    const char* method,
+    const char* path,
+    const char* json_body,
+    uint8_t priority
+);
+SupabaseError supabase_batch_flush(SupabaseBatch* batch, SupabaseBuffer** out);
+void supabase_batch_free(SupabaseBatch* batch);
+
+// Streaming select
+//
+// Rows are parsed incrementally and delivered in JSON arrays of up to
+// batch_size rows (0 is treated as 1), keeping memory bounded regardless of the
+// result size. The callback runs on the calling thread; `rows_json` is only
+// valid during the call. Return false to stop the stream early.
+typedef bool (*SupabaseRowsCallback)(
+    const char* rows_json,
+    size_t rows_json_len,
+    size_t row_count,
+    void* user_data
+);
+
+SupabaseError supabase_database_select_stream(
+    SupabaseClient* client,
+    const char* table,
+    const char* columns,
+    size_t batch_size,
+    SupabaseRowsCallback callback,
+    void* user_data
+);
+
 // Storage operations
 SupabaseError supabase_storage_list_buckets(
     SupabaseClient* client,
@@ -71,6 +285,105 @@ SupabaseError supabase_storage_list_buckets(
     size_t result_len
 );
 
+// Signs `count` paths in one request. *out holds a JSON array of
+// {"path", "signedURL", "error"} objects in the order of `paths`; paths with a
+// cached URL valid for at least `expires_in` more seconds are served from the
+// client's signed URL cache when it is enabled.
+SupabaseError supabase_storage_create_signed_urls(
+    SupabaseClient* client,
+    const char* bucket_id,
+    const char* const* paths,
+    size_t count,
+    uint32_t expires_in,
+    SupabaseBuffer** out
+);
+
+// Deletes `count` files from the bucket in one request.
+SupabaseError supabase_storage_remove(
+    SupabaseClient* client,
+    const char* bucket_id,
+    const char* const* paths,
+    size_t count
+);
+
+// File transfers
+//
+// Local files are read directly by the library. Files larger than chunk_size
+// are uploaded as a resumable upload with up to max_concurrent_parts chunks in
+// flight while the next chunk is read from disk (0 selects the defaults: 5 MiB
+// chunks, 4 parts). The progress callback may be NULL and runs on the calling
+// thread. On success *out holds the upload response as JSON.
+typedef void (*SupabaseProgressCallback)(uint64_t transferred, uint64_t total, void* user_data);
+
+// checkpoint_path may be NULL. When set, finished parts are recorded there and
+// calling again with the same arguments after a crash resumes the upload; the
+// file is removed once the upload completes.
+SupabaseError supabase_storage_upload_file(
+    SupabaseClient* client,
+    const char* bucket_id,
+    const char* path,
+    const char* file_path,
+    const char* content_type,
+    const char* checkpoint_path,
+    uint64_t chunk_size,
+    size_t max_concurrent_parts,
+    SupabaseProgressCallback progress,
+    void* user_data,
+    SupabaseBuffer** out
+);
+
+// Same as supabase_storage_upload_file, but sends parts straight from a
+// read-only memory map of the file. The file must not change during the call.
+SupabaseError supabase_storage_upload_file_mapped(
+    SupabaseClient* client,
+    const char* bucket_id,
+    const char* path,
+    const char* file_path,
+    const char* content_type,
+    uint64_t chunk_size,
+    size_t max_concurrent_parts,
+    SupabaseProgressCallback progress,
+    void* user_data,
+    SupabaseBuffer** out
+);
+
+// Streams a file, or `length` bytes from `offset` (0/0 for the whole file, length
+// 0 to read to the end), to the callback as chunks arrive. `data` is only valid
+// during the call; return false to stop early.
+typedef bool (*SupabaseChunkCallback)(const uint8_t* data, size_t len, void* user_data);
+
+SupabaseError supabase_storage_download_stream(
+    SupabaseClient* client,
+    const char* bucket_id,
+    const char* path,
+    uint64_t offset,
+    uint64_t length,
+    SupabaseChunkCallback callback,
+    void* user_data
+);
+
+// POSIX only. Writes the file to an open descriptor as it arrives; fd is not closed.
+SupabaseError supabase_storage_download_to_fd(
+    SupabaseClient* client,
+    const char* bucket_id,
+    const char* path,
+    int fd
+);
+
+// Downloads part_size ranges of the file in parallel (0 selects the defaults:
+// 8 MiB parts, 4 at once) and writes them into file_path. `written` may be NULL.
+SupabaseError supabase_storage_download_to_file(
+    SupabaseClient* client,
+    const char* bucket_id,
+    const char* path,
+    const char* file_path,
+    uint64_t part_size,
+    size_t max_concurrent_parts,
+    SupabaseProgressCallback progress,
+    void* user_data,
+    uint64_t* written
+);
+
 // Edge Functions
 SupabaseError supabase_functions_invoke(
     SupabaseClient* client,
@@ -79,9 +392,241 @@ SupabaseError supabase_functions_invoke(
     char* result,
     size_t result_len
 );
+// Concurrent calls with the same name and payload share one request; only use
+// for idempotent functions
+SupabaseError supabase_functions_invoke_coalesced(
+    SupabaseClient* client,
+    const char* function_name,
+    const char* json_payload,
+    char* result,
+    size_t result_len
+);
+
+// Invokes the function once per payload with up to max_concurrency calls in
+// flight (0 is treated as 1). *out holds a JSON array with one entry per
+// payload, in order: {"data": <response>} or {"error": "<message>"}; failed
+// invocations do not fail the call.
+SupabaseError supabase_functions_invoke_many(
+    SupabaseClient* client,
+    const char* function_name,
+    const char* const* json_payloads,
+    size_t count,
+    size_t max_concurrency,
+    SupabaseBuffer** out
+);
+
+// Streams the response to the callback one chunk at a time: one call per
+// server-sent event (is_final is set for `data: [DONE]`), or per piece of body
+// text for other content types. String data is passed unquoted, anything else
+// as JSON; `data` is only valid during the call. The rest of the response is not
+// read until the callback returns; return false to stop early.
+typedef bool (*SupabaseFunctionChunkCallback)(
+    const char* data,
+    size_t data_len,
+    uint64_t sequence,
+    bool is_final,
+    void* user_data
+);
+
+SupabaseError supabase_functions_invoke_stream(
+    SupabaseClient* client,
+    const char* function_name,
+    const char* json_payload,
+    SupabaseFunctionChunkCallback callback,
+    void* user_data
+);
+
+// Realtime
+//
+// Database changes are queued by the library as they arrive and drained in
+// batches with supabase_realtime_poll; no callback runs per event. Each
+// subscription buffers up to 4096 events between polls; when the queue is full
+// new events are dropped and counted by supabase_realtime_dropped.
+typedef enum {
+    SUPABASE_REALTIME_INSERT = 1,
+    SUPABASE_REALTIME_UPDATE = 2,
+    SUPABASE_REALTIME_DELETE = 3
+} SupabaseRealtimeEventType;
+
+// `payload` is the change's JSON payload (NUL-terminated), valid until the next
+// poll of the same subscription or until it is unsubscribed. `sequence` counts
+// events from 0; gaps mean events were dropped.
+typedef struct {
+    SupabaseRealtimeEventType event_type;
+    const char* payload;
+    size_t payload_len;
+    uint64_t sequence;
+} SupabaseRealtimeEvent;
+
+// schema NULL is "public"; table NULL subscribes to every table in the schema.
+// event is "INSERT", "UPDATE", "DELETE", "*" or NULL for all; filter is an
+// optional PostgREST filter such as "id=eq.1". Returns NULL on error.
+SupabaseRealtimeSubscription* supabase_realtime_subscribe(
+    SupabaseClient* client,
+    const char* schema,
+    const char* table,
+    const char* event,
+    const char* filter
+);
+
+// Writes up to max_events queued events, oldest first, and returns how many.
+// Poll each subscription from one thread at a time.
+size_t supabase_realtime_poll(
+    SupabaseRealtimeSubscription* subscription,
+    SupabaseRealtimeEvent* events,
+    size_t max_events
+);
+
+uint64_t supabase_realtime_dropped(const SupabaseRealtimeSubscription* subscription);
+
+// Leaves the channel and frees the handle
+SupabaseError supabase_realtime_unsubscribe(SupabaseRealtimeSubscription* subscription);
+
+// Library-owned result buffers
+//
+// The *_buffer variants return the full result in a buffer sized by the library,
+// so large results never have to be re-fetched into a bigger array. On failure
+// *out is set to NULL. Buffers are NUL-terminated and freed with
+// supabase_buffer_free.
+const char* supabase_buffer_data(const SupabaseBuffer* buffer);
+size_t supabase_buffer_len(const SupabaseBuffer* buffer);
+void supabase_buffer_free(SupabaseBuffer* buffer);
+
+SupabaseError supabase_auth_sign_in_buffer(
+    SupabaseClient* client,
+    const char* email,
+    const char* password,
+    SupabaseBuffer** out
+);
+
+SupabaseError supabase_auth_sign_up_buffer(
+    SupabaseClient* client,
+    const char* email,
+    const char* password,
+    SupabaseBuffer** out
+);
+
+SupabaseError supabase_database_select_buffer(
+    SupabaseClient* client,
+    const char* table,
+    const char* columns,
+    SupabaseBuffer** out
+);
+
+SupabaseError supabase_database_insert_buffer(
+    SupabaseClient* client,
+    const char* table,
+    const char* json_data,
+    SupabaseBuffer** out
+);
+
+// Raw pass-through: request and response bodies are forwarded verbatim,
+// without being parsed or re-serialized by the library.
+SupabaseError supabase_database_select_raw(
+    SupabaseClient* client,
+    const char* table,
+    const char* columns,
+    SupabaseBuffer** out
+);
+
+SupabaseError supabase_database_insert_raw(
+    SupabaseClient* client,
+    const char* table,
+    const char* json_data,
+    size_t json_len,
+    SupabaseBuffer** out
+);
+
+SupabaseError supabase_storage_list_buckets_buffer(
+    SupabaseClient* client,
+    SupabaseBuffer** out
+);
+
+SupabaseError supabase_functions_invoke_buffer(
+    SupabaseClient* client,
+    const char* function_name,
+    const char* json_payload,
+    SupabaseBuffer** out
+);
+
+// Asynchronous operations
+//
+// Each *_async call returns immediately with a request handle (NULL on invalid
+// input). The callback fires exactly once on a runtime worker thread with the
+// JSON result or the error message; `result` is only valid during the call.
+// Callbacks must not block or call the blocking supabase_* functions.
+// Cancelled requests complete with SUPABASE_RUNTIME_ERROR.
+typedef void (*SupabaseCompletionCallback)(
+    SupabaseError error,
+    const char* result,
+    size_t result_len,
+    void* user_data
+);
+
+SupabaseRequest* supabase_auth_sign_in_async(
+    SupabaseClient* client,
+    const char* email,
+    const char* password,
+    SupabaseCompletionCallback callback,
+    void* user_data
+);
+
+SupabaseRequest* supabase_auth_sign_up_async(
+    SupabaseClient* client,
+    const char* email,
+    const char* password,
+    SupabaseCompletionCallback callback,
+    void* user_data
+);
+
+SupabaseRequest* supabase_database_select_async(
+    SupabaseClient* client,
+    const char* table,
+    const char* columns,
+    SupabaseCompletionCallback callback,
+    void* user_data
+);
+
+SupabaseRequest* supabase_database_insert_async(
+    SupabaseClient* client,
+    const char* table,
+    const char* json_data,
+    SupabaseCompletionCallback callback,
+    void* user_data
+);
+
+SupabaseRequest* supabase_storage_list_buckets_async(
+    SupabaseClient* client,
+    SupabaseCompletionCallback callback,
+    void* user_data
+);
+
+SupabaseRequest* supabase_functions_invoke_async(
+    SupabaseClient* client,
+    const char* function_name,
+    const char* json_payload,
+    SupabaseCompletionCallback callback,
+    void* user_data
+);
+
+// Request handles
+bool supabase_request_is_done(const SupabaseRequest* request);
+SupabaseError supabase_request_wait(SupabaseRequest* request, char* result, size_t result_len);
+void supabase_request_cancel(SupabaseRequest* request);
+void supabase_request_free(SupabaseRequest* request);
+
+// Metrics
+// Process-wide request counters, latency quantiles and per-module compression
+// savings as JSON
+SupabaseError supabase_metrics_snapshot(SupabaseBuffer** out);
 
 // Error handling
+// The last error is kept per calling thread (errno-style); async failures are
+// recorded on the thread that calls supabase_request_wait.
 SupabaseError supabase_get_last_error(char* buffer, size_t buffer_len);
+// Code of the last error on the calling thread, SUPABASE_SUCCESS if none. Client
+// and runtime constructors that return NULL record their failure here.
+SupabaseError supabase_get_last_error_code(void);
 
 #ifdef __cplusplus
 }
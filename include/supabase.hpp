@@ -0,0 +1,602 @@
+#ifndef SUPABASE_HPP
+#define SUPABASE_HPP
+
+// Header-only C++17 wrapper over supabase.h
+//
+// - Client, Runtime, Buffer and Request own their C handles and are move-only.
+// - Inputs are std::string_view. Views are NUL-terminated on the stack when
+//   they fit in 256 bytes; JSON documents for insert are passed with their
+//   length and not copied at all.
+// - Results come back as a Buffer over the library's allocation (the *_buffer
+//   and *_raw entry points), so nothing is copied into a std::string unless the
+//   caller asks for one.
+// - Failures throw a subclass of supabase::Error matching the SupabaseError code.
+// - *_async methods return a Request that can be waited on, turned into a
+//   std::future or, with C++20 coroutines, co_awaited. Awaiting coroutines are
+//   resumed on a runtime worker thread and must not make blocking calls there.
+//
+//   supabase::Client client("http://localhost:54321", anon_key);
+//   supabase::Buffer rows = client.select("profiles", "id,name");
+//   std::string_view json = rows.view();
+
+#include "supabase.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define SUPABASE_HPP_COROUTINES 1
+#endif
+
+namespace supabase {
+
+// Errors
+
+class Error : public std::runtime_error {
+public:
+    Error(SupabaseError code, const std::string& message)
+        : std::runtime_error(message), code_(code) {}
+
+    SupabaseError code() const noexcept { return code_; }
+
+private:
+    SupabaseError code_;
+};
+
+#define SUPABASE_HPP_ERROR(name)                                                           \
+    class name : public Error {                                                            \
+    public:                                                                                \
+        using Error::Error;                                                                \
+    };
+
+SUPABASE_HPP_ERROR(InvalidInputError)
+SUPABASE_HPP_ERROR(NetworkError)
+SUPABASE_HPP_ERROR(AuthError)
+SUPABASE_HPP_ERROR(DatabaseError)
+SUPABASE_HPP_ERROR(StorageError)
+SUPABASE_HPP_ERROR(FunctionsError)
+SUPABASE_HPP_ERROR(RealtimeError)
+SUPABASE_HPP_ERROR(RuntimeError)
+
+#undef SUPABASE_HPP_ERROR
+
+namespace detail {
+
+inline std::exception_ptr make_error(SupabaseError code, const std::string& message) {
+    switch (code) {
+    case SUPABASE_INVALID_INPUT:
+        return std::make_exception_ptr(InvalidInputError(code, message));
+    case SUPABASE_NETWORK_ERROR:
+        return std::make_exception_ptr(NetworkError(code, message));
+    case SUPABASE_AUTH_ERROR:
+        return std::make_exception_ptr(AuthError(code, message));
+    case SUPABASE_DATABASE_ERROR:
+        return std::make_exception_ptr(DatabaseError(code, message));
+    case SUPABASE_STORAGE_ERROR:
+        return std::make_exception_ptr(StorageError(code, message));
+    case SUPABASE_FUNCTIONS_ERROR:
+        return std::make_exception_ptr(FunctionsError(code, message));
+    case SUPABASE_REALTIME_ERROR:
+        return std::make_exception_ptr(RealtimeError(code, message));
+    case SUPABASE_RUNTIME_ERROR:
+        return std::make_exception_ptr(RuntimeError(code, message));
+    default:
+        return std::make_exception_ptr(Error(code, message));
+    }
+}
+
+// The calling thread's last error message
+inline std::string last_error_message() {
+    char message[1024];
+    if (supabase_get_last_error(message, sizeof(message)) != SUPABASE_SUCCESS) {
+        return "Unknown error";
+    }
+    return message;
+}
+
+[[noreturn]] inline void throw_error(SupabaseError code, const std::string& message) {
+    std::rethrow_exception(make_error(code, message));
+}
+
+// Throw the failure recorded by a C constructor that returned NULL
+[[noreturn]] inline void throw_last_error() {
+    SupabaseError code = supabase_get_last_error_code();
+    throw_error(code == SUPABASE_SUCCESS ? SUPABASE_UNKNOWN_ERROR : code, last_error_message());
+}
+
+inline void check(SupabaseError code) {
+    if (code != SUPABASE_SUCCESS) {
+        throw_error(code, last_error_message());
+    }
+}
+
+// NUL-terminated copy of a view, on the stack unless it is long
+class CStr {
+public:
+    explicit CStr(std::string_view value) {
+        if (value.size() < sizeof(inline_)) {
+            std::memcpy(inline_, value.data(), value.size());
+            inline_[value.size()] = '\0';
+            ptr_ = inline_;
+        } else {
+            heap_.assign(value.data(), value.size());
+            ptr_ = heap_.c_str();
+        }
+    }
+
+    CStr(const CStr&) = delete;
+    CStr& operator=(const CStr&) = delete;
+
+    const char* get() const noexcept { return ptr_; }
+
+private:
+    char inline_[256];
+    std::string heap_;
+    const char* ptr_;
+};
+
+// Call a C function that writes into a caller-sized buffer, growing the buffer
+// while the library reports it as too small
+template <typename F>
+std::string call_with_buffer(F&& call) {
+    std::string result(4096, '\0');
+    for (;;) {
+        SupabaseError code = call(result.data(), result.size());
+        if (code == SUPABASE_SUCCESS) {
+            result.resize(std::strlen(result.c_str()));
+            return result;
+        }
+        std::string message = last_error_message();
+        if (code != SUPABASE_INVALID_INPUT || message.rfind("Result buffer too small", 0) != 0 ||
+            result.size() >= (std::size_t{1} << 26)) {
+            throw_error(code, message);
+        }
+        result.assign(result.size() * 4, '\0');
+    }
+}
+
+} // namespace detail
+
+// Results
+
+// A library-owned, NUL-terminated result; the bytes stay valid until the
+// Buffer is destroyed
+class Buffer {
+public:
+    Buffer() noexcept = default;
+    explicit Buffer(SupabaseBuffer* buffer) noexcept : buffer_(buffer) {}
+
+    Buffer(Buffer&& other) noexcept : buffer_(std::exchange(other.buffer_, nullptr)) {}
+    Buffer& operator=(Buffer&& other) noexcept {
+        if (this != &other) {
+            supabase_buffer_free(buffer_);
+            buffer_ = std::exchange(other.buffer_, nullptr);
+        }
+        return *this;
+    }
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+    ~Buffer() { supabase_buffer_free(buffer_); }
+
+    const char* data() const noexcept { return buffer_ ? supabase_buffer_data(buffer_) : ""; }
+    const char* c_str() const noexcept { return data(); }
+    std::size_t size() const noexcept { return buffer_ ? supabase_buffer_len(buffer_) : 0; }
+    bool empty() const noexcept { return size() == 0; }
+
+    const char* begin() const noexcept { return data(); }
+    const char* end() const noexcept { return data() + size(); }
+
+    std::string_view view() const noexcept { return std::string_view(data(), size()); }
+    operator std::string_view() const noexcept { return view(); }
+    std::string str() const { return std::string(view()); }
+
+#if defined(__cpp_lib_span)
+    std::span<const char> span() const noexcept { return std::span<const char>(data(), size()); }
+#endif
+
+    SupabaseBuffer* native_handle() const noexcept { return buffer_; }
+    SupabaseBuffer* release() noexcept { return std::exchange(buffer_, nullptr); }
+
+private:
+    SupabaseBuffer* buffer_ = nullptr;
+};
+
+namespace detail {
+
+template <typename F>
+Buffer call_with_out(F&& call) {
+    SupabaseBuffer* out = nullptr;
+    SupabaseError code = call(&out);
+    Buffer buffer(out);
+    check(code);
+    return buffer;
+}
+
+} // namespace detail
+
+// Asynchronous requests
+
+// An in-flight *_async call. Destroying the Request does not cancel it; the
+// result is then discarded when it arrives.
+class Request {
+public:
+    Request() noexcept = default;
+
+    Request(Request&& other) noexcept
+        : state_(std::exchange(other.state_, nullptr)),
+          request_(std::exchange(other.request_, nullptr)) {}
+    Request& operator=(Request&& other) noexcept {
+        if (this != &other) {
+            reset();
+            state_ = std::exchange(other.state_, nullptr);
+            request_ = std::exchange(other.request_, nullptr);
+        }
+        return *this;
+    }
+    Request(const Request&) = delete;
+    Request& operator=(const Request&) = delete;
+    ~Request() { reset(); }
+
+    bool valid() const noexcept { return state_ != nullptr && state_->future.valid(); }
+    bool is_done() const noexcept { return request_ != nullptr && supabase_request_is_done(request_); }
+
+    // The request still completes, with a RuntimeError
+    void cancel() noexcept {
+        if (request_ != nullptr) {
+            supabase_request_cancel(request_);
+        }
+    }
+
+    // Block until the result arrives; consumes the result
+    std::string get() { return take_future().get(); }
+
+    // Hand the result over to a std::future; consumes the result
+    std::future<std::string> future() { return take_future(); }
+
+#if defined(SUPABASE_HPP_COROUTINES)
+    class Awaiter {
+    public:
+        explicit Awaiter(Request& request) : request_(request) {}
+
+        bool await_ready() const noexcept { return request_.is_done(); }
+
+        // Returns false when the result arrived first, resuming immediately
+        bool await_suspend(std::coroutine_handle<> waiting) {
+            State& state = *request_.state_;
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (state.done) {
+                return false;
+            }
+            state.waiting = waiting;
+            return true;
+        }
+
+        std::string await_resume() { return request_.get(); }
+
+    private:
+        Request& request_;
+    };
+
+    Awaiter operator co_await() & { return Awaiter(*this); }
+    Awaiter operator co_await() && { return Awaiter(*this); }
+#endif
+
+    // Start a request through a *_async entry point taking (callback, user_data)
+    template <typename Start>
+    static Request start(Start&& start) {
+        Request request;
+        request.state_ = new State();
+        request.state_->future = request.state_->promise.get_future();
+        // One reference for the Request, one for the callback
+        request.state_->references = 2;
+        request.request_ = start(&Request::complete, static_cast<void*>(request.state_));
+        if (request.request_ == nullptr) {
+            // Rejected before spawning, so the callback will never run
+            delete std::exchange(request.state_, nullptr);
+            throw InvalidInputError(SUPABASE_INVALID_INPUT, "Invalid request arguments");
+        }
+        return request;
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::promise<std::string> promise;
+        std::future<std::string> future;
+        bool done = false;
+        int references = 0;
+#if defined(SUPABASE_HPP_COROUTINES)
+        std::coroutine_handle<> waiting;
+#endif
+    };
+
+    static void release(State* state) noexcept {
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            last = --state->references == 0;
+        }
+        if (last) {
+            delete state;
+        }
+    }
+
+    static void complete(SupabaseError error, const char* result, std::size_t result_len,
+                         void* user_data) {
+        State* state = static_cast<State*>(user_data);
+#if defined(SUPABASE_HPP_COROUTINES)
+        std::coroutine_handle<> waiting;
+#endif
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            try {
+                std::string payload(result, result_len);
+                if (error == SUPABASE_SUCCESS) {
+                    state->promise.set_value(std::move(payload));
+                } else {
+                    state->promise.set_exception(detail::make_error(error, payload));
+                }
+            } catch (...) {
+                state->promise.set_exception(std::current_exception());
+            }
+            state->done = true;
+#if defined(SUPABASE_HPP_COROUTINES)
+            waiting = std::exchange(state->waiting, nullptr);
+#endif
+        }
+#if defined(SUPABASE_HPP_COROUTINES)
+        // Resume before dropping our reference so the awaited Request is alive
+        if (waiting) {
+            waiting.resume();
+        }
+#endif
+        release(state);
+    }
+
+    std::future<std::string> take_future() {
+        if (!valid()) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return std::move(state_->future);
+    }
+
+    void reset() noexcept {
+        if (request_ != nullptr) {
+            supabase_request_free(std::exchange(request_, nullptr));
+        }
+        if (state_ != nullptr) {
+            release(std::exchange(state_, nullptr));
+        }
+    }
+
+    State* state_ = nullptr;
+    SupabaseRequest* request_ = nullptr;
+};
+
+// Handles
+
+// Worker threads shared by the clients created on it; 0 keeps tokio's defaults
+class Runtime {
+public:
+    explicit Runtime(std::size_t worker_threads = 0, std::size_t max_blocking_threads = 0)
+        : runtime_(supabase_runtime_new(worker_threads, max_blocking_threads)) {
+        if (runtime_ == nullptr) {
+            detail::throw_last_error();
+        }
+    }
+
+    Runtime(Runtime&& other) noexcept : runtime_(std::exchange(other.runtime_, nullptr)) {}
+    Runtime& operator=(Runtime&& other) noexcept {
+        if (this != &other) {
+            supabase_runtime_free(runtime_);
+            runtime_ = std::exchange(other.runtime_, nullptr);
+        }
+        return *this;
+    }
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+    ~Runtime() { supabase_runtime_free(runtime_); }
+
+    SupabaseRuntime* native_handle() const noexcept { return runtime_; }
+
+private:
+    SupabaseRuntime* runtime_;
+};
+
+class Client {
+public:
+    Client(std::string_view url, std::string_view key)
+        : client_(supabase_client_new(detail::CStr(url).get(), detail::CStr(key).get())) {
+        if (client_ == nullptr) {
+            detail::throw_last_error();
+        }
+    }
+
+    // The client keeps the runtime alive; `runtime` may be destroyed first
+    Client(Runtime& runtime, std::string_view url, std::string_view key)
+        : client_(supabase_client_new_with_runtime(runtime.native_handle(),
+                                                   detail::CStr(url).get(),
+                                                   detail::CStr(key).get())) {
+        if (client_ == nullptr) {
+            detail::throw_last_error();
+        }
+    }
+
+    // Zero-initialized fields of `config` keep their defaults; see supabase.h
+    Client(std::string_view url, std::string_view key, const SupabaseClientConfig& config,
+           Runtime* runtime = nullptr)
+        : client_(supabase_client_new_with_config(runtime ? runtime->native_handle() : nullptr,
+                                                  detail::CStr(url).get(),
+                                                  detail::CStr(key).get(), &config)) {
+        if (client_ == nullptr) {
+            detail::throw_last_error();
+        }
+    }
+
+    Client(Client&& other) noexcept : client_(std::exchange(other.client_, nullptr)) {}
+    Client& operator=(Client&& other) noexcept {
+        if (this != &other) {
+            supabase_client_free(client_);
+            client_ = std::exchange(other.client_, nullptr);
+        }
+        return *this;
+    }
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+    ~Client() { supabase_client_free(client_); }
+
+    SupabaseClient* native_handle() const noexcept { return client_; }
+
+    void warm_up(std::uint32_t connections) {
+        detail::check(supabase_client_warm_up(client_, connections));
+    }
+
+    // Authentication
+
+    Buffer sign_in(std::string_view email, std::string_view password) {
+        detail::CStr email_c(email), password_c(password);
+        return detail::call_with_out([&](SupabaseBuffer** out) {
+            return supabase_auth_sign_in_buffer(client_, email_c.get(), password_c.get(), out);
+        });
+    }
+
+    Buffer sign_up(std::string_view email, std::string_view password) {
+        detail::CStr email_c(email), password_c(password);
+        return detail::call_with_out([&](SupabaseBuffer** out) {
+            return supabase_auth_sign_up_buffer(client_, email_c.get(), password_c.get(), out);
+        });
+    }
+
+    // 0 selects the library default (300 seconds ahead of expiry)
+    void start_auto_refresh(std::uint32_t refresh_ahead_seconds = 0) {
+        detail::check(supabase_auth_start_auto_refresh(client_, refresh_ahead_seconds));
+    }
+
+    void stop_auto_refresh() noexcept { supabase_auth_stop_auto_refresh(client_); }
+
+    std::string access_token() {
+        return detail::call_with_buffer([&](char* result, std::size_t len) {
+            return supabase_auth_access_token(client_, result, len);
+        });
+    }
+
+    // Claims of a locally verified access token, as JSON
+    std::string verify_token(std::string_view token) {
+        detail::CStr token_c(token);
+        return detail::call_with_buffer([&](char* result, std::size_t len) {
+            return supabase_auth_verify_token(client_, token_c.get(), result, len);
+        });
+    }
+
+    // Database (raw pass-through: bodies are neither parsed nor re-serialized)
+
+    Buffer select(std::string_view table, std::string_view columns = "*") {
+        detail::CStr table_c(table), columns_c(columns);
+        return detail::call_with_out([&](SupabaseBuffer** out) {
+            return supabase_database_select_raw(client_, table_c.get(), columns_c.get(), out);
+        });
+    }
+
+    Buffer insert(std::string_view table, std::string_view json) {
+        detail::CStr table_c(table);
+        return detail::call_with_out([&](SupabaseBuffer** out) {
+            return supabase_database_insert_raw(client_, table_c.get(),
+                                                json.data() != nullptr ? json.data() : "",
+                                                json.size(), out);
+        });
+    }
+
+    // Storage
+
+    Buffer list_buckets() {
+        return detail::call_with_out([&](SupabaseBuffer** out) {
+            return supabase_storage_list_buckets_buffer(client_, out);
+        });
+    }
+
+    // Edge Functions
+
+    Buffer invoke(std::string_view function_name, std::string_view json_payload = "{}") {
+        detail::CStr name_c(function_name), payload_c(json_payload);
+        return detail::call_with_out([&](SupabaseBuffer** out) {
+            return supabase_functions_invoke_buffer(client_, name_c.get(), payload_c.get(), out);
+        });
+    }
+
+    // Asynchronous variants
+
+    Request sign_in_async(std::string_view email, std::string_view password) {
+        detail::CStr email_c(email), password_c(password);
+        return Request::start([&](SupabaseCompletionCallback callback, void* user_data) {
+            return supabase_auth_sign_in_async(client_, email_c.get(), password_c.get(), callback,
+                                               user_data);
+        });
+    }
+
+    Request sign_up_async(std::string_view email, std::string_view password) {
+        detail::CStr email_c(email), password_c(password);
+        return Request::start([&](SupabaseCompletionCallback callback, void* user_data) {
+            return supabase_auth_sign_up_async(client_, email_c.get(), password_c.get(), callback,
+                                               user_data);
+        });
+    }
+
+    Request select_async(std::string_view table, std::string_view columns = "*") {
+        detail::CStr table_c(table), columns_c(columns);
+        return Request::start([&](SupabaseCompletionCallback callback, void* user_data) {
+            return supabase_database_select_async(client_, table_c.get(), columns_c.get(),
+                                                  callback, user_data);
+        });
+    }
+
+    Request insert_async(std::string_view table, std::string_view json) {
+        detail::CStr table_c(table), json_c(json);
+        return Request::start([&](SupabaseCompletionCallback callback, void* user_data) {
+            return supabase_database_insert_async(client_, table_c.get(), json_c.get(), callback,
+                                                  user_data);
+        });
+    }
+
+    Request list_buckets_async() {
+        return Request::start([&](SupabaseCompletionCallback callback, void* user_data) {
+            return supabase_storage_list_buckets_async(client_, callback, user_data);
+        });
+    }
+
+    Request invoke_async(std::string_view function_name, std::string_view json_payload = "{}") {
+        detail::CStr name_c(function_name), payload_c(json_payload);
+        return Request::start([&](SupabaseCompletionCallback callback, void* user_data) {
+            return supabase_functions_invoke_async(client_, name_c.get(), payload_c.get(),
+                                                   callback, user_data);
+        });
+    }
+
+private:
+    SupabaseClient* client_;
+};
+
+// Process-wide request metrics as JSON
+inline Buffer metrics_snapshot() {
+    return detail::call_with_out([](SupabaseBuffer** out) { return supabase_metrics_snapshot(out); });
+}
+
+} // namespace supabase
+
+#endif // SUPABASE_HPP
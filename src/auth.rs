@@ -11,8 +11,12 @@
 
 use crate::{
     error::{Error, Result},
+    jwt::{JwtVerifier, VerifiedToken},
+    metrics::SendMetered,
+    single_flight::SingleFlight,
     types::{SupabaseConfig, Timestamp},
 };
+use arc_swap::ArcSwapOption;
 use chrono::Utc;
 use reqwest::Client as HttpClient;
 use serde::{Deserialize, Serialize};
@@ -323,20 +327,88 @@ pub struct Auth {
     http_client: Arc<HttpClient>,
     config: Arc<SupabaseConfig>,
     session: Arc<RwLock<Option<Session>>>,
+    /// Mirror of the session's access token, readable without the session lock
+    token: Arc<ArcSwapOption<AccessToken>>,
+    refreshes: Arc<SingleFlight<Session>>,
+    verifier: Arc<JwtVerifier>,
     event_listeners: Arc<RwLock<HashMap<Uuid, AuthStateCallback>>>,
 }
 
 impl Clone for Auth {
     fn clone(&self) -> Self {
         Self {
-            http_client: self.http_client.clone(),
-            config: self.config.clone(),
-            session: self.session.clone(),
             event_listeners: Arc::new(RwLock::new(HashMap::new())),
+            ..self.share()
+        }
+    }
+}
+
+/// The current bearer token and its expiry
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct AccessToken {
+    /// JWT to send as `Authorization: Bearer <token>`
+    pub access_token: String,
+    /// When the token expires
+    pub expires_at: Timestamp,
+}
+
+impl AccessToken {
+    fn of(session: &Session) -> Self {
+        Self {
+            access_token: session.access_token.clone(),
+            expires_at: session.expires_at,
+        }
+    }
+
+    /// Whether the token expires within `buffer_seconds`
+    pub fn expires_within(&self, buffer_seconds: i64) -> bool {
+        Utc::now() >= self.expires_at - chrono::Duration::seconds(buffer_seconds)
+    }
+}
+
+/// Timing for [`Auth::start_auto_refresh`]
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+#[derive(Debug, Clone)]
+pub struct AutoRefreshConfig {
+    /// Refresh this long before the access token expires
+    pub refresh_ahead: std::time::Duration,
+    /// Wait this long before retrying a failed refresh
+    pub retry_after: std::time::Duration,
+    /// Longest sleep between checks, so sign-ins and sign-outs are noticed
+    pub check_interval: std::time::Duration,
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl Default for AutoRefreshConfig {
+    fn default() -> Self {
+        Self {
+            refresh_ahead: std::time::Duration::from_secs(300),
+            retry_after: std::time::Duration::from_secs(30),
+            check_interval: std::time::Duration::from_secs(60),
         }
     }
 }
 
+/// Background refresher started by [`Auth::start_auto_refresh`]; stops when dropped
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+#[derive(Debug)]
+pub struct AutoRefreshHandle {
+    task: tokio::task::JoinHandle<()>,
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl AutoRefreshHandle {
+    /// Stop refreshing
+    pub fn stop(self) {}
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl Drop for AutoRefreshHandle {
+    fn drop(&mut self) {
+        self.task.abort();
+    }
+}
+
 impl std::fmt::Debug for Auth {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         f.debug_struct("Auth")
@@ -439,13 +511,29 @@ impl Auth {
         debug!("Initializing Auth module");
 
         Ok(Self {
+            verifier: Arc::new(JwtVerifier::new(config.clone(), http_client.clone())),
             http_client,
             config,
             session: Arc::new(RwLock::new(None)),
+            token: Arc::new(ArcSwapOption::empty()),
+            refreshes: Arc::new(SingleFlight::default()),
             event_listeners: Arc::new(RwLock::new(HashMap::new())),
         })
     }
 
+    /// A handle on the same session and event listeners
+    fn share(&self) -> Self {
+        Self {
+            http_client: self.http_client.clone(),
+            config: self.config.clone(),
+            session: self.session.clone(),
+            token: self.token.clone(),
+            refreshes: self.refreshes.clone(),
+            verifier: self.verifier.clone(),
+            event_listeners: self.event_listeners.clone(),
+        }
+    }
+
     /// Sign up a new user with email and password
     pub async fn sign_up_with_email_and_password(
         &self,
@@ -477,7 +565,7 @@ impl Auth {
             .http_client
             .post(format!("{}/auth/v1/signup", self.config.url))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -525,7 +613,7 @@ impl Auth {
                 self.config.url
             ))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -563,7 +651,7 @@ impl Auth {
             .http_client
             .post(format!("{}/auth/v1/logout", self.config.url))
             .header("Authorization", format!("Bearer {}", session.access_token))
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -600,7 +688,7 @@ impl Auth {
             .http_client
             .post(format!("{}/auth/v1/recover", self.config.url))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -638,7 +726,7 @@ impl Auth {
             .put(format!("{}/auth/v1/user", self.config.url))
             .header("Authorization", format!("Bearer {}", session.access_token))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -677,7 +765,7 @@ impl Auth {
                 self.config.url
             ))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -732,6 +820,7 @@ impl Auth {
             .session
             .write()
             .map_err(|_| Error::auth("Failed to write session"))?;
+        self.token.store(Some(Arc::new(AccessToken::of(&session))));
         *session_guard = Some(session);
         Ok(())
     }
@@ -744,7 +833,7 @@ impl Auth {
             .http_client
             .get(format!("{}/auth/v1/user", self.config.url))
             .header("Authorization", format!("Bearer {}", token))
-            .send()
+            .send_metered()
             .await?;
 
         if !user_response.status().is_success() {
@@ -772,24 +861,114 @@ impl Auth {
             .session
             .write()
             .map_err(|_| Error::auth("Failed to write session"))?;
+        self.token.store(None);
         *session_guard = None;
         Ok(())
     }
 
     /// Check if the user is authenticated
     pub fn is_authenticated(&self) -> bool {
-        let session_guard = self.session.read().unwrap_or_else(|_| {
-            warn!("Failed to read session lock");
-            self.session.read().unwrap()
-        });
+        self.token
+            .load()
+            .as_ref()
+            .is_some_and(|token| token.expires_at > Utc::now())
+    }
 
-        match session_guard.as_ref() {
-            Some(session) => {
-                let now = Utc::now();
-                session.expires_at > now
-            }
-            None => false,
+    /// The current access token, read without locking the session
+    ///
+    /// This is the cheap call for per-request bearer headers; a background
+    /// refresher started with [`Auth::start_auto_refresh`] swaps new tokens in
+    /// atomically.
+    pub fn access_token(&self) -> Option<Arc<AccessToken>> {
+        self.token.load_full()
+    }
+
+    /// Return an access token valid for at least `buffer_seconds`, refreshing first
+    /// if needed
+    ///
+    /// Concurrent callers that find the same token expiring share one refresh
+    /// request instead of each making their own.
+    pub async fn ensure_fresh_token(&self, buffer_seconds: i64) -> Result<Arc<AccessToken>> {
+        let stale = self
+            .token
+            .load_full()
+            .ok_or_else(|| Error::auth("No active session to refresh"))?;
+        if !stale.expires_within(buffer_seconds) {
+            return Ok(stale);
         }
+
+        let refresh = async {
+            // A refresh that finished between our check and joining the flight
+            // already replaced the token
+            match self.token.load_full() {
+                Some(current) if current.access_token != stale.access_token => self.get_session(),
+                _ => self.refresh_token_advanced().await,
+            }
+        };
+        let session = self
+            .refreshes
+            .run(stale.access_token.clone(), refresh)
+            .await?;
+        Ok(Arc::new(AccessToken::of(&session)))
+    }
+
+    /// Refresh the session in the background ahead of expiry
+    ///
+    /// The task runs on the current Tokio runtime until the returned handle is
+    /// dropped. Refreshes go through [`Auth::ensure_fresh_token`], so they are
+    /// shared with any foreground caller refreshing at the same time, and fire
+    /// [`AuthEvent::TokenRefreshed`] on this client's listeners.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::{auth::AutoRefreshConfig, Client};
+    /// # async fn example() -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("https://example.supabase.co", "your-anon-key")?;
+    /// client
+    ///     .auth()
+    ///     .sign_in_with_email_and_password("user@example.com", "password")
+    ///     .await?;
+    ///
+    /// let _refresher = client.auth().start_auto_refresh(AutoRefreshConfig::default());
+    /// // ... requests read client.auth().access_token() without locking
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub fn start_auto_refresh(&self, config: AutoRefreshConfig) -> AutoRefreshHandle {
+        let auth = self.share();
+        let task = tokio::spawn(async move {
+            let buffer_seconds = config.refresh_ahead.as_secs() as i64;
+            let mut just_refreshed = false;
+            loop {
+                let until_refresh = auth.token.load_full().and_then(|token| {
+                    (token.expires_at - chrono::Duration::seconds(buffer_seconds) - Utc::now())
+                        .to_std()
+                        .ok()
+                });
+                let delay = match (auth.token.load_full(), until_refresh) {
+                    (None, _) => config.check_interval,
+                    (Some(_), Some(remaining)) => remaining.min(config.check_interval),
+                    // Tokens shorter-lived than `refresh_ahead` would refresh in a loop
+                    (Some(_), None) if just_refreshed => config.retry_after,
+                    (Some(_), None) => match auth.ensure_fresh_token(buffer_seconds).await {
+                        Ok(_) => {
+                            debug!("Background token refresh succeeded");
+                            just_refreshed = true;
+                            continue;
+                        }
+                        Err(err) => {
+                            warn!("Background token refresh failed: {}", err);
+                            config.retry_after
+                        }
+                    },
+                };
+                just_refreshed = false;
+                tokio::time::sleep(delay).await;
+            }
+        });
+        AutoRefreshHandle { task }
     }
 
     /// Check if the current token needs refresh
@@ -912,7 +1091,7 @@ impl Auth {
             .http_client
             .post(format!("{}/auth/v1/signup", self.config.url))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -968,7 +1147,7 @@ impl Auth {
                 self.config.url
             ))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1032,7 +1211,7 @@ impl Auth {
             .http_client
             .post(format!("{}/auth/v1/verify", self.config.url))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1089,7 +1268,7 @@ impl Auth {
             .http_client
             .post(format!("{}/auth/v1/magiclink", self.config.url))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1138,7 +1317,7 @@ impl Auth {
             .post(format!("{}/auth/v1/signup", self.config.url))
             .header("Authorization", format!("Bearer {}", self.config.key))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1193,7 +1372,7 @@ impl Auth {
             .http_client
             .post(format!("{}/auth/v1/recover", self.config.url))
             .json(&payload)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1312,7 +1491,7 @@ impl Auth {
             .http_client
             .get(format!("{}/auth/v1/factors", self.config.url))
             .header("Authorization", format!("Bearer {}", session.access_token))
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1357,7 +1536,7 @@ impl Auth {
             .post(format!("{}/auth/v1/factors", self.config.url))
             .header("Authorization", format!("Bearer {}", session.access_token))
             .json(&request_body)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1431,7 +1610,7 @@ impl Auth {
             .post(format!("{}/auth/v1/factors", self.config.url))
             .header("Authorization", format!("Bearer {}", session.access_token))
             .json(&request_body)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1480,7 +1659,7 @@ impl Auth {
             ))
             .header("Authorization", format!("Bearer {}", session.access_token))
             .json(&request_body)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1539,7 +1718,7 @@ impl Auth {
             ))
             .header("Authorization", format!("Bearer {}", session.access_token))
             .json(&request_body)
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1585,7 +1764,7 @@ impl Auth {
             .http_client
             .delete(format!("{}/auth/v1/factors/{}", self.config.url, factor_id))
             .header("Authorization", format!("Bearer {}", session.access_token))
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -1742,7 +1921,7 @@ impl Auth {
             .header("apikey", &self.config.key)
             .header("Authorization", format!("Bearer {}", &self.config.key))
             .json(&request_body)
-            .send()
+            .send_metered()
             .await;
 
         match response {
@@ -1843,20 +2022,12 @@ impl Auth {
     /// # }
     /// ```
     pub fn needs_refresh_with_buffer(&self, buffer_seconds: i64) -> Result<bool> {
-        let session_guard = self
-            .session
-            .read()
-            .map_err(|_| Error::auth("Failed to read session"))?;
-
-        match session_guard.as_ref() {
-            Some(session) => {
-                let now = Utc::now();
-                let refresh_threshold =
-                    session.expires_at - chrono::Duration::seconds(buffer_seconds);
-                Ok(now >= refresh_threshold)
-            }
-            None => Ok(false), // No session, no need to refresh
-        }
+        // No session, no need to refresh
+        Ok(self
+            .token
+            .load()
+            .as_ref()
+            .is_some_and(|token| token.expires_within(buffer_seconds)))
     }
 
     /// Get time until token expiry in seconds
@@ -1927,11 +2098,44 @@ impl Auth {
             None => Ok(false),
         }
     }
+
+    /// Verify an access token locally and return its claims
+    ///
+    /// The signature is checked against the project's signing keys (fetched from
+    /// the JWKS endpoint and refetched on key rotation) or, for HS256 tokens,
+    /// [`AuthConfig::jwt_secret`](crate::types::AuthConfig::jwt_secret). Verified
+    /// tokens are cached until they expire, so repeat calls for the same token
+    /// make no network request and skip signature verification.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::Client;
+    /// # async fn example(bearer: &str) -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("https://example.supabase.co", "your-anon-key")?;
+    ///
+    /// let verified = client.auth().verify_token(bearer).await?;
+    /// println!("Request from {:?}", verified.claims.sub);
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub async fn verify_token(&self, token: &str) -> Result<Arc<VerifiedToken>> {
+        self.verifier.verify(token).await
+    }
+
+    /// The claims of `token` if it was already verified and has not expired
+    ///
+    /// Never blocks on the network; fall back to [`Auth::verify_token`] on `None`.
+    pub fn verify_token_cached(&self, token: &str) -> Option<Arc<VerifiedToken>> {
+        self.verifier.cached(token)
+    }
 }
 
 #[cfg(test)]
 mod tests {
     use super::*;
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    use crate::mock_server::{MockResponse, MockServer};
     use crate::types::SupabaseConfig;
     use std::sync::Arc;
 
@@ -1944,6 +2148,7 @@ mod tests {
             auth_config: crate::types::AuthConfig::default(),
             database_config: crate::types::DatabaseConfig::default(),
             storage_config: crate::types::StorageConfig::default(),
+            functions_config: crate::types::FunctionsConfig::default(),
         })
     }
 
@@ -2273,4 +2478,129 @@ mod tests {
         assert_eq!(enhanced_session.active_factors.len(), 0);
         assert_eq!(enhanced_session.token_type, "bearer");
     }
+
+    fn session_expiring_in(seconds: i64) -> Session {
+        Session {
+            access_token: "stale-token".to_string(),
+            refresh_token: "refresh-token".to_string(),
+            expires_in: seconds,
+            expires_at: Utc::now() + chrono::Duration::seconds(seconds),
+            token_type: "bearer".to_string(),
+            user: User {
+                id: Uuid::new_v4(),
+                email: None,
+                phone: None,
+                email_confirmed_at: None,
+                phone_confirmed_at: None,
+                created_at: Utc::now(),
+                updated_at: Utc::now(),
+                last_sign_in_at: None,
+                app_metadata: serde_json::json!({}),
+                user_metadata: serde_json::json!({}),
+                aud: "authenticated".to_string(),
+                role: None,
+            },
+        }
+    }
+
+    /// Answer token refreshes with `fresh-token-<n>` after a short delay; returns
+    /// the server and the number of refresh requests served
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    fn serve_refreshes() -> (MockServer, Arc<std::sync::atomic::AtomicUsize>) {
+        use std::sync::atomic::Ordering;
+
+        let refreshes = Arc::new(std::sync::atomic::AtomicUsize::new(0));
+        let served = Arc::clone(&refreshes);
+        let server = MockServer::start(move |request| {
+            assert_eq!(request.target, "/auth/v1/token?grant_type=refresh_token");
+
+            let n = served.fetch_add(1, Ordering::SeqCst) + 1;
+            let mut session = session_expiring_in(3600);
+            session.access_token = format!("fresh-token-{}", n);
+            MockResponse::json(serde_json::to_vec(&session).unwrap())
+                .delay(std::time::Duration::from_millis(50))
+        });
+        (server, refreshes)
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    fn refreshing_auth() -> (Auth, MockServer, Arc<std::sync::atomic::AtomicUsize>) {
+        let (server, refreshes) = serve_refreshes();
+        let mut config = (*mock_config()).clone();
+        config.url = server.url().to_string();
+        let auth = Auth::new(Arc::new(config), Arc::new(reqwest::Client::new())).unwrap();
+        (auth, server, refreshes)
+    }
+
+    #[tokio::test]
+    async fn test_access_token_mirrors_session() {
+        let auth = Auth::new(mock_config(), Arc::new(reqwest::Client::new())).unwrap();
+        assert!(auth.access_token().is_none());
+        assert!(!auth.needs_refresh_with_buffer(300).unwrap());
+
+        auth.set_session(session_expiring_in(60)).await.unwrap();
+        let token = auth.access_token().unwrap();
+        assert_eq!(token.access_token, "stale-token");
+        assert!(auth.is_authenticated());
+        assert!(auth.needs_refresh_with_buffer(300).unwrap());
+        assert!(!auth.needs_refresh_with_buffer(0).unwrap());
+
+        auth.clear_session().await.unwrap();
+        assert!(auth.access_token().is_none());
+        assert!(!auth.is_authenticated());
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_concurrent_refreshes_share_one_request() {
+        use std::sync::atomic::Ordering;
+
+        let (auth, _server, refreshes) = refreshing_auth();
+        auth.set_session(session_expiring_in(10)).await.unwrap();
+
+        let callers: Vec<_> = (0..8)
+            .map(|_| {
+                let auth = auth.clone();
+                tokio::spawn(async move { auth.ensure_fresh_token(300).await })
+            })
+            .collect();
+        for caller in callers {
+            assert_eq!(caller.await.unwrap().unwrap().access_token, "fresh-token-1");
+        }
+        assert_eq!(refreshes.load(Ordering::SeqCst), 1);
+
+        // Fresh tokens are returned without another request
+        auth.ensure_fresh_token(300).await.unwrap();
+        assert_eq!(refreshes.load(Ordering::SeqCst), 1);
+        assert_eq!(auth.get_session().unwrap().access_token, "fresh-token-1");
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_auto_refresh_runs_ahead_of_expiry() {
+        use std::sync::atomic::Ordering;
+
+        let (auth, _server, refreshes) = refreshing_auth();
+        let events = Arc::new(std::sync::atomic::AtomicUsize::new(0));
+        let seen = Arc::clone(&events);
+        auth.on_auth_state_change(move |event, _| {
+            if event == AuthEvent::TokenRefreshed {
+                seen.fetch_add(1, Ordering::SeqCst);
+            }
+        });
+        auth.set_session(session_expiring_in(10)).await.unwrap();
+
+        let refresher = auth.start_auto_refresh(AutoRefreshConfig::default());
+        for _ in 0..100 {
+            if auth.access_token().unwrap().access_token != "stale-token" {
+                break;
+            }
+            tokio::time::sleep(std::time::Duration::from_millis(20)).await;
+        }
+        assert_eq!(auth.access_token().unwrap().access_token, "fresh-token-1");
+        assert_eq!(events.load(Ordering::SeqCst), 1);
+
+        refresher.stop();
+        assert_eq!(refreshes.load(Ordering::SeqCst), 1);
+    }
 }
@@ -2,7 +2,10 @@
 
 use crate::{
     error::{Error, Result},
-    types::{AuthConfig, DatabaseConfig, HttpConfig, StorageConfig, SupabaseConfig},
+    metrics::SendMetered,
+    types::{
+        AuthConfig, DatabaseConfig, FunctionsConfig, HttpConfig, StorageConfig, SupabaseConfig,
+    },
 };
 
 #[cfg(feature = "auth")]
@@ -77,6 +80,7 @@ impl Client {
             auth_config: AuthConfig::default(),
             database_config: DatabaseConfig::default(),
             storage_config: StorageConfig::default(),
+            functions_config: FunctionsConfig::default(),
         };
 
         Self::new_with_config(config)
@@ -115,6 +119,7 @@ impl Client {
             auth_config: AuthConfig::default(),
             database_config: DatabaseConfig::default(),
             storage_config: StorageConfig::default(),
+            functions_config: FunctionsConfig::default(),
         };
 
         Self::new_with_config(config)
@@ -139,20 +144,51 @@ impl Client {
     ///     auth_config: AuthConfig::default(),
     ///     database_config: DatabaseConfig::default(),
     ///     storage_config: StorageConfig::default(),
+    ///     functions_config: FunctionsConfig::default(),
     /// };
     ///
     /// let client = Client::new_with_config(config)?;
     /// # Ok::<(), Box<dyn std::error::Error>>(())
     /// ```
     pub fn new_with_config(config: SupabaseConfig) -> Result<Self> {
+        let http_client = Arc::new(Self::build_http_client(&config)?);
+        Self::new_with_http_client(config, http_client)
+    }
+
+    /// Create a new Supabase client that reuses an existing HTTP client
+    ///
+    /// Clients created this way share the HTTP client's connection pool, which makes
+    /// creating many short-lived or per-tenant clients cheap. The HTTP client must
+    /// have been built for the same API key and HTTP settings, typically with
+    /// [`Client::build_http_client`].
+    ///
+    /// # Example
+    ///
+    /// ```rust
+    /// use std::sync::Arc;
+    /// use supabase_lib_rs::{Client, types::*};
+    ///
+    /// let config = SupabaseConfig {
+    ///     url: "https://your-project.supabase.co".to_string(),
+    ///     key: "your-anon-key".to_string(),
+    ///     ..Default::default()
+    /// };
+    ///
+    /// let http_client = Arc::new(Client::build_http_client(&config)?);
+    /// let first = Client::new_with_http_client(config.clone(), Arc::clone(&http_client))?;
+    /// let second = Client::new_with_http_client(config, http_client)?;
+    /// # Ok::<(), Box<dyn std::error::Error>>(())
+    /// ```
+    pub fn new_with_http_client(
+        config: SupabaseConfig,
+        http_client: Arc<HttpClient>,
+    ) -> Result<Self> {
         // Validate URL
         let _base_url =
             Url::parse(&config.url).map_err(|e| Error::config(format!("Invalid URL: {}", e)))?;
 
         debug!("Creating Supabase client for URL: {}", config.url);
 
-        // Build HTTP client
-        let http_client = Arc::new(Self::build_http_client(&config)?);
         let config = Arc::new(config);
 
         // Initialize modules conditionally based on features
@@ -263,8 +299,11 @@ impl Client {
         self.auth.current_user().await
     }
 
-    /// Build HTTP client with configuration
-    fn build_http_client(config: &SupabaseConfig) -> Result<HttpClient> {
+    /// Build an HTTP client carrying the default headers and timeouts for `config`
+    ///
+    /// The result can be shared between clients with the same API key and HTTP
+    /// settings via [`Client::new_with_http_client`].
+    pub fn build_http_client(config: &SupabaseConfig) -> Result<HttpClient> {
         let mut headers = HeaderMap::new();
 
         // Add default headers
@@ -294,15 +333,42 @@ impl Client {
         }
 
         #[cfg(not(target_arch = "wasm32"))]
-        let client = HttpClient::builder()
-            .timeout(Duration::from_secs(config.http_config.timeout))
-            .connect_timeout(Duration::from_secs(config.http_config.connect_timeout))
-            .redirect(reqwest::redirect::Policy::limited(
-                config.http_config.max_redirects,
-            ))
-            .default_headers(headers)
-            .build()
-            .map_err(|e| Error::config(format!("Failed to build HTTP client: {}", e)))?;
+        let client = {
+            use crate::types::HttpVersion;
+
+            let http = &config.http_config;
+            let mut builder = HttpClient::builder()
+                .timeout(Duration::from_secs(http.timeout))
+                .connect_timeout(Duration::from_secs(http.connect_timeout))
+                .redirect(reqwest::redirect::Policy::limited(http.max_redirects))
+                .default_headers(headers)
+                .pool_idle_timeout(Duration::from_secs(http.pool_idle_timeout))
+                .http2_adaptive_window(http.http2_adaptive_window);
+
+            builder = match http.http_version {
+                HttpVersion::Negotiate => builder,
+                HttpVersion::Http1Only => builder.http1_only(),
+                HttpVersion::Http2PriorKnowledge => builder.http2_prior_knowledge(),
+            };
+            if let Some(max_idle) = http.pool_max_idle_per_host {
+                builder = builder.pool_max_idle_per_host(max_idle);
+            }
+            if http.tcp_keepalive > 0 {
+                builder = builder.tcp_keepalive(Duration::from_secs(http.tcp_keepalive));
+            }
+            #[cfg(feature = "native")]
+            if http.dns_cache_ttl > 0 {
+                builder = builder.dns_resolver(Arc::new(crate::dns::CachingResolver::new(
+                    Duration::from_secs(http.dns_cache_ttl),
+                )));
+            }
+
+            // TLS sessions are resumed from rustls' in-memory cache, which lives in
+            // this client and so is shared by every client reusing it
+            builder
+                .build()
+                .map_err(|e| Error::config(format!("Failed to build HTTP client: {}", e)))?
+        };
 
         #[cfg(target_arch = "wasm32")]
         let client = HttpClient::builder()
@@ -320,7 +386,7 @@ impl Client {
         let response = self
             .http_client
             .get(format!("{}/health", self.config.url))
-            .send()
+            .send_metered()
             .await?;
 
         let is_healthy = response.status().is_success();
@@ -341,7 +407,7 @@ impl Client {
         let response = self
             .http_client
             .get(format!("{}/rest/v1/", self.config.url))
-            .send()
+            .send_metered()
             .await?;
 
         if !response.status().is_success() {
@@ -354,11 +420,55 @@ impl Client {
         let version_info = response.json().await?;
         Ok(version_info)
     }
+
+    /// Open connections to the project before the first real requests need them
+    ///
+    /// Sends `connections` concurrent `HEAD` requests spread over the REST,
+    /// Storage, Functions and Auth endpoints, so DNS, TCP and TLS setup are paid
+    /// up front and the idle pool holds that many connections (over HTTP/2 they
+    /// share one). Any HTTP response counts, error statuses included. Warm-up
+    /// requests are not recorded in [`crate::metrics`].
+    ///
+    /// Returns how many requests got a response; fails only if none did.
+    #[cfg(all(feature = "native", not(target_arch = "wasm32")))]
+    pub async fn warm_up(&self, connections: usize) -> Result<usize> {
+        const PATHS: [&str; 4] = [
+            "/rest/v1/",
+            "/storage/v1/bucket",
+            "/functions/v1/",
+            "/auth/v1/health",
+        ];
+
+        let mut requests = tokio::task::JoinSet::new();
+        for i in 0..connections {
+            let request =
+                self.http_client
+                    .head(format!("{}{}", self.config.url, PATHS[i % PATHS.len()]));
+            requests.spawn(request.send());
+        }
+
+        let mut answered = 0;
+        let mut last_error = None;
+        while let Some(outcome) = requests.join_next().await {
+            match outcome {
+                Ok(Ok(_)) => answered += 1,
+                Ok(Err(err)) => last_error = Some(Error::from(err)),
+                Err(err) => last_error = Some(Error::platform(err.to_string())),
+            }
+        }
+
+        debug!("Warmed up {}/{} connections", answered, connections);
+        match last_error {
+            Some(err) if answered == 0 => Err(err),
+            _ => Ok(answered),
+        }
+    }
 }
 
 #[cfg(test)]
 mod tests {
     use super::*;
+    use crate::types::HttpVersion;
 
     #[test]
     fn test_client_creation() {
@@ -383,4 +493,79 @@ mod tests {
         let client = Client::new("https://test.supabase.co", "test-key").unwrap();
         assert_eq!(client.key(), "test-key");
     }
+
+    #[test]
+    fn test_clients_share_http_client() {
+        let config = SupabaseConfig {
+            url: "https://test.supabase.co".to_string(),
+            key: "test-key".to_string(),
+            ..Default::default()
+        };
+        let http_client = Arc::new(Client::build_http_client(&config).unwrap());
+
+        let first = Client::new_with_http_client(config.clone(), Arc::clone(&http_client)).unwrap();
+        let second = Client::new_with_http_client(config, Arc::clone(&http_client)).unwrap();
+
+        assert!(Arc::ptr_eq(&first.http_client(), &second.http_client()));
+        assert!(Arc::ptr_eq(&first.http_client(), &http_client));
+    }
+
+    #[test]
+    fn test_build_http_client_with_connection_settings() {
+        for http_version in [
+            HttpVersion::Negotiate,
+            HttpVersion::Http1Only,
+            HttpVersion::Http2PriorKnowledge,
+        ] {
+            let config = SupabaseConfig {
+                url: "https://test.supabase.co".to_string(),
+                key: "test-key".to_string(),
+                http_config: HttpConfig {
+                    http_version,
+                    http2_adaptive_window: true,
+                    pool_max_idle_per_host: Some(8),
+                    tcp_keepalive: 30,
+                    dns_cache_ttl: 60,
+                    ..Default::default()
+                },
+                ..Default::default()
+            };
+            assert!(Client::build_http_client(&config).is_ok());
+        }
+    }
+
+    #[cfg(all(feature = "native", not(target_arch = "wasm32")))]
+    #[tokio::test]
+    async fn test_warm_up_opens_pooled_connections() {
+        use crate::mock_server::{MockResponse, MockServer};
+
+        // Hold each answer so the warm-up requests overlap
+        let server = MockServer::start(|_| MockResponse::new(404).delay(Duration::from_millis(50)));
+
+        let config = SupabaseConfig {
+            url: server.url().to_string(),
+            key: "test-key".to_string(),
+            http_config: HttpConfig {
+                dns_cache_ttl: 60,
+                ..Default::default()
+            },
+            ..Default::default()
+        };
+        let client = Client::new_with_config(config).unwrap();
+        assert_eq!(client.warm_up(4).await.unwrap(), 4);
+        assert_eq!(server.connections(), 4);
+
+        // Later requests reuse the warmed connections
+        client.health_check().await.unwrap();
+        assert_eq!(server.connections(), 4);
+    }
+
+    #[cfg(all(feature = "native", not(target_arch = "wasm32")))]
+    #[tokio::test]
+    async fn test_warm_up_fails_when_nothing_answers() {
+        // Nothing listens on port 1, so connections are refused without network access
+        let client = Client::new("http://127.0.0.1:1", "test-key").unwrap();
+        assert!(client.warm_up(2).await.is_err());
+        assert_eq!(client.warm_up(0).await.unwrap(), 0);
+    }
 }
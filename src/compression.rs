@@ -0,0 +1,579 @@
+//! Content-encoding negotiation for requests and responses
+//!
+//! Modules send through [`SendCompressed::send_compressed`] with their
+//! [`CompressionConfig`]. With the `compression` feature that offers the
+//! configured encodings in `Accept-Encoding`, compresses large JSON request
+//! bodies, and swaps an encoded response's body for one that decodes chunk by
+//! chunk as it is read. Callers keep using `Response::json`, `text`, `bytes` or
+//! `chunk` unchanged, and streaming readers never hold more than one decoded
+//! chunk. Without the feature (or on WASM, where the browser negotiates
+//! encodings itself) requests are sent as configured by the caller.
+//!
+//! Bytes saved in each direction are counted per module in [`crate::metrics`].
+
+use crate::{metrics::SendMetered, types::CompressionConfig};
+
+/// `RequestBuilder::send_metered` with content-encoding negotiation
+pub(crate) trait SendCompressed {
+    /// Send the request with `config`'s encodings, decoding the response body
+    async fn send_compressed(
+        self,
+        config: &CompressionConfig,
+    ) -> reqwest::Result<reqwest::Response>;
+}
+
+impl SendCompressed for reqwest::RequestBuilder {
+    #[cfg(all(feature = "compression", not(target_arch = "wasm32")))]
+    async fn send_compressed(
+        self,
+        config: &CompressionConfig,
+    ) -> reqwest::Result<reqwest::Response> {
+        if config.is_disabled() {
+            return self.send_metered().await;
+        }
+
+        let (client, request) = self.build_split();
+        let mut request = request?;
+        let module = crate::metrics::module_of(request.url());
+        native::prepare_request(&mut request, config, module);
+
+        let response = crate::metrics::execute_metered(client, request).await?;
+        Ok(native::decode_response(response, module))
+    }
+
+    #[cfg(not(all(feature = "compression", not(target_arch = "wasm32"))))]
+    async fn send_compressed(
+        self,
+        _config: &CompressionConfig,
+    ) -> reqwest::Result<reqwest::Response> {
+        self.send_metered().await
+    }
+}
+
+#[cfg(all(feature = "compression", not(target_arch = "wasm32")))]
+mod native {
+    use std::io::{self, Write};
+    use std::pin::Pin;
+    use std::task::{Context, Poll};
+
+    use bytes::Bytes;
+    use http_body::{Body as HttpBody, Frame, SizeHint};
+    use reqwest::header::{
+        HeaderValue, ACCEPT_ENCODING, CONTENT_ENCODING, CONTENT_LENGTH, CONTENT_TYPE, RANGE,
+    };
+    use reqwest::ResponseBuilderExt;
+    use tracing::debug;
+
+    use crate::metrics::{record_request_compression, record_response_decoding, Module};
+    use crate::types::{CompressionConfig, ContentEncoding};
+
+    /// Offer response encodings and compress the body, as configured
+    pub(super) fn prepare_request(
+        request: &mut reqwest::Request,
+        config: &CompressionConfig,
+        module: Module,
+    ) {
+        let headers = request.headers();
+        // A range of an encoded representation can't be resumed or stitched together
+        if !config.accept.is_empty()
+            && !headers.contains_key(RANGE)
+            && !headers.contains_key(ACCEPT_ENCODING)
+        {
+            let offer = config
+                .accept
+                .iter()
+                .map(|encoding| encoding.as_str())
+                .collect::<Vec<_>>()
+                .join(", ");
+            if let Ok(value) = HeaderValue::from_str(&offer) {
+                request.headers_mut().insert(ACCEPT_ENCODING, value);
+            }
+        }
+
+        let Some(encoding) = config.request else {
+            return;
+        };
+        let headers = request.headers();
+        let is_json = headers
+            .get(CONTENT_TYPE)
+            .and_then(|value| value.to_str().ok())
+            .is_some_and(|value| value.contains("json"));
+        if !is_json || headers.contains_key(CONTENT_ENCODING) {
+            return;
+        }
+        let Some(body) = request.body().and_then(reqwest::Body::as_bytes) else {
+            return;
+        };
+        if body.len() < config.min_request_size {
+            return;
+        }
+
+        match encode(encoding, body) {
+            // Incompressible bodies go out as they are
+            Ok(compressed) if compressed.len() < body.len() => {
+                record_request_compression(module, body.len() as u64, compressed.len() as u64);
+                request.headers_mut().insert(
+                    CONTENT_ENCODING,
+                    HeaderValue::from_static(encoding.as_str()),
+                );
+                *request.body_mut() = Some(compressed.into());
+            }
+            Ok(_) => {}
+            Err(err) => debug!("Sending request body uncompressed: {}", err),
+        }
+    }
+
+    pub(super) fn encode(encoding: ContentEncoding, data: &[u8]) -> io::Result<Vec<u8>> {
+        let output = Vec::with_capacity(data.len() / 4);
+        match encoding {
+            ContentEncoding::Gzip => {
+                let mut encoder =
+                    flate2::write::GzEncoder::new(output, flate2::Compression::fast());
+                encoder.write_all(data)?;
+                encoder.finish()
+            }
+            ContentEncoding::Deflate => {
+                let mut encoder =
+                    flate2::write::ZlibEncoder::new(output, flate2::Compression::fast());
+                encoder.write_all(data)?;
+                encoder.finish()
+            }
+            ContentEncoding::Zstd => zstd::stream::encode_all(data, 3),
+        }
+    }
+
+    /// Replace an encoded response body with one that decodes as it is read
+    pub(super) fn decode_response(
+        response: reqwest::Response,
+        module: Module,
+    ) -> reqwest::Response {
+        let Some(encoding) = response
+            .headers()
+            .get(CONTENT_ENCODING)
+            .and_then(|value| value.to_str().ok())
+            .and_then(ContentEncoding::from_header)
+        else {
+            return response;
+        };
+        let decoder = match Decoder::new(encoding) {
+            Ok(decoder) => decoder,
+            Err(err) => {
+                debug!("Leaving {} response encoded: {}", encoding.as_str(), err);
+                return response;
+            }
+        };
+
+        let url = response.url().clone();
+        let response: http::Response<reqwest::Body> = response.into();
+        let (mut parts, body) = response.into_parts();
+        // The decoded length is unknown until the body has been read
+        parts.headers.remove(CONTENT_ENCODING);
+        parts.headers.remove(CONTENT_LENGTH);
+        // The URL travels in an extension that only `ResponseBuilderExt::url` can
+        // create; every other extension is kept as reqwest attached it
+        if let Ok(with_url) = http::Response::builder().url(url).body(()) {
+            parts.extensions.extend(with_url.into_parts().0.extensions);
+        }
+
+        let body = DecodingBody {
+            inner: body,
+            decoder: Some(decoder),
+            module,
+            received: 0,
+            decoded: 0,
+        };
+        http::Response::from_parts(parts, reqwest::Body::wrap(body)).into()
+    }
+
+    /// Push-style decoder writing decoded bytes into a buffer drained per chunk
+    pub(super) enum Decoder {
+        Gzip(flate2::write::GzDecoder<Vec<u8>>),
+        Deflate(flate2::write::ZlibDecoder<Vec<u8>>),
+        Zstd {
+            decoder: Box<zstd::stream::raw::Decoder<'static>>,
+            /// Whether the input so far ends exactly at the end of a frame
+            frame_complete: bool,
+        },
+    }
+
+    impl Decoder {
+        pub(super) fn new(encoding: ContentEncoding) -> io::Result<Self> {
+            Ok(match encoding {
+                ContentEncoding::Gzip => Decoder::Gzip(flate2::write::GzDecoder::new(Vec::new())),
+                ContentEncoding::Deflate => {
+                    Decoder::Deflate(flate2::write::ZlibDecoder::new(Vec::new()))
+                }
+                ContentEncoding::Zstd => Decoder::Zstd {
+                    decoder: Box::new(zstd::stream::raw::Decoder::new()?),
+                    frame_complete: false,
+                },
+            })
+        }
+
+        /// Decode `input` and take whatever output it produced
+        pub(super) fn push(&mut self, input: &[u8]) -> io::Result<Vec<u8>> {
+            match self {
+                Decoder::Gzip(decoder) => {
+                    decoder.write_all(input)?;
+                    Ok(std::mem::take(decoder.get_mut()))
+                }
+                Decoder::Deflate(decoder) => {
+                    decoder.write_all(input)?;
+                    Ok(std::mem::take(decoder.get_mut()))
+                }
+                Decoder::Zstd {
+                    decoder,
+                    frame_complete,
+                } => decode_zstd(decoder, input, frame_complete),
+            }
+        }
+
+        /// Check the stream ended cleanly and take the remaining output
+        pub(super) fn finish(&mut self) -> io::Result<Vec<u8>> {
+            match self {
+                Decoder::Gzip(decoder) => {
+                    decoder.try_finish()?;
+                    Ok(std::mem::take(decoder.get_mut()))
+                }
+                Decoder::Deflate(decoder) => {
+                    decoder.try_finish()?;
+                    Ok(std::mem::take(decoder.get_mut()))
+                }
+                Decoder::Zstd { frame_complete, .. } => {
+                    if !*frame_complete {
+                        return Err(io::Error::new(
+                            io::ErrorKind::UnexpectedEof,
+                            "zstd stream ended in the middle of a frame",
+                        ));
+                    }
+                    // `push` already drained every decoded byte
+                    Ok(Vec::new())
+                }
+            }
+        }
+    }
+
+    /// Decode all of `input`, noting whether it ended on a frame boundary
+    fn decode_zstd(
+        decoder: &mut zstd::stream::raw::Decoder<'static>,
+        input: &[u8],
+        frame_complete: &mut bool,
+    ) -> io::Result<Vec<u8>> {
+        use zstd::stream::raw::{InBuffer, Operation, OutBuffer};
+
+        let mut input = InBuffer::around(input);
+        let mut output = Vec::new();
+        let mut chunk = vec![0u8; zstd::zstd_safe::DCtx::out_size()];
+        loop {
+            let mut out = OutBuffer::around(chunk.as_mut_slice());
+            let hint = decoder.run(&mut input, &mut out)?;
+            let written = out.pos();
+            output.extend_from_slice(&chunk[..written]);
+            if written > 0 || input.pos() > 0 {
+                // 0 means a frame was just completed and fully flushed
+                *frame_complete = hint == 0;
+            }
+            // A full output buffer may still hold back decoded bytes
+            if input.pos() == input.src.len() && written < chunk.len() {
+                return Ok(output);
+            }
+        }
+    }
+
+    /// Response body decoding its inner body's frames as they arrive
+    struct DecodingBody {
+        inner: reqwest::Body,
+        /// `None` once the stream has ended
+        decoder: Option<Decoder>,
+        module: Module,
+        received: u64,
+        decoded: u64,
+    }
+
+    impl DecodingBody {
+        fn record(&mut self) {
+            if self.received > 0 {
+                record_response_decoding(self.module, self.received, self.decoded);
+                self.received = 0;
+            }
+        }
+    }
+
+    impl HttpBody for DecodingBody {
+        type Data = Bytes;
+        type Error = io::Error;
+
+        fn poll_frame(
+            self: Pin<&mut Self>,
+            cx: &mut Context<'_>,
+        ) -> Poll<Option<Result<Frame<Bytes>, io::Error>>> {
+            let this = self.get_mut();
+            loop {
+                let Some(decoder) = this.decoder.as_mut() else {
+                    return Poll::Ready(None);
+                };
+                match Pin::new(&mut this.inner).poll_frame(cx) {
+                    Poll::Pending => return Poll::Pending,
+                    Poll::Ready(Some(Ok(frame))) => {
+                        let frame = match frame.into_data() {
+                            Ok(data) => data,
+                            Err(frame) => {
+                                return Poll::Ready(Some(Ok(frame.map_data(Bytes::from))))
+                            }
+                        };
+                        this.received += frame.len() as u64;
+                        let output = decoder.push(&frame)?;
+                        if !output.is_empty() {
+                            this.decoded += output.len() as u64;
+                            return Poll::Ready(Some(Ok(Frame::data(output.into()))));
+                        }
+                    }
+                    Poll::Ready(Some(Err(err))) => {
+                        this.decoder = None;
+                        return Poll::Ready(Some(Err(io::Error::other(err))));
+                    }
+                    Poll::Ready(None) => {
+                        // Empty bodies (HEAD, 204) carry no encoded stream to finish
+                        let output = match this.received {
+                            0 => Ok(Vec::new()),
+                            _ => decoder.finish(),
+                        };
+                        this.decoder = None;
+                        let output = output?;
+                        this.decoded += output.len() as u64;
+                        this.record();
+                        if output.is_empty() {
+                            return Poll::Ready(None);
+                        }
+                        return Poll::Ready(Some(Ok(Frame::data(output.into()))));
+                    }
+                }
+            }
+        }
+
+        fn is_end_stream(&self) -> bool {
+            self.decoder.is_none()
+        }
+
+        fn size_hint(&self) -> SizeHint {
+            SizeHint::default()
+        }
+    }
+
+    impl Drop for DecodingBody {
+        /// Bodies dropped part-way still count what they transferred
+        fn drop(&mut self) {
+            self.record();
+        }
+    }
+}
+
+#[cfg(all(test, feature = "compression", not(target_arch = "wasm32")))]
+mod tests {
+    use super::*;
+    use crate::mock_server::{MockRequest, MockResponse, MockServer};
+    use crate::types::ContentEncoding;
+    use std::io::Read;
+    use std::sync::{Arc, Mutex};
+
+    fn decode_all(encoding: ContentEncoding, data: &[u8]) -> Vec<u8> {
+        let mut output = Vec::new();
+        match encoding {
+            ContentEncoding::Gzip => flate2::read::GzDecoder::new(data)
+                .read_to_end(&mut output)
+                .unwrap(),
+            ContentEncoding::Deflate => flate2::read::ZlibDecoder::new(data)
+                .read_to_end(&mut output)
+                .unwrap(),
+            ContentEncoding::Zstd => zstd::stream::read::Decoder::new(data)
+                .unwrap()
+                .read_to_end(&mut output)
+                .unwrap(),
+        };
+        output
+    }
+
+    fn rows_json(rows: usize) -> String {
+        let rows: Vec<_> = (0..rows)
+            .map(|i| format!("{{\"id\":{},\"name\":\"row-{}\",\"active\":true}}", i, i))
+            .collect();
+        format!("[{}]", rows.join(","))
+    }
+
+    /// Record every request and answer with `body`, encoded per the request's
+    /// `Accept-Encoding` and split into small writes
+    fn serve_encoded(body: Vec<u8>) -> (MockServer, Arc<Mutex<Vec<MockRequest>>>) {
+        let requests = Arc::new(Mutex::new(Vec::new()));
+        let recorded = Arc::clone(&requests);
+        let server = MockServer::start(move |request| {
+            recorded.lock().unwrap().push(request.clone());
+
+            let encoding = request
+                .header("accept-encoding")
+                .and_then(|offer| offer.split(',').next())
+                .and_then(ContentEncoding::from_header);
+            let response = match encoding {
+                Some(encoding) => MockResponse::json(native::encode(encoding, &body).unwrap())
+                    .header("content-encoding", encoding.as_str()),
+                None => MockResponse::json(body.clone()),
+            };
+            response.in_writes_of(64)
+        });
+        (server, requests)
+    }
+
+    #[test]
+    fn test_encode_round_trips() {
+        let data = rows_json(200);
+        for encoding in [
+            ContentEncoding::Gzip,
+            ContentEncoding::Deflate,
+            ContentEncoding::Zstd,
+        ] {
+            let encoded = native::encode(encoding, data.as_bytes()).unwrap();
+            assert!(encoded.len() < data.len() / 4);
+            assert_eq!(decode_all(encoding, &encoded), data.as_bytes());
+        }
+    }
+
+    #[test]
+    fn test_decoder_yields_output_before_the_end() {
+        // Larger than one 128 KiB zstd block, which decodes only once complete
+        let data = rows_json(8000);
+        for encoding in [
+            ContentEncoding::Gzip,
+            ContentEncoding::Deflate,
+            ContentEncoding::Zstd,
+        ] {
+            let encoded = native::encode(encoding, data.as_bytes()).unwrap();
+            let mut decoder = native::Decoder::new(encoding).unwrap();
+            let mut decoded = Vec::new();
+            let mut outputs = 0;
+            for piece in encoded.chunks(encoded.len() / 8 + 1) {
+                let output = decoder.push(piece).unwrap();
+                outputs += usize::from(!output.is_empty());
+                decoded.extend_from_slice(&output);
+            }
+            decoded.extend_from_slice(&decoder.finish().unwrap());
+            assert!(outputs > 1, "{} decoded incrementally", encoding.as_str());
+            assert_eq!(decoded, data.as_bytes());
+        }
+
+        // A truncated stream is an error rather than a short body
+        let encoded = native::encode(ContentEncoding::Gzip, data.as_bytes()).unwrap();
+        let mut decoder = native::Decoder::new(ContentEncoding::Gzip).unwrap();
+        decoder.push(&encoded[..encoded.len() / 2]).unwrap();
+        assert!(decoder.finish().is_err());
+
+        let encoded = native::encode(ContentEncoding::Zstd, data.as_bytes()).unwrap();
+        let mut decoder = native::Decoder::new(ContentEncoding::Zstd).unwrap();
+        decoder.push(&encoded[..encoded.len() / 2]).unwrap();
+        assert_eq!(
+            decoder.finish().unwrap_err().kind(),
+            std::io::ErrorKind::UnexpectedEof
+        );
+    }
+
+    #[test]
+    fn test_parse_content_encoding() {
+        assert_eq!(
+            ContentEncoding::from_header(" GZIP "),
+            Some(ContentEncoding::Gzip)
+        );
+        assert_eq!(
+            ContentEncoding::from_header("x-gzip"),
+            Some(ContentEncoding::Gzip)
+        );
+        assert_eq!(
+            ContentEncoding::from_header("zstd"),
+            Some(ContentEncoding::Zstd)
+        );
+        assert_eq!(ContentEncoding::from_header("br"), None);
+        assert_eq!(ContentEncoding::from_header("gzip, br"), None);
+    }
+
+    #[tokio::test]
+    async fn test_responses_are_decoded_while_streaming() {
+        let data = rows_json(500);
+        for encoding in [
+            ContentEncoding::Zstd,
+            ContentEncoding::Gzip,
+            ContentEncoding::Deflate,
+        ] {
+            let (server, requests) = serve_encoded(data.clone().into_bytes());
+            let config = CompressionConfig {
+                accept: vec![encoding],
+                ..Default::default()
+            };
+            let mut response = reqwest::Client::new()
+                .get(format!("{}/rest/v1/compressed_rows", server.url()))
+                .send_compressed(&config)
+                .await
+                .unwrap();
+            assert!(response.headers().get("content-encoding").is_none());
+            assert_eq!(response.content_length(), None);
+
+            let mut decoded = Vec::new();
+            while let Some(chunk) = response.chunk().await.unwrap() {
+                decoded.extend_from_slice(&chunk);
+            }
+            assert_eq!(decoded, data.as_bytes());
+
+            let request = requests.lock().unwrap().pop().unwrap();
+            assert_eq!(request.header("accept-encoding"), Some(encoding.as_str()));
+        }
+
+        let database = crate::metrics::snapshot()
+            .modules
+            .into_iter()
+            .find(|module| module.module == "database")
+            .unwrap();
+        assert!(database.compression.responses_decoded >= 3);
+        assert!(
+            database.compression.response_bytes_decoded
+                > database.compression.response_bytes_received
+        );
+        assert!(database.compression.bytes_saved() > 0);
+    }
+
+    #[tokio::test]
+    async fn test_json_request_bodies_are_compressed() {
+        let data = rows_json(100);
+        let config = CompressionConfig {
+            request: Some(ContentEncoding::Gzip),
+            ..Default::default()
+        };
+
+        let (server, requests) = serve_encoded(b"[]".to_vec());
+        let response = reqwest::Client::new()
+            .post(format!("{}/functions/v1/compressed", server.url()))
+            .header("Content-Type", "application/json")
+            .body(data.clone())
+            .send_compressed(&config)
+            .await
+            .unwrap();
+        assert_eq!(response.text().await.unwrap(), "[]");
+        let request = requests.lock().unwrap().pop().unwrap();
+        assert_eq!(request.header("content-encoding"), Some("gzip"));
+        assert!(request.header("accept-encoding").is_none());
+        assert_eq!(
+            decode_all(ContentEncoding::Gzip, &request.body),
+            data.as_bytes()
+        );
+
+        // Small and non-JSON bodies are left alone, and ranges are never encoded
+        let (server, requests) = serve_encoded(b"ok".to_vec());
+        reqwest::Client::new()
+            .post(format!("{}/storage/v1/object/bucket/file", server.url()))
+            .header("Content-Type", "application/octet-stream")
+            .header("Range", "bytes=0-1")
+            .body(data.clone())
+            .send_compressed(&CompressionConfig::enabled())
+            .await
+            .unwrap();
+        let request = requests.lock().unwrap().pop().unwrap();
+        assert!(request.header("content-encoding").is_none());
+        assert!(request.header("accept-encoding").is_none());
+        assert_eq!(request.body, data.as_bytes());
+    }
+}
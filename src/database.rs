@@ -1,13 +1,22 @@
 //! Database module for Supabase REST API
 
 use crate::{
+    compression::SendCompressed,
     error::{Error, Result},
-    types::{FilterOperator, JsonValue, OrderDirection, SupabaseConfig},
+    sharded_cache::ShardedCache,
+    single_flight::SingleFlight,
+    types::{CompressionConfig, FilterOperator, JsonValue, OrderDirection, SupabaseConfig},
 };
+use bytes::Bytes;
 use reqwest::Client as HttpClient;
 use serde::{Deserialize, Serialize};
 use serde_json::json;
-use std::{collections::HashMap, sync::Arc};
+use std::{
+    collections::{hash_map::DefaultHasher, HashMap},
+    hash::{Hash, Hasher},
+    sync::Arc,
+    time::Duration,
+};
 use tracing::{debug, info};
 use url::Url;
 
@@ -16,6 +25,8 @@ use url::Url;
 pub struct Database {
     http_client: Arc<HttpClient>,
     config: Arc<SupabaseConfig>,
+    query_cache: Arc<QueryCache>,
+    in_flight: Arc<SingleFlight<Bytes>>,
 }
 
 /// Query builder for SELECT operations
@@ -30,6 +41,48 @@ pub struct QueryBuilder {
     offset: Option<u32>,
     single: bool,
     joins: Vec<Join>,
+    cache_ttl: Option<Duration>,
+    coalesce: bool,
+}
+
+/// A SELECT query with a precomputed URL that can be re-executed with new filter values
+///
+/// Created with [`QueryBuilder::prepare`]. Each top-level simple filter (`eq`,
+/// `gt`, `in`, ...) becomes a binding slot, numbered in the order the filters were
+/// added.
+#[derive(Debug, Clone)]
+pub struct PreparedQuery {
+    query: QueryBuilder,
+    base_url: Url,
+    params: Vec<(String, String)>,
+    bindings: Vec<FilterBinding>,
+    url: String,
+}
+
+/// Keyset-paginated cursor over a query, created by [`QueryBuilder::paginate`]
+///
+/// Each page is requested with `key_column=gt.<last key of the previous page>`
+/// instead of an offset, so every page costs the server the same regardless of
+/// how far into the table it is. While the caller works on a page, the next one
+/// is already being fetched.
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+#[derive(Debug)]
+pub struct Paginator {
+    query: QueryBuilder,
+    key_column: String,
+    page_size: u32,
+    /// Request for the page after the last one returned
+    next: Option<tokio::task::JoinHandle<Result<Bytes>>>,
+    done: bool,
+}
+
+/// Location of a rebindable filter value inside a prepared query's parameters
+#[derive(Debug, Clone, Copy)]
+struct FilterBinding {
+    /// Index into the parameter list
+    param: usize,
+    /// PostgREST operator code preceding the value
+    operator: &'static str,
 }
 
 /// Represents a table join operation
@@ -78,6 +131,8 @@ pub struct InsertBuilder {
     database: Database,
     table: String,
     data: JsonValue,
+    /// Pre-serialized request body that replaces `data` when set
+    raw_body: Option<Bytes>,
     upsert: bool,
     on_conflict: Option<String>,
     returning: Option<String>,
@@ -135,17 +190,106 @@ pub struct DatabaseResponse<T> {
     pub count: Option<u64>,
 }
 
+/// Options for [`Database::bulk_load`] and [`Database::bulk_load_ndjson`]
+#[derive(Debug, Clone)]
+pub struct BulkLoadConfig {
+    /// Rows sent per request (default: 1000)
+    pub chunk_size: usize,
+    /// Maximum number of chunk requests in flight (default: 4)
+    pub max_concurrent_chunks: usize,
+    /// Merge rows that conflict with existing ones instead of failing (default: false)
+    pub upsert: bool,
+    /// Columns identifying conflicting rows for upserts; the primary key when `None`
+    pub on_conflict: Option<String>,
+}
+
+impl Default for BulkLoadConfig {
+    fn default() -> Self {
+        Self {
+            chunk_size: 1000,
+            max_concurrent_chunks: 4,
+            upsert: false,
+            on_conflict: None,
+        }
+    }
+}
+
+/// Outcome of a bulk load
+///
+/// Chunks fail independently: rows of failed chunks are listed in `failures`
+/// and every other chunk was written.
+#[derive(Debug, Default)]
+pub struct BulkLoadReport {
+    /// Rows accepted by the server
+    pub rows_loaded: u64,
+    /// Number of chunk requests sent
+    pub chunks: usize,
+    /// Chunks the server rejected, in chunk order
+    pub failures: Vec<BulkChunkFailure>,
+}
+
+/// A chunk of a bulk load that was not written
+#[derive(Debug)]
+pub struct BulkChunkFailure {
+    /// Index of the chunk, from 0
+    pub chunk: usize,
+    /// Position of the chunk's first row in the input, from 0
+    pub first_row: u64,
+    /// Number of rows in the chunk
+    pub rows: usize,
+    /// Why the chunk's request failed
+    pub error: Error,
+}
+
+/// JSON array body of one bulk load chunk, built row by row
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+#[derive(Debug, Default)]
+struct ChunkBody {
+    json: Vec<u8>,
+    rows: usize,
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl ChunkBody {
+    /// Start the next array element and return the buffer to write it into
+    fn next_row(&mut self) -> &mut Vec<u8> {
+        self.json.push(if self.rows == 0 { b'[' } else { b',' });
+        self.rows += 1;
+        &mut self.json
+    }
+
+    fn finish(mut self) -> (Bytes, usize) {
+        self.json.push(b']');
+        (Bytes::from(self.json), self.rows)
+    }
+}
+
 impl Database {
     /// Create a new Database instance
     pub fn new(config: Arc<SupabaseConfig>, http_client: Arc<HttpClient>) -> Result<Self> {
         debug!("Initializing Database module");
 
+        let query_cache = Arc::new(QueryCache::new(
+            &config.key,
+            config.database_config.query_cache_max_entries,
+            config.database_config.query_cache_max_bytes,
+        ));
+
         Ok(Self {
             http_client,
             config,
+            query_cache,
+            in_flight: Arc::new(SingleFlight::default()),
         })
     }
 
+    /// Drop every response stored by `.cached()` queries
+    ///
+    /// Call this after writes that must be visible to cached reads immediately.
+    pub fn clear_query_cache(&self) {
+        self.query_cache.clear();
+    }
+
     /// Start a query from a table
     pub fn from(&self, table: &str) -> QueryBuilder {
         QueryBuilder::new(self.clone(), table.to_string())
@@ -187,6 +331,9 @@ impl Database {
 
     /// Bulk insert multiple records at once
     ///
+    /// The inserted rows are returned. For large inputs use
+    /// [`Database::bulk_load`], which sends chunks concurrently without echoing rows.
+    ///
     /// # Examples
     ///
     /// ```rust,no_run
@@ -223,7 +370,7 @@ impl Database {
             .post(&url)
             .json(&data)
             .header("Prefer", "return=representation")
-            .send()
+            .send_compressed(self.compression())
             .await?;
 
         if !response.status().is_success() {
@@ -242,6 +389,8 @@ impl Database {
 
     /// Bulk upsert multiple records at once
     ///
+    /// For large inputs use [`Database::bulk_load`] with [`BulkLoadConfig::upsert`].
+    ///
     /// # Examples
     ///
     /// ```rust,no_run
@@ -280,7 +429,7 @@ impl Database {
                 "Prefer",
                 "return=representation,resolution=merge-duplicates",
             )
-            .send()
+            .send_compressed(self.compression())
             .await?;
 
         if !response.status().is_success() {
@@ -297,6 +446,211 @@ impl Database {
         Ok(result)
     }
 
+    /// Load rows in chunks of `config.chunk_size`, sending several chunks at once
+    ///
+    /// Unlike [`Database::bulk_insert`], rows are serialized one chunk at a time
+    /// and sent with `Prefer: return=minimal`, so neither the whole input nor
+    /// the inserted rows are ever held in memory at once: at most
+    /// `max_concurrent_chunks` chunk bodies exist at any time. A rejected chunk
+    /// doesn't stop the load; it is reported in [`BulkLoadReport::failures`].
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::Client;
+    /// # use supabase_lib_rs::database::BulkLoadConfig;
+    /// # use serde_json::json;
+    /// # async fn example() -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("http://localhost:54321", "test-key")?;
+    ///
+    /// let rows = (0..100_000).map(|i| json!({"id": i, "name": format!("user {}", i)}));
+    /// let report = client
+    ///     .database()
+    ///     .bulk_load("users", rows, &BulkLoadConfig::default())
+    ///     .await?;
+    /// println!("{} rows loaded, {} chunks failed", report.rows_loaded, report.failures.len());
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub async fn bulk_load<I, T>(
+        &self,
+        table: &str,
+        rows: I,
+        config: &BulkLoadConfig,
+    ) -> Result<BulkLoadReport>
+    where
+        I: IntoIterator<Item = T>,
+        T: Serialize,
+    {
+        let mut rows = rows.into_iter();
+        self.bulk_load_chunks(table, config, |chunk, chunk_size| {
+            for row in rows.by_ref().take(chunk_size) {
+                serde_json::to_writer(chunk.next_row(), &row)?;
+            }
+            Ok(())
+        })
+        .await
+    }
+
+    /// Load newline-delimited JSON rows from `reader`, see [`Database::bulk_load`]
+    ///
+    /// Each non-empty line must hold one JSON object; lines are forwarded
+    /// without being parsed, and PostgREST validates them. Reading stops at the
+    /// first I/O error, which fails the load. `reader` is read on the calling
+    /// task, so pass an in-memory or file reader rather than a slow stream.
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub async fn bulk_load_ndjson<R>(
+        &self,
+        table: &str,
+        mut reader: R,
+        config: &BulkLoadConfig,
+    ) -> Result<BulkLoadReport>
+    where
+        R: std::io::BufRead,
+    {
+        let mut line = Vec::new();
+        self.bulk_load_chunks(table, config, |chunk, chunk_size| {
+            while chunk.rows < chunk_size {
+                line.clear();
+                let read = reader
+                    .read_until(b'\n', &mut line)
+                    .map_err(|e| Error::database(format!("Failed to read NDJSON rows: {}", e)))?;
+                if read == 0 {
+                    break;
+                }
+                let row = line.trim_ascii();
+                if !row.is_empty() {
+                    chunk.next_row().extend_from_slice(row);
+                }
+            }
+            Ok(())
+        })
+        .await
+    }
+
+    /// Drive a bulk load: `fill` appends up to `chunk_size` rows to each chunk
+    /// and leaves it empty once the input is exhausted
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    async fn bulk_load_chunks<F>(
+        &self,
+        table: &str,
+        config: &BulkLoadConfig,
+        mut fill: F,
+    ) -> Result<BulkLoadReport>
+    where
+        F: FnMut(&mut ChunkBody, usize) -> Result<()>,
+    {
+        let chunk_size = config.chunk_size.max(1);
+        let max_in_flight = config.max_concurrent_chunks.max(1);
+
+        let mut url = Url::parse(&format!("{}/{}", self.rest_url(), table))?;
+        if let Some(ref columns) = config.on_conflict {
+            url.query_pairs_mut().append_pair("on_conflict", columns);
+        }
+        let url: Arc<str> = Arc::from(String::from(url));
+        let prefer = if config.upsert {
+            "return=minimal,resolution=merge-duplicates"
+        } else {
+            "return=minimal"
+        };
+
+        debug!(
+            "Executing BULK LOAD on table: {} in chunks of {} rows, {} at a time",
+            table, chunk_size, max_in_flight
+        );
+
+        let mut report = BulkLoadReport::default();
+        let mut chunks = tokio::task::JoinSet::new();
+        let mut next_row = 0u64;
+        let mut exhausted = false;
+
+        loop {
+            while !exhausted && chunks.len() < max_in_flight {
+                let mut chunk = ChunkBody::default();
+                fill(&mut chunk, chunk_size)?;
+                if chunk.rows == 0 {
+                    exhausted = true;
+                    break;
+                }
+
+                let (body, rows) = chunk.finish();
+                let index = report.chunks;
+                let first_row = next_row;
+                report.chunks += 1;
+                next_row += rows as u64;
+
+                let http_client = Arc::clone(&self.http_client);
+                let config = Arc::clone(&self.config);
+                let url = Arc::clone(&url);
+                chunks.spawn(async move {
+                    let result = Self::send_bulk_chunk(
+                        &http_client,
+                        &config.database_config.compression,
+                        &url,
+                        prefer,
+                        body,
+                    )
+                    .await;
+                    (index, first_row, rows, result)
+                });
+            }
+
+            let Some(joined) = chunks.join_next().await else {
+                break;
+            };
+            let (chunk, first_row, rows, result) =
+                joined.map_err(|e| Error::database(format!("Bulk load task failed: {}", e)))?;
+            match result {
+                Ok(()) => report.rows_loaded += rows as u64,
+                Err(error) => report.failures.push(BulkChunkFailure {
+                    chunk,
+                    first_row,
+                    rows,
+                    error,
+                }),
+            }
+        }
+
+        report.failures.sort_by_key(|failure| failure.chunk);
+        info!(
+            "Bulk load on table {} finished: {} rows in {} chunks, {} failed",
+            table,
+            report.rows_loaded,
+            report.chunks,
+            report.failures.len()
+        );
+        Ok(report)
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    async fn send_bulk_chunk(
+        http_client: &HttpClient,
+        compression: &CompressionConfig,
+        url: &str,
+        prefer: &'static str,
+        body: Bytes,
+    ) -> Result<()> {
+        let response = http_client
+            .post(url)
+            .header("Content-Type", "application/json")
+            .header("Prefer", prefer)
+            .body(body)
+            .send_compressed(compression)
+            .await?;
+
+        if !response.status().is_success() {
+            let status = response.status();
+            let error_msg = match response.text().await {
+                Ok(text) => text,
+                Err(_) => format!("Bulk load chunk failed with status: {}", status),
+            };
+            return Err(Error::database(error_msg));
+        }
+
+        Ok(())
+    }
+
     /// Execute raw SQL via stored procedure/function
     ///
     /// # Examples
@@ -542,7 +896,7 @@ impl Database {
             request = request.json(&params);
         }
 
-        let response = request.send().await?;
+        let response = request.send_compressed(self.compression()).await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -564,6 +918,11 @@ impl Database {
         format!("{}/rest/v1", self.config.url)
     }
 
+    /// Content encodings used for REST requests
+    fn compression(&self) -> &CompressionConfig {
+        &self.config.database_config.compression
+    }
+
     /// Build query parameters from filters
     fn build_query_params(&self, filters: &[Filter]) -> HashMap<String, String> {
         let mut params = HashMap::new();
@@ -698,25 +1057,7 @@ impl Database {
                 operator,
                 value,
             } => {
-                let op_str = match operator {
-                    FilterOperator::Equal => "eq",
-                    FilterOperator::NotEqual => "neq",
-                    FilterOperator::GreaterThan => "gt",
-                    FilterOperator::GreaterThanOrEqual => "gte",
-                    FilterOperator::LessThan => "lt",
-                    FilterOperator::LessThanOrEqual => "lte",
-                    FilterOperator::Like => "like",
-                    FilterOperator::ILike => "ilike",
-                    FilterOperator::Is => "is",
-                    FilterOperator::In => "in",
-                    FilterOperator::Contains => "cs",
-                    FilterOperator::ContainedBy => "cd",
-                    FilterOperator::StrictlyLeft => "sl",
-                    FilterOperator::StrictlyRight => "sr",
-                    FilterOperator::NotExtendToRight => "nxr",
-                    FilterOperator::NotExtendToLeft => "nxl",
-                    FilterOperator::Adjacent => "adj",
-                };
+                let op_str = operator.as_str();
                 format!("{}.{}.{}", column, op_str, value)
             }
             Filter::And(filters) => {
@@ -743,6 +1084,7 @@ impl Database {
 
 impl QueryBuilder {
     fn new(database: Database, table: String) -> Self {
+        let coalesce = database.config.database_config.coalesce_selects;
         Self {
             database,
             table,
@@ -753,9 +1095,55 @@ impl QueryBuilder {
             offset: None,
             single: false,
             joins: Vec::new(),
+            cache_ttl: None,
+            coalesce,
         }
     }
 
+    /// Serve this query from the client's response cache for up to `ttl`
+    ///
+    /// Responses are keyed by the normalized request URL and the credentials the
+    /// client sends, so hits never touch the network. Once an entry is older than
+    /// `ttl` it is revalidated with `If-None-Match` when the server supplied an
+    /// `ETag`; a `304 Not Modified` reply refreshes the entry without a body.
+    /// Streaming execution always bypasses the cache.
+    ///
+    /// # Example
+    ///
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::Client;
+    /// # use serde_json::Value;
+    /// # use std::time::Duration;
+    /// # async fn example() -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("https://your-project.supabase.co", "your-anon-key")?;
+    ///
+    /// let countries: Vec<Value> = client
+    ///     .database()
+    ///     .from("countries")
+    ///     .select("code,name")
+    ///     .cached(Duration::from_secs(600))
+    ///     .execute()
+    ///     .await?;
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub fn cached(mut self, ttl: Duration) -> Self {
+        self.cache_ttl = Some(ttl);
+        self
+    }
+
+    /// Share one request between this query and identical ones already in flight
+    ///
+    /// Concurrent executions with the same URL and credentials wait for the first
+    /// one's response instead of each sending a request, which keeps bursts of
+    /// identical reads (for example right after a cache entry expires) from
+    /// reaching PostgREST more than once. Enabled for every query when
+    /// [`DatabaseConfig::coalesce_selects`](crate::types::DatabaseConfig::coalesce_selects) is set.
+    pub fn coalesce(mut self) -> Self {
+        self.coalesce = true;
+        self
+    }
+
     /// Select specific columns
     pub fn select(mut self, columns: &str) -> Self {
         self.columns = Some(columns.to_string());
@@ -1152,14 +1540,231 @@ impl QueryBuilder {
     {
         debug!("Executing SELECT query on table: {}", self.table);
 
-        let mut url = Url::parse(&format!("{}/{}", self.database.rest_url(), self.table))?;
+        let body = self.fetch(self.build_url()?.as_str()).await?;
+        self.parse_rows(&body)
+    }
+
+    /// Deserialize a successful SELECT response body into rows
+    fn parse_rows<T>(&self, body: &[u8]) -> Result<Vec<T>>
+    where
+        T: for<'de> Deserialize<'de>,
+    {
+        let result = if self.single {
+            let single_item: T = serde_json::from_slice(body)?;
+            vec![single_item]
+        } else {
+            serde_json::from_slice(body)?
+        };
 
-        // Add query parameters
-        let mut query_params = self.database.build_query_params(&self.filters);
+        info!(
+            "SELECT query executed successfully on table: {}",
+            self.table
+        );
+        Ok(result)
+    }
+
+    /// Execute the query and return the response body without parsing it
+    ///
+    /// Useful when the JSON is handed to another parser anyway, since it skips
+    /// deserializing into Rust values and serializing back to text.
+    ///
+    /// # Example
+    ///
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::Client;
+    /// # async fn example() -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("https://your-project.supabase.co", "your-anon-key")?;
+    ///
+    /// let body = client.database().from("posts").select("*").execute_raw().await?;
+    /// println!("Received {} bytes of JSON", body.len());
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub async fn execute_raw(&self) -> Result<Bytes> {
+        debug!("Executing raw SELECT query on table: {}", self.table);
+
+        let body = self.fetch(self.build_url()?.as_str()).await?;
+
+        info!(
+            "SELECT query executed successfully on table: {}",
+            self.table
+        );
+        Ok(body)
+    }
+
+    /// Execute the query, handing each row's JSON text to `on_row` as it arrives
+    ///
+    /// The response body is scanned incrementally, so memory use is bounded by the
+    /// largest single row rather than the size of the whole result. Returning an
+    /// error from `on_row` stops the stream and is propagated to the caller.
+    ///
+    /// Returns the number of rows delivered.
+    ///
+    /// # Example
+    ///
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::Client;
+    /// # async fn example() -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("https://your-project.supabase.co", "your-anon-key")?;
+    ///
+    /// let rows = client
+    ///     .database()
+    ///     .from("events")
+    ///     .select("*")
+    ///     .execute_streaming(|row| {
+    ///         let event: serde_json::Value = serde_json::from_str(row)?;
+    ///         println!("{}", event["id"]);
+    ///         Ok(())
+    ///     })
+    ///     .await?;
+    /// println!("Exported {} rows", rows);
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(not(target_arch = "wasm32"))]
+    pub async fn execute_streaming<F>(&self, mut on_row: F) -> Result<u64>
+    where
+        F: FnMut(&str) -> Result<()>,
+    {
+        if self.single {
+            return Err(Error::invalid_input(
+                "Streaming is not supported for single-row queries",
+            ));
+        }
+
+        debug!("Executing streaming SELECT query on table: {}", self.table);
+
+        let mut response = self.send().await?;
+        let mut scanner = JsonArrayScanner::default();
+        let mut rows = 0u64;
+
+        while let Some(chunk) = response.chunk().await? {
+            scanner.feed(&chunk, &mut |row| {
+                let row = std::str::from_utf8(row)
+                    .map_err(|e| Error::database(format!("Invalid UTF-8 in row: {}", e)))?;
+                rows += 1;
+                on_row(row)
+            })?;
+        }
+        scanner.finish()?;
+
+        info!(
+            "Streaming SELECT query delivered {} rows from table: {}",
+            rows, self.table
+        );
+        Ok(rows)
+    }
+
+    /// Page through the results in `key_column` order using keyset pagination
+    ///
+    /// `key_column` must be unique and non-null (usually the primary key), part
+    /// of the selected columns and not filtered on otherwise. The query's
+    /// ordering, limit and offset are replaced by ascending `key_column` order and
+    /// `page_size` rows per page; its other filters apply to every page.
+    ///
+    /// # Example
+    ///
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::Client;
+    /// # async fn example() -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("https://your-project.supabase.co", "your-anon-key")?;
+    ///
+    /// let mut pages = client
+    ///     .database()
+    ///     .from("events")
+    ///     .select("id,payload")
+    ///     .paginate("id", 1000);
+    /// while let Some(rows) = pages.next_page::<serde_json::Value>().await? {
+    ///     println!("{} rows", rows.len());
+    /// }
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub fn paginate(mut self, key_column: &str, page_size: u32) -> Paginator {
+        let page_size = page_size.max(1);
+        self.order_by = vec![OrderBy {
+            column: key_column.to_string(),
+            direction: OrderDirection::Ascending,
+            nulls_first: None,
+        }];
+        self.limit = Some(page_size);
+        self.offset = None;
+        self.single = false;
+
+        Paginator {
+            query: self,
+            key_column: key_column.to_string(),
+            page_size,
+            next: None,
+            done: false,
+        }
+    }
+
+    /// Build the request URL including filters, ordering and pagination
+    fn build_url(&self) -> Result<Url> {
+        let mut url = self.base_url()?;
+        let (params, _) = self.build_params();
+
+        // Set URL query parameters
+        url.query_pairs_mut().extend_pairs(&params);
+
+        Ok(url)
+    }
+
+    /// URL of the table endpoint, without query parameters
+    fn base_url(&self) -> Result<Url> {
+        Ok(Url::parse(&format!(
+            "{}/{}",
+            self.database.rest_url(),
+            self.table
+        ))?)
+    }
+
+    /// Collect the query parameters in a stable order
+    ///
+    /// Also returns a [`FilterBinding`] for every top-level simple filter, in the
+    /// order the filters were added, so prepared queries can rebind their values.
+    /// Every filter gets its own parameter, so several filters on one column all
+    /// apply (PostgREST combines repeated parameters with AND) and no two bindings
+    /// share a parameter.
+    fn build_params(&self) -> (Vec<(String, String)>, Vec<FilterBinding>) {
+        fn set_param(params: &mut Vec<(String, String)>, key: String, value: String) {
+            match params.iter_mut().find(|(existing, _)| *existing == key) {
+                Some(param) => param.1 = value,
+                None => params.push((key, value)),
+            }
+        }
+
+        let mut params = Vec::new();
+        let mut bindings = Vec::new();
+
+        for filter in &self.filters {
+            match filter {
+                Filter::Simple {
+                    column,
+                    operator,
+                    value,
+                } => {
+                    let operator = operator.as_str();
+                    bindings.push(FilterBinding {
+                        param: params.len(),
+                        operator,
+                    });
+                    params.push((column.clone(), format!("{}.{}", operator, value)));
+                }
+                logical => {
+                    let mut logical_params = HashMap::new();
+                    self.database
+                        .build_filter_params(logical, &mut logical_params);
+                    params.extend(logical_params);
+                }
+            }
+        }
 
         // Build select statement with joins
         let select_clause = self.build_select_with_joins();
-        query_params.insert("select".to_string(), select_clause);
+        set_param(&mut params, "select".to_string(), select_clause);
 
         if !self.order_by.is_empty() {
             let order_clauses: Vec<String> = self
@@ -1173,31 +1778,49 @@ impl QueryBuilder {
                     format!("{}.{}", order.column, direction)
                 })
                 .collect();
-            query_params.insert("order".to_string(), order_clauses.join(","));
+            set_param(&mut params, "order".to_string(), order_clauses.join(","));
         }
 
         if let Some(limit) = self.limit {
-            query_params.insert("limit".to_string(), limit.to_string());
+            set_param(&mut params, "limit".to_string(), limit.to_string());
         }
 
         if let Some(offset) = self.offset {
-            query_params.insert("offset".to_string(), offset.to_string());
+            set_param(&mut params, "offset".to_string(), offset.to_string());
         }
 
-        // Set URL query parameters
-        for (key, value) in query_params {
-            url.query_pairs_mut().append_pair(&key, &value);
-        }
+        (params, bindings)
+    }
+
+    /// Send the query and return the successful response
+    async fn send(&self) -> Result<reqwest::Response> {
+        let url = self.build_url()?;
+        self.send_url(url.as_str()).await
+    }
+
+    /// Send the query to an already-built URL and return the successful response
+    async fn send_url(&self, url: &str) -> Result<reqwest::Response> {
+        let response = self
+            .request(url)
+            .send_compressed(self.database.compression())
+            .await?;
+        Self::check_status(response).await
+    }
 
-        debug!("Generated query URL: {}", url.as_str());
-        let mut request = self.database.http_client.get(url.as_str());
+    /// GET request for `url` with the headers this query needs
+    fn request(&self, url: &str) -> reqwest::RequestBuilder {
+        debug!("Generated query URL: {}", url);
+        let request = self.database.http_client.get(url);
 
         if self.single {
-            request = request.header("Accept", "application/vnd.pgrst.object+json");
+            request.header("Accept", "application/vnd.pgrst.object+json")
+        } else {
+            request
         }
+    }
 
-        let response = request.send().await?;
-
+    /// Turn an unsuccessful response into a database error
+    async fn check_status(response: reqwest::Response) -> Result<reqwest::Response> {
         if !response.status().is_success() {
             let status = response.status();
             let error_msg = match response.text().await {
@@ -1207,45 +1830,140 @@ impl QueryBuilder {
             return Err(Error::database(error_msg));
         }
 
-        let result = if self.single {
-            let single_item: T = response.json().await?;
-            vec![single_item]
-        } else {
-            response.json().await?
-        };
+        Ok(response)
+    }
 
-        info!(
-            "SELECT query executed successfully on table: {}",
-            self.table
-        );
-        Ok(result)
+    /// Response body for `url`, shared with identical in-flight queries when enabled
+    async fn fetch(&self, url: &str) -> Result<Bytes> {
+        if !self.coalesce {
+            return self.fetch_once(url).await;
+        }
+
+        let key = self.database.query_cache.key(url, self.single);
+        self.database.in_flight.run(key, self.fetch_once(url)).await
     }
 
-    /// Build the SELECT clause including any joins
-    fn build_select_with_joins(&self) -> String {
-        let base_columns = self.columns.as_deref().unwrap_or("*");
+    /// Response body for `url`, going through the response cache when enabled
+    async fn fetch_once(&self, url: &str) -> Result<Bytes> {
+        let Some(ttl) = self.cache_ttl else {
+            let response = self.send_url(url).await?;
+            return Ok(response.bytes().await?);
+        };
 
-        if self.joins.is_empty() {
-            return base_columns.to_string();
+        let cache = &self.database.query_cache;
+        let key = cache.key(url, self.single);
+        let cached = cache.get(&key);
+
+        let mut request = self.request(url);
+        if let Some(entry) = &cached {
+            if entry.is_fresh() {
+                debug!("Query cache hit for table: {}", self.table);
+                return Ok(entry.body.clone());
+            }
+            if let Some(etag) = &entry.etag {
+                request = request.header(reqwest::header::IF_NONE_MATCH, etag);
+            }
         }
 
-        let mut select_parts = vec![base_columns.to_string()];
+        let response = request.send_compressed(self.database.compression()).await?;
 
-        for join in &self.joins {
-            let join_clause = self.build_join_clause(join);
-            select_parts.push(join_clause);
+        if response.status() == reqwest::StatusCode::NOT_MODIFIED {
+            if let Some(entry) = cached {
+                debug!("Query cache entry revalidated for table: {}", self.table);
+                cache.insert(key, entry.body.clone(), entry.etag.clone(), ttl);
+                return Ok(entry.body.clone());
+            }
         }
 
-        select_parts.join(",")
+        let response = Self::check_status(response).await?;
+        let etag = response
+            .headers()
+            .get(reqwest::header::ETAG)
+            .and_then(|value| value.to_str().ok())
+            .map(str::to_string);
+        let body = response.bytes().await?;
+
+        cache.insert(key, body.clone(), etag, ttl);
+        Ok(body)
     }
 
-    /// Build a single join clause for PostgREST
-    fn build_join_clause(&self, join: &Join) -> String {
-        match (&join.alias, &join.join_type) {
-            (Some(alias), JoinType::Inner) => {
-                // alias:foreign_table!inner(columns)
-                format!(
-                    "{}:{}!inner({})",
+    /// Freeze the query into a [`PreparedQuery`]
+    ///
+    /// The URL and parameters are computed once; afterwards only the values of
+    /// simple filters can change, via [`PreparedQuery::bind`].
+    ///
+    /// # Example
+    ///
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::Client;
+    /// # use serde_json::Value;
+    /// # async fn example() -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("https://your-project.supabase.co", "your-anon-key")?;
+    ///
+    /// let mut by_user = client
+    ///     .database()
+    ///     .from("orders")
+    ///     .select("id,total")
+    ///     .eq("user_id", "0")
+    ///     .prepare()?;
+    ///
+    /// for user_id in ["17", "42"] {
+    ///     by_user.bind(0, user_id)?;
+    ///     let orders: Vec<Value> = by_user.execute().await?;
+    ///     println!("user {} has {} orders", user_id, orders.len());
+    /// }
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub fn prepare(self) -> Result<PreparedQuery> {
+        let base_url = self.base_url()?;
+        let (params, bindings) = self.build_params();
+        let mut prepared = PreparedQuery {
+            query: self,
+            base_url,
+            params,
+            bindings,
+            url: String::new(),
+        };
+        prepared.refresh_url();
+        Ok(prepared)
+    }
+
+    /// Add a filter with an arbitrary operator
+    pub fn filter(mut self, column: &str, operator: FilterOperator, value: &str) -> Self {
+        self.filters.push(Filter::Simple {
+            column: column.to_string(),
+            operator,
+            value: value.to_string(),
+        });
+        self
+    }
+
+    /// Build the SELECT clause including any joins
+    fn build_select_with_joins(&self) -> String {
+        let base_columns = self.columns.as_deref().unwrap_or("*");
+
+        if self.joins.is_empty() {
+            return base_columns.to_string();
+        }
+
+        let mut select_parts = vec![base_columns.to_string()];
+
+        for join in &self.joins {
+            let join_clause = self.build_join_clause(join);
+            select_parts.push(join_clause);
+        }
+
+        select_parts.join(",")
+    }
+
+    /// Build a single join clause for PostgREST
+    fn build_join_clause(&self, join: &Join) -> String {
+        match (&join.alias, &join.join_type) {
+            (Some(alias), JoinType::Inner) => {
+                // alias:foreign_table!inner(columns)
+                format!(
+                    "{}:{}!inner({})",
                     alias, join.foreign_table, join.foreign_columns
                 )
             }
@@ -1277,12 +1995,164 @@ impl QueryBuilder {
     }
 }
 
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl Paginator {
+    /// Fetch the next page as the server's JSON array, or `None` after the last one
+    pub async fn next_page_raw(&mut self) -> Result<Option<Bytes>> {
+        if self.done {
+            return Ok(None);
+        }
+
+        let request = match self.next.take() {
+            Some(request) => request,
+            None => self.request_page(None),
+        };
+        let body = match request.await {
+            Ok(Ok(body)) => body,
+            Ok(Err(e)) => {
+                self.done = true;
+                return Err(e);
+            }
+            Err(e) => {
+                self.done = true;
+                return Err(Error::database(format!("Page request failed: {}", e)));
+            }
+        };
+
+        let rows: Vec<&serde_json::value::RawValue> = serde_json::from_slice(&body)?;
+        let Some(last) = rows.last() else {
+            self.done = true;
+            return Ok(None);
+        };
+
+        if rows.len() < self.page_size as usize {
+            self.done = true;
+        } else {
+            let last_key = Self::key_of(last.get(), &self.key_column)?;
+            self.next = Some(self.request_page(Some(last_key)));
+        }
+
+        Ok(Some(body))
+    }
+
+    /// Fetch and deserialize the next page, or `None` after the last one
+    pub async fn next_page<T>(&mut self) -> Result<Option<Vec<T>>>
+    where
+        T: for<'de> Deserialize<'de>,
+    {
+        match self.next_page_raw().await? {
+            Some(body) => Ok(Some(serde_json::from_slice(&body)?)),
+            None => Ok(None),
+        }
+    }
+
+    /// Start fetching the page after `last_key` (the first page for `None`)
+    fn request_page(&self, last_key: Option<String>) -> tokio::task::JoinHandle<Result<Bytes>> {
+        let query = match last_key {
+            Some(key) => self.query.clone().gt(&self.key_column, &key),
+            None => self.query.clone(),
+        };
+        tokio::spawn(async move { query.execute_raw().await })
+    }
+
+    /// Keyset value of `row` as used in a filter
+    fn key_of(row: &str, key_column: &str) -> Result<String> {
+        let row: HashMap<String, &serde_json::value::RawValue> = serde_json::from_str(row)?;
+        let key = row.get(key_column).ok_or_else(|| {
+            Error::invalid_input(format!(
+                "Pagination key column {} is missing from the selected rows",
+                key_column
+            ))
+        })?;
+
+        match serde_json::from_str::<JsonValue>(key.get())? {
+            JsonValue::String(key) => Ok(key),
+            JsonValue::Number(key) => Ok(key.to_string()),
+            JsonValue::Bool(key) => Ok(key.to_string()),
+            _ => Err(Error::invalid_input(format!(
+                "Pagination key column {} must hold strings, numbers or booleans",
+                key_column
+            ))),
+        }
+    }
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl Drop for Paginator {
+    fn drop(&mut self) {
+        if let Some(request) = self.next.take() {
+            request.abort();
+        }
+    }
+}
+
+impl PreparedQuery {
+    /// The full request URL
+    pub fn url(&self) -> &str {
+        &self.url
+    }
+
+    /// Number of filter values that can be rebound
+    pub fn binding_count(&self) -> usize {
+        self.bindings.len()
+    }
+
+    /// Replace the value of the filter in `slot`
+    ///
+    /// For `in` filters the value is the parenthesised list, e.g. `(1,2,3)`.
+    pub fn bind(&mut self, slot: usize, value: &str) -> Result<()> {
+        let binding = self.bindings.get(slot).copied().ok_or_else(|| {
+            Error::invalid_input(format!(
+                "Binding slot {} out of range (query has {})",
+                slot,
+                self.bindings.len()
+            ))
+        })?;
+
+        self.params[binding.param].1 = format!("{}.{}", binding.operator, value);
+        self.refresh_url();
+        Ok(())
+    }
+
+    /// Execute the query
+    pub async fn execute<T>(&self) -> Result<Vec<T>>
+    where
+        T: for<'de> Deserialize<'de>,
+    {
+        debug!(
+            "Executing prepared SELECT query on table: {}",
+            self.query.table
+        );
+
+        let body = self.query.fetch(&self.url).await?;
+        self.query.parse_rows(&body)
+    }
+
+    /// Execute the query and return the response body without parsing it
+    pub async fn execute_raw(&self) -> Result<Bytes> {
+        debug!(
+            "Executing prepared raw SELECT query on table: {}",
+            self.query.table
+        );
+
+        self.query.fetch(&self.url).await
+    }
+
+    /// Re-serialize the URL after the parameters changed
+    fn refresh_url(&mut self) {
+        let mut url = self.base_url.clone();
+        url.query_pairs_mut().extend_pairs(&self.params);
+        self.url = url.into();
+    }
+}
+
 impl InsertBuilder {
     fn new(database: Database, table: String) -> Self {
         Self {
             database,
             table,
             data: JsonValue::Null,
+            raw_body: None,
             upsert: false,
             on_conflict: None,
             returning: None,
@@ -1292,9 +2162,20 @@ impl InsertBuilder {
     /// Set the data to insert
     pub fn values<T: Serialize>(mut self, data: T) -> Result<Self> {
         self.data = serde_json::to_value(data)?;
+        self.raw_body = None;
         Ok(self)
     }
 
+    /// Set an already-serialized JSON body to insert
+    ///
+    /// The bytes are sent as-is without being parsed, which avoids a
+    /// parse/serialize round trip when the caller already holds JSON text.
+    /// PostgREST validates the document.
+    pub fn raw_values(mut self, json: impl Into<Bytes>) -> Self {
+        self.raw_body = Some(json.into());
+        self
+    }
+
     /// Enable upsert mode
     pub fn upsert(mut self) -> Self {
         self.upsert = true;
@@ -1318,10 +2199,43 @@ impl InsertBuilder {
     where
         T: for<'de> Deserialize<'de>,
     {
+        let response = self.send().await?;
+
+        let result: Vec<T> = response.json().await?;
+        info!(
+            "INSERT query executed successfully on table: {}",
+            self.table
+        );
+
+        Ok(result)
+    }
+
+    /// Execute the insert and return the response body without parsing it
+    pub async fn execute_raw(&self) -> Result<Bytes> {
+        let response = self.send().await?;
+
+        let body = response.bytes().await?;
+        info!(
+            "INSERT query executed successfully on table: {}",
+            self.table
+        );
+
+        Ok(body)
+    }
+
+    /// Send the insert and return the successful response
+    async fn send(&self) -> Result<reqwest::Response> {
         debug!("Executing INSERT query on table: {}", self.table);
 
         let url = format!("{}/{}", self.database.rest_url(), self.table);
-        let mut request = self.database.http_client.post(&url).json(&self.data);
+        let mut request = self.database.http_client.post(&url);
+
+        request = match &self.raw_body {
+            Some(body) => request
+                .header("Content-Type", "application/json")
+                .body(body.clone()),
+            None => request.json(&self.data),
+        };
 
         if let Some(ref _returning) = self.returning {
             request = request.header("Prefer", "return=representation".to_string());
@@ -1331,7 +2245,7 @@ impl InsertBuilder {
             request = request.header("Prefer", "resolution=merge-duplicates");
         }
 
-        let response = request.send().await?;
+        let response = request.send_compressed(self.database.compression()).await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -1342,13 +2256,7 @@ impl InsertBuilder {
             return Err(Error::database(error_msg));
         }
 
-        let result: Vec<T> = response.json().await?;
-        info!(
-            "INSERT query executed successfully on table: {}",
-            self.table
-        );
-
-        Ok(result)
+        Ok(response)
     }
 }
 
@@ -1410,7 +2318,7 @@ impl UpdateBuilder {
             request = request.header("Prefer", "return=representation");
         }
 
-        let response = request.send().await?;
+        let response = request.send_compressed(self.database.compression()).await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -1478,7 +2386,7 @@ impl DeleteBuilder {
             request = request.header("Prefer", "return=representation");
         }
 
-        let response = request.send().await?;
+        let response = request.send_compressed(self.database.compression()).await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -1587,9 +2495,222 @@ impl TransactionBuilder {
     }
 }
 
+/// Responses stored by `.cached()` queries, shared by all clones of a [`Database`]
+///
+/// Backed by the crate's sharded CLOCK cache, bounded by both entry count and
+/// response bytes. Stale entries stay cached until evicted so that they can be
+/// revalidated with their `ETag`.
+#[derive(Debug)]
+struct QueryCache {
+    /// Fingerprint of the credentials requests are sent with
+    credentials: u64,
+    responses: ShardedCache<Arc<CachedResponse>>,
+}
+
+#[derive(Debug)]
+struct CachedResponse {
+    body: Bytes,
+    etag: Option<String>,
+    expires_at: chrono::DateTime<chrono::Utc>,
+}
+
+impl CachedResponse {
+    fn is_fresh(&self) -> bool {
+        chrono::Utc::now() < self.expires_at
+    }
+}
+
+impl QueryCache {
+    fn new(key: &str, max_entries: usize, max_bytes: usize) -> Self {
+        let mut hasher = DefaultHasher::new();
+        key.hash(&mut hasher);
+
+        Self {
+            credentials: hasher.finish(),
+            responses: ShardedCache::new(max_entries, max_bytes),
+        }
+    }
+
+    /// Cache key for a GET of `url`, independent of query parameter order
+    fn key(&self, url: &str, single: bool) -> String {
+        let normalized = match Url::parse(url) {
+            Ok(mut parsed) => {
+                let mut params: Vec<(String, String)> = parsed.query_pairs().into_owned().collect();
+                // Stable sort: repeated parameters keep their relative order
+                params.sort_by(|a, b| a.0.cmp(&b.0));
+                parsed.set_query(None);
+                if !params.is_empty() {
+                    parsed.query_pairs_mut().extend_pairs(&params);
+                }
+                parsed.into()
+            }
+            Err(_) => url.to_string(),
+        };
+
+        format!(
+            "{:016x}:{}:{}",
+            self.credentials,
+            u8::from(single),
+            normalized
+        )
+    }
+
+    fn get(&self, key: &str) -> Option<Arc<CachedResponse>> {
+        self.responses.get(key)
+    }
+
+    fn insert(&self, key: String, body: Bytes, etag: Option<String>, ttl: Duration) {
+        let expires_at = chrono::Duration::from_std(ttl)
+            .ok()
+            .and_then(|ttl| chrono::Utc::now().checked_add_signed(ttl))
+            .unwrap_or(chrono::DateTime::<chrono::Utc>::MAX_UTC);
+        let size_bytes = key.len() + body.len() + etag.as_ref().map_or(0, String::len);
+        let response = Arc::new(CachedResponse {
+            body,
+            etag,
+            expires_at,
+        });
+
+        self.responses.insert(&key, response, size_bytes, None);
+    }
+
+    fn clear(&self) {
+        self.responses.clear();
+    }
+}
+
+/// Incremental splitter for a top-level JSON array
+///
+/// Bytes are fed as they arrive from the network; each complete element is handed
+/// out as a slice and then discarded, so only the element currently being received
+/// is buffered.
+#[cfg_attr(target_arch = "wasm32", allow(dead_code))]
+#[derive(Debug, Default)]
+struct JsonArrayScanner {
+    buffer: Vec<u8>,
+    /// Next byte of `buffer` to scan
+    position: usize,
+    /// Start of the element currently being scanned
+    element_start: Option<usize>,
+    /// Nesting depth inside the current element
+    depth: usize,
+    in_string: bool,
+    escaped: bool,
+    state: ScanState,
+}
+
+#[cfg_attr(target_arch = "wasm32", allow(dead_code))]
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+enum ScanState {
+    #[default]
+    BeforeArray,
+    InArray,
+    Done,
+}
+
+#[cfg_attr(target_arch = "wasm32", allow(dead_code))]
+impl JsonArrayScanner {
+    /// Consume `chunk`, calling `on_element` for every element it completes
+    fn feed<F>(&mut self, chunk: &[u8], on_element: &mut F) -> Result<()>
+    where
+        F: FnMut(&[u8]) -> Result<()>,
+    {
+        self.buffer.extend_from_slice(chunk);
+
+        while self.position < self.buffer.len() {
+            let index = self.position;
+            let byte = self.buffer[index];
+            self.position += 1;
+
+            match self.state {
+                ScanState::BeforeArray => match byte {
+                    b'[' => self.state = ScanState::InArray,
+                    b if b.is_ascii_whitespace() => {}
+                    _ => return Err(Error::database("Expected a JSON array in response")),
+                },
+                ScanState::Done => {
+                    if !byte.is_ascii_whitespace() {
+                        return Err(Error::database("Unexpected data after JSON array"));
+                    }
+                }
+                ScanState::InArray => {
+                    let Some(start) = self.element_start else {
+                        match byte {
+                            b']' => self.state = ScanState::Done,
+                            b',' => {}
+                            b if b.is_ascii_whitespace() => {}
+                            _ => {
+                                self.element_start = Some(index);
+                                self.scan_element_byte(byte);
+                            }
+                        }
+                        continue;
+                    };
+
+                    if self.in_string || self.depth > 0 || !matches!(byte, b',' | b']') {
+                        self.scan_element_byte(byte);
+                        continue;
+                    }
+
+                    // A top-level `,` or `]` terminates the element
+                    on_element(self.buffer[start..index].trim_ascii_end())?;
+                    self.element_start = None;
+                    if byte == b']' {
+                        self.state = ScanState::Done;
+                    }
+                }
+            }
+        }
+
+        // Drop everything that no longer belongs to a pending element
+        let consumed = self.element_start.unwrap_or(self.position);
+        self.buffer.drain(..consumed);
+        self.position -= consumed;
+        if self.element_start.is_some() {
+            self.element_start = Some(0);
+        }
+
+        Ok(())
+    }
+
+    /// Track strings and nesting for a byte inside an element
+    fn scan_element_byte(&mut self, byte: u8) {
+        if self.in_string {
+            if self.escaped {
+                self.escaped = false;
+            } else if byte == b'\\' {
+                self.escaped = true;
+            } else if byte == b'"' {
+                self.in_string = false;
+            }
+            return;
+        }
+
+        match byte {
+            b'"' => self.in_string = true,
+            b'{' | b'[' => self.depth += 1,
+            b'}' | b']' => self.depth = self.depth.saturating_sub(1),
+            _ => {}
+        }
+    }
+
+    /// Verify the array was closed
+    fn finish(&self) -> Result<()> {
+        if self.state == ScanState::Done {
+            Ok(())
+        } else {
+            Err(Error::database(
+                "Response ended before the JSON array was complete",
+            ))
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    use crate::mock_server::{MockRequest, MockResponse, MockServer};
 
     #[test]
     fn test_logical_operators() {
@@ -1717,6 +2838,154 @@ mod tests {
         assert!(matches!(query.filters[0], Filter::Not(_)));
     }
 
+    #[test]
+    fn test_prepared_query_rebinds_filters() {
+        use crate::types::SupabaseConfig;
+        use reqwest::Client as HttpClient;
+        use std::sync::Arc;
+
+        let config = Arc::new(SupabaseConfig {
+            url: "http://localhost:54321".to_string(),
+            ..Default::default()
+        });
+        let http_client = Arc::new(HttpClient::new());
+        let db = Database::new(config, http_client).unwrap();
+
+        let query = db
+            .from("orders")
+            .select("id,total")
+            .eq("user_id", "1")
+            .r#in("status", &["new", "paid"])
+            .order("id", OrderDirection::Descending)
+            .limit(10);
+        let url = query.build_url().unwrap().to_string();
+
+        let mut prepared = query.prepare().unwrap();
+        assert_eq!(prepared.url(), url);
+        assert_eq!(prepared.binding_count(), 2);
+        assert_eq!(
+            prepared.url(),
+            "http://localhost:54321/rest/v1/orders?user_id=eq.1&status=in.%28new%2Cpaid%29\
+             &select=id%2Ctotal&order=id.desc&limit=10"
+        );
+
+        prepared.bind(0, "42").unwrap();
+        prepared.bind(1, "(shipped)").unwrap();
+        assert!(prepared.url().contains("user_id=eq.42"));
+        assert!(prepared.url().contains("status=in.%28shipped%29"));
+        assert!(prepared.bind(2, "x").is_err());
+
+        // Two filters on one column are both sent and keep separate slots
+        let mut range = db
+            .from("orders")
+            .gt("total", "1")
+            .lt("total", "5")
+            .prepare()
+            .unwrap();
+        assert_eq!(range.binding_count(), 2);
+        assert!(range.url().contains("?total=gt.1&total=lt.5&"));
+        range.bind(0, "2").unwrap();
+        assert!(range.url().contains("?total=gt.2&total=lt.5&"));
+        range.bind(1, "9").unwrap();
+        assert!(range.url().contains("?total=gt.2&total=lt.9&"));
+    }
+
+    #[test]
+    fn test_query_cache_key_normalizes_params() {
+        let cache = QueryCache::new("anon-key", 8, usize::MAX);
+        let a = cache.key("http://localhost/rest/v1/t?b=eq.2&a=eq.1", false);
+        let b = cache.key("http://localhost/rest/v1/t?a=eq.1&b=eq.2", false);
+        assert_eq!(a, b);
+
+        assert_ne!(
+            a,
+            cache.key("http://localhost/rest/v1/t?a=eq.1&b=eq.2", true)
+        );
+        assert_ne!(
+            a,
+            QueryCache::new("service-key", 8, usize::MAX)
+                .key("http://localhost/rest/v1/t?a=eq.1&b=eq.2", false)
+        );
+    }
+
+    #[test]
+    fn test_query_cache_bounds_and_keeps_stale_entries() {
+        // One entry per shard, so a second key in the same shard evicts the first
+        let cache = QueryCache::new("anon-key", 1, 16);
+        let ttl = Duration::from_secs(60);
+
+        cache.insert("a".to_string(), Bytes::from_static(b"[1]"), None, ttl);
+        cache.insert("b".to_string(), Bytes::from_static(b"[2]"), None, ttl);
+        assert!(cache.get("a").is_none());
+        assert_eq!(cache.get("b").unwrap().body, Bytes::from_static(b"[2]"));
+        assert!(cache.get("b").unwrap().is_fresh());
+
+        // Larger than the byte budget, so never stored
+        cache.insert("c".to_string(), Bytes::from(vec![b'0'; 32]), None, ttl);
+        assert!(cache.get("c").is_none());
+
+        cache.insert(
+            "d".to_string(),
+            Bytes::new(),
+            Some("\"v1\"".to_string()),
+            Duration::ZERO,
+        );
+        // Past its TTL but still available for revalidation
+        let stale = cache.get("d").unwrap();
+        assert!(!stale.is_fresh());
+        assert_eq!(stale.etag.as_deref(), Some("\"v1\""));
+    }
+
+    #[tokio::test]
+    async fn test_cached_query_serves_hits_offline() {
+        use crate::types::SupabaseConfig;
+        use reqwest::Client as HttpClient;
+
+        let config = Arc::new(SupabaseConfig {
+            url: "http://127.0.0.1:1".to_string(),
+            ..Default::default()
+        });
+        let db = Database::new(config, Arc::new(HttpClient::new())).unwrap();
+        let query = db
+            .from("countries")
+            .select("code")
+            .cached(Duration::from_secs(60));
+
+        // Nothing cached yet, so the request reaches the (unreachable) server
+        assert!(query.execute_raw().await.is_err());
+
+        let url = query.build_url().unwrap();
+        db.query_cache.insert(
+            db.query_cache.key(url.as_str(), false),
+            Bytes::from_static(br#"[{"code":"NZ"}]"#),
+            None,
+            Duration::from_secs(60),
+        );
+        let rows: Vec<serde_json::Value> = query.execute().await.unwrap();
+        assert_eq!(rows, vec![serde_json::json!({"code": "NZ"})]);
+
+        db.clear_query_cache();
+        assert!(query.execute_raw().await.is_err());
+    }
+
+    #[test]
+    fn test_filter_with_operator() {
+        use crate::types::SupabaseConfig;
+        use reqwest::Client as HttpClient;
+        use std::sync::Arc;
+
+        let config = Arc::new(SupabaseConfig::default());
+        let http_client = Arc::new(HttpClient::new());
+        let db = Database::new(config, http_client).unwrap();
+
+        let query = db
+            .from("users")
+            .filter("age", FilterOperator::GreaterThanOrEqual, "18");
+        let (params, bindings) = query.build_params();
+        assert_eq!(params[0], ("age".to_string(), "gte.18".to_string()));
+        assert_eq!(bindings.len(), 1);
+    }
+
     #[test]
     fn test_join_functionality() {
         use crate::types::SupabaseConfig;
@@ -1872,6 +3141,28 @@ mod tests {
         assert_eq!(builder.on_conflict.as_ref().unwrap(), "email,id");
     }
 
+    #[test]
+    fn test_insert_builder_raw_values() {
+        use crate::types::SupabaseConfig;
+        use reqwest::Client as HttpClient;
+        use std::sync::Arc;
+
+        let config = Arc::new(SupabaseConfig::default());
+        let http_client = Arc::new(HttpClient::new());
+        let db = Database::new(config, http_client).unwrap();
+
+        let builder = db.insert("users").raw_values(r#"{"name":"Ann"}"#);
+        assert_eq!(
+            builder.raw_body.as_deref(),
+            Some(br#"{"name":"Ann"}"#.as_slice())
+        );
+
+        // Structured values replace a previously set raw body
+        let builder = builder.values(json!({"name": "Bob"})).unwrap();
+        assert!(builder.raw_body.is_none());
+        assert_eq!(builder.data["name"], "Bob");
+    }
+
     #[test]
     fn test_transaction_builder() {
         use crate::types::SupabaseConfig;
@@ -1934,4 +3225,271 @@ mod tests {
         assert_eq!(update_op["data"]["status"], "active");
         assert_eq!(update_op["where"], "id = 1");
     }
+
+    fn scan_in_chunks(body: &str, chunk_size: usize) -> Result<Vec<String>> {
+        let mut scanner = JsonArrayScanner::default();
+        let mut rows = Vec::new();
+        for chunk in body.as_bytes().chunks(chunk_size) {
+            scanner.feed(chunk, &mut |row| {
+                rows.push(String::from_utf8(row.to_vec()).unwrap());
+                Ok(())
+            })?;
+        }
+        scanner.finish()?;
+        Ok(rows)
+    }
+
+    #[test]
+    fn test_json_array_scanner_splits_rows() {
+        let body = r#" [ {"id":1,"tags":["a","b"]}, {"id":2,"note":"x, ] } \" y"} ,3, "s" ] "#;
+        let expected = vec![
+            r#"{"id":1,"tags":["a","b"]}"#,
+            r#"{"id":2,"note":"x, ] } \" y"}"#,
+            "3",
+            r#""s""#,
+        ];
+
+        // Every chunk size must yield the same rows, whatever the split points
+        for chunk_size in 1..body.len() {
+            assert_eq!(scan_in_chunks(body, chunk_size).unwrap(), expected);
+        }
+    }
+
+    #[test]
+    fn test_json_array_scanner_buffers_only_pending_row() {
+        let mut scanner = JsonArrayScanner::default();
+        scanner
+            .feed(br#"[{"id":1},{"id":2},{"id""#, &mut |_| Ok(()))
+            .unwrap();
+        assert_eq!(scanner.buffer, br#"{"id""#);
+    }
+
+    #[test]
+    fn test_json_array_scanner_rejects_invalid_bodies() {
+        assert_eq!(scan_in_chunks("[]", 1).unwrap(), Vec::<String>::new());
+        assert!(scan_in_chunks(r#"{"id":1}"#, 4).is_err());
+        assert!(scan_in_chunks(r#"[{"id":1}"#, 4).is_err());
+        assert!(scan_in_chunks(r#"[1] x"#, 4).is_err());
+    }
+
+    /// Accept bulk load chunks over HTTP, rejecting bodies that contain `"fail"`;
+    /// returns the server and every request it received
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    fn serve_bulk_loads() -> (MockServer, Arc<std::sync::Mutex<Vec<MockRequest>>>) {
+        let requests = Arc::new(std::sync::Mutex::new(Vec::new()));
+        let recorded = Arc::clone(&requests);
+        let server = MockServer::start(move |request| {
+            recorded.lock().unwrap().push(request.clone());
+            if request.body_text().contains("\"fail\"") {
+                MockResponse::new(400).body("bad row")
+            } else {
+                MockResponse::new(201)
+            }
+        });
+        (server, requests)
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    fn bulk_database(url: String) -> Database {
+        let config = Arc::new(SupabaseConfig {
+            url,
+            key: "test-key".to_string(),
+            ..Default::default()
+        });
+        Database::new(config, Arc::new(HttpClient::new())).unwrap()
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_bulk_load_sends_chunks_and_reports_failures() {
+        let (server, requests) = serve_bulk_loads();
+        let db = bulk_database(server.url().to_string());
+
+        let rows = (0..10).map(|id| {
+            if id == 4 {
+                json!({"id": id, "name": "fail"})
+            } else {
+                json!({"id": id})
+            }
+        });
+        let config = BulkLoadConfig {
+            chunk_size: 3,
+            max_concurrent_chunks: 2,
+            ..Default::default()
+        };
+        let report = db.bulk_load("users", rows, &config).await.unwrap();
+
+        assert_eq!(report.chunks, 4);
+        assert_eq!(report.rows_loaded, 7);
+        assert_eq!(report.failures.len(), 1);
+        let failure = &report.failures[0];
+        assert_eq!((failure.chunk, failure.first_row, failure.rows), (1, 3, 3));
+        assert!(failure.error.to_string().contains("bad row"));
+
+        let requests = requests.lock().unwrap().clone();
+        assert_eq!(requests.len(), 4);
+        let bodies: Vec<String> = requests.iter().map(MockRequest::body_text).collect();
+        assert!(bodies.iter().any(|body| body == r#"[{"id":9}]"#));
+        assert!(bodies
+            .iter()
+            .any(|body| body == r#"[{"id":0},{"id":1},{"id":2}]"#));
+        for request in &requests {
+            assert_eq!(
+                (request.method.as_str(), request.target.as_str()),
+                ("POST", "/rest/v1/users")
+            );
+            assert_eq!(request.header("prefer"), Some("return=minimal"));
+        }
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_bulk_load_ndjson_upsert() {
+        let (server, requests) = serve_bulk_loads();
+        let db = bulk_database(server.url().to_string());
+
+        let ndjson = "{\"id\":1}\r\n\n  {\"id\":2}\n{\"id\":3}";
+        let config = BulkLoadConfig {
+            chunk_size: 2,
+            upsert: true,
+            on_conflict: Some("id".to_string()),
+            ..Default::default()
+        };
+        let report = db
+            .bulk_load_ndjson("users", ndjson.as_bytes(), &config)
+            .await
+            .unwrap();
+
+        assert_eq!(report.chunks, 2);
+        assert_eq!(report.rows_loaded, 3);
+        assert!(report.failures.is_empty());
+
+        let requests = requests.lock().unwrap().clone();
+        let mut bodies: Vec<String> = requests.iter().map(MockRequest::body_text).collect();
+        bodies.sort_unstable();
+        assert_eq!(bodies, vec![r#"[{"id":1},{"id":2}]"#, r#"[{"id":3}]"#]);
+        for request in &requests {
+            assert_eq!(
+                (request.method.as_str(), request.target.as_str()),
+                ("POST", "/rest/v1/users?on_conflict=id")
+            );
+            assert_eq!(
+                request.header("prefer"),
+                Some("return=minimal,resolution=merge-duplicates")
+            );
+        }
+
+        // Empty input sends nothing
+        let report = db
+            .bulk_load_ndjson("users", &b"\n\n"[..], &config)
+            .await
+            .unwrap();
+        assert_eq!(report.chunks, 0);
+    }
+
+    /// Serve rows `{"id": 1..=total}` honouring `id=gt.N` and `limit`; returns the
+    /// server and the request targets received
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    fn serve_keyset_table(total: u64) -> (MockServer, Arc<std::sync::Mutex<Vec<String>>>) {
+        let requests = Arc::new(std::sync::Mutex::new(Vec::new()));
+        let recorded = Arc::clone(&requests);
+        let server = MockServer::start(move |request| {
+            recorded.lock().unwrap().push(request.target.clone());
+
+            let after: u64 = request
+                .query("id")
+                .and_then(|value| value.strip_prefix("gt.").map(str::to_string))
+                .map_or(0, |value| value.parse().unwrap());
+            let limit: u64 = request.query("limit").unwrap().parse().unwrap();
+            let rows: Vec<JsonValue> = (after + 1..=total.min(after + limit))
+                .map(|id| json!({ "id": id }))
+                .collect();
+            MockResponse::json(serde_json::to_vec(&rows).unwrap())
+        });
+        (server, requests)
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_paginate_walks_keys_and_prefetches() {
+        let (server, requests) = serve_keyset_table(7);
+        let db = bulk_database(server.url().to_string());
+
+        let mut pages = db
+            .from("items")
+            .select("id")
+            .order("name", OrderDirection::Descending)
+            .offset(100)
+            .paginate("id", 3);
+
+        let first: Vec<JsonValue> = pages.next_page().await.unwrap().unwrap();
+        assert_eq!(
+            first,
+            vec![json!({"id": 1}), json!({"id": 2}), json!({"id": 3})]
+        );
+
+        // The second page is requested before the caller asks for it
+        for _ in 0..100 {
+            if requests.lock().unwrap().len() == 2 {
+                break;
+            }
+            tokio::time::sleep(Duration::from_millis(10)).await;
+        }
+        assert_eq!(requests.lock().unwrap().len(), 2);
+
+        let second: Vec<JsonValue> = pages.next_page().await.unwrap().unwrap();
+        assert_eq!(
+            second,
+            vec![json!({"id": 4}), json!({"id": 5}), json!({"id": 6})]
+        );
+        let third = pages.next_page_raw().await.unwrap().unwrap();
+        assert_eq!(&third[..], br#"[{"id":7}]"#);
+        // A short page is the last one, nothing more is requested
+        assert!(pages.next_page_raw().await.unwrap().is_none());
+
+        let requests = requests.lock().unwrap().clone();
+        assert_eq!(requests.len(), 3);
+        for request in &requests {
+            assert!(request.contains("order=id.asc"), "{}", request);
+            assert!(request.contains("limit=3"), "{}", request);
+            assert!(!request.contains("offset"), "{}", request);
+        }
+        assert!(!requests[0].contains("id=gt"));
+        assert!(requests[1].contains("id=gt.3"));
+        assert!(requests[2].contains("id=gt.6"));
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_paginate_stops_on_empty_page_and_missing_key() {
+        let (server, _) = serve_keyset_table(4);
+        let db = bulk_database(server.url().to_string());
+
+        let mut pages = db.from("items").paginate("id", 2);
+        assert_eq!(
+            pages.next_page::<JsonValue>().await.unwrap().unwrap().len(),
+            2
+        );
+        assert_eq!(
+            pages.next_page::<JsonValue>().await.unwrap().unwrap().len(),
+            2
+        );
+        assert!(pages.next_page::<JsonValue>().await.unwrap().is_none());
+        assert!(pages.next_page::<JsonValue>().await.unwrap().is_none());
+
+        let mut pages = db.from("items").paginate("uuid", 2);
+        assert!(pages.next_page::<JsonValue>().await.is_err());
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[test]
+    fn test_paginator_key_formatting() {
+        assert_eq!(Paginator::key_of(r#"{"id":42}"#, "id").unwrap(), "42");
+        assert_eq!(
+            Paginator::key_of(r#"{"slug":"a\"b","id":1}"#, "slug").unwrap(),
+            "a\"b"
+        );
+        assert!(Paginator::key_of(r#"{"id":null}"#, "id").is_err());
+        assert!(Paginator::key_of(r#"{"name":"x"}"#, "id").is_err());
+    }
 }
@@ -0,0 +1,116 @@
+//! DNS resolution with cached answers
+//!
+//! reqwest resolves the host for every new connection. When a pool is refilled
+//! under load that is one lookup per connection; [`CachingResolver`] answers
+//! repeat lookups from memory for a fixed TTL instead. Failed lookups are not
+//! cached.
+
+use std::collections::HashMap;
+use std::net::SocketAddr;
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
+
+use reqwest::dns::{Addrs, Name, Resolve, Resolving};
+
+/// Resolver reusing each host's addresses for `ttl`
+#[derive(Debug)]
+pub(crate) struct CachingResolver {
+    ttl: Duration,
+    entries: Arc<Mutex<HashMap<String, CachedAddrs>>>,
+}
+
+#[derive(Debug, Clone)]
+struct CachedAddrs {
+    resolved_at: Instant,
+    addrs: Arc<[SocketAddr]>,
+}
+
+impl CachingResolver {
+    pub(crate) fn new(ttl: Duration) -> Self {
+        Self {
+            ttl,
+            entries: Arc::new(Mutex::new(HashMap::new())),
+        }
+    }
+
+    fn cached(&self, host: &str) -> Option<Arc<[SocketAddr]>> {
+        let entries = self.entries.lock().ok()?;
+        entries
+            .get(host)
+            .filter(|entry| entry.resolved_at.elapsed() < self.ttl)
+            .map(|entry| Arc::clone(&entry.addrs))
+    }
+}
+
+impl Resolve for CachingResolver {
+    fn resolve(&self, name: Name) -> Resolving {
+        let host = name.as_str().to_string();
+        if let Some(addrs) = self.cached(&host) {
+            return Box::pin(async move { Ok(addrs_iter(addrs)) });
+        }
+
+        let ttl = self.ttl;
+        let entries = Arc::clone(&self.entries);
+        Box::pin(async move {
+            // Port 0 is replaced with the request's port by the connector
+            let addrs: Arc<[SocketAddr]> =
+                tokio::net::lookup_host((host.as_str(), 0)).await?.collect();
+            if !addrs.is_empty() {
+                if let Ok(mut entries) = entries.lock() {
+                    entries.retain(|_, entry| entry.resolved_at.elapsed() < ttl);
+                    entries.insert(
+                        host,
+                        CachedAddrs {
+                            resolved_at: Instant::now(),
+                            addrs: Arc::clone(&addrs),
+                        },
+                    );
+                }
+            }
+            Ok(addrs_iter(addrs))
+        })
+    }
+}
+
+fn addrs_iter(addrs: Arc<[SocketAddr]>) -> Addrs {
+    Box::new((0..addrs.len()).map(move |i| addrs[i]))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::str::FromStr;
+
+    #[tokio::test]
+    async fn test_answers_are_cached_for_ttl() {
+        let resolver = CachingResolver::new(Duration::from_secs(60));
+        assert!(resolver.cached("localhost").is_none());
+
+        let first: Vec<_> = resolver
+            .resolve(Name::from_str("localhost").unwrap())
+            .await
+            .unwrap()
+            .collect();
+        assert!(!first.is_empty());
+
+        let cached = resolver.cached("localhost").unwrap();
+        assert_eq!(&cached[..], &first[..]);
+        let second: Vec<_> = resolver
+            .resolve(Name::from_str("localhost").unwrap())
+            .await
+            .unwrap()
+            .collect();
+        assert_eq!(second, first);
+    }
+
+    #[tokio::test]
+    async fn test_expired_answers_are_not_used() {
+        let resolver = CachingResolver::new(Duration::ZERO);
+        let addrs = resolver
+            .resolve(Name::from_str("localhost").unwrap())
+            .await
+            .unwrap();
+        assert!(addrs.count() > 0);
+        assert!(resolver.cached("localhost").is_none());
+    }
+}
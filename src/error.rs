@@ -409,6 +409,70 @@ impl Error {
             context,
         }
     }
+
+    /// Copy of this error for handing to several callers
+    ///
+    /// Variant, message and context are preserved; wrapped library errors that
+    /// cannot be cloned are carried over as their message.
+    #[cfg_attr(
+        not(any(feature = "database", feature = "functions")),
+        allow(dead_code)
+    )]
+    pub(crate) fn duplicate(&self) -> Self {
+        match self {
+            Error::Http {
+                message, context, ..
+            } => Error::Http {
+                message: message.clone(),
+                source: None,
+                context: context.clone(),
+            },
+            Error::Json(e) => Error::Json(serde::de::Error::custom(e)),
+            Error::UrlParse(e) => Error::UrlParse(*e),
+            #[cfg(feature = "auth")]
+            Error::Jwt(e) => Error::auth(e.to_string()),
+            Error::Auth { message, context } => {
+                Error::auth_with_context(message.clone(), context.clone())
+            }
+            Error::Database { message, context } => {
+                Error::database_with_context(message.clone(), context.clone())
+            }
+            Error::Storage { message, context } => {
+                Error::storage_with_context(message.clone(), context.clone())
+            }
+            Error::Realtime { message, context } => {
+                Error::realtime_with_context(message.clone(), context.clone())
+            }
+            Error::Config { message } => Error::config(message.clone()),
+            Error::InvalidInput { message } => Error::invalid_input(message.clone()),
+            Error::Network { message, context } => Error::Network {
+                message: message.clone(),
+                context: context.clone(),
+            },
+            Error::RateLimit { message, context } => Error::RateLimit {
+                message: message.clone(),
+                context: context.clone(),
+            },
+            Error::PermissionDenied { message, context } => Error::PermissionDenied {
+                message: message.clone(),
+                context: context.clone(),
+            },
+            Error::NotFound { message, context } => Error::NotFound {
+                message: message.clone(),
+                context: context.clone(),
+            },
+            Error::Generic { message } => Error::generic(message.clone()),
+            Error::Functions { message, context } => {
+                Error::functions_with_context(message.clone(), context.clone())
+            }
+            Error::Platform { message, context } => {
+                Error::platform_with_context(message.clone(), context.clone())
+            }
+            Error::Crypto { message, context } => {
+                Error::crypto_with_context(message.clone(), context.clone())
+            }
+        }
+    }
 }
 
 /// Detect current platform context
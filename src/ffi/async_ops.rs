@@ -0,0 +1,586 @@
+//! Non-blocking C entry points with completion callbacks
+//!
+//! Each `*_async` function decodes its arguments on the calling thread, spawns the
+//! operation onto the client's tokio runtime and returns a [`SupabaseRequest`]
+//! handle immediately, so a single C/C++ event loop can keep many requests in
+//! flight without dedicating an OS thread to each one.
+//!
+//! # Completion contract
+//!
+//! - The callback is invoked **exactly once** per request, on a runtime worker
+//!   thread (or on the thread that frees the client, if the runtime is shut down
+//!   while the request is still pending).
+//! - On success `result` holds the JSON response; on failure it holds the error
+//!   message. The pointer is only valid for the duration of the callback.
+//! - Cancelled requests complete with `SUPABASE_RUNTIME_ERROR`.
+//! - The callback must not block and must not call the blocking `supabase_*`
+//!   functions, which would re-enter the runtime it is running on.
+//! - The callback may free the client; if that was the last client on the runtime,
+//!   the runtime shuts down in the background and any other pending requests
+//!   complete with `SUPABASE_RUNTIME_ERROR`.
+//!
+//! ```c
+//! static void on_done(SupabaseError error, const char* result, size_t len, void* user_data) {
+//!     printf("select finished (%d): %.*s\n", error, (int)len, result);
+//! }
+//!
+//! SupabaseRequest* request = supabase_database_select_async(client, "profiles", "*", on_done, NULL);
+//! /* ... keep doing other work ... */
+//! supabase_request_free(request);
+//! ```
+
+use std::ffi::CString;
+use std::future::Future;
+use std::os::raw::{c_char, c_void};
+use std::ptr;
+use std::sync::{Arc, Condvar, Mutex};
+
+use super::{
+    c_json_arg, c_str_arg, c_str_arg_or, ops, set_last_error, write_string_to_buffer, LastError,
+    SupabaseClient, SupabaseError,
+};
+
+/// Completion callback invoked once a request finishes
+///
+/// `result` is NUL-terminated and `result_len` excludes the terminator.
+pub type SupabaseCompletionCallback = Option<
+    unsafe extern "C" fn(
+        error: SupabaseError,
+        result: *const c_char,
+        result_len: usize,
+        user_data: *mut c_void,
+    ),
+>;
+
+/// Opaque handle to an in-flight asynchronous request
+pub struct SupabaseRequest {
+    state: Arc<RequestState>,
+    abort: tokio::task::AbortHandle,
+}
+
+/// Completion state shared between a request handle and its task
+#[derive(Debug, Default)]
+struct RequestState {
+    outcome: Mutex<Option<Completion>>,
+    finished: Condvar,
+}
+
+/// Final outcome of a request
+#[derive(Debug, Clone)]
+struct Completion {
+    error: SupabaseError,
+    payload: Arc<CString>,
+}
+
+/// Caller-provided context pointer carried to the completion callback
+struct UserData(*mut c_void);
+
+// SAFETY: the pointer is never dereferenced on the Rust side; it is handed back
+// verbatim to the caller's callback, which owns its thread-safety contract.
+unsafe impl Send for UserData {}
+
+/// Delivers the completion exactly once, including when the task is dropped
+/// before finishing (cancellation or runtime shutdown)
+struct CompletionGuard {
+    state: Arc<RequestState>,
+    callback: SupabaseCompletionCallback,
+    user_data: UserData,
+    delivered: bool,
+}
+
+impl CompletionGuard {
+    fn deliver(&mut self, outcome: crate::Result<String>) {
+        if self.delivered {
+            return;
+        }
+        self.delivered = true;
+
+        let (error, message) = match outcome {
+            Ok(data) => (SupabaseError::Success, data),
+            // Recorded on the waiting thread by `supabase_request_wait`, not this worker
+            Err(err) => (SupabaseError::code_for(&err), err.to_string()),
+        };
+
+        // A payload C cannot represent is a failure, never data; same code as
+        // `write_string_to_buffer` uses for the synchronous path
+        let (error, payload) = match CString::new(message) {
+            Ok(payload) => (error, payload),
+            Err(_) => (
+                SupabaseError::UnknownError,
+                CString::new("Response contained an interior NUL byte").unwrap_or_default(),
+            ),
+        };
+
+        let completion = Completion {
+            error,
+            payload: Arc::new(payload),
+        };
+
+        if let Ok(mut outcome) = self.state.outcome.lock() {
+            *outcome = Some(completion.clone());
+        }
+        self.state.finished.notify_all();
+
+        if let Some(callback) = self.callback {
+            // SAFETY: the caller guarantees the callback is valid for the request's lifetime
+            unsafe {
+                callback(
+                    completion.error,
+                    completion.payload.as_ptr(),
+                    completion.payload.as_bytes().len(),
+                    self.user_data.0,
+                );
+            }
+        }
+    }
+}
+
+impl Drop for CompletionGuard {
+    fn drop(&mut self) {
+        self.deliver(Err(crate::Error::platform("Request cancelled")));
+    }
+}
+
+/// Spawn `operation` onto the client's runtime and wrap it in a request handle
+fn spawn_request<F>(
+    client: &SupabaseClient,
+    callback: SupabaseCompletionCallback,
+    user_data: *mut c_void,
+    operation: F,
+) -> *mut SupabaseRequest
+where
+    F: Future<Output = crate::Result<String>> + Send + 'static,
+{
+    let state = Arc::new(RequestState::default());
+    let mut guard = CompletionGuard {
+        state: Arc::clone(&state),
+        callback,
+        user_data: UserData(user_data),
+        delivered: false,
+    };
+
+    let handle = client.runtime.spawn(async move {
+        let outcome = operation.await;
+        guard.deliver(outcome);
+    });
+
+    Box::into_raw(Box::new(SupabaseRequest {
+        state,
+        abort: handle.abort_handle(),
+    }))
+}
+
+/// Sign in with email and password without blocking
+///
+/// # Safety
+///
+/// `client`, `email` and `password` must be valid pointers; `callback` may be NULL.
+/// Returns NULL (without invoking the callback) on invalid input.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_auth_sign_in_async(
+    client: *mut SupabaseClient,
+    email: *const c_char,
+    password: *const c_char,
+    callback: SupabaseCompletionCallback,
+    user_data: *mut c_void,
+) -> *mut SupabaseRequest {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+    let client_ref = &(*client);
+
+    let (Some(email), Some(password)) = (c_str_arg(email), c_str_arg(password)) else {
+        return ptr::null_mut();
+    };
+    let (email, password) = (email.to_string(), password.to_string());
+    let api = client_ref.client.clone();
+
+    spawn_request(client_ref, callback, user_data, async move {
+        ops::auth_sign_in(&api, &email, &password).await
+    })
+}
+
+/// Sign up with email and password without blocking
+///
+/// # Safety
+///
+/// `client`, `email` and `password` must be valid pointers; `callback` may be NULL.
+/// Returns NULL (without invoking the callback) on invalid input.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_auth_sign_up_async(
+    client: *mut SupabaseClient,
+    email: *const c_char,
+    password: *const c_char,
+    callback: SupabaseCompletionCallback,
+    user_data: *mut c_void,
+) -> *mut SupabaseRequest {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+    let client_ref = &(*client);
+
+    let (Some(email), Some(password)) = (c_str_arg(email), c_str_arg(password)) else {
+        return ptr::null_mut();
+    };
+    let (email, password) = (email.to_string(), password.to_string());
+    let api = client_ref.client.clone();
+
+    spawn_request(client_ref, callback, user_data, async move {
+        ops::auth_sign_up(&api, &email, &password).await
+    })
+}
+
+/// Execute a database select query without blocking
+///
+/// # Safety
+///
+/// `client` and `table` must be valid pointers; `columns` may be NULL (`*`) and
+/// `callback` may be NULL. Returns NULL (without invoking the callback) on invalid input.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_database_select_async(
+    client: *mut SupabaseClient,
+    table: *const c_char,
+    columns: *const c_char,
+    callback: SupabaseCompletionCallback,
+    user_data: *mut c_void,
+) -> *mut SupabaseRequest {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+    let client_ref = &(*client);
+
+    let (Some(table), Some(columns)) = (c_str_arg(table), c_str_arg_or(columns, "*")) else {
+        return ptr::null_mut();
+    };
+    let (table, columns) = (table.to_string(), columns.to_string());
+    let api = client_ref.client.clone();
+
+    spawn_request(client_ref, callback, user_data, async move {
+        ops::database_select(&api, &table, &columns).await
+    })
+}
+
+/// Execute a database insert without blocking
+///
+/// # Safety
+///
+/// `client`, `table` and `json_data` must be valid pointers; `callback` may be NULL.
+/// Returns NULL (without invoking the callback) on invalid input or malformed JSON.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_database_insert_async(
+    client: *mut SupabaseClient,
+    table: *const c_char,
+    json_data: *const c_char,
+    callback: SupabaseCompletionCallback,
+    user_data: *mut c_void,
+) -> *mut SupabaseRequest {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+    let client_ref = &(*client);
+
+    let (Some(table), Some(json_value)) = (c_str_arg(table), c_json_arg(json_data)) else {
+        return ptr::null_mut();
+    };
+    let table = table.to_string();
+    let api = client_ref.client.clone();
+
+    spawn_request(client_ref, callback, user_data, async move {
+        ops::database_insert(&api, &table, json_value).await
+    })
+}
+
+/// List storage buckets without blocking
+///
+/// # Safety
+///
+/// `client` must be a valid pointer; `callback` may be NULL.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_storage_list_buckets_async(
+    client: *mut SupabaseClient,
+    callback: SupabaseCompletionCallback,
+    user_data: *mut c_void,
+) -> *mut SupabaseRequest {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+    let client_ref = &(*client);
+    let api = client_ref.client.clone();
+
+    spawn_request(client_ref, callback, user_data, async move {
+        ops::storage_list_buckets(&api).await
+    })
+}
+
+/// Invoke an edge function without blocking
+///
+/// # Safety
+///
+/// `client` and `function_name` must be valid pointers; `json_payload` and
+/// `callback` may be NULL. Returns NULL (without invoking the callback) on invalid input.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_functions_invoke_async(
+    client: *mut SupabaseClient,
+    function_name: *const c_char,
+    json_payload: *const c_char,
+    callback: SupabaseCompletionCallback,
+    user_data: *mut c_void,
+) -> *mut SupabaseRequest {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+    let client_ref = &(*client);
+
+    let Some(function_name) = c_str_arg(function_name) else {
+        return ptr::null_mut();
+    };
+    let payload = if json_payload.is_null() {
+        None
+    } else {
+        match c_json_arg(json_payload) {
+            Some(value) => Some(value),
+            None => return ptr::null_mut(),
+        }
+    };
+    let function_name = function_name.to_string();
+    let api = client_ref.client.clone();
+
+    spawn_request(client_ref, callback, user_data, async move {
+        ops::functions_invoke(&api, &function_name, payload).await
+    })
+}
+
+/// Check whether a request has completed (successfully, with an error, or cancelled)
+///
+/// # Safety
+///
+/// `request` must be a valid pointer returned by a `*_async` function
+#[no_mangle]
+pub unsafe extern "C" fn supabase_request_is_done(request: *const SupabaseRequest) -> bool {
+    if request.is_null() {
+        return false;
+    }
+    let request = &*request;
+    request
+        .state
+        .outcome
+        .lock()
+        .map(|outcome| outcome.is_some())
+        .unwrap_or(true)
+}
+
+/// Block until a request completes and copy its result (or error message) into `result`
+///
+/// Returns the request's completion code, or `SUPABASE_INVALID_INPUT` if the
+/// buffer is too small. Must not be called from inside a completion callback.
+///
+/// # Safety
+///
+/// `request` must be a valid pointer returned by a `*_async` function;
+/// `result` may be NULL when only the completion code is needed.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_request_wait(
+    request: *mut SupabaseRequest,
+    result: *mut c_char,
+    result_len: usize,
+) -> SupabaseError {
+    if request.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    let state = &(*request).state;
+
+    let completion = {
+        let Ok(mut outcome) = state.outcome.lock() else {
+            return SupabaseError::RuntimeError;
+        };
+        loop {
+            if let Some(completion) = outcome.as_ref() {
+                break completion.clone();
+            }
+            outcome = match state.finished.wait(outcome) {
+                Ok(guard) => guard,
+                Err(_) => return SupabaseError::RuntimeError,
+            };
+        }
+    };
+
+    if !matches!(completion.error, SupabaseError::Success) {
+        set_last_error(LastError::Message(
+            completion.error,
+            completion.payload.clone(),
+        ));
+    }
+
+    if result.is_null() {
+        return completion.error;
+    }
+
+    let payload = completion.payload.to_string_lossy();
+    match write_string_to_buffer(&payload, result, result_len) {
+        SupabaseError::Success => completion.error,
+        buffer_error => buffer_error,
+    }
+}
+
+/// Cancel a pending request
+///
+/// The callback is still invoked (with `SUPABASE_RUNTIME_ERROR`); cancelling a
+/// completed request has no effect.
+///
+/// # Safety
+///
+/// `request` must be a valid pointer returned by a `*_async` function
+#[no_mangle]
+pub unsafe extern "C" fn supabase_request_cancel(request: *mut SupabaseRequest) {
+    if !request.is_null() {
+        (*request).abort.abort();
+    }
+}
+
+/// Release a request handle
+///
+/// Freeing a pending request does not cancel it: the operation keeps running
+/// and its callback still fires.
+///
+/// # Safety
+///
+/// `request` must be a valid pointer returned by a `*_async` function and must
+/// not be used afterwards
+#[no_mangle]
+pub unsafe extern "C" fn supabase_request_free(request: *mut SupabaseRequest) {
+    if !request.is_null() {
+        let _ = Box::from_raw(request);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::super::{supabase_client_free, supabase_client_new};
+    use super::*;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+
+    unsafe extern "C" fn count_completion(
+        _error: SupabaseError,
+        _result: *const c_char,
+        _result_len: usize,
+        user_data: *mut c_void,
+    ) {
+        let calls = &*(user_data as *const AtomicUsize);
+        calls.fetch_add(1, Ordering::SeqCst);
+    }
+
+    unsafe fn unreachable_client() -> *mut SupabaseClient {
+        // Nothing listens on port 1, so requests fail fast without network access
+        let url = CString::new("http://127.0.0.1:1").unwrap();
+        let key = CString::new("test-key").unwrap();
+        supabase_client_new(url.as_ptr(), key.as_ptr())
+    }
+
+    #[test]
+    fn test_async_invalid_input_returns_null() {
+        let table = CString::new("profiles").unwrap();
+        unsafe {
+            let request = supabase_database_select_async(
+                ptr::null_mut(),
+                table.as_ptr(),
+                ptr::null(),
+                None,
+                ptr::null_mut(),
+            );
+            assert!(request.is_null());
+
+            let client = unreachable_client();
+            let request = supabase_database_select_async(
+                client,
+                ptr::null(),
+                ptr::null(),
+                None,
+                ptr::null_mut(),
+            );
+            assert!(request.is_null());
+
+            let bad_json = CString::new("{not json").unwrap();
+            let request = supabase_database_insert_async(
+                client,
+                table.as_ptr(),
+                bad_json.as_ptr(),
+                None,
+                ptr::null_mut(),
+            );
+            assert!(request.is_null());
+
+            supabase_client_free(client);
+        }
+    }
+
+    #[test]
+    fn test_async_completion_fires_once() {
+        let calls = AtomicUsize::new(0);
+        let table = CString::new("profiles").unwrap();
+        let mut buffer = [0 as c_char; 512];
+
+        unsafe {
+            let client = unreachable_client();
+            let request = supabase_database_select_async(
+                client,
+                table.as_ptr(),
+                ptr::null(),
+                Some(count_completion),
+                &calls as *const AtomicUsize as *mut c_void,
+            );
+            assert!(!request.is_null());
+
+            let error = supabase_request_wait(request, buffer.as_mut_ptr(), buffer.len());
+            assert!(!matches!(error, SupabaseError::Success));
+            assert!(supabase_request_is_done(request));
+
+            // Cancelling after completion must not deliver a second callback
+            supabase_request_cancel(request);
+            supabase_request_free(request);
+            supabase_client_free(client);
+        }
+
+        assert_eq!(calls.load(Ordering::SeqCst), 1);
+    }
+
+    #[test]
+    fn test_async_interior_nul_is_an_error() {
+        unsafe {
+            let client = unreachable_client();
+            let request = spawn_request(&*client, None, ptr::null_mut(), async {
+                Ok::<_, crate::Error>("data\0more".to_string())
+            });
+
+            let error = supabase_request_wait(request, ptr::null_mut(), 0);
+            assert!(matches!(error, SupabaseError::UnknownError));
+
+            supabase_request_free(request);
+            supabase_client_free(client);
+        }
+    }
+
+    #[test]
+    fn test_async_cancel_reports_runtime_error() {
+        let calls = AtomicUsize::new(0);
+
+        unsafe {
+            let client = unreachable_client();
+            let request = spawn_request(
+                &*client,
+                Some(count_completion),
+                &calls as *const AtomicUsize as *mut c_void,
+                std::future::pending::<crate::Result<String>>(),
+            );
+            assert!(!supabase_request_is_done(request));
+
+            supabase_request_cancel(request);
+            let error = supabase_request_wait(request, ptr::null_mut(), 0);
+            assert!(matches!(error, SupabaseError::RuntimeError));
+
+            supabase_request_free(request);
+            supabase_client_free(client);
+        }
+
+        assert_eq!(calls.load(Ordering::SeqCst), 1);
+    }
+}
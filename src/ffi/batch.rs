@@ -0,0 +1,248 @@
+//! Batched request submission for the C API
+//!
+//! A [`SupabaseBatch`] queues REST operations and sends them through
+//! [`Performance`]'s batch processor: single-row inserts into the same table are
+//! merged into bulk inserts, other operations run concurrently with a bounded
+//! number in flight, and the queue is flushed automatically on size or time.
+//!
+//! ```c
+//! SupabaseBatch* batch = supabase_batch_new(client, 500, 50, 8);
+//!
+//! for (int i = 0; i < n_events; i++) {
+//!     supabase_batch_add(batch, event_ids[i], "POST", "/rest/v1/events", event_json[i], 0);
+//! }
+//!
+//! SupabaseBuffer* results = NULL;
+//! supabase_batch_flush(batch, &results);   /* JSON array of {id, status, data, error} */
+//! supabase_buffer_free(results);
+//! supabase_batch_free(batch);
+//! ```
+
+use std::collections::HashMap;
+use std::os::raw::c_char;
+use std::ptr;
+use std::sync::Arc;
+use std::time::Duration;
+
+use super::runtime::SharedRuntime;
+use super::{c_json_arg, c_str_arg, SupabaseBuffer, SupabaseClient, SupabaseError};
+use crate::performance::{
+    BatchConfig, BatchOperation, CacheConfig, ConnectionPoolConfig, Performance,
+};
+
+/// Opaque handle to a queue of batched operations
+pub struct SupabaseBatch {
+    runtime: Arc<SharedRuntime>,
+    performance: Performance,
+    base_url: String,
+}
+
+/// Create a batch queue bound to `client`
+///
+/// Zero values keep the defaults (50 operations per batch, 100 ms flush
+/// interval, 8 requests in flight).
+///
+/// # Safety
+///
+/// `client` must be a valid pointer. The batch may outlive the client.
+/// Returns NULL on error
+#[no_mangle]
+pub unsafe extern "C" fn supabase_batch_new(
+    client: *mut SupabaseClient,
+    max_batch_size: usize,
+    flush_interval_ms: u32,
+    max_in_flight: usize,
+) -> *mut SupabaseBatch {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+    let client_ref = &(*client);
+
+    let mut batch_config = BatchConfig::default();
+    if max_batch_size > 0 {
+        batch_config.max_batch_size = max_batch_size;
+    }
+    if flush_interval_ms > 0 {
+        batch_config.flush_interval = Duration::from_millis(u64::from(flush_interval_ms));
+    }
+    if max_in_flight > 0 {
+        batch_config.max_in_flight = max_in_flight;
+    }
+
+    let performance = match Performance::new_with_config(
+        client_ref.client.config(),
+        client_ref.client.http_client(),
+        ConnectionPoolConfig::default(),
+        CacheConfig::default(),
+        batch_config,
+    ) {
+        Ok(performance) => performance,
+        Err(_) => return ptr::null_mut(),
+    };
+
+    Box::into_raw(Box::new(SupabaseBatch {
+        runtime: Arc::clone(&client_ref.runtime),
+        performance,
+        base_url: client_ref.client.url().trim_end_matches('/').to_string(),
+    }))
+}
+
+/// Queue an operation
+///
+/// `path` is relative to the project URL (e.g. `/rest/v1/events`); `json_body`
+/// may be NULL. Lower `priority` values are sent first.
+///
+/// # Safety
+///
+/// `batch`, `id`, `method` and `path` must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_batch_add(
+    batch: *mut SupabaseBatch,
+    id: *const c_char,
+    method: *const c_char,
+    path: *const c_char,
+    json_body: *const c_char,
+    priority: u8,
+) -> SupabaseError {
+    if batch.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    let batch_ref = &(*batch);
+
+    let (Some(id_str), Some(method_str), Some(path_str)) =
+        (c_str_arg(id), c_str_arg(method), c_str_arg(path))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+    let body = if json_body.is_null() {
+        None
+    } else {
+        match c_json_arg(json_body) {
+            Some(value) => Some(value),
+            None => return SupabaseError::InvalidInput,
+        }
+    };
+
+    let operation = BatchOperation {
+        id: id_str.to_string(),
+        method: method_str.to_string(),
+        url: format!(
+            "{}/{}",
+            batch_ref.base_url,
+            path_str.trim_start_matches('/')
+        ),
+        headers: HashMap::new(),
+        body,
+        priority,
+    };
+
+    match batch_ref
+        .runtime
+        .block_on(batch_ref.performance.add_to_batch(operation))
+    {
+        Ok(()) => SupabaseError::Success,
+        Err(err) => err.into(),
+    }
+}
+
+/// Send everything still queued and collect all results not yet reported
+///
+/// `*out` receives a JSON array of `{"id", "status", "data", "error"}` objects,
+/// including results of automatic flushes since the previous call.
+///
+/// # Safety
+///
+/// `batch` and `out` must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_batch_flush(
+    batch: *mut SupabaseBatch,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if batch.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    let batch_ref = &(*batch);
+    *out = ptr::null_mut();
+
+    let results = batch_ref
+        .runtime
+        .block_on(batch_ref.performance.process_batch())
+        .and_then(|results| Ok(serde_json::to_vec(&results)?));
+
+    match results {
+        Ok(json) => {
+            *out = Box::into_raw(Box::new(SupabaseBuffer::new(json)));
+            SupabaseError::Success
+        }
+        Err(err) => err.into(),
+    }
+}
+
+/// Release a batch queue
+///
+/// Operations still queued are discarded; call `supabase_batch_flush` first to
+/// send them.
+///
+/// # Safety
+///
+/// `batch` must be NULL or a valid pointer returned by `supabase_batch_new` and
+/// must not be used afterwards
+#[no_mangle]
+pub unsafe extern "C" fn supabase_batch_free(batch: *mut SupabaseBatch) {
+    if !batch.is_null() {
+        let _ = Box::from_raw(batch);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::super::{supabase_buffer_data, supabase_buffer_free};
+    use super::super::{supabase_client_free, supabase_client_new};
+    use super::*;
+    use std::ffi::{CStr, CString};
+
+    #[test]
+    fn test_batch_flush_reports_every_operation() {
+        // Nothing listens on port 1, so requests fail fast without network access
+        let url = CString::new("http://127.0.0.1:1").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let method = CString::new("POST").unwrap();
+        let path = CString::new("/rest/v1/events").unwrap();
+        let body = CString::new(r#"{"kind":"click"}"#).unwrap();
+
+        unsafe {
+            let client = supabase_client_new(url.as_ptr(), key.as_ptr());
+            let batch = supabase_batch_new(client, 0, 0, 0);
+            assert!(!batch.is_null());
+
+            for id in ["a", "b"] {
+                let id = CString::new(id).unwrap();
+                let error = supabase_batch_add(
+                    batch,
+                    id.as_ptr(),
+                    method.as_ptr(),
+                    path.as_ptr(),
+                    body.as_ptr(),
+                    0,
+                );
+                assert!(matches!(error, SupabaseError::Success));
+            }
+
+            let mut results = ptr::null_mut();
+            let error = supabase_batch_flush(batch, &mut results);
+            assert!(matches!(error, SupabaseError::Success));
+
+            let json = CStr::from_ptr(supabase_buffer_data(results))
+                .to_str()
+                .unwrap();
+            let parsed: Vec<serde_json::Value> = serde_json::from_str(json).unwrap();
+            assert_eq!(parsed.len(), 2);
+            assert_eq!(parsed[0]["id"], "a");
+            assert_eq!(parsed[1]["id"], "b");
+
+            supabase_buffer_free(results);
+            supabase_batch_free(batch);
+            supabase_client_free(client);
+        }
+    }
+}
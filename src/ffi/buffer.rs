@@ -0,0 +1,408 @@
+//! Library-owned result buffers
+//!
+//! The `*_buffer` entry points hand results back as an opaque [`SupabaseBuffer`]
+//! instead of copying them into a caller-provided array. The buffer is sized to
+//! the response, so callers never have to guess a capacity or repeat a request
+//! because the result did not fit.
+//!
+//! ```c
+//! SupabaseBuffer* rows = NULL;
+//! if (supabase_database_select_buffer(client, "profiles", "*", &rows) == SUPABASE_SUCCESS) {
+//!     consume(supabase_buffer_data(rows), supabase_buffer_len(rows));
+//!     supabase_buffer_free(rows);
+//! }
+//! ```
+
+use std::os::raw::c_char;
+use std::ptr;
+
+use super::{c_json_arg, c_str_arg, c_str_arg_or, ops, SupabaseClient, SupabaseError};
+
+/// Opaque, NUL-terminated byte buffer owned by the library
+#[derive(Debug)]
+pub struct SupabaseBuffer {
+    /// Contents followed by a single NUL terminator
+    data: Vec<u8>,
+}
+
+impl SupabaseBuffer {
+    /// Take ownership of `data`, appending the NUL terminator in place
+    pub(crate) fn new(data: impl Into<Vec<u8>>) -> Self {
+        let mut data = data.into();
+        data.reserve_exact(1);
+        data.push(0);
+        Self { data }
+    }
+
+    /// Length of the contents, excluding the NUL terminator
+    pub(crate) fn len(&self) -> usize {
+        self.data.len() - 1
+    }
+}
+
+/// Publish an operation result through `out`
+///
+/// On failure `*out` is set to NULL and the message is available from
+/// `supabase_get_last_error`.
+pub(super) unsafe fn write_result_to_out(
+    data: crate::Result<impl Into<Vec<u8>>>,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    match data {
+        Ok(data) => {
+            *out = Box::into_raw(Box::new(SupabaseBuffer::new(data)));
+            SupabaseError::Success
+        }
+        Err(err) => {
+            *out = ptr::null_mut();
+            err.into()
+        }
+    }
+}
+
+/// Pointer to the buffer contents (NUL-terminated)
+///
+/// # Safety
+///
+/// `buffer` must be a valid pointer returned by a `*_buffer` function. The
+/// pointer stays valid until `supabase_buffer_free` is called.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_buffer_data(buffer: *const SupabaseBuffer) -> *const c_char {
+    if buffer.is_null() {
+        return ptr::null();
+    }
+    let buffer = &*buffer;
+    buffer.data.as_ptr() as *const c_char
+}
+
+/// Length of the buffer contents in bytes, excluding the NUL terminator
+///
+/// # Safety
+///
+/// `buffer` must be NULL or a valid pointer returned by a `*_buffer` function
+#[no_mangle]
+pub unsafe extern "C" fn supabase_buffer_len(buffer: *const SupabaseBuffer) -> usize {
+    if buffer.is_null() {
+        return 0;
+    }
+    let buffer = &*buffer;
+    buffer.len()
+}
+
+/// Release a result buffer
+///
+/// # Safety
+///
+/// `buffer` must be NULL or a valid pointer returned by a `*_buffer` function and
+/// must not be used afterwards
+#[no_mangle]
+pub unsafe extern "C" fn supabase_buffer_free(buffer: *mut SupabaseBuffer) {
+    if !buffer.is_null() {
+        let _ = Box::from_raw(buffer);
+    }
+}
+
+/// Sign in with email and password, returning the session in a new buffer
+///
+/// # Safety
+///
+/// All parameters must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_auth_sign_in_buffer(
+    client: *mut SupabaseClient,
+    email: *const c_char,
+    password: *const c_char,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(email_str), Some(password_str)) = (c_str_arg(email), c_str_arg(password)) else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let auth_result = client_ref.runtime.block_on(ops::auth_sign_in(
+        &client_ref.client,
+        email_str,
+        password_str,
+    ));
+
+    write_result_to_out(auth_result, out)
+}
+
+/// Sign up with email and password, returning the session in a new buffer
+///
+/// # Safety
+///
+/// All parameters must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_auth_sign_up_buffer(
+    client: *mut SupabaseClient,
+    email: *const c_char,
+    password: *const c_char,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(email_str), Some(password_str)) = (c_str_arg(email), c_str_arg(password)) else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let auth_result = client_ref.runtime.block_on(ops::auth_sign_up(
+        &client_ref.client,
+        email_str,
+        password_str,
+    ));
+
+    write_result_to_out(auth_result, out)
+}
+
+/// Execute a database select query, returning the rows in a new buffer
+///
+/// # Safety
+///
+/// All parameters must be valid pointers; `columns` may be NULL (`*`)
+#[no_mangle]
+pub unsafe extern "C" fn supabase_database_select_buffer(
+    client: *mut SupabaseClient,
+    table: *const c_char,
+    columns: *const c_char,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(table_str), Some(columns_str)) = (c_str_arg(table), c_str_arg_or(columns, "*"))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let db_result = client_ref.runtime.block_on(ops::database_select(
+        &client_ref.client,
+        table_str,
+        columns_str,
+    ));
+
+    write_result_to_out(db_result, out)
+}
+
+/// Execute a database insert, returning the inserted rows in a new buffer
+///
+/// # Safety
+///
+/// All parameters must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_database_insert_buffer(
+    client: *mut SupabaseClient,
+    table: *const c_char,
+    json_data: *const c_char,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(table_str), Some(json_value)) = (c_str_arg(table), c_json_arg(json_data)) else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let db_result = client_ref.runtime.block_on(ops::database_insert(
+        &client_ref.client,
+        table_str,
+        json_value,
+    ));
+
+    write_result_to_out(db_result, out)
+}
+
+/// Execute a database select query, returning the server's JSON unparsed
+///
+/// The response body is moved into the buffer without being parsed or
+/// re-serialized.
+///
+/// # Safety
+///
+/// All parameters must be valid pointers; `columns` may be NULL (`*`)
+#[no_mangle]
+pub unsafe extern "C" fn supabase_database_select_raw(
+    client: *mut SupabaseClient,
+    table: *const c_char,
+    columns: *const c_char,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(table_str), Some(columns_str)) = (c_str_arg(table), c_str_arg_or(columns, "*"))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let db_result = client_ref.runtime.block_on(ops::database_select_raw(
+        &client_ref.client,
+        table_str,
+        columns_str,
+    ));
+
+    write_result_to_out(db_result, out)
+}
+
+/// Insert `json_len` bytes of JSON into a table without parsing them
+///
+/// The document is forwarded as the request body verbatim and PostgREST's
+/// response is returned unparsed.
+///
+/// # Safety
+///
+/// `client`, `table` and `out` must be valid pointers; `json_data` must point to
+/// at least `json_len` readable bytes
+#[no_mangle]
+pub unsafe extern "C" fn supabase_database_insert_raw(
+    client: *mut SupabaseClient,
+    table: *const c_char,
+    json_data: *const c_char,
+    json_len: usize,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() || json_data.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let Some(table_str) = c_str_arg(table) else {
+        return SupabaseError::InvalidInput;
+    };
+    let json =
+        bytes::Bytes::copy_from_slice(std::slice::from_raw_parts(json_data as *const u8, json_len));
+
+    let db_result = client_ref.runtime.block_on(ops::database_insert_raw(
+        &client_ref.client,
+        table_str,
+        json,
+    ));
+
+    write_result_to_out(db_result, out)
+}
+
+/// List storage buckets into a new buffer
+///
+/// # Safety
+///
+/// All parameters must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_storage_list_buckets_buffer(
+    client: *mut SupabaseClient,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let storage_result = client_ref
+        .runtime
+        .block_on(ops::storage_list_buckets(&client_ref.client));
+
+    write_result_to_out(storage_result, out)
+}
+
+/// Invoke an edge function, returning its response in a new buffer
+///
+/// # Safety
+///
+/// All parameters must be valid pointers; `json_payload` may be NULL
+#[no_mangle]
+pub unsafe extern "C" fn supabase_functions_invoke_buffer(
+    client: *mut SupabaseClient,
+    function_name: *const c_char,
+    json_payload: *const c_char,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let Some(function_name_str) = c_str_arg(function_name) else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let payload = if json_payload.is_null() {
+        None
+    } else {
+        match c_json_arg(json_payload) {
+            Some(value) => Some(value),
+            None => return SupabaseError::InvalidInput,
+        }
+    };
+
+    let function_result = client_ref.runtime.block_on(ops::functions_invoke(
+        &client_ref.client,
+        function_name_str,
+        payload,
+    ));
+
+    write_result_to_out(function_result, out)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::super::{supabase_client_free, supabase_client_new};
+    use super::*;
+    use std::ffi::{CStr, CString};
+
+    #[test]
+    fn test_buffer_round_trip() {
+        let buffer = Box::into_raw(Box::new(SupabaseBuffer::new(String::from("[{\"id\":1}]"))));
+        unsafe {
+            assert_eq!(supabase_buffer_len(buffer), 10);
+            let contents = CStr::from_ptr(supabase_buffer_data(buffer));
+            assert_eq!(contents.to_str().unwrap(), "[{\"id\":1}]");
+            supabase_buffer_free(buffer);
+        }
+    }
+
+    #[test]
+    fn test_buffer_null_handling() {
+        unsafe {
+            assert!(supabase_buffer_data(ptr::null()).is_null());
+            assert_eq!(supabase_buffer_len(ptr::null()), 0);
+            supabase_buffer_free(ptr::null_mut());
+        }
+    }
+
+    #[test]
+    fn test_buffer_out_cleared_on_error() {
+        let url = CString::new("http://127.0.0.1:1").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let table = CString::new("profiles").unwrap();
+        let mut out = ptr::NonNull::<SupabaseBuffer>::dangling().as_ptr();
+
+        unsafe {
+            let client = supabase_client_new(url.as_ptr(), key.as_ptr());
+            let error =
+                supabase_database_select_buffer(client, table.as_ptr(), ptr::null(), &mut out);
+            assert!(!matches!(error, SupabaseError::Success));
+            assert!(out.is_null());
+            supabase_client_free(client);
+        }
+    }
+}
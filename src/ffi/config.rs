@@ -0,0 +1,372 @@
+//! Client creation with connection settings
+//!
+//! `supabase_client_new_with_config` exposes the connection-level parts of
+//! [`HttpConfig`] to C and can open connections before returning, so the first
+//! requests after startup do not pay DNS, TCP and TLS setup. A zeroed
+//! [`SupabaseClientConfig`] selects the defaults used by `supabase_client_new`.
+//!
+//! ```c
+//! SupabaseClientConfig config = {0};
+//! config.dns_cache_ttl_seconds = 300;
+//! config.warm_up_connections = 8;
+//!
+//! SupabaseClient* client =
+//!     supabase_client_new_with_config(NULL, "https://example.supabase.co", "key", &config);
+//! ```
+
+use std::os::raw::{c_char, c_int};
+use std::ptr;
+use std::sync::Arc;
+
+use tracing::debug;
+
+use super::{c_str_arg, SharedRuntime, SupabaseClient, SupabaseError, SupabaseRuntime};
+use crate::types::{
+    CompressionConfig, ContentEncoding, DatabaseConfig, FunctionsConfig, HttpConfig, HttpVersion,
+    StorageConfig, SupabaseConfig,
+};
+use crate::Error;
+
+/// Connection settings for `supabase_client_new_with_config`; 0 selects each default
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct SupabaseClientConfig {
+    /// Request timeout (default 60)
+    pub timeout_seconds: u32,
+    /// Connection timeout (default 10)
+    pub connect_timeout_seconds: u32,
+    /// 0 negotiates HTTP/2 during the TLS handshake, 1 forces HTTP/1.1 and 2
+    /// speaks HTTP/2 with prior knowledge
+    pub http_version: c_int,
+    /// Grow HTTP/2 flow-control windows with the measured bandwidth
+    pub http2_adaptive_window: bool,
+    /// Idle connections kept per host (default unlimited)
+    pub pool_max_idle_per_host: u32,
+    /// Seconds an idle connection stays pooled (default 90)
+    pub pool_idle_timeout_seconds: u32,
+    /// TCP keepalive interval (default off)
+    pub tcp_keepalive_seconds: u32,
+    /// Seconds resolved addresses are reused (default off)
+    pub dns_cache_ttl_seconds: u32,
+    /// Connections opened before the client is returned (default none)
+    pub warm_up_connections: u32,
+    /// Response encodings to accept: 1 gzip, 2 deflate, 4 zstd (default none)
+    pub accept_encodings: u32,
+    /// Encoding for JSON request bodies: 0 none, 1 gzip, 2 deflate, 3 zstd
+    pub request_encoding: u32,
+}
+
+impl SupabaseClientConfig {
+    /// The HTTP configuration these settings describe; `None` for an unknown version
+    fn http_config(&self) -> Option<HttpConfig> {
+        let defaults = HttpConfig::default();
+        let or_default = |value: u32, default: u64| match value {
+            0 => default,
+            value => u64::from(value),
+        };
+
+        Some(HttpConfig {
+            timeout: or_default(self.timeout_seconds, defaults.timeout),
+            connect_timeout: or_default(self.connect_timeout_seconds, defaults.connect_timeout),
+            http_version: match self.http_version {
+                0 => HttpVersion::Negotiate,
+                1 => HttpVersion::Http1Only,
+                2 => HttpVersion::Http2PriorKnowledge,
+                _ => return None,
+            },
+            http2_adaptive_window: self.http2_adaptive_window,
+            pool_max_idle_per_host: match self.pool_max_idle_per_host {
+                0 => defaults.pool_max_idle_per_host,
+                value => Some(value as usize),
+            },
+            pool_idle_timeout: or_default(
+                self.pool_idle_timeout_seconds,
+                defaults.pool_idle_timeout,
+            ),
+            tcp_keepalive: u64::from(self.tcp_keepalive_seconds),
+            dns_cache_ttl: u64::from(self.dns_cache_ttl_seconds),
+            ..defaults
+        })
+    }
+
+    /// The content encodings these settings describe; `None` for an unknown encoding
+    fn compression_config(&self) -> Option<CompressionConfig> {
+        const ACCEPT: [(u32, ContentEncoding); 3] = [
+            (4, ContentEncoding::Zstd),
+            (1, ContentEncoding::Gzip),
+            (2, ContentEncoding::Deflate),
+        ];
+        if self.accept_encodings & !7 != 0 {
+            return None;
+        }
+
+        Some(CompressionConfig {
+            accept: ACCEPT
+                .iter()
+                .filter(|(bit, _)| self.accept_encodings & bit != 0)
+                .map(|&(_, encoding)| encoding)
+                .collect(),
+            request: match self.request_encoding {
+                0 => None,
+                1 => Some(ContentEncoding::Gzip),
+                2 => Some(ContentEncoding::Deflate),
+                3 => Some(ContentEncoding::Zstd),
+                _ => return None,
+            },
+            ..Default::default()
+        })
+    }
+}
+
+/// Create a client with explicit connection settings
+///
+/// `runtime` may be NULL to give the client its own runtime; `config` may be
+/// NULL for the defaults. With `warm_up_connections` set, the call blocks until
+/// the warm-up requests finish; a failed warm-up is not an error.
+///
+/// # Safety
+///
+/// `runtime` must be NULL or a valid pointer returned by `supabase_runtime_new`;
+/// `url` and `key` must be valid C strings; `config` must be NULL or point to a
+/// `SupabaseClientConfig`.
+/// Returns NULL on error
+#[no_mangle]
+pub unsafe extern "C" fn supabase_client_new_with_config(
+    runtime: *mut SupabaseRuntime,
+    url: *const c_char,
+    key: *const c_char,
+    config: *const SupabaseClientConfig,
+) -> *mut SupabaseClient {
+    let (Some(url_str), Some(key_str)) = (c_str_arg(url), c_str_arg(key)) else {
+        let _ = SupabaseError::from(Error::invalid_input("URL and key must be UTF-8 C strings"));
+        return ptr::null_mut();
+    };
+    let settings = if config.is_null() {
+        SupabaseClientConfig::default()
+    } else {
+        *config
+    };
+    let Some(http_config) = settings.http_config() else {
+        let _ = SupabaseError::from(Error::invalid_input(format!(
+            "Unknown HTTP version: {}",
+            settings.http_version
+        )));
+        return ptr::null_mut();
+    };
+    let Some(compression) = settings.compression_config() else {
+        let _ = SupabaseError::from(Error::invalid_input(format!(
+            "Unknown content encoding: accept {:#x}, request {}",
+            settings.accept_encodings, settings.request_encoding
+        )));
+        return ptr::null_mut();
+    };
+
+    let shared = if runtime.is_null() {
+        match tokio::runtime::Runtime::new() {
+            Ok(rt) => Arc::new(SharedRuntime::new(rt)),
+            Err(e) => {
+                let _ = SupabaseError::from(Error::platform(format!(
+                    "Failed to create runtime: {}",
+                    e
+                )));
+                return ptr::null_mut();
+            }
+        }
+    } else {
+        Arc::clone((*runtime).shared())
+    };
+
+    let client = match shared.client(SupabaseConfig {
+        url: url_str.to_string(),
+        key: key_str.to_string(),
+        http_config,
+        database_config: DatabaseConfig {
+            compression: compression.clone(),
+            ..Default::default()
+        },
+        storage_config: StorageConfig {
+            compression: compression.clone(),
+            ..Default::default()
+        },
+        functions_config: FunctionsConfig { compression },
+        ..Default::default()
+    }) {
+        Ok(client) => client,
+        Err(err) => {
+            let _ = SupabaseError::from(err);
+            return ptr::null_mut();
+        }
+    };
+
+    if settings.warm_up_connections > 0 {
+        if let Err(err) = shared.block_on(client.warm_up(settings.warm_up_connections as usize)) {
+            debug!("Connection warm-up failed: {}", err);
+        }
+    }
+
+    Box::into_raw(Box::new(SupabaseClient::new(client, shared)))
+}
+
+/// Open `connections` connections to the client's project
+///
+/// Useful to re-warm the pool after an idle period longer than the pool's idle
+/// timeout. Fails only if none of the warm-up requests got a response.
+///
+/// # Safety
+///
+/// `client` must be a valid pointer returned by a `supabase_client_new*` function
+#[no_mangle]
+pub unsafe extern "C" fn supabase_client_warm_up(
+    client: *mut SupabaseClient,
+    connections: u32,
+) -> SupabaseError {
+    if client.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    let client_ref = &(*client);
+
+    match client_ref
+        .runtime
+        .block_on(client_ref.client.warm_up(connections as usize))
+    {
+        Ok(_) => SupabaseError::Success,
+        Err(err) => err.into(),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::super::{supabase_client_free, supabase_runtime_free, supabase_runtime_new};
+    use super::*;
+    use std::ffi::CString;
+
+    #[test]
+    fn test_zeroed_config_keeps_defaults() {
+        let http = SupabaseClientConfig::default().http_config().unwrap();
+        let defaults = HttpConfig::default();
+        assert_eq!(http.timeout, defaults.timeout);
+        assert_eq!(http.connect_timeout, defaults.connect_timeout);
+        assert_eq!(http.http_version, HttpVersion::Negotiate);
+        assert_eq!(http.pool_max_idle_per_host, None);
+        assert_eq!(http.pool_idle_timeout, defaults.pool_idle_timeout);
+        assert_eq!((http.tcp_keepalive, http.dns_cache_ttl), (0, 0));
+    }
+
+    #[test]
+    fn test_config_maps_every_setting() {
+        let http = SupabaseClientConfig {
+            timeout_seconds: 5,
+            connect_timeout_seconds: 2,
+            http_version: 2,
+            http2_adaptive_window: true,
+            pool_max_idle_per_host: 16,
+            pool_idle_timeout_seconds: 300,
+            tcp_keepalive_seconds: 30,
+            dns_cache_ttl_seconds: 600,
+            warm_up_connections: 4,
+            accept_encodings: 0,
+            request_encoding: 0,
+        }
+        .http_config()
+        .unwrap();
+        assert_eq!((http.timeout, http.connect_timeout), (5, 2));
+        assert_eq!(http.http_version, HttpVersion::Http2PriorKnowledge);
+        assert!(http.http2_adaptive_window);
+        assert_eq!(http.pool_max_idle_per_host, Some(16));
+        assert_eq!(http.pool_idle_timeout, 300);
+        assert_eq!((http.tcp_keepalive, http.dns_cache_ttl), (30, 600));
+
+        let unknown = SupabaseClientConfig {
+            http_version: 7,
+            ..Default::default()
+        };
+        assert!(unknown.http_config().is_none());
+    }
+
+    #[test]
+    fn test_config_maps_compression() {
+        let none = SupabaseClientConfig::default()
+            .compression_config()
+            .unwrap();
+        assert!(none.is_disabled());
+
+        let compression = SupabaseClientConfig {
+            accept_encodings: 1 | 4,
+            request_encoding: 3,
+            ..Default::default()
+        }
+        .compression_config()
+        .unwrap();
+        assert_eq!(
+            compression.accept,
+            vec![ContentEncoding::Zstd, ContentEncoding::Gzip]
+        );
+        assert_eq!(compression.request, Some(ContentEncoding::Zstd));
+
+        for (accept_encodings, request_encoding) in [(8, 0), (0, 4)] {
+            let unknown = SupabaseClientConfig {
+                accept_encodings,
+                request_encoding,
+                ..Default::default()
+            };
+            assert!(unknown.compression_config().is_none());
+        }
+    }
+
+    #[test]
+    fn test_client_new_with_config() {
+        // Nothing listens on port 1, so the warm-up fails fast without network access
+        let url = CString::new("http://127.0.0.1:1").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let config = SupabaseClientConfig {
+            http_version: 1,
+            dns_cache_ttl_seconds: 60,
+            warm_up_connections: 2,
+            ..Default::default()
+        };
+
+        unsafe {
+            let client = supabase_client_new_with_config(
+                ptr::null_mut(),
+                url.as_ptr(),
+                key.as_ptr(),
+                &config,
+            );
+            assert!(!client.is_null());
+            assert!(matches!(
+                supabase_client_warm_up(client, 1),
+                SupabaseError::NetworkError | SupabaseError::UnknownError
+            ));
+            supabase_client_free(client);
+
+            let runtime = supabase_runtime_new(1, 0);
+            let first =
+                supabase_client_new_with_config(runtime, url.as_ptr(), key.as_ptr(), &config);
+            let second =
+                supabase_client_new_with_config(runtime, url.as_ptr(), key.as_ptr(), &config);
+            let default =
+                supabase_client_new_with_config(runtime, url.as_ptr(), key.as_ptr(), ptr::null());
+            assert!(Arc::ptr_eq(
+                &(*first).client.http_client(),
+                &(*second).client.http_client()
+            ));
+            // Different connection settings get their own connection pool
+            assert!(!Arc::ptr_eq(
+                &(*first).client.http_client(),
+                &(*default).client.http_client()
+            ));
+            supabase_runtime_free(runtime);
+            supabase_client_free(first);
+            supabase_client_free(second);
+            supabase_client_free(default);
+
+            let bad = SupabaseClientConfig {
+                http_version: -1,
+                ..Default::default()
+            };
+            let client =
+                supabase_client_new_with_config(ptr::null_mut(), url.as_ptr(), key.as_ptr(), &bad);
+            assert!(client.is_null());
+        }
+    }
+}
@@ -0,0 +1,187 @@
+//! Operation bodies shared by the blocking and asynchronous C entry points
+//!
+//! Every function here takes owned or borrowed Rust values (already decoded from
+//! C strings) and yields the JSON text handed back across the FFI boundary, so the
+//! `block_on` wrappers in [`super`] and the `*_async` wrappers in
+//! [`super::async_ops`] stay thin and behave identically.
+
+use crate::{Client, Error, Result};
+
+/// Sign in with email and password, returning the session as JSON
+pub(crate) async fn auth_sign_in(client: &Client, email: &str, password: &str) -> Result<String> {
+    let session = client
+        .auth()
+        .sign_in_with_email_and_password(email, password)
+        .await?;
+    Ok(serde_json::to_string(&session)?)
+}
+
+/// Sign up with email and password, returning the session as JSON
+pub(crate) async fn auth_sign_up(client: &Client, email: &str, password: &str) -> Result<String> {
+    let session = client
+        .auth()
+        .sign_up_with_email_and_password(email, password)
+        .await?;
+    Ok(serde_json::to_string(&session)?)
+}
+
+/// Select `columns` from `table`, returning the rows as a JSON array
+pub(crate) async fn database_select(client: &Client, table: &str, columns: &str) -> Result<String> {
+    let rows: Vec<serde_json::Value> = client
+        .database()
+        .from(table)
+        .select(columns)
+        .execute()
+        .await?;
+    Ok(serde_json::to_string(&rows)?)
+}
+
+/// Select `columns` from `table`, returning the response body untouched
+pub(crate) async fn database_select_raw(
+    client: &Client,
+    table: &str,
+    columns: &str,
+) -> Result<Vec<u8>> {
+    let body = client
+        .database()
+        .from(table)
+        .select(columns)
+        .execute_raw()
+        .await?;
+    Ok(body.into())
+}
+
+/// Insert a JSON document into `table`, returning the inserted rows as JSON
+pub(crate) async fn database_insert(
+    client: &Client,
+    table: &str,
+    json_value: serde_json::Value,
+) -> Result<String> {
+    let rows = client
+        .database()
+        .insert(table)
+        .values(json_value)?
+        .execute::<serde_json::Value>()
+        .await?;
+    Ok(serde_json::to_string(&rows)?)
+}
+
+/// Insert pre-serialized JSON into `table`, returning the response body untouched
+pub(crate) async fn database_insert_raw(
+    client: &Client,
+    table: &str,
+    json: bytes::Bytes,
+) -> Result<Vec<u8>> {
+    let body = client
+        .database()
+        .insert(table)
+        .raw_values(json)
+        .execute_raw()
+        .await?;
+    Ok(body.into())
+}
+
+/// Bulk load NDJSON rows from `reader` into `table`, returning the report as JSON
+///
+/// The report is `{"rows_loaded", "chunks", "failures": [{"chunk", "first_row",
+/// "rows", "error"}]}`.
+pub(crate) async fn database_bulk_load_ndjson<R: std::io::BufRead>(
+    client: &Client,
+    table: &str,
+    reader: R,
+    config: &crate::database::BulkLoadConfig,
+) -> Result<String> {
+    let report = client
+        .database()
+        .bulk_load_ndjson(table, reader, config)
+        .await?;
+    let failures: Vec<serde_json::Value> = report
+        .failures
+        .iter()
+        .map(|failure| {
+            serde_json::json!({
+                "chunk": failure.chunk,
+                "first_row": failure.first_row,
+                "rows": failure.rows,
+                "error": failure.error.to_string(),
+            })
+        })
+        .collect();
+    Ok(serde_json::to_string(&serde_json::json!({
+        "rows_loaded": report.rows_loaded,
+        "chunks": report.chunks,
+        "failures": failures,
+    }))?)
+}
+
+/// List storage buckets as a JSON array
+pub(crate) async fn storage_list_buckets(client: &Client) -> Result<String> {
+    let buckets = client.storage().list_buckets().await?;
+    Ok(serde_json::to_string(&buckets)?)
+}
+
+/// Sign `paths` in `bucket_id` in one request, returning the results as a JSON array
+pub(crate) async fn storage_create_signed_urls(
+    client: &Client,
+    bucket_id: &str,
+    paths: &[&str],
+    expires_in: u32,
+) -> Result<String> {
+    let urls = client
+        .storage()
+        .create_signed_urls(bucket_id, paths, expires_in)
+        .await?;
+    Ok(serde_json::to_string(&urls)?)
+}
+
+/// Invoke an edge function; plain string responses are returned unquoted
+pub(crate) async fn functions_invoke(
+    client: &Client,
+    function_name: &str,
+    payload: Option<serde_json::Value>,
+) -> Result<String> {
+    let response = client.functions().invoke(function_name, payload).await?;
+    function_response_text(response)
+}
+
+/// Invoke an idempotent edge function, sharing identical in-flight calls
+pub(crate) async fn functions_invoke_coalesced(
+    client: &Client,
+    function_name: &str,
+    payload: Option<serde_json::Value>,
+) -> Result<String> {
+    let response = client
+        .functions()
+        .invoke_coalesced(function_name, payload)
+        .await?;
+    function_response_text(response)
+}
+
+/// Invoke an edge function once per payload, returning a JSON array with one
+/// `{"data": ...}` or `{"error": "..."}` object per payload, in order
+pub(crate) async fn functions_invoke_many(
+    client: &Client,
+    function_name: &str,
+    payloads: Vec<serde_json::Value>,
+    max_concurrency: usize,
+) -> Result<String> {
+    let results = client
+        .functions()
+        .invoke_many(function_name, payloads, max_concurrency)
+        .await;
+    let entries: Vec<serde_json::Value> = results
+        .into_iter()
+        .map(|result| match result {
+            Ok(data) => serde_json::json!({ "data": data }),
+            Err(e) => serde_json::json!({ "error": e.to_string() }),
+        })
+        .collect();
+    Ok(serde_json::to_string(&entries)?)
+}
+
+fn function_response_text(response: serde_json::Value) -> Result<String> {
+    match response {
+        serde_json::Value::String(s) => Ok(s),
+        other => serde_json::to_string(&other).map_err(Error::from),
+    }
+}
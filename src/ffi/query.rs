@@ -0,0 +1,677 @@
+//! Query builder handles for the C API
+//!
+//! A [`SupabaseQuery`] mirrors [`QueryBuilder`]: filters, ordering, pagination and
+//! joins are added one call at a time, and the first execution freezes it into a
+//! [`PreparedQuery`] whose URL is reused by every later execution. Filter values
+//! can then be changed with `supabase_query_bind` without rebuilding the query.
+//!
+//! ```c
+//! SupabaseQuery* query = supabase_query_new(client, "orders");
+//! supabase_query_select(query, "id,total");
+//! supabase_query_filter(query, "user_id", "eq", "0");   /* binding slot 0 */
+//! supabase_query_order(query, "id", false);
+//! supabase_query_limit(query, 50);
+//!
+//! for (int i = 0; i < n_users; i++) {
+//!     SupabaseBuffer* rows = NULL;
+//!     supabase_query_bind(query, 0, user_ids[i]);
+//!     if (supabase_query_execute(query, &rows) == SUPABASE_SUCCESS) {
+//!         consume(supabase_buffer_data(rows), supabase_buffer_len(rows));
+//!         supabase_buffer_free(rows);
+//!     }
+//! }
+//! supabase_query_free(query);
+//! ```
+
+use std::os::raw::c_char;
+use std::ptr;
+use std::sync::Arc;
+use std::time::Duration;
+
+use super::runtime::SharedRuntime;
+use super::{c_str_arg, write_string_to_buffer, SupabaseBuffer, SupabaseClient, SupabaseError};
+use crate::database::{Paginator, PreparedQuery, QueryBuilder};
+use crate::types::{FilterOperator, OrderDirection};
+use crate::Error;
+
+/// Opaque handle to a query under construction or a prepared query
+pub struct SupabaseQuery {
+    runtime: Arc<SharedRuntime>,
+    state: QueryState,
+}
+
+enum QueryState {
+    Building(QueryBuilder),
+    Prepared(PreparedQuery),
+}
+
+impl SupabaseQuery {
+    /// Apply a builder step; fails once the query has been prepared
+    fn modify(&mut self, step: impl FnOnce(QueryBuilder) -> QueryBuilder) -> SupabaseError {
+        match &mut self.state {
+            QueryState::Building(builder) => {
+                *builder = step(builder.clone());
+                SupabaseError::Success
+            }
+            QueryState::Prepared(_) => {
+                Error::invalid_input("Query is already prepared and can no longer be modified")
+                    .into()
+            }
+        }
+    }
+
+    /// Freeze the query on first use and return the prepared form
+    fn prepared(&mut self) -> crate::Result<&mut PreparedQuery> {
+        if let QueryState::Building(builder) = &self.state {
+            let prepared = builder.clone().prepare()?;
+            self.state = QueryState::Prepared(prepared);
+        }
+        match &mut self.state {
+            QueryState::Prepared(prepared) => Ok(prepared),
+            QueryState::Building(_) => unreachable!("query was prepared above"),
+        }
+    }
+}
+
+/// Opaque handle to a keyset-paginated cursor created by `supabase_query_paginate`
+pub struct SupabaseCursor {
+    runtime: Arc<SharedRuntime>,
+    pages: Paginator,
+}
+
+/// Borrow a query handle or bail out with `SUPABASE_INVALID_INPUT`
+macro_rules! query_mut {
+    ($query:expr) => {
+        match $query.as_mut() {
+            Some(query) => query,
+            None => return SupabaseError::InvalidInput,
+        }
+    };
+}
+
+/// Start a query against `table`
+///
+/// # Safety
+///
+/// `client` and `table` must be valid pointers. The query may outlive the client.
+/// Returns NULL on invalid input
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_new(
+    client: *mut SupabaseClient,
+    table: *const c_char,
+) -> *mut SupabaseQuery {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+    let client_ref = &(*client);
+
+    let Some(table_str) = c_str_arg(table) else {
+        return ptr::null_mut();
+    };
+
+    Box::into_raw(Box::new(SupabaseQuery {
+        runtime: Arc::clone(&client_ref.runtime),
+        state: QueryState::Building(client_ref.client.database().from(table_str)),
+    }))
+}
+
+/// Set the selected columns (defaults to `*`)
+///
+/// # Safety
+///
+/// `query` and `columns` must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_select(
+    query: *mut SupabaseQuery,
+    columns: *const c_char,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    let Some(columns) = c_str_arg(columns) else {
+        return SupabaseError::InvalidInput;
+    };
+    query.modify(|builder| builder.select(columns))
+}
+
+/// Add a filter using a PostgREST operator code (`eq`, `neq`, `gt`, `gte`, `lt`,
+/// `lte`, `like`, `ilike`, `is`, `in`, `cs`, `cd`, ...)
+///
+/// Filters are numbered from 0 in the order they are added; the number is the
+/// slot passed to `supabase_query_bind`.
+///
+/// # Safety
+///
+/// All parameters must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_filter(
+    query: *mut SupabaseQuery,
+    column: *const c_char,
+    op: *const c_char,
+    value: *const c_char,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    let (Some(column), Some(op), Some(value)) =
+        (c_str_arg(column), c_str_arg(op), c_str_arg(value))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+    let Ok(operator) = serde_json::from_value::<FilterOperator>(op.into()) else {
+        return Error::invalid_input(format!("Unknown filter operator: {}", op)).into();
+    };
+    query.modify(|builder| builder.filter(column, operator, value))
+}
+
+/// Add an `in` filter matching any of `count` values
+///
+/// # Safety
+///
+/// `query` and `column` must be valid pointers; `values` must point to `count`
+/// valid C strings
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_in(
+    query: *mut SupabaseQuery,
+    column: *const c_char,
+    values: *const *const c_char,
+    count: usize,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    let Some(column) = c_str_arg(column) else {
+        return SupabaseError::InvalidInput;
+    };
+    if values.is_null() && count > 0 {
+        return SupabaseError::InvalidInput;
+    }
+
+    let mut decoded = Vec::with_capacity(count);
+    for index in 0..count {
+        match c_str_arg(*values.add(index)) {
+            Some(value) => decoded.push(value),
+            None => return SupabaseError::InvalidInput,
+        }
+    }
+    query.modify(|builder| builder.r#in(column, &decoded))
+}
+
+/// Order by `column`
+///
+/// # Safety
+///
+/// `query` and `column` must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_order(
+    query: *mut SupabaseQuery,
+    column: *const c_char,
+    ascending: bool,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    let Some(column) = c_str_arg(column) else {
+        return SupabaseError::InvalidInput;
+    };
+    let direction = if ascending {
+        OrderDirection::Ascending
+    } else {
+        OrderDirection::Descending
+    };
+    query.modify(|builder| builder.order(column, direction))
+}
+
+/// Limit the number of rows returned
+///
+/// # Safety
+///
+/// `query` must be a valid pointer
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_limit(
+    query: *mut SupabaseQuery,
+    limit: u32,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    query.modify(|builder| builder.limit(limit))
+}
+
+/// Skip the first `offset` rows
+///
+/// # Safety
+///
+/// `query` must be a valid pointer
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_offset(
+    query: *mut SupabaseQuery,
+    offset: u32,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    query.modify(|builder| builder.offset(offset))
+}
+
+/// Return a single object instead of an array
+///
+/// # Safety
+///
+/// `query` must be a valid pointer
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_single(query: *mut SupabaseQuery) -> SupabaseError {
+    let query = query_mut!(query);
+    query.modify(|builder| builder.single())
+}
+
+/// Serve executions from the client's response cache for up to `ttl_ms` milliseconds
+///
+/// Stale entries are revalidated with the server's `ETag` when one was sent.
+///
+/// # Safety
+///
+/// `query` must be a valid pointer
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_cached(
+    query: *mut SupabaseQuery,
+    ttl_ms: u64,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    query.modify(|builder| builder.cached(Duration::from_millis(ttl_ms)))
+}
+
+/// Share executions with identical queries already in flight on the same client
+///
+/// # Safety
+///
+/// `query` must be a valid pointer
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_coalesce(query: *mut SupabaseQuery) -> SupabaseError {
+    let query = query_mut!(query);
+    query.modify(|builder| builder.coalesce())
+}
+
+/// Embed a related table with an inner join
+///
+/// # Safety
+///
+/// All parameters must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_inner_join(
+    query: *mut SupabaseQuery,
+    foreign_table: *const c_char,
+    foreign_columns: *const c_char,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    let (Some(foreign_table), Some(foreign_columns)) =
+        (c_str_arg(foreign_table), c_str_arg(foreign_columns))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+    query.modify(|builder| builder.inner_join(foreign_table, foreign_columns))
+}
+
+/// Embed a related table with a left join
+///
+/// # Safety
+///
+/// All parameters must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_left_join(
+    query: *mut SupabaseQuery,
+    foreign_table: *const c_char,
+    foreign_columns: *const c_char,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    let (Some(foreign_table), Some(foreign_columns)) =
+        (c_str_arg(foreign_table), c_str_arg(foreign_columns))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+    query.modify(|builder| builder.left_join(foreign_table, foreign_columns))
+}
+
+/// Replace the value of the filter in `slot`, preparing the query if needed
+///
+/// For `in` filters the value is the parenthesised list, e.g. `(1,2,3)`.
+///
+/// # Safety
+///
+/// `query` and `value` must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_bind(
+    query: *mut SupabaseQuery,
+    slot: usize,
+    value: *const c_char,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    let Some(value) = c_str_arg(value) else {
+        return SupabaseError::InvalidInput;
+    };
+    match query
+        .prepared()
+        .and_then(|prepared| prepared.bind(slot, value))
+    {
+        Ok(()) => SupabaseError::Success,
+        Err(err) => err.into(),
+    }
+}
+
+/// Copy the request URL into `result`, preparing the query if needed
+///
+/// # Safety
+///
+/// `query` and `result` must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_url(
+    query: *mut SupabaseQuery,
+    result: *mut c_char,
+    result_len: usize,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    if result.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    match query.prepared() {
+        Ok(prepared) => write_string_to_buffer(prepared.url(), result, result_len),
+        Err(err) => err.into(),
+    }
+}
+
+/// Execute the query, returning the server's JSON unparsed in a new buffer
+///
+/// The first execution prepares the query; later executions reuse its URL.
+/// On failure `*out` is set to NULL.
+///
+/// # Safety
+///
+/// `query` and `out` must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_execute(
+    query: *mut SupabaseQuery,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    let query = query_mut!(query);
+    if out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    *out = ptr::null_mut();
+
+    let runtime = Arc::clone(&query.runtime);
+    let result = match query.prepared() {
+        Ok(prepared) => runtime.block_on(prepared.execute_raw()),
+        Err(err) => Err(err),
+    };
+
+    match result {
+        Ok(body) => {
+            *out = Box::into_raw(Box::new(SupabaseBuffer::new(body)));
+            SupabaseError::Success
+        }
+        Err(err) => err.into(),
+    }
+}
+
+/// Release a query handle
+///
+/// # Safety
+///
+/// `query` must be NULL or a valid pointer returned by `supabase_query_new` and
+/// must not be used afterwards
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_free(query: *mut SupabaseQuery) {
+    if !query.is_null() {
+        let _ = Box::from_raw(query);
+    }
+}
+
+/// Create a cursor paging through the query's rows in `key_column` order
+///
+/// Pages of `page_size` rows (0 is treated as 1) are requested with a filter on
+/// the last key seen rather than an offset, so each page costs the same however
+/// far the cursor has advanced. `key_column` must be unique, selected and not
+/// otherwise filtered on. The query must not have been executed or bound yet; it
+/// stays usable and is freed separately.
+///
+/// # Safety
+///
+/// `query` and `key_column` must be valid pointers. Returns NULL on invalid input
+#[no_mangle]
+pub unsafe extern "C" fn supabase_query_paginate(
+    query: *mut SupabaseQuery,
+    key_column: *const c_char,
+    page_size: u32,
+) -> *mut SupabaseCursor {
+    let Some(query) = query.as_mut() else {
+        return ptr::null_mut();
+    };
+    let Some(key_column) = c_str_arg(key_column) else {
+        return ptr::null_mut();
+    };
+    let QueryState::Building(builder) = &query.state else {
+        let _: SupabaseError = Error::invalid_input("Prepared queries can't be paginated").into();
+        return ptr::null_mut();
+    };
+
+    Box::into_raw(Box::new(SupabaseCursor {
+        runtime: Arc::clone(&query.runtime),
+        pages: builder.clone().paginate(key_column, page_size),
+    }))
+}
+
+/// Fetch the next page as the server's JSON array
+///
+/// Returns `SUPABASE_SUCCESS` with `*out` set to NULL once every row has been
+/// returned. The following page is fetched in the background while the caller
+/// processes this one.
+///
+/// # Safety
+///
+/// `cursor` and `out` must be valid pointers
+#[no_mangle]
+pub unsafe extern "C" fn supabase_cursor_next(
+    cursor: *mut SupabaseCursor,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    let Some(cursor) = cursor.as_mut() else {
+        return SupabaseError::InvalidInput;
+    };
+    if out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    *out = ptr::null_mut();
+
+    let runtime = Arc::clone(&cursor.runtime);
+    match runtime.block_on(cursor.pages.next_page_raw()) {
+        Ok(Some(body)) => {
+            *out = Box::into_raw(Box::new(SupabaseBuffer::new(body)));
+            SupabaseError::Success
+        }
+        Ok(None) => SupabaseError::Success,
+        Err(err) => err.into(),
+    }
+}
+
+/// Release a cursor, cancelling its prefetch
+///
+/// # Safety
+///
+/// `cursor` must be NULL or a valid pointer returned by `supabase_query_paginate`
+/// and must not be used afterwards
+#[no_mangle]
+pub unsafe extern "C" fn supabase_cursor_free(cursor: *mut SupabaseCursor) {
+    if !cursor.is_null() {
+        let _ = Box::from_raw(cursor);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::super::{supabase_client_free, supabase_client_new};
+    use super::*;
+    use std::ffi::{CStr, CString};
+
+    fn query_url(query: *mut SupabaseQuery) -> String {
+        let mut buffer = [0 as c_char; 512];
+        unsafe {
+            let error = supabase_query_url(query, buffer.as_mut_ptr(), buffer.len());
+            assert!(matches!(error, SupabaseError::Success));
+            CStr::from_ptr(buffer.as_ptr())
+                .to_str()
+                .unwrap()
+                .to_string()
+        }
+    }
+
+    #[test]
+    fn test_query_builds_and_rebinds() {
+        let url = CString::new("http://localhost:54321").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let table = CString::new("orders").unwrap();
+        let columns = CString::new("id,total").unwrap();
+        let user = CString::new("user_id").unwrap();
+        let eq = CString::new("eq").unwrap();
+        let first = CString::new("1").unwrap();
+        let second = CString::new("2").unwrap();
+
+        unsafe {
+            let client = supabase_client_new(url.as_ptr(), key.as_ptr());
+            let query = supabase_query_new(client, table.as_ptr());
+            assert!(!query.is_null());
+
+            assert!(matches!(
+                supabase_query_select(query, columns.as_ptr()),
+                SupabaseError::Success
+            ));
+            assert!(matches!(
+                supabase_query_filter(query, user.as_ptr(), eq.as_ptr(), first.as_ptr()),
+                SupabaseError::Success
+            ));
+            assert!(matches!(
+                supabase_query_limit(query, 5),
+                SupabaseError::Success
+            ));
+            assert!(matches!(
+                supabase_query_cached(query, 60_000),
+                SupabaseError::Success
+            ));
+            assert!(matches!(
+                supabase_query_coalesce(query),
+                SupabaseError::Success
+            ));
+
+            // Caching and coalescing change how the query is executed, not its URL
+            assert_eq!(
+                query_url(query),
+                "http://localhost:54321/rest/v1/orders?user_id=eq.1&select=id%2Ctotal&limit=5"
+            );
+
+            assert!(matches!(
+                supabase_query_bind(query, 0, second.as_ptr()),
+                SupabaseError::Success
+            ));
+            assert!(query_url(query).contains("user_id=eq.2"));
+
+            // Prepared queries cannot change shape, and unknown slots are rejected
+            assert!(matches!(
+                supabase_query_limit(query, 10),
+                SupabaseError::InvalidInput
+            ));
+            assert!(matches!(
+                supabase_query_bind(query, 1, second.as_ptr()),
+                SupabaseError::InvalidInput
+            ));
+
+            supabase_query_free(query);
+            supabase_client_free(client);
+        }
+    }
+
+    #[test]
+    fn test_query_rejects_unknown_operator() {
+        let url = CString::new("http://localhost:54321").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let table = CString::new("orders").unwrap();
+        let column = CString::new("id").unwrap();
+        let op = CString::new("between").unwrap();
+
+        unsafe {
+            let client = supabase_client_new(url.as_ptr(), key.as_ptr());
+            let query = supabase_query_new(client, table.as_ptr());
+            let error = supabase_query_filter(query, column.as_ptr(), op.as_ptr(), op.as_ptr());
+            assert!(matches!(error, SupabaseError::InvalidInput));
+            supabase_query_free(query);
+            supabase_client_free(client);
+        }
+    }
+
+    #[test]
+    fn test_cursor_pages_through_table() {
+        use crate::mock_server::{MockResponse, MockServer};
+        use std::sync::{Arc, Mutex};
+
+        let targets = Arc::new(Mutex::new(Vec::new()));
+        let recorded = Arc::clone(&targets);
+        let server = MockServer::start(move |request| {
+            let mut targets = recorded.lock().unwrap();
+            targets.push(request.target.clone());
+            let body = if targets.len() == 1 {
+                r#"[{"id":1},{"id":2}]"#
+            } else {
+                r#"[{"id":3}]"#
+            };
+            MockResponse::json(body)
+        });
+
+        let url = CString::new(server.url()).unwrap();
+        let key = CString::new("test-key").unwrap();
+        let table = CString::new("items").unwrap();
+        let id = CString::new("id").unwrap();
+        let mut pages = Vec::new();
+
+        unsafe {
+            let client = supabase_client_new(url.as_ptr(), key.as_ptr());
+            let query = supabase_query_new(client, table.as_ptr());
+            let cursor = supabase_query_paginate(query, id.as_ptr(), 2);
+            assert!(!cursor.is_null());
+
+            loop {
+                let mut page: *mut SupabaseBuffer = ptr::null_mut();
+                let error = supabase_cursor_next(cursor, &mut page);
+                assert!(matches!(error, SupabaseError::Success));
+                if page.is_null() {
+                    break;
+                }
+                let data = super::super::supabase_buffer_data(page);
+                assert_eq!(
+                    CStr::from_ptr(data).to_bytes().len(),
+                    super::super::supabase_buffer_len(page)
+                );
+                pages.push(CStr::from_ptr(data).to_str().unwrap().to_string());
+                super::super::supabase_buffer_free(page);
+            }
+
+            supabase_cursor_free(cursor);
+            supabase_query_free(query);
+            supabase_client_free(client);
+        }
+
+        assert_eq!(pages, vec![r#"[{"id":1},{"id":2}]"#, r#"[{"id":3}]"#]);
+        let targets = targets.lock().unwrap();
+        assert_eq!(targets.len(), 2);
+        assert!(!targets[0].contains("id=gt"));
+        assert!(targets[1].contains("id=gt.2"));
+    }
+
+    #[test]
+    fn test_paginate_rejects_prepared_queries() {
+        let url = CString::new("http://localhost:54321").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let table = CString::new("items").unwrap();
+        let id = CString::new("id").unwrap();
+        let mut buffer = [0 as c_char; 256];
+
+        unsafe {
+            let client = supabase_client_new(url.as_ptr(), key.as_ptr());
+            let query = supabase_query_new(client, table.as_ptr());
+            supabase_query_url(query, buffer.as_mut_ptr(), buffer.len());
+            assert!(supabase_query_paginate(query, id.as_ptr(), 10).is_null());
+            assert!(supabase_query_paginate(ptr::null_mut(), id.as_ptr(), 10).is_null());
+            assert!(matches!(
+                supabase_cursor_next(ptr::null_mut(), ptr::null_mut()),
+                SupabaseError::InvalidInput
+            ));
+            supabase_query_free(query);
+            supabase_client_free(client);
+        }
+    }
+}
@@ -0,0 +1,506 @@
+//! Realtime C entry points
+//!
+//! A subscription pushes matching database changes into a bounded ring owned by
+//! its [`SupabaseRealtimeSubscription`] handle, and C drains it in batches with
+//! [`supabase_realtime_poll`] instead of taking a callback per event. The
+//! realtime message loop is the only producer and the polling thread the only
+//! consumer, so the ring needs no locks; when it is full new events are counted
+//! and dropped rather than blocking the connection.
+
+use std::cell::UnsafeCell;
+use std::mem::MaybeUninit;
+use std::os::raw::c_char;
+use std::ptr;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex};
+
+use super::{c_str_arg, c_str_arg_or, runtime::SharedRuntime, SupabaseClient, SupabaseError};
+use crate::realtime::{Realtime, RealtimeEvent, RealtimeFrame, SubscriptionConfig};
+use crate::Error;
+
+/// Number of events a subscription buffers between polls
+const EVENT_QUEUE_CAPACITY: usize = 4096;
+
+/// Kind of database change carried by a [`SupabaseRealtimeEvent`]
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum SupabaseRealtimeEventType {
+    Insert = 1,
+    Update = 2,
+    Delete = 3,
+}
+
+impl SupabaseRealtimeEventType {
+    fn from_event(event: RealtimeEvent) -> Option<Self> {
+        match event {
+            RealtimeEvent::Insert => Some(Self::Insert),
+            RealtimeEvent::Update => Some(Self::Update),
+            RealtimeEvent::Delete => Some(Self::Delete),
+            RealtimeEvent::All => None,
+        }
+    }
+
+    fn matches(self, filter: &RealtimeEvent) -> bool {
+        matches!(
+            (self, filter),
+            (_, RealtimeEvent::All)
+                | (Self::Insert, RealtimeEvent::Insert)
+                | (Self::Update, RealtimeEvent::Update)
+                | (Self::Delete, RealtimeEvent::Delete)
+        )
+    }
+}
+
+/// One database change returned by [`supabase_realtime_poll`]
+///
+/// `payload` is the change's JSON payload, NUL-terminated, and stays valid until
+/// the next poll of the same subscription or until it is unsubscribed.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct SupabaseRealtimeEvent {
+    pub event_type: SupabaseRealtimeEventType,
+    pub payload: *const c_char,
+    pub payload_len: usize,
+    /// Position of the event among those received by the subscription, from 0;
+    /// gaps mean events were dropped because the queue was full
+    pub sequence: u64,
+}
+
+/// Change as queued between the message loop and the poller
+struct QueuedEvent {
+    event_type: SupabaseRealtimeEventType,
+    /// Payload JSON followed by a NUL terminator
+    payload: Box<[u8]>,
+    sequence: u64,
+}
+
+/// Bounded single-producer, single-consumer queue
+///
+/// `head` is only advanced by the consumer and `tail` only by the producer; a
+/// slot is written before `tail` is published past it and read before `head`
+/// is published past it, so each slot is owned by exactly one side at a time.
+struct EventRing {
+    slots: Box<[UnsafeCell<MaybeUninit<QueuedEvent>>]>,
+    head: AtomicUsize,
+    tail: AtomicUsize,
+    dropped: AtomicU64,
+}
+
+// SAFETY: slots are handed between the single producer and the single consumer
+// through the acquire/release `head` and `tail` counters, see `EventRing`.
+unsafe impl Send for EventRing {}
+unsafe impl Sync for EventRing {}
+
+impl EventRing {
+    fn new(capacity: usize) -> Self {
+        Self {
+            slots: (0..capacity.max(1))
+                .map(|_| UnsafeCell::new(MaybeUninit::uninit()))
+                .collect(),
+            head: AtomicUsize::new(0),
+            tail: AtomicUsize::new(0),
+            dropped: AtomicU64::new(0),
+        }
+    }
+
+    /// Queue `event`, or drop and count it when the ring is full (producer only)
+    fn push(&self, event: QueuedEvent) -> bool {
+        let tail = self.tail.load(Ordering::Relaxed);
+        let head = self.head.load(Ordering::Acquire);
+        if tail.wrapping_sub(head) == self.slots.len() {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+            return false;
+        }
+
+        // SAFETY: the slot at `tail` is outside the consumer's readable range
+        // until `tail` is published below.
+        unsafe { (*self.slots[tail % self.slots.len()].get()).write(event) };
+        self.tail.store(tail.wrapping_add(1), Ordering::Release);
+        true
+    }
+
+    /// Take the oldest queued event (consumer only)
+    fn pop(&self) -> Option<QueuedEvent> {
+        let head = self.head.load(Ordering::Relaxed);
+        let tail = self.tail.load(Ordering::Acquire);
+        if head == tail {
+            return None;
+        }
+
+        // SAFETY: slots in `head..tail` were initialised by the producer before
+        // it published `tail`, and the producer won't reuse this one until `head`
+        // moves past it.
+        let event = unsafe { (*self.slots[head % self.slots.len()].get()).assume_init_read() };
+        self.head.store(head.wrapping_add(1), Ordering::Release);
+        Some(event)
+    }
+}
+
+impl Drop for EventRing {
+    fn drop(&mut self) {
+        while self.pop().is_some() {}
+    }
+}
+
+/// Realtime producer state: turns frames into queued events
+struct EventSink {
+    ring: Arc<EventRing>,
+    event: RealtimeEvent,
+    received: AtomicU64,
+}
+
+impl EventSink {
+    /// Queue `frame` if it is a database change this subscription asked for
+    ///
+    /// Accepts `postgres_changes` frames as well as change events named after
+    /// the change type itself.
+    fn accept(&self, frame: &RealtimeFrame<'_>) {
+        let event_type = frame
+            .change_event()
+            .and_then(SupabaseRealtimeEventType::from_event);
+        let Some(event_type) = event_type.filter(|kind| kind.matches(&self.event)) else {
+            return;
+        };
+
+        let json = frame.payload_json().as_bytes();
+        let mut payload = Vec::with_capacity(json.len() + 1);
+        payload.extend_from_slice(json);
+        payload.push(0);
+
+        self.ring.push(QueuedEvent {
+            event_type,
+            payload: payload.into_boxed_slice(),
+            sequence: self.received.fetch_add(1, Ordering::Relaxed),
+        });
+    }
+}
+
+/// Opaque handle to a realtime subscription created by [`supabase_realtime_subscribe`]
+pub struct SupabaseRealtimeSubscription {
+    realtime: Realtime,
+    runtime: Arc<SharedRuntime>,
+    subscription_id: String,
+    ring: Arc<EventRing>,
+    /// Events handed out by the last poll, kept alive for their payload pointers
+    polled: Mutex<Vec<QueuedEvent>>,
+}
+
+/// Subscribe to database changes on `schema` (NULL for `public`) and `table`
+///
+/// `table` may be NULL to receive changes on every table of the schema. `event`
+/// is one of `"INSERT"`, `"UPDATE"`, `"DELETE"` or `"*"`, or NULL for all, and
+/// `filter` an optional PostgREST-style filter such as `"id=eq.1"`. Returns NULL
+/// on error; see `supabase_get_last_error`.
+///
+/// # Safety
+///
+/// `client` must be a valid client pointer and the string arguments valid C
+/// strings or NULL where allowed
+#[no_mangle]
+pub unsafe extern "C" fn supabase_realtime_subscribe(
+    client: *mut SupabaseClient,
+    schema: *const c_char,
+    table: *const c_char,
+    event: *const c_char,
+    filter: *const c_char,
+) -> *mut SupabaseRealtimeSubscription {
+    if client.is_null() {
+        return ptr::null_mut();
+    }
+
+    let client_ref = &(*client);
+
+    let Some(schema_str) = c_str_arg_or(schema, "public") else {
+        return ptr::null_mut();
+    };
+    let optional = |value: *const c_char| -> Option<Option<String>> {
+        if value.is_null() {
+            Some(None)
+        } else {
+            c_str_arg(value).map(|s| Some(s.to_string()))
+        }
+    };
+    let (Some(table_name), Some(event_name), Some(filter_str)) =
+        (optional(table), optional(event), optional(filter))
+    else {
+        return ptr::null_mut();
+    };
+
+    let event_filter = match event_name.as_deref() {
+        None | Some("*") => RealtimeEvent::All,
+        Some("INSERT") => RealtimeEvent::Insert,
+        Some("UPDATE") => RealtimeEvent::Update,
+        Some("DELETE") => RealtimeEvent::Delete,
+        Some(other) => {
+            let _: SupabaseError =
+                Error::invalid_input(format!("Unknown realtime event: {}", other)).into();
+            return ptr::null_mut();
+        }
+    };
+
+    let ring = Arc::new(EventRing::new(EVENT_QUEUE_CAPACITY));
+    let sink = EventSink {
+        ring: Arc::clone(&ring),
+        event: event_filter.clone(),
+        received: AtomicU64::new(0),
+    };
+
+    let config = SubscriptionConfig {
+        schema: schema_str.to_string(),
+        table: table_name,
+        event: Some(event_filter),
+        filter: filter_str,
+        ..Default::default()
+    };
+
+    let realtime = client_ref.client.realtime().clone();
+    let subscribed = client_ref.runtime.block_on(
+        realtime.subscribe_frames(config, move |frame: &RealtimeFrame<'_>| sink.accept(frame)),
+    );
+
+    match subscribed {
+        Ok(subscription_id) => Box::into_raw(Box::new(SupabaseRealtimeSubscription {
+            realtime,
+            runtime: Arc::clone(&client_ref.runtime),
+            subscription_id,
+            ring,
+            polled: Mutex::new(Vec::new()),
+        })),
+        Err(e) => {
+            let _: SupabaseError = e.into();
+            ptr::null_mut()
+        }
+    }
+}
+
+/// Move up to `max_events` queued changes into `events`, oldest first
+///
+/// Returns the number of entries written, 0 when nothing is queued. Payloads of
+/// the previous poll are released, so poll each subscription from one thread at
+/// a time.
+///
+/// # Safety
+///
+/// `subscription` must be a valid subscription handle and `events` point to at
+/// least `max_events` writable entries
+#[no_mangle]
+pub unsafe extern "C" fn supabase_realtime_poll(
+    subscription: *mut SupabaseRealtimeSubscription,
+    events: *mut SupabaseRealtimeEvent,
+    max_events: usize,
+) -> usize {
+    if subscription.is_null() || events.is_null() || max_events == 0 {
+        return 0;
+    }
+
+    let subscription = &*subscription;
+    let mut polled = subscription
+        .polled
+        .lock()
+        .unwrap_or_else(|poisoned| poisoned.into_inner());
+    polled.clear();
+
+    while polled.len() < max_events {
+        let Some(event) = subscription.ring.pop() else {
+            break;
+        };
+        polled.push(event);
+    }
+
+    for (index, event) in polled.iter().enumerate() {
+        events.add(index).write(SupabaseRealtimeEvent {
+            event_type: event.event_type,
+            payload: event.payload.as_ptr() as *const c_char,
+            payload_len: event.payload.len() - 1,
+            sequence: event.sequence,
+        });
+    }
+    polled.len()
+}
+
+/// Number of changes dropped because the subscription's queue was full
+///
+/// # Safety
+///
+/// `subscription` must be a valid subscription handle or NULL
+#[no_mangle]
+pub unsafe extern "C" fn supabase_realtime_dropped(
+    subscription: *const SupabaseRealtimeSubscription,
+) -> u64 {
+    if subscription.is_null() {
+        return 0;
+    }
+    let subscription = &*subscription;
+    subscription.ring.dropped.load(Ordering::Relaxed)
+}
+
+/// Unsubscribe and free the handle, including payloads of the last poll
+///
+/// # Safety
+///
+/// `subscription` must be a handle returned by [`supabase_realtime_subscribe`]
+/// that has not been freed, or NULL
+#[no_mangle]
+pub unsafe extern "C" fn supabase_realtime_unsubscribe(
+    subscription: *mut SupabaseRealtimeSubscription,
+) -> SupabaseError {
+    if subscription.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let subscription = Box::from_raw(subscription);
+    let result = subscription.runtime.block_on(
+        subscription
+            .realtime
+            .unsubscribe(&subscription.subscription_id),
+    );
+
+    match result {
+        Ok(()) => SupabaseError::Success,
+        Err(e) => e.into(),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::ffi::CStr;
+
+    fn queued(sequence: u64) -> QueuedEvent {
+        QueuedEvent {
+            event_type: SupabaseRealtimeEventType::Insert,
+            payload: b"{}\0".to_vec().into_boxed_slice(),
+            sequence,
+        }
+    }
+
+    #[test]
+    fn test_event_ring_is_bounded_fifo() {
+        let ring = EventRing::new(2);
+        assert!(ring.push(queued(0)));
+        assert!(ring.push(queued(1)));
+        assert!(!ring.push(queued(2)));
+        assert_eq!(ring.dropped.load(Ordering::Relaxed), 1);
+
+        assert_eq!(ring.pop().map(|e| e.sequence), Some(0));
+        assert!(ring.push(queued(3)));
+        assert_eq!(ring.pop().map(|e| e.sequence), Some(1));
+        assert_eq!(ring.pop().map(|e| e.sequence), Some(3));
+        assert!(ring.pop().is_none());
+    }
+
+    #[test]
+    fn test_event_ring_across_threads() {
+        let ring = Arc::new(EventRing::new(64));
+        let producer = {
+            let ring = Arc::clone(&ring);
+            std::thread::spawn(move || {
+                for sequence in 0..10_000 {
+                    while !ring.push(queued(sequence)) {
+                        std::thread::yield_now();
+                    }
+                }
+            })
+        };
+
+        let mut expected = 0;
+        while expected < 10_000 {
+            match ring.pop() {
+                Some(event) => {
+                    assert_eq!(event.sequence, expected);
+                    expected += 1;
+                }
+                None => std::thread::yield_now(),
+            }
+        }
+        producer.join().unwrap();
+        assert!(ring.pop().is_none());
+    }
+
+    /// Run frames in `frames` through a sink filtering on `event` and poll them
+    fn sink_events(
+        event: RealtimeEvent,
+        frames: &[&str],
+    ) -> Vec<(SupabaseRealtimeEventType, String)> {
+        let ring = Arc::new(EventRing::new(8));
+        let sink = EventSink {
+            ring: Arc::clone(&ring),
+            event,
+            received: AtomicU64::new(0),
+        };
+        for frame in frames {
+            RealtimeFrame::parse(frame, |frame| sink.accept(frame)).unwrap();
+        }
+
+        let mut handle = SupabaseRealtimeSubscription {
+            realtime: Realtime::new(Arc::new(Default::default())).unwrap(),
+            runtime: Arc::new(SharedRuntime::new(
+                tokio::runtime::Builder::new_current_thread()
+                    .build()
+                    .unwrap(),
+            )),
+            subscription_id: String::new(),
+            ring,
+            polled: Mutex::new(Vec::new()),
+        };
+
+        let mut events = [SupabaseRealtimeEvent {
+            event_type: SupabaseRealtimeEventType::Insert,
+            payload: ptr::null(),
+            payload_len: 0,
+            sequence: 0,
+        }; 4];
+        let count =
+            unsafe { supabase_realtime_poll(&mut handle, events.as_mut_ptr(), events.len()) };
+        events[..count]
+            .iter()
+            .map(|event| {
+                let payload = unsafe { CStr::from_ptr(event.payload) }.to_str().unwrap();
+                assert_eq!(payload.len(), event.payload_len);
+                (event.event_type, payload.to_string())
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_sink_queues_postgres_changes() {
+        let insert = r#"{"topic":"realtime:public:posts","event":"postgres_changes","ref":null,"payload":{"data":{"type":"INSERT","record":{"id":1}},"ids":[1]}}"#;
+        let delete = r#"{"topic":"realtime:public:posts","event":"DELETE","ref":null,"payload":{"old_record":{"id":1}}}"#;
+        let presence =
+            r#"{"topic":"realtime:public:posts","event":"presence_diff","ref":null,"payload":{}}"#;
+
+        let all = sink_events(RealtimeEvent::All, &[insert, delete, presence]);
+        assert_eq!(
+            all,
+            vec![
+                (
+                    SupabaseRealtimeEventType::Insert,
+                    r#"{"data":{"type":"INSERT","record":{"id":1}},"ids":[1]}"#.to_string()
+                ),
+                (
+                    SupabaseRealtimeEventType::Delete,
+                    r#"{"old_record":{"id":1}}"#.to_string()
+                ),
+            ]
+        );
+
+        let deletes = sink_events(RealtimeEvent::Delete, &[insert, delete]);
+        assert_eq!(deletes.len(), 1);
+        assert_eq!(deletes[0].0, SupabaseRealtimeEventType::Delete);
+    }
+
+    #[test]
+    fn test_poll_rejects_null_arguments() {
+        unsafe {
+            assert_eq!(
+                supabase_realtime_poll(ptr::null_mut(), ptr::null_mut(), 4),
+                0
+            );
+            assert_eq!(supabase_realtime_dropped(ptr::null()), 0);
+            assert!(matches!(
+                supabase_realtime_unsubscribe(ptr::null_mut()),
+                SupabaseError::InvalidInput
+            ));
+        }
+    }
+}
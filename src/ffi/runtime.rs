@@ -0,0 +1,303 @@
+//! Shared runtimes for many FFI clients
+//!
+//! By default every `supabase_client_new` call starts its own multi-threaded tokio
+//! runtime and HTTP connection pool. Processes that hold many clients (one per
+//! tenant, for example) can instead create a single [`SupabaseRuntime`] and attach
+//! clients to it with `supabase_client_new_with_runtime`: all of them then run on
+//! the same worker pool, and clients with the same API key and HTTP settings reuse
+//! one HTTP client and its connections.
+//!
+//! ```c
+//! SupabaseRuntime* runtime = supabase_runtime_new(4, 0);
+//!
+//! SupabaseClient* a = supabase_client_new_with_runtime(runtime, "https://a.supabase.co", "key-a");
+//! SupabaseClient* b = supabase_client_new_with_runtime(runtime, "https://b.supabase.co", "key-b");
+//!
+//! supabase_client_free(a);
+//! supabase_client_free(b);
+//! supabase_runtime_free(runtime);
+//! ```
+
+use std::collections::HashMap;
+use std::ops::Deref;
+use std::os::raw::c_char;
+use std::ptr;
+use std::sync::{Arc, Mutex, Weak};
+
+use reqwest::Client as HttpClient;
+use tokio::runtime::Runtime;
+
+use super::{c_str_arg, SupabaseClient, SupabaseError};
+use crate::types::SupabaseConfig;
+use crate::{Client, Error, Result};
+
+/// Opaque handle to a tokio runtime shared between clients
+pub struct SupabaseRuntime {
+    inner: Arc<SharedRuntime>,
+}
+
+impl SupabaseRuntime {
+    pub(crate) fn shared(&self) -> &Arc<SharedRuntime> {
+        &self.inner
+    }
+}
+
+/// Runtime plus the HTTP clients handed out to clients attached to it
+pub(crate) struct SharedRuntime {
+    /// Only `None` while being dropped
+    runtime: Option<Runtime>,
+    http_clients: Mutex<HashMap<String, Weak<HttpClient>>>,
+}
+
+impl SharedRuntime {
+    pub(crate) fn new(runtime: Runtime) -> Self {
+        Self {
+            runtime: Some(runtime),
+            http_clients: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Return the HTTP client for `config`, building it on first use
+    ///
+    /// HTTP clients carry the API key in their default headers, so they are shared
+    /// per key and HTTP settings. Entries are held weakly and released together with
+    /// the last client using them.
+    fn http_client(&self, config: &SupabaseConfig) -> Result<Arc<HttpClient>> {
+        let fingerprint = http_client_fingerprint(config);
+        let mut http_clients = self
+            .http_clients
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+
+        if let Some(existing) = http_clients.get(&fingerprint).and_then(Weak::upgrade) {
+            return Ok(existing);
+        }
+
+        let http_client = Arc::new(Client::build_http_client(config)?);
+        http_clients.retain(|_, client| client.strong_count() > 0);
+        http_clients.insert(fingerprint, Arc::downgrade(&http_client));
+        Ok(http_client)
+    }
+
+    /// Create a client attached to this runtime
+    pub(crate) fn client(&self, config: SupabaseConfig) -> Result<Client> {
+        let http_client = self.http_client(&config)?;
+        Client::new_with_http_client(config, http_client)
+    }
+}
+
+impl Deref for SharedRuntime {
+    type Target = Runtime;
+
+    fn deref(&self) -> &Runtime {
+        self.runtime
+            .as_ref()
+            .expect("runtime is only taken on drop")
+    }
+}
+
+impl Drop for SharedRuntime {
+    /// The last client may be freed from a completion callback, that is on one of
+    /// the runtime's own workers, where a blocking shutdown would panic
+    fn drop(&mut self) {
+        if let Some(runtime) = self.runtime.take() {
+            if tokio::runtime::Handle::try_current().is_ok() {
+                runtime.shutdown_background();
+            } else {
+                drop(runtime);
+            }
+        }
+    }
+}
+
+/// Identity of the settings baked into an HTTP client at build time
+fn http_client_fingerprint(config: &SupabaseConfig) -> String {
+    let http = &config.http_config;
+    let mut headers: Vec<_> = http.default_headers.iter().collect();
+    headers.sort();
+
+    format!(
+        "{}\u{0}{}\u{0}{}\u{0}{}\u{0}{:?}\u{0}{:?}\u{0}{}\u{0}{:?}\u{0}{}\u{0}{}\u{0}{}",
+        config.key,
+        http.timeout,
+        http.connect_timeout,
+        http.max_redirects,
+        headers,
+        http.http_version,
+        http.http2_adaptive_window,
+        http.pool_max_idle_per_host,
+        http.pool_idle_timeout,
+        http.tcp_keepalive,
+        http.dns_cache_ttl
+    )
+}
+
+/// Create a runtime that several clients can share
+///
+/// `worker_threads` and `max_blocking_threads` of 0 keep tokio's defaults (one
+/// worker per core and 512 blocking threads respectively).
+///
+/// # Safety
+///
+/// The returned pointer must be released with `supabase_runtime_free`.
+/// Returns NULL if the runtime cannot be started.
+#[no_mangle]
+pub unsafe extern "C" fn supabase_runtime_new(
+    worker_threads: usize,
+    max_blocking_threads: usize,
+) -> *mut SupabaseRuntime {
+    let mut builder = tokio::runtime::Builder::new_multi_thread();
+    builder.enable_all().thread_name("supabase-worker");
+    if worker_threads > 0 {
+        builder.worker_threads(worker_threads);
+    }
+    if max_blocking_threads > 0 {
+        builder.max_blocking_threads(max_blocking_threads);
+    }
+
+    match builder.build() {
+        Ok(runtime) => Box::into_raw(Box::new(SupabaseRuntime {
+            inner: Arc::new(SharedRuntime::new(runtime)),
+        })),
+        Err(e) => {
+            let _ =
+                SupabaseError::from(Error::platform(format!("Failed to create runtime: {}", e)));
+            ptr::null_mut()
+        }
+    }
+}
+
+/// Release a runtime handle
+///
+/// Clients created from the runtime keep it alive, so the handle may be freed
+/// before them; the worker threads stop once the last client is freed.
+///
+/// # Safety
+///
+/// `runtime` must be a valid pointer returned by `supabase_runtime_new` and must
+/// not be used afterwards
+#[no_mangle]
+pub unsafe extern "C" fn supabase_runtime_free(runtime: *mut SupabaseRuntime) {
+    if !runtime.is_null() {
+        let _ = Box::from_raw(runtime);
+    }
+}
+
+/// Create a client that runs on a shared runtime
+///
+/// # Safety
+///
+/// `runtime` must be a valid pointer returned by `supabase_runtime_new`;
+/// `url` and `key` must be valid C strings.
+/// Returns NULL on error
+#[no_mangle]
+pub unsafe extern "C" fn supabase_client_new_with_runtime(
+    runtime: *mut SupabaseRuntime,
+    url: *const c_char,
+    key: *const c_char,
+) -> *mut SupabaseClient {
+    if runtime.is_null() {
+        let _ = SupabaseError::from(Error::invalid_input("Runtime must not be NULL"));
+        return ptr::null_mut();
+    }
+    let (Some(url_str), Some(key_str)) = (c_str_arg(url), c_str_arg(key)) else {
+        let _ = SupabaseError::from(Error::invalid_input("URL and key must be UTF-8 C strings"));
+        return ptr::null_mut();
+    };
+
+    let shared = Arc::clone(&(*runtime).inner);
+    let config = SupabaseConfig {
+        url: url_str.to_string(),
+        key: key_str.to_string(),
+        ..Default::default()
+    };
+
+    match shared.client(config) {
+        Ok(client) => Box::into_raw(Box::new(SupabaseClient::new(client, shared))),
+        Err(err) => {
+            let _ = SupabaseError::from(err);
+            ptr::null_mut()
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::super::supabase_client_free;
+    use super::*;
+    use std::ffi::CString;
+
+    #[test]
+    fn test_clients_share_runtime_and_http_client() {
+        let url = CString::new("http://localhost:54321").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let other_key = CString::new("other-key").unwrap();
+
+        unsafe {
+            let runtime = supabase_runtime_new(2, 0);
+            assert!(!runtime.is_null());
+
+            let first = supabase_client_new_with_runtime(runtime, url.as_ptr(), key.as_ptr());
+            let second = supabase_client_new_with_runtime(runtime, url.as_ptr(), key.as_ptr());
+            let other = supabase_client_new_with_runtime(runtime, url.as_ptr(), other_key.as_ptr());
+            assert!(!first.is_null() && !second.is_null() && !other.is_null());
+
+            assert!(Arc::ptr_eq(&(*first).runtime, &(*other).runtime));
+            assert!(Arc::ptr_eq(
+                &(*first).client.http_client(),
+                &(*second).client.http_client()
+            ));
+            assert!(!Arc::ptr_eq(
+                &(*first).client.http_client(),
+                &(*other).client.http_client()
+            ));
+
+            // Clients keep the runtime alive after its handle is released
+            supabase_runtime_free(runtime);
+            supabase_client_free(first);
+            supabase_client_free(second);
+            supabase_client_free(other);
+        }
+    }
+
+    #[test]
+    fn test_last_reference_dropped_on_own_worker() {
+        let runtime = tokio::runtime::Builder::new_multi_thread()
+            .worker_threads(1)
+            .enable_all()
+            .build()
+            .unwrap();
+        let shared = Arc::new(SharedRuntime::new(runtime));
+        let (release, released) = std::sync::mpsc::channel::<()>();
+        let (done, finished) = std::sync::mpsc::channel::<()>();
+
+        let last = Arc::clone(&shared);
+        shared.spawn(async move {
+            let _ = released.recv();
+            // Like a completion callback freeing the last client
+            drop(last);
+            let _ = done.send(());
+        });
+        drop(shared);
+        release.send(()).unwrap();
+
+        finished
+            .recv_timeout(std::time::Duration::from_secs(5))
+            .expect("dropping the runtime on its own worker must not panic");
+    }
+
+    #[test]
+    fn test_client_new_with_runtime_invalid_input() {
+        let url = CString::new("http://localhost:54321").unwrap();
+        unsafe {
+            let client =
+                supabase_client_new_with_runtime(ptr::null_mut(), url.as_ptr(), url.as_ptr());
+            assert!(client.is_null());
+
+            let runtime = supabase_runtime_new(1, 0);
+            let client = supabase_client_new_with_runtime(runtime, url.as_ptr(), ptr::null());
+            assert!(client.is_null());
+            supabase_runtime_free(runtime);
+        }
+    }
+}
@@ -0,0 +1,387 @@
+//! Streaming C entry points
+//!
+//! Streaming calls deliver results to a callback piece by piece while the
+//! response is still arriving, instead of materialising it as one string. The
+//! callback runs on the calling thread and can stop the stream early by
+//! returning `false`; the rest of the response is not read until it returns.
+
+use std::os::raw::{c_char, c_void};
+
+use super::{c_json_arg, c_str_arg, c_str_arg_or, SupabaseClient, SupabaseError};
+use crate::functions::StreamChunk;
+use crate::Error;
+
+/// Callback receiving one batch of rows as a NUL-terminated JSON array
+///
+/// `rows_json` is only valid for the duration of the call. Return `false` to stop
+/// the stream.
+pub type SupabaseRowsCallback = Option<
+    unsafe extern "C" fn(
+        rows_json: *const c_char,
+        rows_json_len: usize,
+        row_count: usize,
+        user_data: *mut c_void,
+    ) -> bool,
+>;
+
+/// Reusable JSON array of at most `capacity` rows handed to a [`SupabaseRowsCallback`]
+struct RowBatch {
+    json: Vec<u8>,
+    rows: usize,
+    capacity: usize,
+}
+
+impl RowBatch {
+    fn new(capacity: usize) -> Self {
+        Self {
+            json: Vec::new(),
+            rows: 0,
+            capacity: capacity.max(1),
+        }
+    }
+
+    fn push(&mut self, row: &str) {
+        self.json.push(if self.rows == 0 { b'[' } else { b',' });
+        self.json.extend_from_slice(row.as_bytes());
+        self.rows += 1;
+    }
+
+    fn is_full(&self) -> bool {
+        self.rows >= self.capacity
+    }
+
+    /// Hand the pending rows to `callback`; returns its continue flag
+    unsafe fn flush(
+        &mut self,
+        callback: unsafe extern "C" fn(*const c_char, usize, usize, *mut c_void) -> bool,
+        user_data: *mut c_void,
+    ) -> bool {
+        if self.rows == 0 {
+            return true;
+        }
+
+        self.json.extend_from_slice(b"]\0");
+        let keep_going = callback(
+            self.json.as_ptr() as *const c_char,
+            self.json.len() - 1,
+            self.rows,
+            user_data,
+        );
+
+        // Keep the allocation so memory stays bounded by one batch
+        self.json.clear();
+        self.rows = 0;
+        keep_going
+    }
+}
+
+/// Stream the rows of a select query to `callback` in batches of `batch_size`
+///
+/// Rows are parsed incrementally from the response body, so memory use is bounded
+/// by `batch_size` rows regardless of the total result size. A `batch_size` of 0 is
+/// treated as 1. Stopping early by returning `false` from the callback is not an
+/// error.
+///
+/// # Safety
+///
+/// `client`, `table` and `callback` must be valid; `columns` may be NULL (`*`)
+#[no_mangle]
+pub unsafe extern "C" fn supabase_database_select_stream(
+    client: *mut SupabaseClient,
+    table: *const c_char,
+    columns: *const c_char,
+    batch_size: usize,
+    callback: SupabaseRowsCallback,
+    user_data: *mut c_void,
+) -> SupabaseError {
+    if client.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    let Some(callback) = callback else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let client_ref = &(*client);
+
+    let (Some(table_str), Some(columns_str)) = (c_str_arg(table), c_str_arg_or(columns, "*"))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let mut batch = RowBatch::new(batch_size);
+    let mut stopped = false;
+
+    let stream_result = client_ref.runtime.block_on(async {
+        let query = client_ref
+            .client
+            .database()
+            .from(table_str)
+            .select(columns_str);
+        query
+            .execute_streaming(|row| {
+                batch.push(row);
+                if batch.is_full() && !batch.flush(callback, user_data) {
+                    stopped = true;
+                    return Err(Error::generic("Stream stopped by callback"));
+                }
+                Ok(())
+            })
+            .await
+    });
+
+    match stream_result {
+        Ok(_) => {
+            batch.flush(callback, user_data);
+            SupabaseError::Success
+        }
+        Err(_) if stopped => SupabaseError::Success,
+        Err(err) => err.into(),
+    }
+}
+
+/// Callback receiving one chunk of a streamed function response
+///
+/// `data` is NUL-terminated and only valid for the duration of the call. Return
+/// `false` to stop the stream.
+pub type SupabaseFunctionChunkCallback = Option<
+    unsafe extern "C" fn(
+        data: *const c_char,
+        data_len: usize,
+        sequence: u64,
+        is_final: bool,
+        user_data: *mut c_void,
+    ) -> bool,
+>;
+
+/// Write the text handed to C for `chunk` into `text`, reusing its allocation
+///
+/// String data is passed unquoted, like `supabase_functions_invoke` results;
+/// anything else as JSON.
+fn chunk_text(chunk: &StreamChunk, text: &mut Vec<u8>) -> crate::Result<()> {
+    text.clear();
+    match &chunk.data {
+        serde_json::Value::String(s) => text.extend_from_slice(s.as_bytes()),
+        serde_json::Value::Null if chunk.is_final => {}
+        other => serde_json::to_writer(&mut *text, other)?,
+    }
+    text.push(0);
+    Ok(())
+}
+
+/// Invoke an edge function and hand each chunk of its response to `callback`
+///
+/// Each server-sent event (or, for other content types, each piece of body text)
+/// is delivered as soon as it has been received and parsed. The next part of the
+/// body is not read until the callback returns, so a slow consumer slows the
+/// transfer instead of having the response buffered in memory. Stopping early by
+/// returning `false` closes the connection and is not an error.
+///
+/// # Safety
+///
+/// `client`, `function_name` and `callback` must be valid; `json_payload` may be NULL
+#[no_mangle]
+pub unsafe extern "C" fn supabase_functions_invoke_stream(
+    client: *mut SupabaseClient,
+    function_name: *const c_char,
+    json_payload: *const c_char,
+    callback: SupabaseFunctionChunkCallback,
+    user_data: *mut c_void,
+) -> SupabaseError {
+    if client.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    let Some(callback) = callback else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let client_ref = &(*client);
+
+    let Some(function_str) = c_str_arg(function_name) else {
+        return SupabaseError::InvalidInput;
+    };
+    let payload = if json_payload.is_null() {
+        None
+    } else {
+        match c_json_arg(json_payload) {
+            Some(v) => Some(v),
+            None => return SupabaseError::InvalidInput,
+        }
+    };
+
+    let stream_result = client_ref.runtime.block_on(async {
+        let mut stream = client_ref
+            .client
+            .functions()
+            .invoke_stream(function_str, payload)
+            .await?;
+
+        let mut text = Vec::new();
+        while let Some(chunk) = stream.next_chunk().await? {
+            chunk_text(&chunk, &mut text)?;
+            let keep_going = callback(
+                text.as_ptr() as *const c_char,
+                text.len() - 1,
+                chunk.sequence.unwrap_or_default(),
+                chunk.is_final,
+                user_data,
+            );
+            if !keep_going || chunk.is_final {
+                break;
+            }
+        }
+        Ok::<_, Error>(())
+    });
+
+    match stream_result {
+        Ok(()) => SupabaseError::Success,
+        Err(err) => err.into(),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::ffi::CStr;
+
+    unsafe extern "C" fn collect_batches(
+        rows_json: *const c_char,
+        rows_json_len: usize,
+        row_count: usize,
+        user_data: *mut c_void,
+    ) -> bool {
+        let batches = &mut *(user_data as *mut Vec<(String, usize)>);
+        let json = CStr::from_ptr(rows_json).to_str().unwrap().to_string();
+        assert_eq!(json.len(), rows_json_len);
+        batches.push((json, row_count));
+        batches.len() < 2
+    }
+
+    #[test]
+    fn test_row_batch_groups_rows() {
+        let mut batches: Vec<(String, usize)> = Vec::new();
+        let user_data = &mut batches as *mut Vec<(String, usize)> as *mut c_void;
+        let mut batch = RowBatch::new(2);
+
+        unsafe {
+            batch.push(r#"{"id":1}"#);
+            assert!(!batch.is_full());
+            batch.push(r#"{"id":2}"#);
+            assert!(batch.is_full());
+            assert!(batch.flush(collect_batches, user_data));
+
+            batch.push(r#"{"id":3}"#);
+            assert!(!batch.flush(collect_batches, user_data));
+
+            // Flushing an empty batch does not call back
+            assert!(batch.flush(collect_batches, user_data));
+        }
+
+        assert_eq!(
+            batches,
+            vec![
+                (r#"[{"id":1},{"id":2}]"#.to_string(), 2),
+                (r#"[{"id":3}]"#.to_string(), 1),
+            ]
+        );
+    }
+
+    #[test]
+    fn test_chunk_text() {
+        let mut text = Vec::new();
+        let chunk = |data, is_final| StreamChunk {
+            data,
+            sequence: Some(0),
+            is_final,
+        };
+
+        chunk_text(&chunk(serde_json::json!("token"), false), &mut text).unwrap();
+        assert_eq!(text, b"token\0");
+        chunk_text(&chunk(serde_json::json!({"n": 1}), false), &mut text).unwrap();
+        assert_eq!(text, b"{\"n\":1}\0");
+        chunk_text(&chunk(serde_json::Value::Null, true), &mut text).unwrap();
+        assert_eq!(text, b"\0");
+    }
+
+    unsafe extern "C" fn collect_chunks(
+        data: *const c_char,
+        data_len: usize,
+        sequence: u64,
+        is_final: bool,
+        user_data: *mut c_void,
+    ) -> bool {
+        let chunks = &mut *(user_data as *mut Vec<(String, u64, bool)>);
+        let text = CStr::from_ptr(data).to_str().unwrap().to_string();
+        assert_eq!(text.len(), data_len);
+        chunks.push((text, sequence, is_final));
+        true
+    }
+
+    #[test]
+    fn test_functions_invoke_stream() {
+        use crate::mock_server::{MockResponse, MockServer};
+
+        let server = MockServer::start(|_| {
+            MockResponse::new(200)
+                .header("content-type", "text/event-stream")
+                .body("data: {\"token\":\"Hi\"}\n\ndata: there\n\ndata: [DONE]\n\n")
+        });
+
+        let url = std::ffi::CString::new(server.url()).unwrap();
+        let key = std::ffi::CString::new("test-key").unwrap();
+        let name = std::ffi::CString::new("chat").unwrap();
+        let mut chunks: Vec<(String, u64, bool)> = Vec::new();
+
+        unsafe {
+            let client = super::super::supabase_client_new(url.as_ptr(), key.as_ptr());
+            let error = supabase_functions_invoke_stream(
+                client,
+                name.as_ptr(),
+                std::ptr::null(),
+                Some(collect_chunks),
+                &mut chunks as *mut Vec<(String, u64, bool)> as *mut c_void,
+            );
+            assert!(matches!(error, SupabaseError::Success));
+            super::super::supabase_client_free(client);
+        }
+
+        assert_eq!(
+            chunks,
+            vec![
+                (r#"{"token":"Hi"}"#.to_string(), 0, false),
+                ("there".to_string(), 1, false),
+                (String::new(), 2, true),
+            ]
+        );
+    }
+
+    #[test]
+    fn test_functions_stream_invalid_input() {
+        let name = std::ffi::CString::new("chat").unwrap();
+        unsafe {
+            let error = supabase_functions_invoke_stream(
+                std::ptr::null_mut(),
+                name.as_ptr(),
+                std::ptr::null(),
+                None,
+                std::ptr::null_mut(),
+            );
+            assert!(matches!(error, SupabaseError::InvalidInput));
+        }
+    }
+
+    #[test]
+    fn test_select_stream_invalid_input() {
+        let table = std::ffi::CString::new("profiles").unwrap();
+        unsafe {
+            let error = supabase_database_select_stream(
+                std::ptr::null_mut(),
+                table.as_ptr(),
+                std::ptr::null(),
+                10,
+                Some(collect_batches),
+                std::ptr::null_mut(),
+            );
+            assert!(matches!(error, SupabaseError::InvalidInput));
+        }
+    }
+}
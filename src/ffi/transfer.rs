@@ -0,0 +1,533 @@
+//! File transfer C entry points
+//!
+//! Transfers read from and write to the local filesystem (or a descriptor)
+//! directly, so large objects never pass through C memory as a whole. The
+//! `_mapped` upload memory-maps the file instead of reading it. Progress is
+//! reported to an optional callback that runs on the calling thread.
+
+use std::os::raw::{c_char, c_void};
+use std::sync::Arc;
+
+use super::buffer::write_result_to_out;
+use super::{c_str_arg, SupabaseBuffer, SupabaseClient, SupabaseError};
+use crate::storage::{
+    DownloadStream, FileOptions, RangedDownloadConfig, ResumableUploadConfig,
+    UploadProgressCallback,
+};
+use crate::Error;
+
+/// Callback receiving the number of bytes transferred so far and the total size
+pub type SupabaseProgressCallback =
+    Option<unsafe extern "C" fn(transferred: u64, total: u64, user_data: *mut c_void)>;
+
+/// Callback receiving one chunk of a download; return `false` to stop
+///
+/// `data` is only valid for the duration of the call.
+pub type SupabaseChunkCallback =
+    Option<unsafe extern "C" fn(data: *const u8, len: usize, user_data: *mut c_void) -> bool>;
+
+/// A C progress callback together with its user data
+#[derive(Clone, Copy)]
+struct Progress {
+    callback: unsafe extern "C" fn(u64, u64, *mut c_void),
+    user_data: *mut c_void,
+}
+
+// The callback is only invoked from the future driven by the calling thread;
+// the bounds are required by `UploadProgressCallback`.
+unsafe impl Send for Progress {}
+unsafe impl Sync for Progress {}
+
+impl Progress {
+    fn new(callback: SupabaseProgressCallback, user_data: *mut c_void) -> Option<Self> {
+        callback.map(|callback| Self {
+            callback,
+            user_data,
+        })
+    }
+
+    fn report(&self, transferred: u64, total: u64) {
+        unsafe { (self.callback)(transferred, total, self.user_data) }
+    }
+
+    fn into_callback(self) -> UploadProgressCallback {
+        Arc::new(move |transferred, total| self.report(transferred, total))
+    }
+}
+
+/// Upload settings from the C arguments, with 0 selecting the defaults
+unsafe fn upload_settings(
+    content_type: *const c_char,
+    chunk_size: u64,
+    max_concurrent_parts: usize,
+) -> Option<(ResumableUploadConfig, FileOptions)> {
+    let content_type = if content_type.is_null() {
+        None
+    } else {
+        Some(c_str_arg(content_type)?.to_string())
+    };
+
+    let defaults = ResumableUploadConfig::default();
+    let config = ResumableUploadConfig {
+        chunk_size: if chunk_size == 0 {
+            defaults.chunk_size
+        } else {
+            chunk_size
+        },
+        max_concurrent_parts: if max_concurrent_parts == 0 {
+            defaults.max_concurrent_parts
+        } else {
+            max_concurrent_parts
+        },
+        ..defaults
+    };
+    let options = FileOptions {
+        content_type,
+        ..Default::default()
+    };
+    Some((config, options))
+}
+
+/// Upload a local file, splitting large files into concurrently uploaded chunks
+///
+/// Files up to `chunk_size` bytes are sent in one request. Larger files use a
+/// resumable upload with up to `max_concurrent_parts` chunks in flight while the
+/// next chunk is read from disk. A `chunk_size` or `max_concurrent_parts` of 0
+/// selects the default (5 MiB, 4 parts). On success `*out` holds the upload
+/// response as JSON.
+///
+/// When `checkpoint_path` is set, finished parts are recorded in that file and a
+/// later call with the same arguments after a crash continues the upload instead
+/// of starting over. The file is removed once the upload completes.
+///
+/// # Safety
+///
+/// `client`, `bucket_id`, `path`, `file_path` and `out` must be valid pointers;
+/// `content_type`, `checkpoint_path` and `progress` may be NULL
+#[no_mangle]
+pub unsafe extern "C" fn supabase_storage_upload_file(
+    client: *mut SupabaseClient,
+    bucket_id: *const c_char,
+    path: *const c_char,
+    file_path: *const c_char,
+    content_type: *const c_char,
+    checkpoint_path: *const c_char,
+    chunk_size: u64,
+    max_concurrent_parts: usize,
+    progress: SupabaseProgressCallback,
+    user_data: *mut c_void,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(bucket_str), Some(path_str), Some(file_str)) =
+        (c_str_arg(bucket_id), c_str_arg(path), c_str_arg(file_path))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+    let Some((mut config, options)) =
+        upload_settings(content_type, chunk_size, max_concurrent_parts)
+    else {
+        return SupabaseError::InvalidInput;
+    };
+    if !checkpoint_path.is_null() {
+        let Some(checkpoint_str) = c_str_arg(checkpoint_path) else {
+            return SupabaseError::InvalidInput;
+        };
+        config.checkpoint_file = Some(checkpoint_str.into());
+    }
+    let progress = Progress::new(progress, user_data).map(Progress::into_callback);
+
+    let upload_result = client_ref.runtime.block_on(async {
+        let storage = client_ref.client.storage();
+        let response = if config.checkpoint_file.is_some() {
+            storage
+                .resume_large_file(
+                    bucket_str,
+                    path_str,
+                    file_str,
+                    Some(config),
+                    Some(options),
+                    progress,
+                )
+                .await?
+        } else {
+            storage
+                .upload_large_file(
+                    bucket_str,
+                    path_str,
+                    file_str,
+                    Some(config),
+                    Some(options),
+                    progress,
+                )
+                .await?
+        };
+        Ok(serde_json::to_vec(&response)?)
+    });
+
+    write_result_to_out(upload_result, out)
+}
+
+/// Upload a local file by memory-mapping it
+///
+/// Same as `supabase_storage_upload_file`, but parts are sent straight from the
+/// mapped file instead of being read into buffers. The file must not be modified
+/// or truncated until the call returns.
+///
+/// # Safety
+///
+/// `client`, `bucket_id`, `path`, `file_path` and `out` must be valid pointers;
+/// `content_type` and `progress` may be NULL
+#[no_mangle]
+pub unsafe extern "C" fn supabase_storage_upload_file_mapped(
+    client: *mut SupabaseClient,
+    bucket_id: *const c_char,
+    path: *const c_char,
+    file_path: *const c_char,
+    content_type: *const c_char,
+    chunk_size: u64,
+    max_concurrent_parts: usize,
+    progress: SupabaseProgressCallback,
+    user_data: *mut c_void,
+    out: *mut *mut SupabaseBuffer,
+) -> SupabaseError {
+    if client.is_null() || out.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(bucket_str), Some(path_str), Some(file_str)) =
+        (c_str_arg(bucket_id), c_str_arg(path), c_str_arg(file_path))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+    let Some((config, options)) = upload_settings(content_type, chunk_size, max_concurrent_parts)
+    else {
+        return SupabaseError::InvalidInput;
+    };
+    let progress = Progress::new(progress, user_data).map(Progress::into_callback);
+
+    let upload_result = client_ref.runtime.block_on(async {
+        let response = client_ref
+            .client
+            .storage()
+            .upload_file_mapped(
+                bucket_str,
+                path_str,
+                file_str,
+                Some(config),
+                Some(options),
+                progress,
+            )
+            .await?;
+        Ok(serde_json::to_vec(&response)?)
+    });
+
+    write_result_to_out(upload_result, out)
+}
+
+/// Hand every remaining chunk of `stream` to `sink`, stopping early if it returns `false`
+async fn drain(
+    stream: &mut DownloadStream,
+    mut sink: impl FnMut(&[u8]) -> crate::Result<bool>,
+) -> crate::Result<()> {
+    while let Some(chunk) = stream.next_chunk().await? {
+        if !sink(&chunk)? {
+            break;
+        }
+    }
+    Ok(())
+}
+
+/// Stream a file, or `length` bytes of it starting at `offset`, to `callback`
+///
+/// Chunks are delivered as they arrive, so memory stays flat regardless of the
+/// object size. An `offset` and `length` of 0 download the whole file; a
+/// `length` of 0 with a non-zero `offset` reads to the end. Stopping early by
+/// returning `false` is not an error.
+///
+/// # Safety
+///
+/// `client`, `bucket_id`, `path` and `callback` must be valid
+#[no_mangle]
+pub unsafe extern "C" fn supabase_storage_download_stream(
+    client: *mut SupabaseClient,
+    bucket_id: *const c_char,
+    path: *const c_char,
+    offset: u64,
+    length: u64,
+    callback: SupabaseChunkCallback,
+    user_data: *mut c_void,
+) -> SupabaseError {
+    if client.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+    let Some(callback) = callback else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let client_ref = &(*client);
+
+    let (Some(bucket_str), Some(path_str)) = (c_str_arg(bucket_id), c_str_arg(path)) else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let download_result = client_ref.runtime.block_on(async {
+        let storage = client_ref.client.storage();
+        let mut stream = if offset == 0 && length == 0 {
+            storage.download_stream(bucket_str, path_str).await?
+        } else {
+            let length = (length > 0).then_some(length);
+            storage
+                .download_range(bucket_str, path_str, offset, length)
+                .await?
+        };
+        drain(&mut stream, |chunk| {
+            Ok(callback(chunk.as_ptr(), chunk.len(), user_data))
+        })
+        .await
+    });
+
+    match download_result {
+        Ok(()) => SupabaseError::Success,
+        Err(err) => err.into(),
+    }
+}
+
+/// Write a file to the open file descriptor `fd` as it downloads
+///
+/// `fd` may be a regular file, pipe or socket and is not closed. Memory stays
+/// flat regardless of the object size.
+///
+/// # Safety
+///
+/// `client`, `bucket_id` and `path` must be valid pointers and `fd` an open,
+/// writable file descriptor
+#[cfg(unix)]
+#[no_mangle]
+pub unsafe extern "C" fn supabase_storage_download_to_fd(
+    client: *mut SupabaseClient,
+    bucket_id: *const c_char,
+    path: *const c_char,
+    fd: std::os::raw::c_int,
+) -> SupabaseError {
+    use std::io::Write;
+    use std::os::unix::io::FromRawFd;
+
+    if client.is_null() || fd < 0 {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(bucket_str), Some(path_str)) = (c_str_arg(bucket_id), c_str_arg(path)) else {
+        return SupabaseError::InvalidInput;
+    };
+
+    // The descriptor belongs to the caller, so it must not be closed on drop
+    let mut output = std::mem::ManuallyDrop::new(std::fs::File::from_raw_fd(fd));
+
+    let download_result = client_ref.runtime.block_on(async {
+        let mut stream = client_ref
+            .client
+            .storage()
+            .download_stream(bucket_str, path_str)
+            .await?;
+        drain(&mut stream, |chunk| {
+            output
+                .write_all(chunk)
+                .map_err(|e| Error::storage(format!("Failed to write to descriptor: {}", e)))?;
+            Ok(true)
+        })
+        .await
+    });
+
+    match download_result {
+        Ok(()) => SupabaseError::Success,
+        Err(err) => err.into(),
+    }
+}
+
+/// Download a file to `file_path`, fetching `part_size` ranges in parallel
+///
+/// Up to `max_concurrent_parts` ranges are in flight at once (0 selects the
+/// defaults: 8 MiB parts, 4 at once). `progress` may be NULL and runs on the
+/// calling thread as ranges complete. When `written` is not NULL it receives
+/// the number of bytes written.
+///
+/// # Safety
+///
+/// `client`, `bucket_id`, `path` and `file_path` must be valid pointers;
+/// `progress` and `written` may be NULL
+#[no_mangle]
+pub unsafe extern "C" fn supabase_storage_download_to_file(
+    client: *mut SupabaseClient,
+    bucket_id: *const c_char,
+    path: *const c_char,
+    file_path: *const c_char,
+    part_size: u64,
+    max_concurrent_parts: usize,
+    progress: SupabaseProgressCallback,
+    user_data: *mut c_void,
+    written: *mut u64,
+) -> SupabaseError {
+    if client.is_null() {
+        return SupabaseError::InvalidInput;
+    }
+
+    let client_ref = &(*client);
+
+    let (Some(bucket_str), Some(path_str), Some(file_str)) =
+        (c_str_arg(bucket_id), c_str_arg(path), c_str_arg(file_path))
+    else {
+        return SupabaseError::InvalidInput;
+    };
+
+    let defaults = RangedDownloadConfig::default();
+    let config = RangedDownloadConfig {
+        part_size: if part_size == 0 {
+            defaults.part_size
+        } else {
+            part_size
+        },
+        max_concurrent_parts: if max_concurrent_parts == 0 {
+            defaults.max_concurrent_parts
+        } else {
+            max_concurrent_parts
+        },
+        ..defaults
+    };
+    let progress = Progress::new(progress, user_data).map(Progress::into_callback);
+
+    let download_result =
+        client_ref
+            .runtime
+            .block_on(client_ref.client.storage().download_to_file(
+                bucket_str,
+                path_str,
+                file_str,
+                Some(config),
+                progress,
+            ));
+
+    match download_result {
+        Ok(bytes) => {
+            if !written.is_null() {
+                *written = bytes;
+            }
+            SupabaseError::Success
+        }
+        Err(err) => err.into(),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ffi::{supabase_client_free, supabase_client_new};
+    use std::ffi::CString;
+    use std::ptr;
+
+    #[test]
+    fn test_download_entry_points_validate_and_report_errors() {
+        let url = CString::new("http://127.0.0.1:1").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let bucket = CString::new("media").unwrap();
+        let path = CString::new("clip.mp4").unwrap();
+
+        unsafe extern "C" fn ignore(_: *const u8, _: usize, _: *mut c_void) -> bool {
+            true
+        }
+
+        unsafe {
+            let client = supabase_client_new(url.as_ptr(), key.as_ptr());
+
+            let missing_callback = supabase_storage_download_stream(
+                client,
+                bucket.as_ptr(),
+                path.as_ptr(),
+                0,
+                0,
+                None,
+                ptr::null_mut(),
+            );
+            assert!(matches!(missing_callback, SupabaseError::InvalidInput));
+
+            let unreachable = supabase_storage_download_stream(
+                client,
+                bucket.as_ptr(),
+                path.as_ptr(),
+                0,
+                0,
+                Some(ignore),
+                ptr::null_mut(),
+            );
+            assert!(!matches!(
+                unreachable,
+                SupabaseError::Success | SupabaseError::InvalidInput
+            ));
+
+            #[cfg(unix)]
+            assert!(matches!(
+                supabase_storage_download_to_fd(client, bucket.as_ptr(), path.as_ptr(), -1),
+                SupabaseError::InvalidInput
+            ));
+
+            supabase_client_free(client);
+        }
+    }
+
+    #[test]
+    fn test_upload_file_reports_missing_file() {
+        let url = CString::new("http://127.0.0.1:1").unwrap();
+        let key = CString::new("test-key").unwrap();
+        let bucket = CString::new("media").unwrap();
+        let path = CString::new("clip.mp4").unwrap();
+        let file = CString::new("/nonexistent/clip.mp4").unwrap();
+
+        unsafe {
+            let client = supabase_client_new(url.as_ptr(), key.as_ptr());
+            let mut out = ptr::dangling_mut::<SupabaseBuffer>();
+
+            let error = supabase_storage_upload_file(
+                client,
+                bucket.as_ptr(),
+                path.as_ptr(),
+                file.as_ptr(),
+                ptr::null(),
+                ptr::null(),
+                0,
+                0,
+                None,
+                ptr::null_mut(),
+                &mut out,
+            );
+            assert!(!matches!(error, SupabaseError::Success));
+            assert!(out.is_null());
+
+            let mut out = ptr::dangling_mut::<SupabaseBuffer>();
+            let error = supabase_storage_upload_file_mapped(
+                client,
+                bucket.as_ptr(),
+                path.as_ptr(),
+                file.as_ptr(),
+                ptr::null(),
+                0,
+                0,
+                None,
+                ptr::null_mut(),
+                &mut out,
+            );
+            assert!(!matches!(error, SupabaseError::Success));
+            assert!(out.is_null());
+
+            supabase_client_free(client);
+        }
+    }
+}
@@ -13,7 +13,10 @@
 //! - **Enhanced Error Handling**: Detailed error context and retry logic
 
 use crate::{
+    compression::SendCompressed,
     error::{Error, Result},
+    metrics,
+    single_flight::SingleFlight,
     types::SupabaseConfig,
 };
 use reqwest::Client as HttpClient;
@@ -94,6 +97,7 @@ async fn async_sleep(_duration: Duration) {
 pub struct Functions {
     http_client: Arc<HttpClient>,
     config: Arc<SupabaseConfig>,
+    in_flight: Arc<SingleFlight<Value>>,
 }
 
 /// Function metadata and introspection information
@@ -183,6 +187,239 @@ pub struct StreamChunk {
     pub is_final: bool,
 }
 
+/// Incrementally parsed response of [`Functions::invoke_stream`]
+#[cfg(not(target_arch = "wasm32"))]
+pub struct FunctionStream {
+    state: ReadState,
+    parser: ChunkParser,
+    ready: std::collections::VecDeque<StreamChunk>,
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+type PendingRead = std::pin::Pin<
+    Box<dyn std::future::Future<Output = (Response, reqwest::Result<Option<bytes::Bytes>>)> + Send>,
+>;
+
+#[cfg(not(target_arch = "wasm32"))]
+enum ReadState {
+    Idle(Response),
+    Reading(PendingRead),
+    Done,
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+impl FunctionStream {
+    fn new(response: Response) -> Self {
+        let event_stream = response
+            .headers()
+            .get(reqwest::header::CONTENT_TYPE)
+            .and_then(|value| value.to_str().ok())
+            .is_some_and(|value| value.starts_with("text/event-stream"));
+
+        Self {
+            state: ReadState::Idle(response),
+            parser: ChunkParser::new(event_stream),
+            ready: std::collections::VecDeque::new(),
+        }
+    }
+
+    /// The next chunk, or `None` once the response has ended
+    pub async fn next_chunk(&mut self) -> Result<Option<StreamChunk>> {
+        std::future::poll_fn(|cx| {
+            Stream::poll_next(std::pin::Pin::new(&mut *self), cx).map(Option::transpose)
+        })
+        .await
+    }
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+impl Stream for FunctionStream {
+    type Item = Result<StreamChunk>;
+
+    fn poll_next(
+        mut self: std::pin::Pin<&mut Self>,
+        cx: &mut std::task::Context<'_>,
+    ) -> std::task::Poll<Option<Self::Item>> {
+        use std::task::Poll;
+
+        loop {
+            if let Some(chunk) = self.ready.pop_front() {
+                return Poll::Ready(Some(Ok(chunk)));
+            }
+
+            match std::mem::replace(&mut self.state, ReadState::Done) {
+                ReadState::Idle(mut response) => {
+                    self.state = ReadState::Reading(Box::pin(async move {
+                        let bytes = response.chunk().await;
+                        (response, bytes)
+                    }));
+                }
+                ReadState::Reading(mut pending) => match pending.as_mut().poll(cx) {
+                    Poll::Pending => {
+                        self.state = ReadState::Reading(pending);
+                        return Poll::Pending;
+                    }
+                    Poll::Ready((response, Ok(Some(bytes)))) => {
+                        self.state = ReadState::Idle(response);
+                        let this = &mut *self;
+                        this.parser.feed(&bytes, &mut this.ready);
+                    }
+                    Poll::Ready((_, Ok(None))) => {
+                        let this = &mut *self;
+                        this.parser.finish(&mut this.ready);
+                    }
+                    Poll::Ready((_, Err(e))) => return Poll::Ready(Some(Err(e.into()))),
+                },
+                ReadState::Done => return Poll::Ready(None),
+            }
+        }
+    }
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+impl std::fmt::Debug for FunctionStream {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("FunctionStream")
+            .field("buffered_chunks", &self.ready.len())
+            .finish_non_exhaustive()
+    }
+}
+
+/// Splits a streamed function response into [`StreamChunk`]s
+///
+/// Server-sent events are assembled line by line; other bodies are decoded as
+/// UTF-8, holding back a code point split across network chunks.
+#[cfg_attr(target_arch = "wasm32", allow(dead_code))]
+#[derive(Debug)]
+struct ChunkParser {
+    event_stream: bool,
+    /// Bytes of the line (or code point) not yet complete
+    pending: Vec<u8>,
+    /// `data` lines of the event being assembled
+    data: Option<String>,
+    id: Option<u64>,
+    next_sequence: u64,
+}
+
+#[cfg_attr(target_arch = "wasm32", allow(dead_code))]
+impl ChunkParser {
+    fn new(event_stream: bool) -> Self {
+        Self {
+            event_stream,
+            pending: Vec::new(),
+            data: None,
+            id: None,
+            next_sequence: 0,
+        }
+    }
+
+    fn feed(&mut self, bytes: &[u8], out: &mut std::collections::VecDeque<StreamChunk>) {
+        if !self.event_stream {
+            self.pending.extend_from_slice(bytes);
+            let complete = match std::str::from_utf8(&self.pending) {
+                Ok(_) => self.pending.len(),
+                Err(e) if e.error_len().is_none() => e.valid_up_to(),
+                // Invalid bytes are replaced rather than held back forever
+                Err(_) => self.pending.len(),
+            };
+            if complete > 0 {
+                let text = String::from_utf8_lossy(&self.pending[..complete]).into_owned();
+                self.pending.drain(..complete);
+                self.emit(Value::String(text), false, out);
+            }
+            return;
+        }
+
+        // Lines are parsed in place; only a trailing partial line is kept
+        let mut buffer = std::mem::take(&mut self.pending);
+        let mut start = 0;
+        let mut scan_from = buffer.len();
+        buffer.extend_from_slice(bytes);
+        while let Some(newline) = buffer[scan_from..].iter().position(|&b| b == b'\n') {
+            let end = scan_from + newline;
+            let line = &buffer[start..end];
+            let line = line.strip_suffix(b"\r").unwrap_or(line);
+            self.line(&String::from_utf8_lossy(line), out);
+            start = end + 1;
+            scan_from = start;
+        }
+        buffer.drain(..start);
+        self.pending = buffer;
+    }
+
+    /// Flush whatever the body ended with
+    fn finish(&mut self, out: &mut std::collections::VecDeque<StreamChunk>) {
+        if !self.pending.is_empty() {
+            let rest = std::mem::take(&mut self.pending);
+            if self.event_stream {
+                let line = rest.strip_suffix(b"\r").unwrap_or(&rest);
+                self.line(&String::from_utf8_lossy(line), out);
+            } else {
+                let text = String::from_utf8_lossy(&rest).into_owned();
+                self.emit(Value::String(text), false, out);
+            }
+        }
+        self.dispatch(out);
+    }
+
+    fn line(&mut self, line: &str, out: &mut std::collections::VecDeque<StreamChunk>) {
+        if line.is_empty() {
+            self.dispatch(out);
+            return;
+        }
+        if line.starts_with(':') {
+            return;
+        }
+
+        let (field, value) = match line.split_once(':') {
+            Some((field, value)) => (field, value.strip_prefix(' ').unwrap_or(value)),
+            None => (line, ""),
+        };
+        match field {
+            "data" => match &mut self.data {
+                Some(data) => {
+                    data.push('\n');
+                    data.push_str(value);
+                }
+                None => self.data = Some(value.to_string()),
+            },
+            "id" => self.id = value.parse().ok(),
+            _ => {}
+        }
+    }
+
+    /// Emit the event assembled so far, if it carried data
+    fn dispatch(&mut self, out: &mut std::collections::VecDeque<StreamChunk>) {
+        let Some(data) = self.data.take() else {
+            return;
+        };
+        if let Some(id) = self.id.take() {
+            self.next_sequence = id;
+        }
+
+        if data == "[DONE]" {
+            self.emit(Value::Null, true, out);
+        } else {
+            let value = serde_json::from_str(&data).unwrap_or(Value::String(data));
+            self.emit(value, false, out);
+        }
+    }
+
+    fn emit(
+        &mut self,
+        data: Value,
+        is_final: bool,
+        out: &mut std::collections::VecDeque<StreamChunk>,
+    ) {
+        out.push_back(StreamChunk {
+            data,
+            sequence: Some(self.next_sequence),
+            is_final,
+        });
+        self.next_sequence += 1;
+    }
+}
+
 /// Local development configuration
 #[derive(Debug, Clone)]
 pub struct LocalConfig {
@@ -202,9 +439,159 @@ impl Functions {
         Ok(Self {
             http_client,
             config,
+            in_flight: Arc::new(SingleFlight::default()),
         })
     }
 
+    /// Invoke an idempotent Edge Function, sharing the call with identical ones in flight
+    ///
+    /// Concurrent invocations with the same function name and body wait for the
+    /// first one's response instead of each calling the function. Only use this
+    /// for functions whose result does not depend on being called once per caller.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use serde_json::json;
+    ///
+    /// # async fn example(functions: &supabase_lib_rs::Functions) -> supabase_lib_rs::Result<()> {
+    /// let rates = functions
+    ///     .invoke_coalesced("exchange-rates", Some(json!({"base": "EUR"})))
+    ///     .await?;
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub async fn invoke_coalesced(
+        &self,
+        function_name: &str,
+        body: Option<Value>,
+    ) -> Result<Value> {
+        let key = format!(
+            "{}\n{}",
+            function_name,
+            body.as_ref().map(Value::to_string).unwrap_or_default()
+        );
+        self.in_flight
+            .run(key, self.invoke(function_name, body))
+            .await
+    }
+
+    /// Invoke an Edge Function once per payload with bounded parallelism
+    ///
+    /// Up to `max_concurrency` invocations (at least one) are in flight at a time,
+    /// all on this client's pooled connections, and payloads are taken from the
+    /// iterator only as slots free up. Results are returned in payload order; a
+    /// failed invocation only affects its own entry. Use
+    /// [`invoke_many_as_completed`](Self::invoke_many_as_completed) to handle
+    /// results as soon as each one arrives.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use serde_json::json;
+    ///
+    /// # async fn example(functions: &supabase_lib_rs::Functions) -> supabase_lib_rs::Result<()> {
+    /// let payloads = (0..1000).map(|id| json!({ "id": id }));
+    /// let results = functions.invoke_many("enrich", payloads, 32).await;
+    ///
+    /// let failed = results.iter().filter(|result| result.is_err()).count();
+    /// println!("{} of {} invocations failed", failed, results.len());
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub async fn invoke_many<I>(
+        &self,
+        function_name: &str,
+        payloads: I,
+        max_concurrency: usize,
+    ) -> Vec<Result<Value>>
+    where
+        I: IntoIterator<Item = Value>,
+    {
+        let mut results = Vec::new();
+        self.invoke_many_as_completed(function_name, payloads, max_concurrency, |index, result| {
+            if index >= results.len() {
+                results.resize_with(index + 1, || None);
+            }
+            results[index] = Some(result);
+        })
+        .await;
+
+        results
+            .into_iter()
+            .map(|result| {
+                result.unwrap_or_else(|| Err(Error::functions("Invocation did not complete")))
+            })
+            .collect()
+    }
+
+    /// Invoke an Edge Function once per payload, handing each result to
+    /// `on_result` with its payload index as soon as it completes
+    ///
+    /// Concurrency behaves as in [`invoke_many`](Self::invoke_many). `on_result`
+    /// runs on the calling task, so it may borrow local state.
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub async fn invoke_many_as_completed<I, F>(
+        &self,
+        function_name: &str,
+        payloads: I,
+        max_concurrency: usize,
+        mut on_result: F,
+    ) where
+        I: IntoIterator<Item = Value>,
+        F: FnMut(usize, Result<Value>),
+    {
+        let max_in_flight = max_concurrency.max(1);
+        let function_name: Arc<str> = Arc::from(function_name);
+        let mut payloads = payloads.into_iter().enumerate();
+        let mut invocations = tokio::task::JoinSet::new();
+        let mut task_indices = HashMap::new();
+        let mut total = 0usize;
+
+        debug!(
+            "Invoking Edge Function {} for many payloads, {} at a time",
+            function_name, max_in_flight
+        );
+
+        loop {
+            while invocations.len() < max_in_flight {
+                let Some((index, payload)) = payloads.next() else {
+                    break;
+                };
+                let functions = self.clone();
+                let name = Arc::clone(&function_name);
+                let handle = invocations
+                    .spawn(async move { (index, functions.invoke(&name, Some(payload)).await) });
+                task_indices.insert(handle.id(), index);
+                total += 1;
+            }
+
+            let Some(joined) = invocations.join_next_with_id().await else {
+                break;
+            };
+            match joined {
+                Ok((id, (index, result))) => {
+                    task_indices.remove(&id);
+                    on_result(index, result);
+                }
+                Err(e) => {
+                    if let Some(index) = task_indices.remove(&e.id()) {
+                        on_result(
+                            index,
+                            Err(Error::functions(format!("Invocation task failed: {}", e))),
+                        );
+                    }
+                }
+            }
+        }
+
+        info!(
+            "Edge Function {} invoked for {} payloads",
+            function_name, total
+        );
+    }
+
     /// Invoke an Edge Function
     ///
     /// # Parameters
@@ -288,7 +675,9 @@ impl Functions {
             request = request.json(&body);
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.functions_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -321,6 +710,12 @@ impl Functions {
     /// This method enables server-sent events or streaming responses from functions.
     /// Only available on native platforms (not WASM).
     ///
+    /// Chunks are parsed as the body arrives, so the first one is available as soon
+    /// as the function sends it. `text/event-stream` responses yield one chunk per
+    /// event (`data: [DONE]` marks the final chunk); any other response yields its
+    /// body text as it is received. Event data that is not JSON is returned as a
+    /// string. The body is only read as fast as the stream is polled.
+    ///
     /// # Parameters
     ///
     /// * `function_name` - Name of the function to invoke
@@ -352,7 +747,7 @@ impl Functions {
         &self,
         function_name: &str,
         body: Option<Value>,
-    ) -> Result<impl Stream<Item = Result<StreamChunk>>> {
+    ) -> Result<FunctionStream> {
         debug!(
             "Starting streaming invocation of function: {}",
             function_name
@@ -373,7 +768,9 @@ impl Functions {
             request = request.json(&body);
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.functions_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -386,7 +783,7 @@ impl Functions {
             return Err(Error::functions(error_msg));
         }
 
-        self.process_stream(response).await
+        Ok(FunctionStream::new(response))
     }
 
     /// Get metadata for a specific function
@@ -418,7 +815,7 @@ impl Functions {
             .http_client
             .get(&url)
             .header("Authorization", format!("Bearer {}", self.config.key))
-            .send()
+            .send_compressed(&self.config.functions_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -457,7 +854,7 @@ impl Functions {
             .http_client
             .get(&url)
             .header("Authorization", format!("Bearer {}", self.config.key))
-            .send()
+            .send_compressed(&self.config.functions_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -530,6 +927,7 @@ impl Functions {
                 Ok(result) => return Ok(result),
                 Err(e) if attempt < max_attempts => {
                     warn!("Function invocation attempt {} failed: {}", attempt, e);
+                    metrics::record_retry(metrics::Module::Functions);
 
                     if let Some(retry_config) = &options.retry {
                         let base_delay_ms = retry_config.delay.as_millis() as u64;
@@ -597,7 +995,9 @@ impl Functions {
             request = request.json(&body);
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.functions_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -652,7 +1052,9 @@ impl Functions {
             request = request.json(&body);
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.functions_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -674,61 +1076,6 @@ impl Functions {
         Ok(result)
     }
 
-    #[cfg(not(target_arch = "wasm32"))]
-    async fn process_stream(
-        &self,
-        response: Response,
-    ) -> Result<impl Stream<Item = Result<StreamChunk>>> {
-        use tokio_stream::StreamExt;
-
-        // Simplified streaming - read response as text and split by lines
-        let text = response.text().await?;
-        let lines: Vec<String> = text.lines().map(|s| s.to_string()).collect();
-
-        let stream = tokio_stream::iter(lines.into_iter().map(Ok::<String, Error>));
-
-        Ok(
-            stream.map(|line_result: Result<String>| -> Result<StreamChunk> {
-                let line = line_result?;
-
-                // Parse Server-Sent Events format
-                if let Some(data_str) = line.strip_prefix("data: ") {
-                    // Remove "data: " prefix
-                    if data_str == "[DONE]" {
-                        return Ok(StreamChunk {
-                            data: Value::Null,
-                            sequence: None,
-                            is_final: true,
-                        });
-                    }
-
-                    let data: Value = serde_json::from_str(data_str).map_err(|e| {
-                        Error::functions(format!("Failed to parse stream data: {}", e))
-                    })?;
-
-                    Ok(StreamChunk {
-                        data,
-                        sequence: None,
-                        is_final: false,
-                    })
-                } else if !line.is_empty() && !line.starts_with(':') {
-                    // Skip non-data lines (event:, id:, etc.) and empty lines
-                    Ok(StreamChunk {
-                        data: Value::Null,
-                        sequence: None,
-                        is_final: false,
-                    })
-                } else {
-                    Ok(StreamChunk {
-                        data: Value::Null,
-                        sequence: None,
-                        is_final: false,
-                    })
-                }
-            }),
-        )
-    }
-
     fn parse_function_error(&self, error_json: &Value) -> String {
         // Enhanced error parsing for different error formats
         if let Some(message) = error_json.get("error") {
@@ -753,7 +1100,9 @@ impl Functions {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::types::{AuthConfig, DatabaseConfig, HttpConfig, StorageConfig, SupabaseConfig};
+    use crate::types::{
+        AuthConfig, DatabaseConfig, FunctionsConfig, HttpConfig, StorageConfig, SupabaseConfig,
+    };
 
     fn create_test_functions() -> Functions {
         let config = Arc::new(SupabaseConfig {
@@ -764,6 +1113,7 @@ mod tests {
             auth_config: AuthConfig::default(),
             database_config: DatabaseConfig::default(),
             storage_config: StorageConfig::default(),
+            functions_config: FunctionsConfig::default(),
         });
 
         let http_client = Arc::new(HttpClient::new());
@@ -779,6 +1129,82 @@ mod tests {
         );
     }
 
+    fn parse(event_stream: bool, pieces: &[&[u8]]) -> Vec<StreamChunk> {
+        let mut parser = ChunkParser::new(event_stream);
+        let mut out = std::collections::VecDeque::new();
+        for piece in pieces {
+            parser.feed(piece, &mut out);
+        }
+        parser.finish(&mut out);
+        out.into_iter().collect()
+    }
+
+    #[test]
+    fn test_event_stream_parsing() {
+        // Events split across network chunks at arbitrary points
+        let chunks = parse(
+            true,
+            &[
+                b": keep-alive\n\nid: 7\ndata: {\"tok",
+                b"en\": \"Hel\"}\r\n\r\ndata: lo\ndata: world\n",
+                b"\nevent: done\ndata: [DONE]\n\n",
+            ],
+        );
+
+        assert_eq!(chunks.len(), 3);
+        assert_eq!(chunks[0].data, serde_json::json!({"token": "Hel"}));
+        assert_eq!(chunks[0].sequence, Some(7));
+        assert_eq!(chunks[1].data, Value::String("lo\nworld".to_string()));
+        assert_eq!(chunks[1].sequence, Some(8));
+        assert!(!chunks[1].is_final);
+        assert!(chunks[2].is_final);
+
+        // A final event without the terminating blank line is still delivered
+        let chunks = parse(true, &[b"data: 1\n", b"data: 2"]);
+        assert_eq!(chunks.len(), 1);
+        assert_eq!(chunks[0].data, Value::String("1\n2".to_string()));
+    }
+
+    #[test]
+    fn test_plain_stream_parsing() {
+        let euro = "€".as_bytes();
+        let chunks = parse(false, &[b"caf", &euro[..1], &euro[1..]]);
+        let text: String = chunks
+            .iter()
+            .map(|chunk| chunk.data.as_str().unwrap())
+            .collect();
+        assert_eq!(text, "caf€");
+        assert_eq!(chunks.len(), 2);
+    }
+
+    #[tokio::test]
+    async fn test_invoke_many_isolates_failures_in_order() {
+        let config = Arc::new(SupabaseConfig {
+            url: "http://127.0.0.1:1".to_string(),
+            ..Default::default()
+        });
+        let functions = Functions::new(config, Arc::new(HttpClient::new())).unwrap();
+
+        let payloads = (0..5).map(|id| serde_json::json!({ "id": id }));
+        let results = functions.invoke_many("enrich", payloads, 2).await;
+        assert_eq!(results.len(), 5);
+        assert!(results.iter().all(|result| result.is_err()));
+
+        let mut seen = Vec::new();
+        functions
+            .invoke_many_as_completed("enrich", vec![Value::Null; 3], 0, |index, _| {
+                seen.push(index)
+            })
+            .await;
+        seen.sort_unstable();
+        assert_eq!(seen, vec![0, 1, 2]);
+
+        assert!(functions
+            .invoke_many("enrich", Vec::new(), 4)
+            .await
+            .is_empty());
+    }
+
     #[test]
     fn test_functions_url_generation() {
         let functions = create_test_functions();
@@ -0,0 +1,422 @@
+//! Local verification of Supabase access tokens
+//!
+//! Tokens are checked against the signing keys published at
+//! `/auth/v1/.well-known/jwks.json` or, for HS256 tokens, the project's JWT secret
+//! ([`AuthConfig::jwt_secret`](crate::types::AuthConfig::jwt_secret)). Each
+//! token's signature is verified once; its claims are then served from a cache
+//! keyed by the token's hash until the token expires, so verifying a token an API
+//! gateway has already seen is a hash lookup rather than an auth round trip.
+//!
+//! The key set is fetched lazily and refetched when a token names a key id it does
+//! not contain (key rotation), at most once per [`JWKS_REFETCH_SECONDS`].
+
+use crate::{
+    error::{Error, Result},
+    metrics::SendMetered,
+    single_flight::SingleFlight,
+    types::{SupabaseConfig, Timestamp},
+};
+use chrono::Utc;
+use jsonwebtoken::{jwk::JwkSet, Algorithm, DecodingKey, Validation};
+use reqwest::Client as HttpClient;
+use serde::{Deserialize, Serialize};
+use std::{
+    collections::{hash_map::RandomState, HashMap},
+    hash::BuildHasher,
+    sync::{Arc, RwLock},
+};
+use tracing::{debug, warn};
+
+/// Cached tokens kept before expired entries are purged
+const CACHE_CAPACITY: usize = 10_000;
+
+/// Minimum seconds between key set fetches triggered by unknown key ids
+pub const JWKS_REFETCH_SECONDS: i64 = 30;
+
+/// Seconds a fetched key set is used before it is refreshed
+const JWKS_MAX_AGE_SECONDS: i64 = 600;
+
+/// Claims of a verified Supabase access token
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct Claims {
+    /// Subject: the user id
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub sub: Option<String>,
+    /// Expiry as a Unix timestamp in seconds
+    pub exp: i64,
+    /// Issue time as a Unix timestamp in seconds
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub iat: Option<i64>,
+    /// Issuer, normally `<project url>/auth/v1`
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub iss: Option<String>,
+    /// A single audience or an array of them
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub aud: Option<serde_json::Value>,
+    /// Postgres role the request runs as (`authenticated`, `anon`, ...)
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub role: Option<String>,
+    /// Email address of the user
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub email: Option<String>,
+    /// Id of the auth session the token belongs to
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub session_id: Option<String>,
+    /// Every other claim (`app_metadata`, `user_metadata`, `aal`, ...)
+    #[serde(flatten)]
+    pub extra: serde_json::Map<String, serde_json::Value>,
+}
+
+/// A token whose signature has been verified, with its claims
+#[derive(Debug)]
+pub struct VerifiedToken {
+    /// Claims decoded from the token payload
+    pub claims: Claims,
+    json: String,
+}
+
+impl VerifiedToken {
+    /// The claims as JSON, serialized once at verification time
+    pub fn claims_json(&self) -> &str {
+        &self.json
+    }
+
+    fn is_expired(&self) -> bool {
+        self.claims.exp <= Utc::now().timestamp()
+    }
+}
+
+struct CacheEntry {
+    /// Compared on lookup so a hash collision can never return another token's claims
+    token: Box<str>,
+    verified: Arc<VerifiedToken>,
+}
+
+struct KeySet {
+    keys: Arc<JwkSet>,
+    fetched_at: Timestamp,
+}
+
+/// Verifies access tokens locally and caches the results
+pub(crate) struct JwtVerifier {
+    http_client: Arc<HttpClient>,
+    config: Arc<SupabaseConfig>,
+    hasher: RandomState,
+    cache: RwLock<HashMap<u64, CacheEntry>>,
+    key_set: RwLock<Option<KeySet>>,
+    key_set_fetches: SingleFlight<Arc<JwkSet>>,
+}
+
+impl std::fmt::Debug for JwtVerifier {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("JwtVerifier")
+            .field(
+                "cached_tokens",
+                &self.cache.read().map(|cache| cache.len()).unwrap_or(0),
+            )
+            .finish()
+    }
+}
+
+impl JwtVerifier {
+    pub(crate) fn new(config: Arc<SupabaseConfig>, http_client: Arc<HttpClient>) -> Self {
+        Self {
+            http_client,
+            config,
+            hasher: RandomState::new(),
+            cache: RwLock::new(HashMap::new()),
+            key_set: RwLock::new(None),
+            key_set_fetches: SingleFlight::default(),
+        }
+    }
+
+    /// The cached result for `token`, if it was verified before and has not expired
+    pub(crate) fn cached(&self, token: &str) -> Option<Arc<VerifiedToken>> {
+        let cache = self
+            .cache
+            .read()
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+        cache
+            .get(&self.hasher.hash_one(token))
+            .filter(|entry| &*entry.token == token && !entry.verified.is_expired())
+            .map(|entry| Arc::clone(&entry.verified))
+    }
+
+    /// Verify `token`'s signature and expiry, returning its claims
+    pub(crate) async fn verify(&self, token: &str) -> Result<Arc<VerifiedToken>> {
+        if let Some(verified) = self.cached(token) {
+            return Ok(verified);
+        }
+
+        let header = jsonwebtoken::decode_header(token)
+            .map_err(|e| Error::auth(format!("Invalid token: {}", e)))?;
+        let key = self.decoding_key(header.kid.as_deref(), header.alg).await?;
+
+        let mut validation = Validation::new(header.alg);
+        // Supabase tokens carry `aud: "authenticated"`; callers check roles themselves
+        validation.validate_aud = false;
+        let claims = jsonwebtoken::decode::<Claims>(token, &key, &validation)
+            .map_err(|e| Error::auth(format!("Invalid token: {}", e)))?
+            .claims;
+
+        let verified = Arc::new(VerifiedToken {
+            json: serde_json::to_string(&claims)?,
+            claims,
+        });
+        self.insert(token, Arc::clone(&verified));
+        Ok(verified)
+    }
+
+    fn insert(&self, token: &str, verified: Arc<VerifiedToken>) {
+        let mut cache = self
+            .cache
+            .write()
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+        if cache.len() >= CACHE_CAPACITY {
+            cache.retain(|_, entry| !entry.verified.is_expired());
+            if cache.len() >= CACHE_CAPACITY {
+                debug!("JWT cache full, dropping {} entries", cache.len());
+                cache.clear();
+            }
+        }
+        cache.insert(
+            self.hasher.hash_one(token),
+            CacheEntry {
+                token: token.into(),
+                verified,
+            },
+        );
+    }
+
+    /// The key named by `kid` in the key set, else the project secret for HMAC tokens
+    async fn decoding_key(&self, kid: Option<&str>, algorithm: Algorithm) -> Result<DecodingKey> {
+        if let Some(kid) = kid {
+            if let Some(key) = self.key_for(kid).await? {
+                return Ok(key);
+            }
+        }
+
+        let hmac = matches!(
+            algorithm,
+            Algorithm::HS256 | Algorithm::HS384 | Algorithm::HS512
+        );
+        match &self.config.auth_config.jwt_secret {
+            Some(secret) if hmac => Ok(DecodingKey::from_secret(secret.as_bytes())),
+            _ => Err(Error::auth(format!(
+                "No key to verify token signature (kid {:?}, alg {:?})",
+                kid, algorithm
+            ))),
+        }
+    }
+
+    async fn key_for(&self, kid: &str) -> Result<Option<DecodingKey>> {
+        let (keys, refetch) = {
+            let key_set = self
+                .key_set
+                .read()
+                .unwrap_or_else(|poisoned| poisoned.into_inner());
+            match key_set.as_ref() {
+                Some(key_set) => {
+                    let age = (Utc::now() - key_set.fetched_at).num_seconds();
+                    let found = key_set.keys.find(kid).is_some();
+                    let refetch =
+                        age >= JWKS_MAX_AGE_SECONDS || (!found && age >= JWKS_REFETCH_SECONDS);
+                    (Arc::clone(&key_set.keys), refetch)
+                }
+                None => (Arc::new(JwkSet { keys: Vec::new() }), true),
+            }
+        };
+
+        let keys = if refetch {
+            self.key_set_fetches
+                .run("jwks".to_string(), self.fetch_key_set())
+                .await?
+        } else {
+            keys
+        };
+
+        keys.find(kid)
+            .map(|jwk| {
+                DecodingKey::from_jwk(jwk)
+                    .map_err(|e| Error::auth(format!("Unusable signing key {}: {}", kid, e)))
+            })
+            .transpose()
+    }
+
+    /// Fetch the key set; failures are remembered as an empty set so they are retried
+    /// no more often than key rotations
+    async fn fetch_key_set(&self) -> Result<Arc<JwkSet>> {
+        let url = format!("{}/auth/v1/.well-known/jwks.json", self.config.url);
+        debug!("Fetching signing keys from {}", url);
+
+        let fetched = async {
+            let response = self.http_client.get(&url).send_metered().await?;
+            if !response.status().is_success() {
+                return Err(Error::auth(format!(
+                    "Fetching signing keys failed with status: {}",
+                    response.status()
+                )));
+            }
+            Ok(response.json::<JwkSet>().await?)
+        }
+        .await;
+
+        let keys = Arc::new(fetched.unwrap_or_else(|err| {
+            warn!("Failed to fetch signing keys: {}", err);
+            JwkSet { keys: Vec::new() }
+        }));
+        *self
+            .key_set
+            .write()
+            .unwrap_or_else(|poisoned| poisoned.into_inner()) = Some(KeySet {
+            keys: Arc::clone(&keys),
+            fetched_at: Utc::now(),
+        });
+        Ok(keys)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::mock_server::{MockResponse, MockServer};
+    use jsonwebtoken::{EncodingKey, Header};
+
+    const SECRET: &str = "super-secret-jwt-token-with-at-least-32-characters";
+
+    fn config(url: &str, jwt_secret: Option<&str>) -> Arc<SupabaseConfig> {
+        let mut config = SupabaseConfig {
+            url: url.to_string(),
+            key: "test-key".to_string(),
+            ..Default::default()
+        };
+        config.auth_config.jwt_secret = jwt_secret.map(str::to_string);
+        Arc::new(config)
+    }
+
+    fn sign(kid: Option<&str>, secret: &[u8], expires_in: i64) -> String {
+        let mut header = Header::new(Algorithm::HS256);
+        header.kid = kid.map(str::to_string);
+        let claims = serde_json::json!({
+            "sub": "31815c55-f553-41f4-b54f-14d6ac60de16",
+            "exp": Utc::now().timestamp() + expires_in,
+            "role": "authenticated",
+            "aal": "aal1",
+        });
+        jsonwebtoken::encode(&header, &claims, &EncodingKey::from_secret(secret)).unwrap()
+    }
+
+    #[tokio::test]
+    async fn test_verifies_once_and_serves_claims_from_cache() {
+        let verifier = JwtVerifier::new(
+            config("http://127.0.0.1:9", Some(SECRET)),
+            Arc::new(HttpClient::new()),
+        );
+        let token = sign(None, SECRET.as_bytes(), 3600);
+
+        assert!(verifier.cached(&token).is_none());
+        let verified = verifier.verify(&token).await.unwrap();
+        assert_eq!(verified.claims.role.as_deref(), Some("authenticated"));
+        assert_eq!(verified.claims.extra["aal"], "aal1");
+        assert!(verified.claims_json().contains("\"aal\":\"aal1\""));
+
+        let cached = verifier.cached(&token).unwrap();
+        assert!(Arc::ptr_eq(&cached, &verified));
+    }
+
+    #[tokio::test]
+    async fn test_rejects_bad_signatures_and_expired_tokens() {
+        let verifier = JwtVerifier::new(
+            config("http://127.0.0.1:9", Some(SECRET)),
+            Arc::new(HttpClient::new()),
+        );
+
+        let forged = sign(None, b"not-the-project-secret-not-the-project", 3600);
+        assert!(verifier.verify(&forged).await.is_err());
+        assert!(verifier.cached(&forged).is_none());
+
+        let expired = sign(None, SECRET.as_bytes(), -3600);
+        assert!(verifier.verify(&expired).await.is_err());
+
+        let unconfigured = JwtVerifier::new(
+            config("http://127.0.0.1:9", None),
+            Arc::new(HttpClient::new()),
+        );
+        let err = unconfigured
+            .verify(&sign(None, SECRET.as_bytes(), 3600))
+            .await
+            .unwrap_err();
+        assert!(err.to_string().contains("No key to verify"), "{err}");
+    }
+
+    /// Serve `key_sets` in turn from the JWKS endpoint; returns the server and the
+    /// number of fetches
+    fn serve_key_sets(
+        key_sets: Vec<serde_json::Value>,
+    ) -> (MockServer, Arc<std::sync::atomic::AtomicUsize>) {
+        use std::sync::atomic::Ordering;
+
+        let fetches = Arc::new(std::sync::atomic::AtomicUsize::new(0));
+        let served = Arc::clone(&fetches);
+        let server = MockServer::start(move |request| {
+            assert_eq!(
+                (request.method.as_str(), request.path()),
+                ("GET", "/auth/v1/.well-known/jwks.json")
+            );
+            let n = served.fetch_add(1, Ordering::SeqCst);
+            MockResponse::json(key_sets[n.min(key_sets.len() - 1)].to_string())
+        });
+        (server, fetches)
+    }
+
+    fn octet_key(kid: &str, secret: &[u8]) -> serde_json::Value {
+        use base64::Engine;
+        serde_json::json!({
+            "kty": "oct",
+            "kid": kid,
+            "alg": "HS256",
+            "k": base64::engine::general_purpose::URL_SAFE_NO_PAD.encode(secret),
+        })
+    }
+
+    #[tokio::test]
+    async fn test_fetches_key_set_and_follows_rotation() {
+        use std::sync::atomic::Ordering;
+
+        let (server, fetches) = serve_key_sets(vec![serde_json::json!({ "keys": [] })]);
+        let verifier = JwtVerifier::new(config(server.url(), None), Arc::new(HttpClient::new()));
+
+        // A rotated-in key the fetched set does not know about yet
+        let token = sign(
+            Some("rotated"),
+            b"rotated-signing-key-rotated-signing",
+            3600,
+        );
+        assert!(verifier.verify(&token).await.is_err());
+        assert_eq!(fetches.load(Ordering::SeqCst), 1);
+
+        // Unknown key ids do not refetch within the refetch interval
+        assert!(verifier.verify(&token).await.is_err());
+        assert_eq!(fetches.load(Ordering::SeqCst), 1);
+
+        let (server, fetches) = serve_key_sets(vec![
+            serde_json::json!({ "keys": [octet_key("current", b"current-signing-key-current-sign")] }),
+            serde_json::json!({ "keys": [
+                octet_key("current", b"current-signing-key-current-sign"),
+                octet_key("rotated", b"rotated-signing-key-rotated-signing"),
+            ] }),
+        ]);
+        let verifier = JwtVerifier::new(config(server.url(), None), Arc::new(HttpClient::new()));
+
+        let current = sign(Some("current"), b"current-signing-key-current-sign", 3600);
+        verifier.verify(&current).await.unwrap();
+        assert_eq!(fetches.load(Ordering::SeqCst), 1);
+
+        // Pretend the set is old enough to look for the new key
+        if let Some(key_set) = verifier.key_set.write().unwrap().as_mut() {
+            key_set.fetched_at = Utc::now() - chrono::Duration::seconds(JWKS_REFETCH_SECONDS);
+        }
+        verifier.verify(&token).await.unwrap();
+        assert_eq!(fetches.load(Ordering::SeqCst), 2);
+    }
+}
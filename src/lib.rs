@@ -326,6 +326,9 @@
 #[cfg(feature = "auth")]
 pub mod auth;
 
+#[cfg(feature = "auth")]
+pub mod jwt;
+
 #[cfg(feature = "session-management")]
 pub mod session;
 
@@ -336,6 +339,8 @@ pub mod database;
 
 pub mod error;
 
+pub mod metrics;
+
 #[cfg(feature = "realtime")]
 pub mod realtime;
 
@@ -364,6 +369,21 @@ mod async_runtime;
 #[cfg(feature = "realtime")]
 mod websocket;
 
+#[cfg(any(feature = "auth", feature = "database", feature = "functions"))]
+mod single_flight;
+
+#[cfg(any(feature = "database", feature = "storage", feature = "functions"))]
+mod compression;
+
+#[cfg(any(feature = "database", feature = "storage", feature = "performance"))]
+mod sharded_cache;
+
+#[cfg(all(feature = "native", not(target_arch = "wasm32")))]
+mod dns;
+
+#[cfg(all(test, not(target_arch = "wasm32")))]
+mod mock_server;
+
 pub use client::Client;
 pub use error::{Error, Result};
 
@@ -408,7 +428,7 @@ pub mod prelude {
 
     #[cfg(feature = "database")]
     pub use crate::database::{
-        Database, DeleteBuilder, InsertBuilder, QueryBuilder, UpdateBuilder,
+        Database, DeleteBuilder, InsertBuilder, PreparedQuery, QueryBuilder, UpdateBuilder,
     };
 
     #[cfg(feature = "storage")]
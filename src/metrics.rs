@@ -0,0 +1,660 @@
+//! Request-level instrumentation for every HTTP call the client makes
+//!
+//! Each module sends its requests through [`SendMetered::send_metered`], which
+//! classifies the request by URL (`/rest/v1/<table>` is the database endpoint
+//! `<table>`, `/storage/v1/object/...` the storage endpoint `object`, and so on)
+//! and records latency, bytes and failures into a process-wide registry. The hot
+//! path is a shared-lock map lookup followed by relaxed atomic increments; nothing
+//! is formatted or allocated until an endpoint is first seen.
+//!
+//! Latencies go into log-linear histograms (16 sub-buckets per power of two, so
+//! quantiles are within ~6% of the true value, HDR-style) from which
+//! [`snapshot`] reports p50/p99/p999.
+//!
+//! With the `compression` feature, each module also counts the bytes its
+//! compressed request bodies and encoded responses saved on the wire.
+//!
+//! # Examples
+//!
+//! ```rust,no_run
+//! let snapshot = supabase_lib_rs::metrics::snapshot();
+//! for endpoint in &snapshot.endpoints {
+//!     println!(
+//!         "{} {} {}: {} requests, p99 {}us",
+//!         endpoint.module, endpoint.method, endpoint.endpoint,
+//!         endpoint.requests, endpoint.latency.p99_us
+//!     );
+//! }
+//! ```
+
+use serde::{Deserialize, Serialize};
+use std::{
+    collections::HashMap,
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        Arc, OnceLock, RwLock,
+    },
+    time::Duration,
+};
+
+/// Client module a request belongs to
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) enum Module {
+    Auth,
+    Database,
+    Storage,
+    Functions,
+    Other,
+}
+
+impl Module {
+    const ALL: [Module; 5] = [
+        Module::Auth,
+        Module::Database,
+        Module::Storage,
+        Module::Functions,
+        Module::Other,
+    ];
+
+    fn name(self) -> &'static str {
+        match self {
+            Module::Auth => "auth",
+            Module::Database => "database",
+            Module::Storage => "storage",
+            Module::Functions => "functions",
+            Module::Other => "other",
+        }
+    }
+
+    fn index(self) -> usize {
+        self as usize
+    }
+}
+
+/// Distinct endpoints tracked per module before new ones are folded into `"other"`
+const MAX_ENDPOINTS_PER_MODULE: usize = 1024;
+
+const METHODS: [&str; 6] = ["GET", "POST", "PUT", "PATCH", "DELETE", "OTHER"];
+
+fn method_index(method: &reqwest::Method) -> usize {
+    match *method {
+        reqwest::Method::GET => 0,
+        reqwest::Method::POST => 1,
+        reqwest::Method::PUT => 2,
+        reqwest::Method::PATCH => 3,
+        reqwest::Method::DELETE => 4,
+        _ => 5,
+    }
+}
+
+/// Module a request URL belongs to
+#[cfg(all(feature = "compression", not(target_arch = "wasm32")))]
+pub(crate) fn module_of(url: &reqwest::Url) -> Module {
+    classify(url.path()).0
+}
+
+/// Split a request path into its module and endpoint label
+fn classify(path: &str) -> (Module, &str) {
+    let (module, rest) = if let Some(rest) = path.strip_prefix("/rest/v1/") {
+        (Module::Database, rest)
+    } else if let Some(rest) = path.strip_prefix("/storage/v1/") {
+        (Module::Storage, rest)
+    } else if let Some(rest) = path.strip_prefix("/functions/v1/") {
+        (Module::Functions, rest)
+    } else if let Some(rest) = path.strip_prefix("/auth/v1/") {
+        (Module::Auth, rest)
+    } else {
+        (Module::Other, path.trim_start_matches('/'))
+    };
+
+    // Keep `rpc/<function>` whole; everything else is labelled by its first segment
+    let end = match rest.strip_prefix("rpc/") {
+        Some(function) if module == Module::Database => {
+            4 + function.find('/').unwrap_or(function.len())
+        }
+        _ => rest.find('/').unwrap_or(rest.len()),
+    };
+    (module, &rest[..end])
+}
+
+const SUB_BUCKET_BITS: u32 = 4;
+const SUB_BUCKETS: usize = 1 << SUB_BUCKET_BITS;
+/// Latencies are clamped to 2^40 microseconds (about 12 days)
+const MAX_EXPONENT: u32 = 40;
+const BUCKETS: usize = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) as usize * SUB_BUCKETS;
+
+/// Log-linear histogram of microsecond latencies
+struct Histogram {
+    buckets: Box<[AtomicU64]>,
+    sum_us: AtomicU64,
+    max_us: AtomicU64,
+}
+
+impl Histogram {
+    fn new() -> Self {
+        Self {
+            buckets: (0..BUCKETS).map(|_| AtomicU64::new(0)).collect(),
+            sum_us: AtomicU64::new(0),
+            max_us: AtomicU64::new(0),
+        }
+    }
+
+    fn bucket_of(value: u64) -> usize {
+        let value = value.min((1 << (MAX_EXPONENT + 1)) - 1);
+        if value < SUB_BUCKETS as u64 {
+            return value as usize;
+        }
+        let exponent = 63 - value.leading_zeros();
+        let sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) as usize & (SUB_BUCKETS - 1);
+        (exponent - SUB_BUCKET_BITS + 1) as usize * SUB_BUCKETS + sub_bucket
+    }
+
+    /// Midpoint of the values that land in `bucket`
+    fn value_of(bucket: usize) -> u64 {
+        if bucket < SUB_BUCKETS {
+            return bucket as u64;
+        }
+        let shift = (bucket / SUB_BUCKETS - 1) as u32;
+        let lower = ((SUB_BUCKETS + bucket % SUB_BUCKETS) as u64) << shift;
+        lower + ((1u64 << shift) >> 1)
+    }
+
+    fn record(&self, value_us: u64) {
+        self.buckets[Self::bucket_of(value_us)].fetch_add(1, Ordering::Relaxed);
+        self.sum_us.fetch_add(value_us, Ordering::Relaxed);
+        self.max_us.fetch_max(value_us, Ordering::Relaxed);
+    }
+
+    fn counts(&self) -> Vec<u64> {
+        self.buckets
+            .iter()
+            .map(|bucket| bucket.load(Ordering::Relaxed))
+            .collect()
+    }
+}
+
+/// Counters for one method of one endpoint
+struct Stats {
+    failures: AtomicU64,
+    bytes_out: AtomicU64,
+    bytes_in: AtomicU64,
+    latency: Histogram,
+}
+
+impl Stats {
+    fn new() -> Self {
+        Self {
+            failures: AtomicU64::new(0),
+            bytes_out: AtomicU64::new(0),
+            bytes_in: AtomicU64::new(0),
+            latency: Histogram::new(),
+        }
+    }
+}
+
+#[derive(Default)]
+struct Endpoint {
+    /// Allocated on first use, indexed like [`METHODS`]
+    methods: [OnceLock<Stats>; METHODS.len()],
+}
+
+/// Bytes before and after compression for one module
+#[derive(Default)]
+struct CompressionCounters {
+    requests_compressed: AtomicU64,
+    request_bytes_raw: AtomicU64,
+    request_bytes_sent: AtomicU64,
+    responses_decoded: AtomicU64,
+    response_bytes_received: AtomicU64,
+    response_bytes_decoded: AtomicU64,
+}
+
+struct Registry {
+    endpoints: [RwLock<HashMap<String, Arc<Endpoint>>>; Module::ALL.len()],
+    retries: [AtomicU64; Module::ALL.len()],
+    compression: [CompressionCounters; Module::ALL.len()],
+}
+
+fn registry() -> &'static Registry {
+    static REGISTRY: OnceLock<Registry> = OnceLock::new();
+    REGISTRY.get_or_init(|| Registry {
+        endpoints: Default::default(),
+        retries: Default::default(),
+        compression: Default::default(),
+    })
+}
+
+impl Registry {
+    fn endpoint(&self, module: Module, label: &str) -> Arc<Endpoint> {
+        let endpoints = &self.endpoints[module.index()];
+        if let Some(endpoint) = endpoints
+            .read()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+            .get(label)
+        {
+            return Arc::clone(endpoint);
+        }
+
+        let mut endpoints = endpoints
+            .write()
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+        let label = if endpoints.len() >= MAX_ENDPOINTS_PER_MODULE && !endpoints.contains_key(label)
+        {
+            "other"
+        } else {
+            label
+        };
+        Arc::clone(endpoints.entry(label.to_string()).or_default())
+    }
+}
+
+/// Counters a request will be recorded into
+fn stats_for(method: &reqwest::Method, url: &reqwest::Url) -> (Arc<Endpoint>, usize) {
+    let (module, label) = classify(url.path());
+    (registry().endpoint(module, label), method_index(method))
+}
+
+/// Record one completed request
+fn record(
+    (endpoint, method): (Arc<Endpoint>, usize),
+    elapsed: Duration,
+    bytes_out: u64,
+    bytes_in: Option<u64>,
+    succeeded: bool,
+) {
+    let stats = endpoint.methods[method].get_or_init(Stats::new);
+
+    stats
+        .latency
+        .record(elapsed.as_micros().min(u64::MAX as u128) as u64);
+    stats.bytes_out.fetch_add(bytes_out, Ordering::Relaxed);
+    if let Some(bytes_in) = bytes_in {
+        stats.bytes_in.fetch_add(bytes_in, Ordering::Relaxed);
+    }
+    if !succeeded {
+        stats.failures.fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+/// Count a retried request for `module`
+#[cfg(any(feature = "storage", feature = "functions"))]
+pub(crate) fn record_retry(module: Module) {
+    registry().retries[module.index()].fetch_add(1, Ordering::Relaxed);
+}
+
+/// Count a request body of `raw` bytes sent as `sent` compressed bytes
+#[cfg(all(feature = "compression", not(target_arch = "wasm32")))]
+pub(crate) fn record_request_compression(module: Module, raw: u64, sent: u64) {
+    let counters = &registry().compression[module.index()];
+    counters.requests_compressed.fetch_add(1, Ordering::Relaxed);
+    counters.request_bytes_raw.fetch_add(raw, Ordering::Relaxed);
+    counters
+        .request_bytes_sent
+        .fetch_add(sent, Ordering::Relaxed);
+}
+
+/// Count an encoded response body of `received` bytes that decoded to `decoded`
+#[cfg(all(feature = "compression", not(target_arch = "wasm32")))]
+pub(crate) fn record_response_decoding(module: Module, received: u64, decoded: u64) {
+    let counters = &registry().compression[module.index()];
+    counters.responses_decoded.fetch_add(1, Ordering::Relaxed);
+    counters
+        .response_bytes_received
+        .fetch_add(received, Ordering::Relaxed);
+    counters
+        .response_bytes_decoded
+        .fetch_add(decoded, Ordering::Relaxed);
+}
+
+/// Execute a built request, recording its latency, size and outcome
+#[cfg(not(target_arch = "wasm32"))]
+pub(crate) async fn execute_metered(
+    client: reqwest::Client,
+    request: reqwest::Request,
+) -> reqwest::Result<reqwest::Response> {
+    let stats = stats_for(request.method(), request.url());
+    let bytes_out = request
+        .body()
+        .and_then(reqwest::Body::as_bytes)
+        .map_or(0, |body| body.len() as u64);
+
+    let started = std::time::Instant::now();
+    let result = client.execute(request).await;
+    let (bytes_in, succeeded) = match &result {
+        Ok(response) => (response.content_length(), response.status().is_success()),
+        Err(_) => (None, false),
+    };
+    record(stats, started.elapsed(), bytes_out, bytes_in, succeeded);
+    result
+}
+
+/// `RequestBuilder::send` with instrumentation
+pub(crate) trait SendMetered {
+    /// Send the request, recording its latency, size and outcome
+    async fn send_metered(self) -> reqwest::Result<reqwest::Response>;
+}
+
+impl SendMetered for reqwest::RequestBuilder {
+    #[cfg(not(target_arch = "wasm32"))]
+    async fn send_metered(self) -> reqwest::Result<reqwest::Response> {
+        let (client, request) = self.build_split();
+        execute_metered(client, request?).await
+    }
+
+    /// No monotonic clock on WASM; requests are sent uninstrumented
+    #[cfg(target_arch = "wasm32")]
+    async fn send_metered(self) -> reqwest::Result<reqwest::Response> {
+        self.send().await
+    }
+}
+
+/// Latency quantiles in microseconds
+#[derive(Debug, Clone, Default, PartialEq, Serialize, Deserialize)]
+pub struct LatencySummary {
+    pub count: u64,
+    pub mean_us: f64,
+    pub p50_us: u64,
+    pub p99_us: u64,
+    pub p999_us: u64,
+    pub max_us: u64,
+}
+
+impl LatencySummary {
+    fn from_counts(counts: &[u64], sum_us: u64, max_us: u64) -> Self {
+        let count: u64 = counts.iter().sum();
+        if count == 0 {
+            return Self::default();
+        }
+        let quantile = |q: f64| {
+            let rank = ((count as f64 * q).ceil() as u64).max(1);
+            let mut seen = 0;
+            for (bucket, &n) in counts.iter().enumerate() {
+                seen += n;
+                if seen >= rank {
+                    return Histogram::value_of(bucket).min(max_us);
+                }
+            }
+            max_us
+        };
+        Self {
+            count,
+            mean_us: sum_us as f64 / count as f64,
+            p50_us: quantile(0.50),
+            p99_us: quantile(0.99),
+            p999_us: quantile(0.999),
+            max_us,
+        }
+    }
+}
+
+/// Counters for one method of one endpoint
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct EndpointSnapshot {
+    pub module: String,
+    pub method: String,
+    /// Table, function, bucket operation or auth route, e.g. `profiles` or `rpc/search`
+    pub endpoint: String,
+    pub requests: u64,
+    /// Transport errors and non-2xx responses
+    pub failures: u64,
+    pub bytes_out: u64,
+    /// Response bytes as announced by `Content-Length`
+    pub bytes_in: u64,
+    pub latency: LatencySummary,
+}
+
+/// Totals for one client module
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct ModuleSnapshot {
+    pub module: String,
+    pub requests: u64,
+    pub failures: u64,
+    pub retries: u64,
+    pub bytes_out: u64,
+    pub bytes_in: u64,
+    pub latency: LatencySummary,
+    pub compression: CompressionSnapshot,
+}
+
+/// Effect of request and response compression for one module
+#[derive(Debug, Clone, Default, PartialEq, Serialize, Deserialize)]
+pub struct CompressionSnapshot {
+    pub requests_compressed: u64,
+    /// Size of the compressed request bodies before compression
+    pub request_bytes_raw: u64,
+    pub request_bytes_sent: u64,
+    pub responses_decoded: u64,
+    /// Encoded response bytes read from the wire
+    pub response_bytes_received: u64,
+    pub response_bytes_decoded: u64,
+}
+
+impl CompressionSnapshot {
+    /// Wire bytes avoided in both directions
+    pub fn bytes_saved(&self) -> u64 {
+        self.request_bytes_raw
+            .saturating_sub(self.request_bytes_sent)
+            + self
+                .response_bytes_decoded
+                .saturating_sub(self.response_bytes_received)
+    }
+}
+
+/// Point-in-time copy of every counter
+#[derive(Debug, Clone, Default, PartialEq, Serialize, Deserialize)]
+pub struct MetricsSnapshot {
+    pub modules: Vec<ModuleSnapshot>,
+    pub endpoints: Vec<EndpointSnapshot>,
+}
+
+impl MetricsSnapshot {
+    pub fn total_requests(&self) -> u64 {
+        self.modules.iter().map(|module| module.requests).sum()
+    }
+
+    pub fn failed_requests(&self) -> u64 {
+        self.modules.iter().map(|module| module.failures).sum()
+    }
+
+    /// Mean latency over all requests, in milliseconds
+    pub fn avg_response_time_ms(&self) -> f64 {
+        let requests = self.total_requests();
+        if requests == 0 {
+            return 0.0;
+        }
+        let total_us: f64 = self
+            .modules
+            .iter()
+            .map(|module| module.latency.mean_us * module.requests as f64)
+            .sum();
+        total_us / requests as f64 / 1000.0
+    }
+}
+
+/// Copy the current counters of every module and endpoint
+///
+/// Counters only grow; exporters compute rates from successive snapshots.
+pub fn snapshot() -> MetricsSnapshot {
+    let registry = registry();
+    let mut snapshot = MetricsSnapshot::default();
+
+    for module in Module::ALL {
+        let mut totals = vec![0u64; BUCKETS];
+        let (mut failures, mut bytes_out, mut bytes_in, mut sum_us, mut max_us) = (0, 0, 0, 0, 0);
+
+        let endpoints = registry.endpoints[module.index()]
+            .read()
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+        let mut labels: Vec<_> = endpoints.iter().collect();
+        labels.sort_by(|a, b| a.0.cmp(b.0));
+
+        for (label, endpoint) in labels {
+            for (method, stats) in METHODS.iter().zip(&endpoint.methods) {
+                let Some(stats) = stats.get() else { continue };
+                let counts = stats.latency.counts();
+                let endpoint_sum = stats.latency.sum_us.load(Ordering::Relaxed);
+                let endpoint_max = stats.latency.max_us.load(Ordering::Relaxed);
+                let latency = LatencySummary::from_counts(&counts, endpoint_sum, endpoint_max);
+
+                totals.iter_mut().zip(&counts).for_each(|(t, n)| *t += n);
+                let endpoint_snapshot = EndpointSnapshot {
+                    module: module.name().to_string(),
+                    method: method.to_string(),
+                    endpoint: label.clone(),
+                    requests: latency.count,
+                    failures: stats.failures.load(Ordering::Relaxed),
+                    bytes_out: stats.bytes_out.load(Ordering::Relaxed),
+                    bytes_in: stats.bytes_in.load(Ordering::Relaxed),
+                    latency,
+                };
+                failures += endpoint_snapshot.failures;
+                bytes_out += endpoint_snapshot.bytes_out;
+                bytes_in += endpoint_snapshot.bytes_in;
+                sum_us += endpoint_sum;
+                max_us = max_us.max(endpoint_max);
+                snapshot.endpoints.push(endpoint_snapshot);
+            }
+        }
+
+        let latency = LatencySummary::from_counts(&totals, sum_us, max_us);
+        snapshot.modules.push(ModuleSnapshot {
+            module: module.name().to_string(),
+            requests: latency.count,
+            failures,
+            retries: registry.retries[module.index()].load(Ordering::Relaxed),
+            bytes_out,
+            bytes_in,
+            latency,
+            compression: registry.compression[module.index()].snapshot(),
+        });
+    }
+    snapshot
+}
+
+impl CompressionCounters {
+    fn snapshot(&self) -> CompressionSnapshot {
+        CompressionSnapshot {
+            requests_compressed: self.requests_compressed.load(Ordering::Relaxed),
+            request_bytes_raw: self.request_bytes_raw.load(Ordering::Relaxed),
+            request_bytes_sent: self.request_bytes_sent.load(Ordering::Relaxed),
+            responses_decoded: self.responses_decoded.load(Ordering::Relaxed),
+            response_bytes_received: self.response_bytes_received.load(Ordering::Relaxed),
+            response_bytes_decoded: self.response_bytes_decoded.load(Ordering::Relaxed),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_classify_paths() {
+        assert_eq!(
+            classify("/rest/v1/profiles"),
+            (Module::Database, "profiles")
+        );
+        assert_eq!(
+            classify("/rest/v1/rpc/search/extra"),
+            (Module::Database, "rpc/search")
+        );
+        assert_eq!(
+            classify("/storage/v1/object/avatars/a.png"),
+            (Module::Storage, "object")
+        );
+        assert_eq!(
+            classify("/functions/v1/hello"),
+            (Module::Functions, "hello")
+        );
+        assert_eq!(classify("/auth/v1/token"), (Module::Auth, "token"));
+        assert_eq!(classify("/health"), (Module::Other, "health"));
+    }
+
+    #[test]
+    fn test_histogram_buckets_round_trip() {
+        let mut last = 0;
+        for value in [0u64, 1, 15, 16, 17, 31, 32, 1_000, 123_456, 1 << 39] {
+            let bucket = Histogram::bucket_of(value);
+            assert!(bucket >= last && bucket < BUCKETS);
+            last = bucket;
+
+            let representative = Histogram::value_of(bucket);
+            let error = representative.abs_diff(value) as f64 / value.max(1) as f64;
+            assert!(
+                error <= 1.0 / SUB_BUCKETS as f64,
+                "{value} -> {representative}"
+            );
+        }
+        assert_eq!(Histogram::bucket_of(u64::MAX), BUCKETS - 1);
+    }
+
+    #[test]
+    fn test_quantiles() {
+        let histogram = Histogram::new();
+        for value in 1..=1000 {
+            histogram.record(value * 10);
+        }
+        let summary = LatencySummary::from_counts(
+            &histogram.counts(),
+            histogram.sum_us.load(Ordering::Relaxed),
+            histogram.max_us.load(Ordering::Relaxed),
+        );
+        assert_eq!(summary.count, 1000);
+        assert_eq!(summary.max_us, 10_000);
+        assert!((summary.mean_us - 5005.0).abs() < 1e-9);
+        assert!(summary.p50_us.abs_diff(5_000) <= 5_000 / 16);
+        assert!(summary.p99_us.abs_diff(9_900) <= 9_900 / 16);
+        assert!(summary.p999_us.abs_diff(9_990) <= 9_990 / 16);
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_send_metered_records_requests() {
+        use crate::mock_server::{MockResponse, MockServer};
+
+        let server = MockServer::start(|request| {
+            let status = if request.method == "DELETE" { 404 } else { 200 };
+            MockResponse::new(status).body("[]")
+        });
+
+        let client = reqwest::Client::new();
+        let url = format!("{}/rest/v1/metered_table?select=*", server.url());
+        for _ in 0..3 {
+            client.get(&url).send_metered().await.unwrap();
+        }
+        client
+            .post(&url)
+            .body("{\"id\":1}")
+            .send_metered()
+            .await
+            .unwrap();
+        client.delete(&url).send_metered().await.unwrap();
+        registry().retries[Module::Database.index()].fetch_add(1, Ordering::Relaxed);
+
+        let snapshot = snapshot();
+        let find = |method: &str| {
+            snapshot
+                .endpoints
+                .iter()
+                .find(|e| e.endpoint == "metered_table" && e.method == method)
+                .unwrap()
+                .clone()
+        };
+        let get = find("GET");
+        assert_eq!(
+            (get.module.as_str(), get.requests, get.failures),
+            ("database", 3, 0)
+        );
+        assert_eq!(get.bytes_in, 6);
+        assert!(get.latency.p50_us > 0 && get.latency.p999_us <= get.latency.max_us);
+        assert_eq!(find("POST").bytes_out, 8);
+        assert_eq!(find("DELETE").failures, 1);
+
+        let database = snapshot
+            .modules
+            .iter()
+            .find(|m| m.module == "database")
+            .unwrap();
+        assert!(database.requests >= 5 && database.retries >= 1);
+    }
+}
@@ -0,0 +1,294 @@
+//! Minimal HTTP/1.1 server for tests that talk to a real socket
+//!
+//! Every request is parsed in full (`Content-Length` or chunked bodies) and
+//! answered by a route closure. Connections are kept alive between requests. Each
+//! server runs on its own thread and runtime, so synchronous FFI tests can use it
+//! as well as async ones, and it stops when the [`MockServer`] is dropped.
+
+// Each test module uses a different subset of the helpers
+#![allow(dead_code)]
+
+use std::{
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc,
+    },
+    time::Duration,
+};
+use tokio::{
+    io::{AsyncBufReadExt, AsyncReadExt, AsyncWriteExt, BufReader},
+    net::TcpStream,
+};
+
+type Route = dyn Fn(&MockRequest) -> MockResponse + Send + Sync;
+
+/// A request received by a [`MockServer`]
+#[derive(Debug, Clone)]
+pub(crate) struct MockRequest {
+    pub method: String,
+    /// Path and query string as sent, e.g. `/rest/v1/users?select=*`
+    pub target: String,
+    /// Header names are lowercased
+    pub headers: Vec<(String, String)>,
+    pub body: Vec<u8>,
+}
+
+impl MockRequest {
+    /// Value of the first header called `name`
+    pub fn header(&self, name: &str) -> Option<&str> {
+        self.headers
+            .iter()
+            .find(|(key, _)| key.eq_ignore_ascii_case(name))
+            .map(|(_, value)| value.as_str())
+    }
+
+    /// Path without the query string
+    pub fn path(&self) -> &str {
+        self.target.split('?').next().unwrap_or_default()
+    }
+
+    /// Decoded value of the query parameter `name`
+    pub fn query(&self, name: &str) -> Option<String> {
+        let (_, query) = self.target.split_once('?')?;
+        url::form_urlencoded::parse(query.as_bytes())
+            .find(|(key, _)| key == name)
+            .map(|(_, value)| value.into_owned())
+    }
+
+    pub fn body_text(&self) -> String {
+        String::from_utf8_lossy(&self.body).into_owned()
+    }
+}
+
+/// The answer to a [`MockRequest`]; `Content-Length` is added automatically
+#[derive(Debug, Clone)]
+pub(crate) struct MockResponse {
+    status: u16,
+    headers: Vec<(String, String)>,
+    body: Vec<u8>,
+    delay: Duration,
+    write_size: usize,
+}
+
+impl MockResponse {
+    pub fn new(status: u16) -> Self {
+        Self {
+            status,
+            headers: Vec::new(),
+            body: Vec::new(),
+            delay: Duration::ZERO,
+            write_size: usize::MAX,
+        }
+    }
+
+    /// `200 OK` with a JSON body
+    pub fn json(body: impl Into<Vec<u8>>) -> Self {
+        Self::new(200)
+            .header("content-type", "application/json")
+            .body(body)
+    }
+
+    pub fn header(mut self, name: &str, value: impl ToString) -> Self {
+        self.headers.push((name.to_string(), value.to_string()));
+        self
+    }
+
+    pub fn body(mut self, body: impl Into<Vec<u8>>) -> Self {
+        self.body = body.into();
+        self
+    }
+
+    /// Wait this long before answering
+    pub fn delay(mut self, delay: Duration) -> Self {
+        self.delay = delay;
+        self
+    }
+
+    /// Send the body in separately flushed writes of `size` bytes
+    pub fn in_writes_of(mut self, size: usize) -> Self {
+        self.write_size = size.max(1);
+        self
+    }
+}
+
+/// HTTP server on a random local port, answering every request with `route`
+pub(crate) struct MockServer {
+    url: String,
+    connections: Arc<AtomicUsize>,
+    shutdown: Option<tokio::sync::oneshot::Sender<()>>,
+}
+
+impl MockServer {
+    pub fn start(route: impl Fn(&MockRequest) -> MockResponse + Send + Sync + 'static) -> Self {
+        let listener = std::net::TcpListener::bind("127.0.0.1:0").unwrap();
+        listener.set_nonblocking(true).unwrap();
+        let url = format!("http://{}", listener.local_addr().unwrap());
+        let connections = Arc::new(AtomicUsize::new(0));
+        let accepted = Arc::clone(&connections);
+        let (shutdown, stopped) = tokio::sync::oneshot::channel::<()>();
+        let route: Arc<Route> = Arc::new(route);
+
+        std::thread::spawn(move || {
+            let runtime = tokio::runtime::Builder::new_current_thread()
+                .enable_all()
+                .build()
+                .unwrap();
+            runtime.block_on(async move {
+                let listener = tokio::net::TcpListener::from_std(listener).unwrap();
+                let accept = async {
+                    while let Ok((socket, _)) = listener.accept().await {
+                        accepted.fetch_add(1, Ordering::SeqCst);
+                        tokio::spawn(serve_connection(socket, Arc::clone(&route)));
+                    }
+                };
+                tokio::select! {
+                    _ = accept => {}
+                    _ = stopped => {}
+                }
+            });
+        });
+
+        Self {
+            url,
+            connections,
+            shutdown: Some(shutdown),
+        }
+    }
+
+    /// Base URL, e.g. `http://127.0.0.1:40000`
+    pub fn url(&self) -> &str {
+        &self.url
+    }
+
+    /// Number of connections accepted so far
+    pub fn connections(&self) -> usize {
+        self.connections.load(Ordering::SeqCst)
+    }
+}
+
+impl Drop for MockServer {
+    fn drop(&mut self) {
+        if let Some(shutdown) = self.shutdown.take() {
+            let _ = shutdown.send(());
+        }
+    }
+}
+
+async fn serve_connection(socket: TcpStream, route: Arc<Route>) {
+    let mut socket = BufReader::new(socket);
+    while let Some(request) = read_request(&mut socket).await {
+        let close = request
+            .header("connection")
+            .is_some_and(|value| value.eq_ignore_ascii_case("close"));
+        let response = route(&request);
+        let head_only = request.method == "HEAD";
+        if write_response(socket.get_mut(), response, head_only)
+            .await
+            .is_err()
+            || close
+        {
+            return;
+        }
+    }
+}
+
+/// Read one request; `None` once the peer closes or sends something unparsable
+async fn read_request(socket: &mut BufReader<TcpStream>) -> Option<MockRequest> {
+    let mut line = String::new();
+    if socket.read_line(&mut line).await.ok()? == 0 {
+        return None;
+    }
+    let mut request_line = line.split_whitespace();
+    let method = request_line.next()?.to_string();
+    let target = request_line.next()?.to_string();
+
+    let mut headers = Vec::new();
+    loop {
+        line.clear();
+        if socket.read_line(&mut line).await.ok()? == 0 {
+            return None;
+        }
+        let header = line.trim_end();
+        if header.is_empty() {
+            break;
+        }
+        let (name, value) = header.split_once(':')?;
+        headers.push((name.trim().to_ascii_lowercase(), value.trim().to_string()));
+    }
+
+    let mut request = MockRequest {
+        method,
+        target,
+        headers,
+        body: Vec::new(),
+    };
+    let chunked = request
+        .header("transfer-encoding")
+        .is_some_and(|value| value.eq_ignore_ascii_case("chunked"));
+    let length = request.header("content-length").map(str::to_string);
+
+    if chunked {
+        loop {
+            line.clear();
+            socket.read_line(&mut line).await.ok()?;
+            let size = usize::from_str_radix(line.trim().split(';').next()?, 16).ok()?;
+            // Every chunk, including the last empty one, ends with CRLF
+            let start = request.body.len();
+            request.body.resize(start + size + 2, 0);
+            socket.read_exact(&mut request.body[start..]).await.ok()?;
+            request.body.truncate(start + size);
+            if size == 0 {
+                break;
+            }
+        }
+    } else if let Some(length) = length {
+        request.body = vec![0; length.parse().ok()?];
+        socket.read_exact(&mut request.body).await.ok()?;
+    }
+    Some(request)
+}
+
+/// Send `response`, leaving out the body when answering a `HEAD` request
+async fn write_response(
+    socket: &mut TcpStream,
+    response: MockResponse,
+    head_only: bool,
+) -> std::io::Result<()> {
+    if !response.delay.is_zero() {
+        tokio::time::sleep(response.delay).await;
+    }
+
+    let mut head = format!(
+        "HTTP/1.1 {} {}\r\n",
+        response.status,
+        reason(response.status)
+    );
+    for (name, value) in &response.headers {
+        head.push_str(&format!("{}: {}\r\n", name, value));
+    }
+    head.push_str(&format!("content-length: {}\r\n\r\n", response.body.len()));
+    socket.write_all(head.as_bytes()).await?;
+    if head_only {
+        return Ok(());
+    }
+
+    for piece in response.body.chunks(response.write_size) {
+        socket.write_all(piece).await?;
+        socket.flush().await?;
+    }
+    Ok(())
+}
+
+fn reason(status: u16) -> &'static str {
+    match status {
+        200 => "OK",
+        201 => "Created",
+        206 => "Partial Content",
+        400 => "Bad Request",
+        404 => "Not Found",
+        412 => "Precondition Failed",
+        416 => "Range Not Satisfiable",
+        500 => "Internal Server Error",
+        _ => "Unknown",
+    }
+}
@@ -8,6 +8,8 @@
 
 use crate::{
     error::{Error, Result},
+    metrics::SendMetered,
+    sharded_cache::ShardedCache,
     types::SupabaseConfig,
 };
 use reqwest::Client as HttpClient;
@@ -15,7 +17,10 @@ use serde::{Deserialize, Serialize};
 use serde_json::Value;
 use std::{
     collections::HashMap,
-    sync::Arc,
+    sync::{
+        atomic::{AtomicBool, AtomicU64, Ordering},
+        Arc, Mutex,
+    },
     time::{Duration, Instant},
 };
 
@@ -52,7 +57,10 @@ mod wasm_rwlock {
 #[cfg(target_arch = "wasm32")]
 use wasm_rwlock::RwLock;
 
-use tracing::{debug, info};
+use tracing::{debug, info, warn};
+
+/// Upper bound on results of automatic flushes waiting for `process_pending`
+const MAX_PARKED_RESULTS: usize = 10_000;
 
 /// Performance optimization manager
 #[derive(Debug, Clone)]
@@ -71,6 +79,7 @@ pub struct Performance {
 pub struct ConnectionPool {
     pools: RwLock<HashMap<String, Arc<HttpClient>>>,
     config: ConnectionPoolConfig,
+    created: AtomicU64,
 }
 
 /// Connection pool configuration
@@ -101,9 +110,14 @@ impl Default for ConnectionPoolConfig {
 }
 
 /// Request cache for API responses
+///
+/// Backed by the crate's sharded CLOCK cache: lookups only take a shard read lock,
+/// and entry and byte limits are divided evenly between the shards.
 #[derive(Debug)]
 pub struct RequestCache {
-    cache: RwLock<HashMap<String, CacheEntry>>,
+    entries: ShardedCache<Value>,
+    hits: AtomicU64,
+    misses: AtomicU64,
     config: CacheConfig,
 }
 
@@ -118,6 +132,11 @@ pub struct CacheConfig {
     pub enable_compression: bool,
     /// Cache only successful responses
     pub cache_success_only: bool,
+    /// Maximum total size of cached responses in bytes (serialized JSON plus key)
+    ///
+    /// Split evenly between up to 16 shards; a response larger than one shard's
+    /// share is never cached (over 4 MiB with the 64 MiB default).
+    pub max_bytes: usize,
 }
 
 impl Default for CacheConfig {
@@ -127,11 +146,16 @@ impl Default for CacheConfig {
             default_ttl: Duration::from_secs(300), // 5 minutes
             enable_compression: true,
             cache_success_only: true,
+            max_bytes: 64 * 1024 * 1024, // 64 MiB
         }
     }
 }
 
 /// Cache entry with metadata
+#[deprecated(
+    since = "0.5.5",
+    note = "unused since `RequestCache` became sharded; will be removed in the next breaking release"
+)]
 #[derive(Debug, Clone)]
 pub struct CacheEntry {
     /// Cached response data
@@ -147,10 +171,17 @@ pub struct CacheEntry {
 }
 
 /// Batch processing for multiple operations
-#[derive(Debug)]
+///
+/// Cloning is cheap and yields a handle to the same queue.
+#[derive(Debug, Clone)]
 pub struct BatchProcessor {
-    pending_operations: RwLock<Vec<BatchOperation>>,
+    pending_operations: Arc<RwLock<Vec<BatchOperation>>>,
+    /// Results of automatic flushes, handed out by the next explicit flush
+    completed: Arc<Mutex<Vec<BatchResult>>>,
+    http_client: Arc<HttpClient>,
     config: BatchConfig,
+    flush_scheduled: Arc<AtomicBool>,
+    total_operations: Arc<AtomicU64>,
 }
 
 /// Batch processing configuration
@@ -164,6 +195,8 @@ pub struct BatchConfig {
     pub auto_batch: bool,
     /// Batch timeout
     pub batch_timeout: Duration,
+    /// Maximum number of batch requests in flight at once
+    pub max_in_flight: usize,
 }
 
 impl Default for BatchConfig {
@@ -173,6 +206,7 @@ impl Default for BatchConfig {
             flush_interval: Duration::from_millis(100),
             auto_batch: true,
             batch_timeout: Duration::from_secs(5),
+            max_in_flight: 8,
         }
     }
 }
@@ -190,7 +224,7 @@ pub struct BatchOperation {
     pub headers: HashMap<String, String>,
     /// Request body
     pub body: Option<Value>,
-    /// Operation priority
+    /// Operation priority (lower values are sent first)
     pub priority: u8,
 }
 
@@ -216,6 +250,8 @@ pub struct PerformanceMetrics {
     pub cache_hit_ratio: f64,
     /// Cache entry count
     pub cache_entries: usize,
+    /// Total size of cached responses in bytes
+    pub cache_bytes: usize,
     /// Average response time (ms)
     pub avg_response_time_ms: f64,
     /// Total requests processed
@@ -235,7 +271,10 @@ impl Performance {
 
         let connection_pool = Arc::new(ConnectionPool::new(ConnectionPoolConfig::default()));
         let cache = Arc::new(RequestCache::new(CacheConfig::default()));
-        let batch_processor = Arc::new(BatchProcessor::new(BatchConfig::default()));
+        let batch_processor = Arc::new(BatchProcessor::new(
+            BatchConfig::default(),
+            Arc::clone(&http_client),
+        ));
 
         Ok(Self {
             http_client,
@@ -258,7 +297,7 @@ impl Performance {
 
         let connection_pool = Arc::new(ConnectionPool::new(pool_config));
         let cache = Arc::new(RequestCache::new(cache_config));
-        let batch_processor = Arc::new(BatchProcessor::new(batch_config));
+        let batch_processor = Arc::new(BatchProcessor::new(batch_config, Arc::clone(&http_client)));
 
         Ok(Self {
             http_client,
@@ -295,24 +334,39 @@ impl Performance {
     }
 
     /// Process pending batch operations
+    ///
+    /// Returns the results of every operation completed since the previous call,
+    /// including those flushed automatically on size or time, in submission order
+    /// within each flush.
+    ///
+    /// Results of automatic flushes are held until this is called. Callers that rely
+    /// on automatic batching must drain them periodically: at most 10,000 are kept,
+    /// and the oldest are discarded beyond that.
     pub async fn process_batch(&self) -> Result<Vec<BatchResult>> {
         self.batch_processor.process_pending().await
     }
 
     /// Get performance metrics
+    ///
+    /// Request counts and latency cover every HTTP call made by this process; see
+    /// [`crate::metrics::snapshot`] for the per-endpoint breakdown.
     pub async fn get_metrics(&self) -> PerformanceMetrics {
         let connection_metrics = self.connection_pool.get_metrics().await;
         let cache_metrics = self.cache.get_metrics().await;
         let batch_metrics = self.batch_processor.get_metrics().await;
+        let requests = crate::metrics::snapshot();
+        let total_requests = requests.total_requests();
+        let failed_requests = requests.failed_requests();
 
         PerformanceMetrics {
             active_connections: connection_metrics.active_count,
             cache_hit_ratio: cache_metrics.hit_ratio,
             cache_entries: cache_metrics.entry_count,
-            avg_response_time_ms: 0.0, // TODO: Implement response time tracking
-            total_requests: 0,         // TODO: Implement request tracking
-            successful_requests: 0,    // TODO: Implement success tracking
-            failed_requests: 0,        // TODO: Implement failure tracking
+            cache_bytes: cache_metrics.size_bytes,
+            avg_response_time_ms: requests.avg_response_time_ms(),
+            total_requests,
+            successful_requests: total_requests - failed_requests,
+            failed_requests,
             batched_operations: batch_metrics.total_operations,
         }
     }
@@ -339,6 +393,7 @@ impl ConnectionPool {
         Self {
             pools: RwLock::new(HashMap::new()),
             config,
+            created: AtomicU64::new(0),
         }
     }
 
@@ -353,6 +408,7 @@ impl ConnectionPool {
 
         // Create new optimized client
         let client = self.create_optimized_client().await?;
+        self.created.fetch_add(1, Ordering::Relaxed);
         let client_arc = Arc::new(client);
 
         // Store in pool
@@ -398,7 +454,7 @@ impl ConnectionPool {
         let pools = self.pools.read().await;
         ConnectionMetrics {
             active_count: pools.len(),
-            total_created: pools.len() as u64, // Simplified for now
+            total_created: self.created.load(Ordering::Relaxed),
         }
     }
 }
@@ -412,153 +468,510 @@ struct ConnectionMetrics {
 
 // Request Cache Implementation
 
+/// Length of `value` serialized as JSON, computed without allocating
+fn json_size(value: &Value) -> usize {
+    struct ByteCounter(usize);
+
+    impl std::io::Write for ByteCounter {
+        fn write(&mut self, buf: &[u8]) -> std::io::Result<usize> {
+            self.0 += buf.len();
+            Ok(buf.len())
+        }
+
+        fn flush(&mut self) -> std::io::Result<()> {
+            Ok(())
+        }
+    }
+
+    let mut counter = ByteCounter(0);
+    let _ = serde_json::to_writer(&mut counter, value);
+    counter.0
+}
+
 impl RequestCache {
     fn new(config: CacheConfig) -> Self {
         Self {
-            cache: RwLock::new(HashMap::new()),
+            entries: ShardedCache::new(config.max_entries, config.max_bytes),
+            hits: AtomicU64::new(0),
+            misses: AtomicU64::new(0),
             config,
         }
     }
 
     async fn set(&self, key: &str, data: Value, ttl: Option<Duration>) -> Result<()> {
-        let entry = CacheEntry {
-            data,
-            created_at: Instant::now(),
-            ttl: ttl.unwrap_or(self.config.default_ttl),
-            size_bytes: 0, // TODO: Calculate actual size
-            hit_count: 0,
-        };
+        let size_bytes = key.len() + json_size(&data);
+        let ttl = ttl.unwrap_or(self.config.default_ttl);
 
-        let mut cache = self.cache.write().await;
-
-        // Check cache size limit
-        if cache.len() >= self.config.max_entries {
-            self.evict_oldest(&mut cache);
+        if self.entries.insert(key, data, size_bytes, Some(ttl)) {
+            debug!("Cached response for key: {}", key);
         }
-
-        cache.insert(key.to_string(), entry);
-        debug!("Cached response for key: {}", key);
         Ok(())
     }
 
     async fn get(&self, key: &str) -> Result<Option<Value>> {
-        let mut cache = self.cache.write().await;
-
-        if let Some(entry) = cache.get_mut(key) {
-            // Check if expired
-            if entry.created_at.elapsed() > entry.ttl {
-                cache.remove(key);
-                debug!("Cache entry expired for key: {}", key);
-                return Ok(None);
-            }
-
-            // Update hit count
-            entry.hit_count += 1;
+        let data = self.entries.get(key);
+        if data.is_some() {
+            self.hits.fetch_add(1, Ordering::Relaxed);
             debug!("Cache hit for key: {}", key);
-            Ok(Some(entry.data.clone()))
         } else {
+            self.misses.fetch_add(1, Ordering::Relaxed);
             debug!("Cache miss for key: {}", key);
-            Ok(None)
         }
+        Ok(data)
     }
 
     async fn clear(&self) -> Result<()> {
-        let mut cache = self.cache.write().await;
-        cache.clear();
+        self.entries.clear();
         info!("Cache cleared");
         Ok(())
     }
 
     async fn get_metrics(&self) -> CacheMetrics {
-        let cache = self.cache.read().await;
-        let total_hits: u64 = cache.values().map(|entry| entry.hit_count).sum();
-        let total_requests = total_hits + cache.len() as u64; // Simplified calculation
+        let (entry_count, size_bytes) = self.entries.usage();
+
+        let hits = self.hits.load(Ordering::Relaxed);
+        let total_requests = hits + self.misses.load(Ordering::Relaxed);
 
         CacheMetrics {
-            entry_count: cache.len(),
+            entry_count,
+            size_bytes,
             hit_ratio: if total_requests > 0 {
-                total_hits as f64 / total_requests as f64
+                hits as f64 / total_requests as f64
             } else {
                 0.0
             },
         }
     }
-
-    fn evict_oldest(&self, cache: &mut HashMap<String, CacheEntry>) {
-        if let Some((oldest_key, _)) = cache
-            .iter()
-            .min_by_key(|(_, entry)| entry.created_at)
-            .map(|(k, v)| (k.clone(), v.created_at))
-        {
-            cache.remove(&oldest_key);
-            debug!("Evicted oldest cache entry: {}", oldest_key);
-        }
-    }
 }
 
 #[derive(Debug, Clone)]
 struct CacheMetrics {
     entry_count: usize,
+    size_bytes: usize,
     hit_ratio: f64,
 }
 
 // Batch Processor Implementation
 
 impl BatchProcessor {
-    fn new(config: BatchConfig) -> Self {
+    fn new(config: BatchConfig, http_client: Arc<HttpClient>) -> Self {
         Self {
-            pending_operations: RwLock::new(Vec::new()),
+            pending_operations: Arc::new(RwLock::new(Vec::new())),
+            completed: Arc::new(Mutex::new(Vec::new())),
+            http_client,
             config,
+            flush_scheduled: Arc::new(AtomicBool::new(false)),
+            total_operations: Arc::new(AtomicU64::new(0)),
         }
     }
 
     async fn add_operation(&self, operation: BatchOperation) -> Result<()> {
         let mut pending = self.pending_operations.write().await;
         pending.push(operation);
+        let queued = pending.len();
+        drop(pending); // Release lock
 
-        // Auto-process if batch is full
-        if self.config.auto_batch && pending.len() >= self.config.max_batch_size {
-            drop(pending); // Release lock
-            let _ = self.process_pending().await;
+        if !self.config.auto_batch {
+            return Ok(());
+        }
+
+        // Auto-process if batch is full, otherwise make sure a timed flush is pending
+        if queued >= self.config.max_batch_size {
+            let results = self.process_queue().await;
+            self.park_results(results);
+        } else {
+            self.schedule_flush();
         }
 
         Ok(())
     }
 
     async fn process_pending(&self) -> Result<Vec<BatchResult>> {
+        let mut results = self.take_parked_results();
+        results.extend(self.process_queue().await);
+        Ok(results)
+    }
+
+    /// Drain the queue and execute it
+    async fn process_queue(&self) -> Vec<BatchResult> {
         let mut pending = self.pending_operations.write().await;
         if pending.is_empty() {
-            return Ok(Vec::new());
+            return Vec::new();
         }
 
         let operations = pending.drain(..).collect::<Vec<_>>();
         drop(pending); // Release lock
 
         debug!("Processing batch of {} operations", operations.len());
+        self.total_operations
+            .fetch_add(operations.len() as u64, Ordering::Relaxed);
 
-        // TODO: Implement actual HTTP batching
-        let results = operations
-            .into_iter()
-            .map(|op| BatchResult {
-                id: op.id,
-                status: 200, // Placeholder
-                data: Some(Value::Null),
-                error: None,
-            })
-            .collect();
+        let results = self.execute(operations).await;
+        info!("Processed batch of {} operations", results.len());
+        results
+    }
 
-        Ok(results)
+    /// Keep results of an automatic flush for the next `process_pending`
+    ///
+    /// Bounded by `MAX_PARKED_RESULTS`; the oldest results are dropped first.
+    fn park_results(&self, results: Vec<BatchResult>) {
+        if results.is_empty() {
+            return;
+        }
+        if let Ok(mut completed) = self.completed.lock() {
+            completed.extend(results);
+            if completed.len() > MAX_PARKED_RESULTS {
+                let excess = completed.len() - MAX_PARKED_RESULTS;
+                warn!(
+                    "Dropping {} undrained batch results; call process_batch to collect them",
+                    excess
+                );
+                completed.drain(..excess);
+            }
+        }
+    }
+
+    fn take_parked_results(&self) -> Vec<BatchResult> {
+        self.completed
+            .lock()
+            .map(|mut completed| std::mem::take(&mut *completed))
+            .unwrap_or_default()
+    }
+
+    /// Flush the queue once `flush_interval` has elapsed, unless a flush is already pending
+    ///
+    /// Without a current Tokio runtime there is no timer to drive, so the queue is
+    /// flushed on size or explicitly.
+    #[cfg(not(target_arch = "wasm32"))]
+    fn schedule_flush(&self) {
+        let Ok(runtime) = tokio::runtime::Handle::try_current() else {
+            return;
+        };
+        if self.flush_scheduled.swap(true, Ordering::AcqRel) {
+            return;
+        }
+
+        let processor = self.clone();
+        runtime.spawn(async move {
+            tokio::time::sleep(processor.config.flush_interval).await;
+            processor.flush_scheduled.store(false, Ordering::Release);
+            let results = processor.process_queue().await;
+            processor.park_results(results);
+        });
+    }
+
+    /// Timed flushes need a timer runtime; on WASM the queue is flushed on size or explicitly
+    #[cfg(target_arch = "wasm32")]
+    fn schedule_flush(&self) {
+        let _ = &self.flush_scheduled;
+    }
+
+    /// Execute operations, coalescing compatible inserts and respecting priority
+    async fn execute(&self, operations: Vec<BatchOperation>) -> Vec<BatchResult> {
+        let mut units = plan_batch(operations, self.config.max_batch_size.max(1));
+
+        // Lowest value (most urgent) first; the sort is stable so ties keep submission order
+        units.sort_by_key(|unit| unit.priority);
+
+        let mut results: Vec<(usize, BatchResult)> = Vec::new();
+        self.run_units(units, &mut results).await;
+
+        results.sort_by_key(|(order, _)| *order);
+        results.into_iter().map(|(_, result)| result).collect()
+    }
+
+    /// Run execution units with at most `max_in_flight` requests outstanding
+    #[cfg(not(target_arch = "wasm32"))]
+    async fn run_units(&self, units: Vec<BatchUnit>, results: &mut Vec<(usize, BatchResult)>) {
+        let max_in_flight = self.config.max_in_flight.max(1);
+        let mut in_flight = tokio::task::JoinSet::new();
+        // Operations served by each task, so a task that panics or is cancelled
+        // still yields one result per operation
+        let mut task_operations: HashMap<tokio::task::Id, Vec<(usize, String)>> = HashMap::new();
+
+        for unit in units {
+            if in_flight.len() >= max_in_flight {
+                if let Some(joined) = in_flight.join_next_with_id().await {
+                    collect_unit(joined, &mut task_operations, results);
+                }
+            }
+
+            let served = unit
+                .orders
+                .iter()
+                .copied()
+                .zip(unit.operations.iter().map(|operation| operation.id.clone()))
+                .collect();
+            let http_client = Arc::clone(&self.http_client);
+            let timeout = self.config.batch_timeout;
+            let handle = in_flight.spawn(async move { unit.execute(&http_client, timeout).await });
+            task_operations.insert(handle.id(), served);
+        }
+
+        while let Some(joined) = in_flight.join_next_with_id().await {
+            collect_unit(joined, &mut task_operations, results);
+        }
+    }
+
+    /// Run execution units one after another (no task spawning on WASM)
+    #[cfg(target_arch = "wasm32")]
+    async fn run_units(&self, units: Vec<BatchUnit>, results: &mut Vec<(usize, BatchResult)>) {
+        for unit in units {
+            results.extend(
+                unit.execute(&self.http_client, self.config.batch_timeout)
+                    .await,
+            );
+        }
     }
 
     async fn get_metrics(&self) -> BatchMetrics {
         let pending = self.pending_operations.read().await;
         BatchMetrics {
             pending_operations: pending.len(),
-            total_operations: 0, // TODO: Track total processed operations
+            total_operations: self.total_operations.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// Record the outcome of a finished unit task, failing every operation it served
+/// if the task did not complete
+#[cfg(not(target_arch = "wasm32"))]
+fn collect_unit(
+    joined: std::result::Result<
+        (tokio::task::Id, Vec<(usize, BatchResult)>),
+        tokio::task::JoinError,
+    >,
+    task_operations: &mut HashMap<tokio::task::Id, Vec<(usize, String)>>,
+    results: &mut Vec<(usize, BatchResult)>,
+) {
+    match joined {
+        Ok((id, finished)) => {
+            task_operations.remove(&id);
+            results.extend(finished);
+        }
+        Err(e) => {
+            let message = format!("Batch task failed: {}", e);
+            let served = task_operations.remove(&e.id()).unwrap_or_default();
+            results.extend(served.into_iter().map(|(order, id)| {
+                (
+                    order,
+                    BatchResult {
+                        id,
+                        status: 0,
+                        data: None,
+                        error: Some(message.clone()),
+                    },
+                )
+            }));
+        }
+    }
+}
+
+/// One HTTP request produced from one or more batch operations
+#[derive(Debug)]
+struct BatchUnit {
+    priority: u8,
+    /// Submission index of every operation served by this request
+    orders: Vec<usize>,
+    operations: Vec<BatchOperation>,
+}
+
+/// Group queued operations into HTTP requests
+///
+/// Single-row PostgREST inserts (`POST /rest/v1/<table>` with an object body) that
+/// target the same URL with the same headers and the same columns are merged into
+/// bulk inserts of at most `max_rows` rows. Everything else is sent on its own.
+fn plan_batch(operations: Vec<BatchOperation>, max_rows: usize) -> Vec<BatchUnit> {
+    let mut units: Vec<BatchUnit> = Vec::new();
+    let mut open_inserts: HashMap<String, usize> = HashMap::new();
+
+    for (order, operation) in operations.into_iter().enumerate() {
+        let Some(key) = insert_coalesce_key(&operation) else {
+            units.push(BatchUnit {
+                priority: operation.priority,
+                orders: vec![order],
+                operations: vec![operation],
+            });
+            continue;
+        };
+
+        match open_inserts.get(&key).copied() {
+            Some(index) if units[index].operations.len() < max_rows => {
+                let unit = &mut units[index];
+                unit.priority = unit.priority.min(operation.priority);
+                unit.orders.push(order);
+                unit.operations.push(operation);
+            }
+            _ => {
+                open_inserts.insert(key, units.len());
+                units.push(BatchUnit {
+                    priority: operation.priority,
+                    orders: vec![order],
+                    operations: vec![operation],
+                });
+            }
+        }
+    }
+
+    units
+}
+
+/// Grouping key for inserts that PostgREST can accept as one bulk request
+fn insert_coalesce_key(operation: &BatchOperation) -> Option<String> {
+    if !operation.method.eq_ignore_ascii_case("POST")
+        || !operation.url.contains("/rest/v1/")
+        || operation.url.contains("/rest/v1/rpc/")
+    {
+        return None;
+    }
+
+    // Bulk inserts require every row to carry the same columns
+    let Some(Value::Object(row)) = &operation.body else {
+        return None;
+    };
+    let mut columns: Vec<&str> = row.keys().map(String::as_str).collect();
+    columns.sort_unstable();
+
+    let mut headers: Vec<_> = operation
+        .headers
+        .iter()
+        .map(|(name, value)| (name.to_ascii_lowercase(), value))
+        .collect();
+    headers.sort();
+
+    Some(format!(
+        "{}\u{0}{:?}\u{0}{:?}",
+        operation.url, headers, columns
+    ))
+}
+
+impl BatchUnit {
+    /// Send the request and fan the response out to the operations it served
+    async fn execute(
+        self,
+        http_client: &HttpClient,
+        timeout: Duration,
+    ) -> Vec<(usize, BatchResult)> {
+        let BatchUnit {
+            orders,
+            mut operations,
+            ..
+        } = self;
+
+        let coalesced = operations.len() > 1;
+        let body = if coalesced {
+            Some(Value::Array(
+                operations
+                    .iter_mut()
+                    .filter_map(|operation| operation.body.take())
+                    .collect(),
+            ))
+        } else {
+            operations[0].body.take()
+        };
+
+        let outcome = send_operation(http_client, &operations[0], body, timeout).await;
+
+        let ids = operations.into_iter().map(|operation| operation.id);
+        match outcome {
+            Ok((status, Some(Value::Array(rows)), None))
+                if coalesced && rows.len() == orders.len() =>
+            {
+                ids.zip(rows)
+                    .zip(orders)
+                    .map(|((id, row), order)| {
+                        (
+                            order,
+                            BatchResult {
+                                id,
+                                status,
+                                data: Some(row),
+                                error: None,
+                            },
+                        )
+                    })
+                    .collect()
+            }
+            Ok((status, data, error)) => {
+                // Without one row per operation, only the request as a whole can be reported
+                let data = if coalesced { None } else { data };
+                ids.zip(orders)
+                    .map(|(id, order)| {
+                        (
+                            order,
+                            BatchResult {
+                                id,
+                                status,
+                                data: data.clone(),
+                                error: error.clone(),
+                            },
+                        )
+                    })
+                    .collect()
+            }
+            Err(err) => {
+                let message = err.to_string();
+                ids.zip(orders)
+                    .map(|(id, order)| {
+                        (
+                            order,
+                            BatchResult {
+                                id,
+                                status: 0,
+                                data: None,
+                                error: Some(message.clone()),
+                            },
+                        )
+                    })
+                    .collect()
+            }
         }
     }
 }
 
+/// Send one operation, returning its status, parsed body and error text
+async fn send_operation(
+    http_client: &HttpClient,
+    operation: &BatchOperation,
+    body: Option<Value>,
+    #[cfg_attr(target_arch = "wasm32", allow(unused_variables))] timeout: Duration,
+) -> Result<(u16, Option<Value>, Option<String>)> {
+    let method = reqwest::Method::from_bytes(operation.method.to_ascii_uppercase().as_bytes())
+        .map_err(|_| Error::invalid_input(format!("Invalid HTTP method: {}", operation.method)))?;
+
+    let mut request = http_client.request(method, &operation.url);
+    for (name, value) in &operation.headers {
+        request = request.header(name.as_str(), value.as_str());
+    }
+    if let Some(body) = &body {
+        request = request.json(body);
+    }
+    #[cfg(not(target_arch = "wasm32"))]
+    {
+        request = request.timeout(timeout);
+    }
+
+    let response = request.send_metered().await?;
+    let status = response.status();
+    let text = response.text().await?;
+
+    if !status.is_success() {
+        let error = if text.is_empty() {
+            format!("Request failed with status: {}", status)
+        } else {
+            text
+        };
+        return Ok((status.as_u16(), None, Some(error)));
+    }
+
+    let data = if text.trim().is_empty() {
+        None
+    } else {
+        Some(serde_json::from_str(&text).unwrap_or(Value::String(text)))
+    };
+    Ok((status.as_u16(), data, None))
+}
+
 #[derive(Debug, Clone)]
 struct BatchMetrics {
     #[allow(dead_code)] // Used in future metrics implementations
@@ -592,14 +1005,66 @@ mod tests {
         assert_eq!(retrieved, Some(test_data));
     }
 
+    #[tokio::test]
+    async fn test_cache_tracks_hits_and_bytes() {
+        let cache = RequestCache::new(CacheConfig::default());
+        let data = serde_json::json!({"id": 1});
+
+        cache.set("key", data.clone(), None).await.unwrap();
+        assert_eq!(cache.get("key").await.unwrap(), Some(data));
+        assert_eq!(cache.get("missing").await.unwrap(), None);
+
+        let metrics = cache.get_metrics().await;
+        assert_eq!(metrics.entry_count, 1);
+        assert_eq!(metrics.size_bytes, "key".len() + r#"{"id":1}"#.len());
+        assert_eq!(metrics.hit_ratio, 0.5);
+
+        // Replacing an entry does not double-count its size
+        cache.set("key", serde_json::json!(12), None).await.unwrap();
+        assert_eq!(cache.get_metrics().await.size_bytes, "key".len() + 2);
+    }
+
+    #[tokio::test]
+    async fn test_cache_respects_byte_budget() {
+        let cache = RequestCache::new(CacheConfig {
+            max_entries: 1,
+            max_bytes: 32,
+            ..Default::default()
+        });
+
+        cache
+            .set("small", serde_json::json!("ok"), None)
+            .await
+            .unwrap();
+        cache
+            .set("large", serde_json::json!("x".repeat(64)), None)
+            .await
+            .unwrap();
+
+        assert_eq!(cache.get("large").await.unwrap(), None);
+        assert!(cache.get_metrics().await.size_bytes <= 32);
+    }
+
+    fn insert_operation(id: &str, url: &str, body: Value, priority: u8) -> BatchOperation {
+        BatchOperation {
+            id: id.to_string(),
+            method: "POST".to_string(),
+            url: url.to_string(),
+            headers: HashMap::new(),
+            body: Some(body),
+            priority,
+        }
+    }
+
     #[tokio::test]
     async fn test_batch_processor() {
-        let processor = BatchProcessor::new(BatchConfig::default());
+        let processor = BatchProcessor::new(BatchConfig::default(), Arc::new(HttpClient::new()));
 
+        // Nothing listens on port 1, so the request fails fast without network access
         let operation = BatchOperation {
             id: "test_op".to_string(),
             method: "GET".to_string(),
-            url: "https://example.com".to_string(),
+            url: "http://127.0.0.1:1/rest/v1/items".to_string(),
             headers: HashMap::new(),
             body: None,
             priority: 1,
@@ -611,4 +1076,100 @@ mod tests {
         assert_eq!(results.len(), 1);
         assert_eq!(results[0].id, "test_op");
     }
+
+    #[test]
+    fn test_plan_batch_coalesces_inserts() {
+        let url = "http://localhost:54321/rest/v1/events";
+        let operations = vec![
+            insert_operation("a", url, serde_json::json!({"kind": "click"}), 1),
+            insert_operation("b", url, serde_json::json!({"kind": "view"}), 0),
+            // Different columns cannot share a bulk insert
+            insert_operation("c", url, serde_json::json!({"kind": "x", "extra": 1}), 1),
+            insert_operation(
+                "d",
+                "http://localhost:54321/rest/v1/rpc/log",
+                serde_json::json!({"kind": "x"}),
+                1,
+            ),
+            insert_operation("e", url, serde_json::json!({"kind": "scroll"}), 1),
+        ];
+
+        let units = plan_batch(operations, 50);
+        let grouped: Vec<Vec<usize>> = units.iter().map(|unit| unit.orders.clone()).collect();
+        assert_eq!(grouped, vec![vec![0, 1, 4], vec![2], vec![3]]);
+        assert_eq!(units[0].priority, 0);
+    }
+
+    #[test]
+    fn test_plan_batch_respects_max_rows() {
+        let url = "http://localhost:54321/rest/v1/events";
+        let operations = (0..5)
+            .map(|i| insert_operation(&i.to_string(), url, serde_json::json!({"n": i}), 0))
+            .collect();
+
+        let sizes: Vec<usize> = plan_batch(operations, 2)
+            .iter()
+            .map(|unit| unit.operations.len())
+            .collect();
+        assert_eq!(sizes, vec![2, 2, 1]);
+    }
+
+    #[tokio::test]
+    async fn test_failed_unit_task_reports_every_operation() {
+        let mut in_flight = tokio::task::JoinSet::new();
+        let handle = in_flight.spawn(async {
+            if true {
+                panic!("unit task panicked");
+            }
+            Vec::<(usize, BatchResult)>::new()
+        });
+
+        let mut task_operations = HashMap::new();
+        task_operations.insert(
+            handle.id(),
+            vec![(0, "a".to_string()), (1, "b".to_string())],
+        );
+
+        let mut results = Vec::new();
+        while let Some(joined) = in_flight.join_next_with_id().await {
+            collect_unit(joined, &mut task_operations, &mut results);
+        }
+
+        let ids: Vec<&str> = results
+            .iter()
+            .map(|(_, result)| result.id.as_str())
+            .collect();
+        assert_eq!(ids, vec!["a", "b"]);
+        assert!(results.iter().all(|(_, result)| result.error.is_some()));
+    }
+
+    #[test]
+    fn test_schedule_flush_without_runtime_is_skipped() {
+        let processor = BatchProcessor::new(BatchConfig::default(), Arc::new(HttpClient::new()));
+
+        processor.schedule_flush();
+        assert!(!processor.flush_scheduled.load(Ordering::Acquire));
+    }
+
+    #[tokio::test]
+    async fn test_batch_results_cover_every_operation() {
+        let config = BatchConfig {
+            max_batch_size: 3,
+            ..Default::default()
+        };
+        let processor = BatchProcessor::new(config, Arc::new(HttpClient::new()));
+        let url = "http://127.0.0.1:1/rest/v1/events";
+
+        // The third operation fills the batch and triggers an automatic flush
+        for i in 0..4 {
+            let operation = insert_operation(&i.to_string(), url, serde_json::json!({"n": i}), 0);
+            processor.add_operation(operation).await.unwrap();
+        }
+
+        let results = processor.process_pending().await.unwrap();
+        let ids: Vec<&str> = results.iter().map(|result| result.id.as_str()).collect();
+        assert_eq!(ids, vec!["0", "1", "2", "3"]);
+        assert!(results.iter().all(|result| result.error.is_some()));
+        assert_eq!(processor.get_metrics().await.total_operations, 4);
+    }
 }
@@ -60,9 +60,9 @@ use tracing::{debug, error, info, warn};
 #[cfg(feature = "realtime")]
 use uuid::Uuid;
 
-/// Type alias for complex connection storage
+/// Idle connections of a [`ConnectionPool`], used as a stack
 #[cfg(feature = "realtime")]
-pub type ConnectionStorage = Arc<RuntimeLock<Vec<Option<Box<dyn WebSocketConnection>>>>>;
+pub type ConnectionStorage = Arc<std::sync::Mutex<Vec<Box<dyn WebSocketConnection>>>>;
 
 /// Realtime client for WebSocket subscriptions
 ///
@@ -103,9 +103,91 @@ struct ConnectionManager {
     connection: RuntimeLock<Option<Box<dyn WebSocketConnection>>>,
     ref_counter: AtomicU64,
     subscriptions: RuntimeLock<HashMap<String, Subscription>>,
+    /// Joined topics, shared by every subscription on the same topic
+    channels: RuntimeLock<HashMap<String, Channel>>,
+    /// Topic -> subscriptions, replaced wholesale per topic on (un)subscribe so
+    /// dispatch only holds the lock for a lookup
+    routes: std::sync::RwLock<HashMap<String, Arc<[Route]>>>,
     is_message_loop_running: AtomicBool,
 }
 
+#[cfg(feature = "realtime")]
+impl ConnectionManager {
+    fn routes_mut(&self) -> std::sync::RwLockWriteGuard<'_, HashMap<String, Arc<[Route]>>> {
+        self.routes
+            .write()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+
+    /// Subscriptions to deliver a message on `topic` to
+    ///
+    /// Topics are matched exactly; a prefix match is only looked for when no
+    /// subscription is registered on the topic itself.
+    fn routes_for(&self, topic: &str) -> Arc<[Route]> {
+        let routes = self
+            .routes
+            .read()
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+
+        if let Some(routes) = routes.get(topic) {
+            return Arc::clone(routes);
+        }
+
+        routes
+            .iter()
+            .filter(|(subscribed, _)| Realtime::topic_matches(subscribed, topic))
+            .flat_map(|(_, routes)| routes.iter().cloned())
+            .collect()
+    }
+
+    fn add_route(&self, subscription: &Subscription) {
+        let route = Route {
+            subscription_id: subscription.id.clone(),
+            event: subscription.config.event.clone(),
+            callback: subscription.callback.clone(),
+        };
+
+        let mut routes = self.routes_mut();
+        let updated = match routes.get(&subscription.topic) {
+            Some(existing) => existing.iter().cloned().chain([route]).collect(),
+            None => Arc::from([route]),
+        };
+        routes.insert(subscription.topic.clone(), updated);
+    }
+
+    fn remove_route(&self, topic: &str, subscription_id: &str) {
+        let mut routes = self.routes_mut();
+        let Some(existing) = routes.get(topic) else {
+            return;
+        };
+
+        let remaining: Arc<[Route]> = existing
+            .iter()
+            .filter(|route| route.subscription_id != subscription_id)
+            .cloned()
+            .collect();
+        if remaining.is_empty() {
+            routes.remove(topic);
+        } else {
+            routes.insert(topic.to_string(), remaining);
+        }
+    }
+}
+
+/// How long the message loop waits for a frame before letting senders use the
+/// connection
+#[cfg(all(feature = "realtime", not(target_arch = "wasm32")))]
+const RECEIVE_POLL: Duration = Duration::from_millis(50);
+
+/// A topic joined on the server, multiplexed across its subscriptions
+#[cfg(feature = "realtime")]
+#[derive(Debug)]
+struct Channel {
+    join_ref: String,
+    join_payload: serde_json::Value,
+    subscribers: Vec<String>,
+}
+
 #[cfg(feature = "realtime")]
 impl std::fmt::Debug for ConnectionManager {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
@@ -115,6 +197,7 @@ impl std::fmt::Debug for ConnectionManager {
             .field("ref_counter", &self.ref_counter)
             .field("connection", &"<WebSocket connection>")
             .field("subscriptions", &"<subscriptions>")
+            .field("channels", &"<channels>")
             .finish()
     }
 }
@@ -126,10 +209,57 @@ pub struct Subscription {
     pub id: String,
     pub topic: String,
     pub config: SubscriptionConfig,
+    pub callback: SubscriptionCallback,
+}
+
+/// Callback invoked for messages delivered to a subscription
+#[cfg(feature = "realtime")]
+#[derive(Clone)]
+pub enum SubscriptionCallback {
+    /// Receives each message with its payload deserialized into a [`RealtimeMessage`]
     #[cfg(not(target_arch = "wasm32"))]
-    pub callback: Arc<dyn Fn(RealtimeMessage) + Send + Sync>,
+    Message(Arc<dyn Fn(RealtimeMessage) + Send + Sync>),
+    /// Receives each message with its payload deserialized into a [`RealtimeMessage`]
     #[cfg(target_arch = "wasm32")]
-    pub callback: Arc<dyn Fn(RealtimeMessage)>,
+    Message(Arc<dyn Fn(RealtimeMessage)>),
+    /// Receives a borrowed [`RealtimeFrame`]; the payload is only parsed on request
+    #[cfg(not(target_arch = "wasm32"))]
+    Frame(Arc<dyn Fn(&RealtimeFrame<'_>) + Send + Sync>),
+    /// Receives a borrowed [`RealtimeFrame`]; the payload is only parsed on request
+    #[cfg(target_arch = "wasm32")]
+    Frame(Arc<dyn Fn(&RealtimeFrame<'_>)>),
+}
+
+/// Subscription on a topic as seen by the dispatcher
+#[cfg(feature = "realtime")]
+#[derive(Clone)]
+struct Route {
+    subscription_id: String,
+    event: Option<RealtimeEvent>,
+    callback: SubscriptionCallback,
+}
+
+#[cfg(feature = "realtime")]
+impl Route {
+    /// Whether `frame` should be delivered to this subscription
+    ///
+    /// Only database changes are filtered; everything else is delivered.
+    /// `change` caches the frame's change type, which is read from the payload
+    /// the first time a route needs it and shared by all routes of the frame.
+    fn accepts(
+        &self,
+        frame: &RealtimeFrame<'_>,
+        change: &mut Option<Option<RealtimeEvent>>,
+    ) -> bool {
+        let filter = match self.event {
+            None | Some(RealtimeEvent::All) => return true,
+            Some(ref filter) => filter,
+        };
+        if !frame.is_change() {
+            return true;
+        }
+        change.get_or_insert_with(|| frame.change_event()).as_ref() == Some(filter)
+    }
 }
 
 #[cfg(feature = "realtime")]
@@ -276,6 +406,139 @@ pub struct RealtimePayload {
     pub old: Option<serde_json::Value>,
 }
 
+/// Borrowed view of a message received from Supabase
+///
+/// Only the envelope (topic, event and ref) is parsed when a frame arrives; the
+/// payload stays a slice of the received text until [`RealtimeFrame::payload`]
+/// or [`RealtimeFrame::to_message`] is called.
+#[cfg(feature = "realtime")]
+#[derive(Debug, Clone, Copy)]
+pub struct RealtimeFrame<'a> {
+    topic: &'a str,
+    event: &'a str,
+    ref_id: Option<&'a str>,
+    payload: &'a serde_json::value::RawValue,
+}
+
+#[cfg(feature = "realtime")]
+impl<'a> RealtimeFrame<'a> {
+    /// Topic the message was sent on
+    pub fn topic(&self) -> &'a str {
+        self.topic
+    }
+
+    /// Event name, e.g. `INSERT` or `broadcast`
+    pub fn event(&self) -> &'a str {
+        self.event
+    }
+
+    /// Message reference, if the server sent one
+    pub fn ref_id(&self) -> Option<&'a str> {
+        self.ref_id
+    }
+
+    /// Payload exactly as received, as JSON text
+    pub fn payload_json(&self) -> &'a str {
+        self.payload.get()
+    }
+
+    /// Deserialize the payload, borrowing from the received text where `T` allows
+    pub fn payload<T: Deserialize<'a>>(&self) -> Result<T> {
+        serde_json::from_str(self.payload.get()).map_err(Error::from)
+    }
+
+    /// Parse the envelope of `text` and run `f` on the resulting frame
+    pub(crate) fn parse<R>(text: &str, f: impl FnOnce(&RealtimeFrame<'_>) -> R) -> Result<R> {
+        let envelope: FrameEnvelope<'_> = serde_json::from_str(text)?;
+        let frame = RealtimeFrame {
+            topic: &envelope.topic,
+            event: &envelope.event,
+            ref_id: envelope.ref_id.as_deref(),
+            payload: envelope.payload,
+        };
+        Ok(f(&frame))
+    }
+
+    /// Type of database change carried by the frame
+    ///
+    /// `postgres_changes` frames carry it in the payload's `data.type` (or
+    /// `type`), which is read without deserializing the rest of the payload;
+    /// legacy change frames are named after it. `None` for frames that are not
+    /// database changes, or whose change type is unreadable.
+    pub fn change_event(&self) -> Option<RealtimeEvent> {
+        if self.event != "postgres_changes" {
+            return change_event_named(self.event);
+        }
+
+        let change: ChangeEnvelope<'_> = serde_json::from_str(self.payload.get()).ok()?;
+        change
+            .data
+            .and_then(|data| data.change_type)
+            .or(change.change_type)
+            .and_then(|name| change_event_named(&name))
+    }
+
+    /// Whether the frame is a database change, in either protocol version
+    fn is_change(&self) -> bool {
+        matches!(
+            self.event,
+            "postgres_changes" | "INSERT" | "UPDATE" | "DELETE"
+        )
+    }
+
+    /// Deserialize the whole frame into an owned [`RealtimeMessage`]
+    pub fn to_message(&self) -> Result<RealtimeMessage> {
+        Ok(RealtimeMessage {
+            event: self.event.to_string(),
+            payload: self.payload()?,
+            ref_id: self.ref_id.map(str::to_string),
+            topic: self.topic.to_string(),
+        })
+    }
+}
+
+/// Envelope of an incoming Phoenix frame, with the payload left unparsed
+#[cfg(feature = "realtime")]
+#[derive(Deserialize)]
+struct FrameEnvelope<'a> {
+    #[serde(borrow)]
+    topic: std::borrow::Cow<'a, str>,
+    #[serde(borrow)]
+    event: std::borrow::Cow<'a, str>,
+    #[serde(default, borrow, rename = "ref", alias = "ref_id")]
+    ref_id: Option<std::borrow::Cow<'a, str>>,
+    #[serde(borrow)]
+    payload: &'a serde_json::value::RawValue,
+}
+
+/// `postgres_changes` payload, read only as far as the change type
+#[cfg(feature = "realtime")]
+#[derive(Deserialize)]
+struct ChangeEnvelope<'a> {
+    #[serde(default, borrow)]
+    data: Option<ChangeType<'a>>,
+    #[serde(default, borrow, rename = "type")]
+    change_type: Option<std::borrow::Cow<'a, str>>,
+}
+
+#[cfg(feature = "realtime")]
+#[derive(Deserialize)]
+struct ChangeType<'a> {
+    #[serde(default, borrow, rename = "type")]
+    change_type: Option<std::borrow::Cow<'a, str>>,
+}
+
+/// Change event for a change type name such as `INSERT`
+#[cfg(feature = "realtime")]
+fn change_event_named(name: &str) -> Option<RealtimeEvent> {
+    match name {
+        "INSERT" => Some(RealtimeEvent::Insert),
+        "UPDATE" => Some(RealtimeEvent::Update),
+        "DELETE" => Some(RealtimeEvent::Delete),
+        _ => None,
+    }
+}
+
 /// Supabase realtime protocol message for sending to server
 #[cfg(feature = "realtime")]
 #[derive(Debug, Serialize)]
@@ -375,7 +638,7 @@ pub enum FilterOperator {
 #[cfg(feature = "realtime")]
 #[derive(Debug, Clone)]
 pub struct ConnectionPoolConfig {
-    /// Maximum number of connections in pool (default: 10)
+    /// Maximum number of idle connections kept in the pool (default: 10)
     pub max_connections: usize,
     /// Connection timeout in seconds (default: 30)
     pub connection_timeout: u64,
@@ -400,11 +663,18 @@ impl Default for ConnectionPoolConfig {
 }
 
 /// Connection pool for efficient WebSocket management
+///
+/// Acquiring and returning a connection are O(1): idle connections are kept on a
+/// stack behind a lock that is only held for a push or pop (never across an
+/// `.await`). The most recently returned connection is reused first.
+///
+/// `max_connections` bounds the idle connections the pool keeps. A checked-out
+/// connection belongs to the caller, so dropping it instead of returning it
+/// costs the pool nothing.
 #[cfg(feature = "realtime")]
 pub struct ConnectionPool {
     config: ConnectionPoolConfig,
-    connections: ConnectionStorage,
-    active_connections: Arc<AtomicU64>,
+    idle: ConnectionStorage,
 }
 
 #[cfg(feature = "realtime")]
@@ -412,7 +682,7 @@ impl std::fmt::Debug for ConnectionPool {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         f.debug_struct("ConnectionPool")
             .field("config", &self.config)
-            .field("active_connections", &self.active_connections)
+            .field("idle_connections", &self.idle_connections().len())
             .finish()
     }
 }
@@ -421,56 +691,63 @@ impl std::fmt::Debug for ConnectionPool {
 impl ConnectionPool {
     /// Create a new connection pool
     pub fn new(config: ConnectionPoolConfig) -> Self {
-        let mut connections = Vec::new();
-        connections.resize_with(config.max_connections, || None);
-
         Self {
+            idle: Arc::new(std::sync::Mutex::new(Vec::with_capacity(
+                config.max_connections,
+            ))),
             config,
-            connections: Arc::new(RuntimeLock::new(connections)),
-            active_connections: Arc::new(AtomicU64::new(0)),
         }
     }
 
+    fn idle_connections(&self) -> std::sync::MutexGuard<'_, Vec<Box<dyn WebSocketConnection>>> {
+        self.idle
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+
     /// Get an available connection from the pool
+    ///
+    /// Returns an idle connected connection when there is one and otherwise a new
+    /// (not yet connected) connection. Returns `None` only for a pool with a
+    /// `max_connections` of zero.
     pub async fn get_connection(&self) -> Result<Option<Box<dyn WebSocketConnection>>> {
-        let mut connections = self.connections.write().await;
-
-        for connection_slot in connections.iter_mut() {
-            if let Some(connection) = connection_slot.take() {
-                if connection.is_connected() {
-                    debug!("Reusing existing connection from pool");
-                    return Ok(Some(connection));
-                }
+        loop {
+            let Some(connection) = self.idle_connections().pop() else {
+                break;
+            };
+            if connection.is_connected() {
+                debug!("Reusing existing connection from pool");
+                return Ok(Some(connection));
             }
+            debug!("Dropping connection that closed while idle");
         }
 
-        // No available connections, try to create a new one
-        for connection_slot in connections.iter_mut() {
-            if connection_slot.is_none() {
-                let new_connection = crate::websocket::create_websocket();
-                *connection_slot = Some(new_connection);
-                self.active_connections
-                    .fetch_add(1, std::sync::atomic::Ordering::SeqCst);
-                debug!("Created new connection in pool");
-                return Ok(connection_slot.take());
-            }
+        if self.config.max_connections == 0 {
+            debug!("Connection pool has no capacity");
+            return Ok(None);
         }
 
-        debug!("Connection pool is full");
-        Ok(None)
+        debug!("Created new connection in pool");
+        Ok(Some(create_websocket()))
     }
 
     /// Return a connection to the pool
+    ///
+    /// Connections that are no longer connected, or that arrive while
+    /// `max_connections` connections are already idle, are dropped.
     pub async fn return_connection(&self, connection: Box<dyn WebSocketConnection>) {
-        let mut connections = self.connections.write().await;
+        if !connection.is_connected() {
+            debug!("Dropping closed connection returned to pool");
+            return;
+        }
 
-        for connection_slot in connections.iter_mut() {
-            if connection_slot.is_none() {
-                *connection_slot = Some(connection);
-                debug!("Returned connection to pool");
-                return;
-            }
+        let mut idle = self.idle_connections();
+        if idle.len() < self.config.max_connections {
+            idle.push(connection);
+            debug!("Returned connection to pool");
+            return;
         }
+        drop(idle);
 
         // Pool is full, close the connection
         warn!("Pool is full, dropping connection");
@@ -478,36 +755,35 @@ impl ConnectionPool {
 
     /// Get pool statistics
     pub async fn get_stats(&self) -> ConnectionPoolStats {
-        let connections = self.connections.read().await;
-        let total = connections.len();
-        let active = connections.iter().filter(|c| c.is_some()).count();
-        let available = connections
+        let idle = self.idle_connections();
+        let available = idle
             .iter()
-            .filter(|c| c.as_ref().is_some_and(|conn| conn.is_connected()))
+            .filter(|connection| connection.is_connected())
             .count();
 
         ConnectionPoolStats {
-            total_connections: total,
-            active_connections: active,
+            total_connections: self.config.max_connections,
+            active_connections: idle.len(),
             available_connections: available,
             max_connections: self.config.max_connections,
         }
     }
 
-    /// Close all connections in the pool
+    /// Close all idle connections in the pool
+    ///
+    /// Connections currently checked out are not affected.
     pub async fn close_all(&self) -> Result<()> {
-        let mut connections = self.connections.write().await;
+        let connections = std::mem::take(&mut *self.idle_connections());
 
-        for connection_slot in connections.iter_mut() {
-            if let Some(mut connection) = connection_slot.take() {
-                connection.close().await?;
+        let mut result = Ok(());
+        for mut connection in connections {
+            if let Err(e) = connection.close().await {
+                result = Err(e);
             }
         }
 
-        self.active_connections
-            .store(0, std::sync::atomic::Ordering::SeqCst);
         info!("Closed all connections in pool");
-        Ok(())
+        result
     }
 }
 
@@ -515,8 +791,11 @@ impl ConnectionPool {
 #[cfg(feature = "realtime")]
 #[derive(Debug, Clone)]
 pub struct ConnectionPoolStats {
+    /// Number of connection slots (the pool's capacity)
     pub total_connections: usize,
+    /// Connections held by the pool; checked-out connections are not counted
     pub active_connections: usize,
+    /// Held connections that are still connected and ready to be reused
     pub available_connections: usize,
     pub max_connections: usize,
 }
@@ -554,6 +833,8 @@ impl Realtime {
             connection: RuntimeLock::new(None),
             ref_counter: AtomicU64::new(0),
             subscriptions: RuntimeLock::new(HashMap::new()),
+            channels: RuntimeLock::new(HashMap::new()),
+            routes: std::sync::RwLock::new(HashMap::new()),
             is_message_loop_running: AtomicBool::new(false),
         });
 
@@ -638,6 +919,9 @@ impl Realtime {
         *connection_guard = None;
 
         // Clear all subscriptions
+        let mut channels = self.connection_manager.channels.write().await;
+        channels.clear();
+        self.connection_manager.routes_mut().clear();
         let mut subscriptions = self.connection_manager.subscriptions.write().await;
         subscriptions.clear();
 
@@ -694,6 +978,8 @@ impl Realtime {
 
     /// Unsubscribe from a channel
     ///
+    /// The topic is left on the server once its last subscription is removed.
+    ///
     /// # Examples
     /// ```rust,no_run
     /// # use supabase_lib_rs::Client;
@@ -715,15 +1001,37 @@ impl Realtime {
     pub async fn unsubscribe(&self, subscription_id: &str) -> Result<()> {
         debug!("Unsubscribing from subscription: {}", subscription_id);
 
-        let mut subscriptions = self.connection_manager.subscriptions.write().await;
-        if let Some(subscription) = subscriptions.remove(subscription_id) {
+        let mut channels = self.connection_manager.channels.write().await;
+        let removed = self
+            .connection_manager
+            .subscriptions
+            .write()
+            .await
+            .remove(subscription_id);
+
+        let Some(subscription) = removed else {
+            warn!("Subscription {} not found for unsubscribe", subscription_id);
+            return Ok(());
+        };
+
+        self.connection_manager
+            .remove_route(&subscription.topic, subscription_id);
+
+        let last_subscriber = match channels.get_mut(&subscription.topic) {
+            Some(channel) => {
+                channel.subscribers.retain(|id| id != subscription_id);
+                channel.subscribers.is_empty()
+            }
+            None => true,
+        };
+
+        if last_subscriber {
+            channels.remove(&subscription.topic);
             // Send leave message to server
             self.send_leave_message(&subscription.topic).await?;
-            info!("Unsubscribed from subscription: {}", subscription_id);
-        } else {
-            warn!("Subscription {} not found for unsubscribe", subscription_id);
         }
 
+        info!("Unsubscribed from subscription: {}", subscription_id);
         Ok(())
     }
 
@@ -737,33 +1045,11 @@ impl Realtime {
     where
         F: Fn(RealtimeMessage) + Send + Sync + 'static,
     {
-        let subscription_id = Uuid::new_v4().to_string();
-        let topic = self.build_topic(&subscription_config);
-
-        debug!(
-            "Creating subscription {} for topic {}",
-            subscription_id, topic
-        );
-
-        // Ensure we're connected
-        self.connect().await?;
-
-        // Send join message to server
-        self.send_join_message(&topic, &subscription_config).await?;
-
-        // Store subscription
-        let subscription = Subscription {
-            id: subscription_id.clone(),
-            topic: topic.clone(),
-            config: subscription_config,
-            callback: Arc::new(callback),
-        };
-
-        let mut subscriptions = self.connection_manager.subscriptions.write().await;
-        subscriptions.insert(subscription_id.clone(), subscription);
-
-        info!("Subscribed to topic {} with ID {}", topic, subscription_id);
-        Ok(subscription_id)
+        self.subscribe_with(
+            subscription_config,
+            SubscriptionCallback::Message(Arc::new(callback)),
+        )
+        .await
     }
 
     /// Subscribe to a channel with custom configuration (WASM version)
@@ -776,6 +1062,76 @@ impl Realtime {
     where
         F: Fn(RealtimeMessage) + 'static,
     {
+        self.subscribe_with(
+            subscription_config,
+            SubscriptionCallback::Message(Arc::new(callback)),
+        )
+        .await
+    }
+
+    /// Subscribe to a channel, receiving borrowed frames instead of owned messages
+    ///
+    /// The callback gets a [`RealtimeFrame`] pointing into the received text, so
+    /// nothing is allocated or deserialized per message unless the callback asks
+    /// for the payload.
+    ///
+    /// # Examples
+    /// ```rust,no_run
+    /// # use supabase_lib_rs::Client;
+    /// # use supabase_lib_rs::realtime::SubscriptionConfig;
+    /// # async fn example() -> supabase_lib_rs::Result<()> {
+    /// let client = Client::new("your-url", "your-key")?;
+    ///
+    /// let config = SubscriptionConfig {
+    ///     table: Some("events".to_string()),
+    ///     ..Default::default()
+    /// };
+    /// client.realtime().subscribe_frames(config, |frame| {
+    ///     if frame.event() == "INSERT" {
+    ///         println!("{} bytes of payload", frame.payload_json().len());
+    ///     }
+    /// }).await?;
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(not(target_arch = "wasm32"))]
+    pub async fn subscribe_frames<F>(
+        &self,
+        subscription_config: SubscriptionConfig,
+        callback: F,
+    ) -> Result<String>
+    where
+        F: Fn(&RealtimeFrame<'_>) + Send + Sync + 'static,
+    {
+        self.subscribe_with(
+            subscription_config,
+            SubscriptionCallback::Frame(Arc::new(callback)),
+        )
+        .await
+    }
+
+    /// Subscribe to a channel, receiving borrowed frames (WASM version)
+    #[cfg(target_arch = "wasm32")]
+    pub async fn subscribe_frames<F>(
+        &self,
+        subscription_config: SubscriptionConfig,
+        callback: F,
+    ) -> Result<String>
+    where
+        F: Fn(&RealtimeFrame<'_>) + 'static,
+    {
+        self.subscribe_with(
+            subscription_config,
+            SubscriptionCallback::Frame(Arc::new(callback)),
+        )
+        .await
+    }
+
+    async fn subscribe_with(
+        &self,
+        subscription_config: SubscriptionConfig,
+        callback: SubscriptionCallback,
+    ) -> Result<String> {
         let subscription_id = Uuid::new_v4().to_string();
         let topic = self.build_topic(&subscription_config);
 
@@ -787,35 +1143,35 @@ impl Realtime {
         // Ensure we're connected
         self.connect().await?;
 
-        // Send join message to server
-        self.send_join_message(&topic, &subscription_config).await?;
-
-        // Store subscription
+        let join_payload = Self::join_payload(&subscription_config);
         let subscription = Subscription {
             id: subscription_id.clone(),
             topic: topic.clone(),
             config: subscription_config,
-            callback: Arc::new(callback),
+            callback,
         };
-
-        let mut subscriptions = self.connection_manager.subscriptions.write().await;
-        subscriptions.insert(subscription_id.clone(), subscription);
+        self.attach(subscription, join_payload).await?;
 
         info!("Subscribed to topic {} with ID {}", topic, subscription_id);
         Ok(subscription_id)
     }
 
     /// Build topic string from subscription config
+    ///
+    /// Filtered table subscriptions get their own topic so that subscriptions with
+    /// different filters on the same table don't share a join.
     fn build_topic(&self, config: &SubscriptionConfig) -> String {
-        if let Some(ref table) = config.table {
-            format!("realtime:{}:{}", config.schema, table)
-        } else {
-            format!("realtime:{}", config.schema)
+        match (&config.table, &config.filter) {
+            (Some(table), Some(filter)) => {
+                format!("realtime:{}:{}:{}", config.schema, table, filter)
+            }
+            (Some(table), None) => format!("realtime:{}:{}", config.schema, table),
+            (None, _) => format!("realtime:{}", config.schema),
         }
     }
 
-    /// Send join message to Supabase realtime server
-    async fn send_join_message(&self, topic: &str, config: &SubscriptionConfig) -> Result<()> {
+    /// Build the join payload sent to Supabase realtime server for `config`
+    fn join_payload(config: &SubscriptionConfig) -> serde_json::Value {
         let mut payload = serde_json::Map::new();
 
         if let Some(ref table) = config.table {
@@ -845,14 +1201,101 @@ impl Realtime {
             );
         }
 
-        let message = RealtimeProtocolMessage {
-            topic: topic.to_string(),
-            event: "phx_join".to_string(),
-            payload: serde_json::Value::Object(payload),
-            ref_id: Uuid::new_v4().to_string(),
+        serde_json::Value::Object(payload)
+    }
+
+    /// Generate the next message reference
+    fn next_ref(&self) -> String {
+        self.connection_manager
+            .ref_counter
+            .fetch_add(1, Ordering::SeqCst)
+            .to_string()
+    }
+
+    /// Register `subscription` on its topic, joining the topic if needed
+    ///
+    /// Only the first subscription on a topic sends `phx_join`; later ones share
+    /// the existing join. A subscription that differs from the joined
+    /// configuration only by event rejoins the topic for all events; the
+    /// dispatcher still delivers each subscription only the change types it asked
+    /// for (see `Route::accepts`). Any other difference is an error.
+    async fn attach(
+        &self,
+        subscription: Subscription,
+        join_payload: serde_json::Value,
+    ) -> Result<()> {
+        let mut channels = self.connection_manager.channels.write().await;
+        let topic = subscription.topic.clone();
+
+        let join = match channels.get(&topic) {
+            None => Some(join_payload),
+            Some(channel) if channel.join_payload == join_payload => None,
+            Some(channel) => {
+                let widened = Self::with_any_event(&channel.join_payload);
+                if widened != Self::with_any_event(&join_payload) {
+                    return Err(Error::realtime(format!(
+                        "Topic {} is already joined with a different configuration",
+                        topic
+                    )));
+                }
+                (widened != channel.join_payload).then_some(widened)
+            }
         };
 
-        self.send_message(&message).await
+        if let Some(join_payload) = join {
+            let join_ref = self.next_ref();
+            let message = RealtimeProtocolMessage {
+                topic: topic.clone(),
+                event: "phx_join".to_string(),
+                payload: join_payload.clone(),
+                ref_id: join_ref.clone(),
+            };
+            // Nothing is recorded until the join has been sent
+            self.send_message(&message).await?;
+
+            let channel = channels.entry(topic.clone()).or_insert_with(|| Channel {
+                join_ref: String::new(),
+                join_payload: serde_json::Value::Null,
+                subscribers: Vec::new(),
+            });
+            channel.join_ref = join_ref;
+            channel.join_payload = join_payload;
+        }
+
+        if let Some(channel) = channels.get_mut(&topic) {
+            debug!(
+                "Topic {} (join ref {}) now has {} subscribers",
+                topic,
+                channel.join_ref,
+                channel.subscribers.len() + 1
+            );
+            channel.subscribers.push(subscription.id.clone());
+        }
+
+        self.connection_manager.add_route(&subscription);
+        let mut subscriptions = self.connection_manager.subscriptions.write().await;
+        subscriptions.insert(subscription.id.clone(), subscription);
+        Ok(())
+    }
+
+    /// Copy of a join payload that listens for every event
+    fn with_any_event(join_payload: &serde_json::Value) -> serde_json::Value {
+        let mut payload = join_payload.clone();
+        let any = serde_json::Value::String("*".to_string());
+        match payload
+            .pointer_mut("/config/postgres_changes/0")
+            .and_then(serde_json::Value::as_object_mut)
+        {
+            Some(changes) => {
+                changes.insert("event".to_string(), any);
+            }
+            None => {
+                if let Some(object) = payload.as_object_mut() {
+                    object.insert("event".to_string(), any);
+                }
+            }
+        }
+        payload
     }
 
     /// Send leave message to Supabase realtime server
@@ -861,7 +1304,7 @@ impl Realtime {
             topic: topic.to_string(),
             event: "phx_leave".to_string(),
             payload: serde_json::Value::Object(serde_json::Map::new()),
-            ref_id: Uuid::new_v4().to_string(),
+            ref_id: self.next_ref(),
         };
 
         self.send_message(&message).await
@@ -925,6 +1368,9 @@ impl Realtime {
     }
 
     /// Main message processing loop
+    ///
+    /// The connection lock is only held while waiting up to [`RECEIVE_POLL`] for a
+    /// frame, so sends are never blocked behind an idle connection for longer.
     async fn message_loop(
         connection_manager: Arc<ConnectionManager>,
         loop_handle: Arc<AtomicBool>,
@@ -933,7 +1379,7 @@ impl Realtime {
 
         while loop_handle.load(Ordering::SeqCst) {
             // Try to receive messages
-            let message = {
+            let received = {
                 let mut connection_guard = connection_manager.connection.write().await;
 
                 if let Some(ref mut connection) = *connection_guard {
@@ -942,45 +1388,41 @@ impl Realtime {
                         break;
                     }
 
-                    match connection.receive().await {
-                        Ok(Some(msg)) => Some(msg),
-                        Ok(None) => None,
-                        Err(e) => {
-                            error!("Error receiving message: {}", e);
-                            None
-                        }
-                    }
+                    // `None` when nothing arrived within the poll window
+                    #[cfg(not(target_arch = "wasm32"))]
+                    let received = tokio::time::timeout(RECEIVE_POLL, connection.receive())
+                        .await
+                        .ok();
+
+                    #[cfg(target_arch = "wasm32")]
+                    let received = Some(connection.receive().await);
+
+                    received
                 } else {
                     debug!("No connection available, stopping message loop");
                     break;
                 }
             };
 
-            if let Some(message_str) = message {
-                debug!("Received realtime message: {}", message_str);
-
-                // Parse the message
-                match serde_json::from_str::<RealtimeMessage>(&message_str) {
-                    Ok(realtime_message) => {
-                        // Process the message
-                        Self::process_message(&connection_manager, realtime_message).await;
-                    }
-                    Err(e) => {
-                        debug!(
-                            "Failed to parse realtime message: {} - Error: {}",
-                            message_str, e
-                        );
-                        // Try to parse as protocol message (join/leave responses, etc.)
-                        if let Ok(_protocol_msg) =
-                            serde_json::from_str::<serde_json::Value>(&message_str)
-                        {
-                            debug!("Received protocol message, ignoring for now");
-                        }
-                    }
+            let idle = match received {
+                Some(Ok(Some(message_str))) => {
+                    Self::dispatch(&connection_manager, &message_str);
+                    false
+                }
+                // Control frames or a finished stream on native; an empty queue on WASM
+                Some(Ok(None)) => true,
+                Some(Err(e)) => {
+                    error!("Error receiving message: {}", e);
+                    true
                 }
+                None => false,
+            };
+
+            // Back off only when there was nothing to do
+            if !idle {
+                continue;
             }
 
-            // Small delay to prevent busy waiting
             #[cfg(not(target_arch = "wasm32"))]
             tokio::time::sleep(Duration::from_millis(10)).await;
 
@@ -1006,46 +1448,56 @@ impl Realtime {
         debug!("Realtime message loop stopped");
     }
 
-    /// Process incoming realtime message
-    async fn process_message(
-        connection_manager: &Arc<ConnectionManager>,
-        message: RealtimeMessage,
-    ) {
-        debug!("Processing message for topic: {}", message.topic);
-
-        let subscriptions = connection_manager.subscriptions.read().await;
-
-        let mut matched_subscriptions = Vec::new();
-
-        // Find matching subscriptions
-        for subscription in subscriptions.values() {
-            if Self::topic_matches(&subscription.topic, &message.topic) {
-                // Check event filter
-                if let Some(ref event_filter) = subscription.config.event {
-                    let message_event = match message.event.as_str() {
-                        "INSERT" => Some(RealtimeEvent::Insert),
-                        "UPDATE" => Some(RealtimeEvent::Update),
-                        "DELETE" => Some(RealtimeEvent::Delete),
-                        _ => None,
-                    };
-
-                    if let Some(msg_event) = message_event {
-                        if *event_filter != RealtimeEvent::All && *event_filter != msg_event {
-                            continue; // Skip if event doesn't match
-                        }
-                    }
-                }
-
-                matched_subscriptions.push(subscription.clone());
+    /// Route an incoming frame to the subscriptions on its topic
+    ///
+    /// Only the envelope is parsed here. Frame subscribers get a view into
+    /// `text`; the payload is deserialized at most once, and only when a message
+    /// subscriber matches.
+    fn dispatch(connection_manager: &ConnectionManager, text: &str) {
+        let parsed = RealtimeFrame::parse(text, |frame| {
+            // Join/leave acknowledgements are protocol traffic, not channel messages
+            if frame.event == "phx_reply" {
+                debug!("Received reply on topic {}", frame.topic);
+                return;
             }
+            Self::deliver(connection_manager, frame);
+        });
+
+        if let Err(e) = parsed {
+            debug!("Failed to parse realtime message: {} - Error: {}", text, e);
         }
+    }
 
-        drop(subscriptions); // Explicitly drop the guard
+    /// Hand `frame` to the subscriptions routed to its topic
+    fn deliver(connection_manager: &ConnectionManager, frame: &RealtimeFrame<'_>) {
+        let routes = connection_manager.routes_for(frame.topic);
+        let mut message: Option<RealtimeMessage> = None;
+        let mut change = None;
 
-        // Call callbacks for matched subscriptions
-        for subscription in matched_subscriptions {
-            debug!("Calling callback for subscription: {}", subscription.id);
-            (subscription.callback)(message.clone());
+        for route in routes.iter() {
+            if !route.accepts(frame, &mut change) {
+                continue;
+            }
+            match &route.callback {
+                SubscriptionCallback::Frame(callback) => callback(frame),
+                SubscriptionCallback::Message(callback) => {
+                    if message.is_none() {
+                        match frame.to_message() {
+                            Ok(parsed) => message = Some(parsed),
+                            Err(e) => {
+                                debug!(
+                                    "Skipping subscription {}: unreadable payload: {}",
+                                    route.subscription_id, e
+                                );
+                                continue;
+                            }
+                        }
+                    }
+                    if let Some(ref message) = message {
+                        callback(message.clone());
+                    }
+                }
+            }
         }
     }
 
@@ -1371,22 +1823,9 @@ impl Realtime {
                 filter: combined_filter,
                 ..config.clone()
             },
-            callback: Arc::new(callback),
+            callback: SubscriptionCallback::Message(Arc::new(callback)),
         };
 
-        // Store subscription
-        {
-            let mut subscriptions = self.connection_manager.subscriptions.write().await;
-            subscriptions.insert(subscription_id.clone(), subscription);
-        }
-
-        // Send join message
-        let ref_id = self
-            .connection_manager
-            .ref_counter
-            .fetch_add(1, Ordering::SeqCst)
-            .to_string();
-
         let mut join_payload = serde_json::json!({
             "config": {
                 "postgres_changes": [{
@@ -1416,23 +1855,8 @@ impl Realtime {
             join_payload["config"]["broadcast"] = serde_json::json!({ "self": true });
         }
 
-        let join_message = RealtimeProtocolMessage {
-            topic: topic.clone(),
-            event: "phx_join".to_string(),
-            payload: join_payload,
-            ref_id,
-        };
-
-        let mut connection_guard = self.connection_manager.connection.write().await;
-        if let Some(ref mut connection) = *connection_guard {
-            let message_json = serde_json::to_string(&join_message)
-                .map_err(|e| Error::realtime(format!("Failed to serialize join message: {}", e)))?;
-
-            connection.send(&message_json).await?;
-            info!("Advanced subscription created: {}", subscription_id);
-        } else {
-            return Err(Error::realtime("Not connected to realtime server"));
-        }
+        self.attach(subscription, join_payload).await?;
+        info!("Advanced subscription created: {}", subscription_id);
 
         Ok(subscription_id)
     }
@@ -1507,22 +1931,9 @@ impl Realtime {
                 filter: combined_filter,
                 ..config.clone()
             },
-            callback: Arc::new(callback),
+            callback: SubscriptionCallback::Message(Arc::new(callback)),
         };
 
-        // Store subscription
-        {
-            let mut subscriptions = self.connection_manager.subscriptions.write().await;
-            subscriptions.insert(subscription_id.clone(), subscription);
-        }
-
-        // Send join message
-        let ref_id = self
-            .connection_manager
-            .ref_counter
-            .fetch_add(1, Ordering::SeqCst)
-            .to_string();
-
         let mut join_payload = serde_json::json!({
             "config": {
                 "postgres_changes": [{
@@ -1552,23 +1963,8 @@ impl Realtime {
             join_payload["config"]["broadcast"] = serde_json::json!({ "self": true });
         }
 
-        let join_message = RealtimeProtocolMessage {
-            topic: topic.clone(),
-            event: "phx_join".to_string(),
-            payload: join_payload,
-            ref_id,
-        };
-
-        let mut connection_guard = self.connection_manager.connection.write().await;
-        if let Some(ref mut connection) = *connection_guard {
-            let message_json = serde_json::to_string(&join_message)
-                .map_err(|e| Error::realtime(format!("Failed to serialize join message: {}", e)))?;
-
-            connection.send(&message_json).await?;
-            info!("Advanced subscription created: {}", subscription_id);
-        } else {
-            return Err(Error::realtime("Not connected to realtime server"));
-        }
+        self.attach(subscription, join_payload).await?;
+        info!("Advanced subscription created: {}", subscription_id);
 
         Ok(subscription_id)
     }
@@ -1739,7 +2135,7 @@ impl ChannelBuilder {
 #[cfg(all(test, feature = "realtime"))]
 mod tests {
     use super::*;
-    use std::sync::atomic::{AtomicBool, Ordering};
+    use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
     use std::sync::Arc;
 
     #[tokio::test]
@@ -1941,4 +2337,471 @@ mod tests {
         // ALL should match ALL
         assert_eq!(all_event, Some(RealtimeEvent::All));
     }
+
+    /// Connection that records sent frames instead of talking to a server
+    struct RecordingConnection {
+        sent: Arc<std::sync::Mutex<Vec<String>>>,
+        connected: Arc<AtomicBool>,
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[async_trait::async_trait]
+    impl WebSocketConnection for RecordingConnection {
+        async fn connect(&mut self, _url: &str) -> Result<()> {
+            self.connected.store(true, Ordering::SeqCst);
+            Ok(())
+        }
+
+        async fn send(&mut self, message: &str) -> Result<()> {
+            self.sent.lock().unwrap().push(message.to_string());
+            Ok(())
+        }
+
+        async fn receive(&mut self) -> Result<Option<String>> {
+            Ok(None)
+        }
+
+        async fn close(&mut self) -> Result<()> {
+            self.connected.store(false, Ordering::SeqCst);
+            Ok(())
+        }
+
+        fn is_connected(&self) -> bool {
+            self.connected.load(Ordering::SeqCst)
+        }
+    }
+
+    fn recording_connection(connected: bool) -> (RecordingConnection, Arc<AtomicBool>) {
+        let flag = Arc::new(AtomicBool::new(connected));
+        let connection = RecordingConnection {
+            sent: Arc::new(std::sync::Mutex::new(Vec::new())),
+            connected: Arc::clone(&flag),
+        };
+        (connection, flag)
+    }
+
+    async fn recording_realtime() -> (Realtime, Arc<std::sync::Mutex<Vec<String>>>) {
+        let config = Arc::new(SupabaseConfig {
+            url: "https://test.supabase.co".to_string(),
+            key: "test-key".to_string(),
+            ..Default::default()
+        });
+        let realtime = Realtime::new(config).unwrap();
+
+        let (connection, _) = recording_connection(true);
+        let sent = Arc::clone(&connection.sent);
+        *realtime.connection_manager.connection.write().await = Some(Box::new(connection));
+        (realtime, sent)
+    }
+
+    fn sent_events(sent: &std::sync::Mutex<Vec<String>>) -> Vec<(String, String)> {
+        sent.lock()
+            .unwrap()
+            .iter()
+            .map(|frame| {
+                let message: serde_json::Value = serde_json::from_str(frame).unwrap();
+                (
+                    message["event"].as_str().unwrap().to_string(),
+                    message["topic"].as_str().unwrap().to_string(),
+                )
+            })
+            .collect()
+    }
+
+    fn posts_config(event: RealtimeEvent) -> SubscriptionConfig {
+        SubscriptionConfig {
+            table: Some("posts".to_string()),
+            event: Some(event),
+            ..Default::default()
+        }
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[tokio::test]
+    async fn test_subscriptions_share_one_join_per_topic() {
+        let (realtime, sent) = recording_realtime().await;
+
+        let first = realtime
+            .subscribe(posts_config(RealtimeEvent::All), |_| {})
+            .await
+            .unwrap();
+        let second = realtime
+            .subscribe(posts_config(RealtimeEvent::All), |_| {})
+            .await
+            .unwrap();
+        assert_ne!(first, second);
+
+        let topic = "realtime:public:posts".to_string();
+        assert_eq!(
+            sent_events(&sent),
+            vec![("phx_join".to_string(), topic.clone())]
+        );
+
+        realtime.unsubscribe(&first).await.unwrap();
+        assert_eq!(sent_events(&sent).len(), 1);
+
+        realtime.unsubscribe(&second).await.unwrap();
+        assert_eq!(
+            sent_events(&sent),
+            vec![
+                ("phx_join".to_string(), topic.clone()),
+                ("phx_leave".to_string(), topic)
+            ]
+        );
+        assert!(realtime.connection_manager.channels.read().await.is_empty());
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[tokio::test]
+    async fn test_subscription_with_other_event_widens_join() {
+        let (realtime, sent) = recording_realtime().await;
+
+        realtime
+            .subscribe(posts_config(RealtimeEvent::Insert), |_| {})
+            .await
+            .unwrap();
+        realtime
+            .subscribe(posts_config(RealtimeEvent::Delete), |_| {})
+            .await
+            .unwrap();
+        // Already listening for every event, no further join needed
+        realtime
+            .subscribe(posts_config(RealtimeEvent::Update), |_| {})
+            .await
+            .unwrap();
+
+        let frames = sent.lock().unwrap().clone();
+        assert_eq!(frames.len(), 2);
+        let rejoin: serde_json::Value = serde_json::from_str(&frames[1]).unwrap();
+        assert_eq!(rejoin["event"], "phx_join");
+        assert_eq!(rejoin["payload"]["event"], "*");
+
+        // A different table configuration on the same topic can't share the join
+        let conflicting = SubscriptionConfig {
+            enable_presence: true,
+            ..posts_config(RealtimeEvent::All)
+        };
+        let result = realtime
+            .subscribe_advanced("posts", conflicting.clone(), |_| {})
+            .await;
+        assert!(result.is_ok());
+        let result = realtime
+            .subscribe_advanced(
+                "posts",
+                SubscriptionConfig {
+                    enable_broadcast: true,
+                    ..conflicting
+                },
+                |_| {},
+            )
+            .await;
+        assert!(matches!(result, Err(Error::Realtime { .. })));
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[tokio::test]
+    async fn test_dispatch_routes_by_topic_and_event() {
+        let (realtime, _sent) = recording_realtime().await;
+        let messages = Arc::new(std::sync::Mutex::new(Vec::new()));
+        let frames = Arc::new(std::sync::Mutex::new(Vec::new()));
+
+        let received = Arc::clone(&messages);
+        let inserts = realtime
+            .subscribe(posts_config(RealtimeEvent::Insert), move |message| {
+                received.lock().unwrap().push(message);
+            })
+            .await
+            .unwrap();
+        let received = Arc::clone(&frames);
+        realtime
+            .subscribe_frames(posts_config(RealtimeEvent::All), move |frame| {
+                received
+                    .lock()
+                    .unwrap()
+                    .push((frame.event().to_string(), frame.payload_json().to_string()));
+            })
+            .await
+            .unwrap();
+
+        let manager = &realtime.connection_manager;
+        let insert = r#"{"topic":"realtime:public:posts","event":"INSERT","ref":null,"payload":{"record":{"id":1},"table":"posts"}}"#;
+        Realtime::dispatch(manager, insert);
+        Realtime::dispatch(
+            manager,
+            r#"{"topic":"realtime:public:posts","event":"UPDATE","ref":"7","payload":{"record":{"id":1}}}"#,
+        );
+        Realtime::dispatch(
+            manager,
+            r#"{"topic":"realtime:public:posts","event":"phx_reply","ref":"1","payload":{"status":"ok","response":{}}}"#,
+        );
+        Realtime::dispatch(
+            manager,
+            r#"{"topic":"realtime:public:users","event":"INSERT","ref":null,"payload":{}}"#,
+        );
+        Realtime::dispatch(manager, "not json");
+
+        let messages_seen = messages.lock().unwrap().clone();
+        assert_eq!(messages_seen.len(), 1);
+        assert_eq!(messages_seen[0].event, "INSERT");
+        assert_eq!(
+            messages_seen[0].payload.record,
+            Some(serde_json::json!({"id": 1}))
+        );
+
+        let frames_seen = frames.lock().unwrap().clone();
+        assert_eq!(
+            frames_seen,
+            vec![
+                (
+                    "INSERT".to_string(),
+                    r#"{"record":{"id":1},"table":"posts"}"#.to_string()
+                ),
+                ("UPDATE".to_string(), r#"{"record":{"id":1}}"#.to_string()),
+            ]
+        );
+
+        realtime.unsubscribe(&inserts).await.unwrap();
+        Realtime::dispatch(manager, insert);
+        assert_eq!(messages.lock().unwrap().len(), 1);
+        assert_eq!(frames.lock().unwrap().len(), 3);
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[tokio::test]
+    async fn test_widened_topic_still_filters_postgres_changes() {
+        let (realtime, _sent) = recording_realtime().await;
+        let inserts = Arc::new(std::sync::Mutex::new(Vec::new()));
+        let deletes = Arc::new(std::sync::Mutex::new(Vec::new()));
+
+        let received = Arc::clone(&inserts);
+        realtime
+            .subscribe(posts_config(RealtimeEvent::Insert), move |message| {
+                received.lock().unwrap().push(message);
+            })
+            .await
+            .unwrap();
+        // Widens the shared join to every event
+        let received = Arc::clone(&deletes);
+        realtime
+            .subscribe_frames(posts_config(RealtimeEvent::Delete), move |frame| {
+                received
+                    .lock()
+                    .unwrap()
+                    .push(frame.payload_json().to_string());
+            })
+            .await
+            .unwrap();
+
+        let manager = &realtime.connection_manager;
+        for change in ["INSERT", "UPDATE", "DELETE"] {
+            let text = format!(
+                r#"{{"topic":"realtime:public:posts","event":"postgres_changes","ref":null,"payload":{{"ids":[1],"data":{{"schema":"public","table":"posts","type":"{}","record":{{"id":1}}}}}}}}"#,
+                change
+            );
+            Realtime::dispatch(manager, &text);
+        }
+        Realtime::dispatch(
+            manager,
+            r#"{"topic":"realtime:public:posts","event":"broadcast","ref":null,"payload":{"event":"ping"}}"#,
+        );
+
+        // Only the INSERT change and the (unfiltered) broadcast get through
+        let inserts_seen = inserts.lock().unwrap().clone();
+        let events: Vec<&str> = inserts_seen.iter().map(|m| m.event.as_str()).collect();
+        assert_eq!(events, vec!["postgres_changes", "broadcast"]);
+
+        let deletes_seen = deletes.lock().unwrap().clone();
+        assert_eq!(deletes_seen.len(), 2);
+        assert!(deletes_seen[0].contains("\"type\":\"DELETE\""));
+    }
+
+    #[test]
+    fn test_frame_change_event() {
+        let change_of =
+            |text: &str| RealtimeFrame::parse(text, |frame| frame.change_event()).unwrap();
+
+        assert_eq!(
+            change_of(
+                r#"{"topic":"realtime:public:posts","event":"postgres_changes","ref":null,"payload":{"ids":[1],"data":{"table":"posts","type":"UPDATE","record":{"type":"INSERT"}}}}"#
+            ),
+            Some(RealtimeEvent::Update)
+        );
+        assert_eq!(
+            change_of(
+                r#"{"topic":"realtime:public:posts","event":"postgres_changes","ref":null,"payload":{"type":"DELETE"}}"#
+            ),
+            Some(RealtimeEvent::Delete)
+        );
+        assert_eq!(
+            change_of(
+                r#"{"topic":"realtime:public:posts","event":"INSERT","ref":null,"payload":{}}"#
+            ),
+            Some(RealtimeEvent::Insert)
+        );
+        assert_eq!(
+            change_of(
+                r#"{"topic":"realtime:public:posts","event":"broadcast","ref":null,"payload":{"type":"INSERT"}}"#
+            ),
+            None
+        );
+    }
+
+    #[test]
+    fn test_frame_payload_is_parsed_on_demand() {
+        #[derive(Deserialize)]
+        struct Change<'a> {
+            table: &'a str,
+        }
+
+        let text = r#"{"topic":"realtime:public:posts","event":"INSERT","ref":"3","payload":{"table":"posts","record":{"id":2}}}"#;
+        let envelope: FrameEnvelope<'_> = serde_json::from_str(text).unwrap();
+        assert!(matches!(envelope.topic, std::borrow::Cow::Borrowed(_)));
+
+        let (ref_id, table, message) = RealtimeFrame::parse(text, |frame| {
+            (
+                frame.ref_id().map(str::to_string),
+                frame.payload::<Change<'_>>().unwrap().table.to_string(),
+                frame.to_message().unwrap(),
+            )
+        })
+        .unwrap();
+        assert_eq!(ref_id.as_deref(), Some("3"));
+        assert_eq!(table, "posts");
+
+        assert_eq!(message.topic, "realtime:public:posts");
+        assert_eq!(message.ref_id.as_deref(), Some("3"));
+        assert_eq!(message.payload.table.as_deref(), Some("posts"));
+    }
+
+    #[test]
+    fn test_build_topic_with_filter() {
+        let config = Arc::new(SupabaseConfig {
+            url: "https://test.supabase.co".to_string(),
+            key: "test-key".to_string(),
+            ..Default::default()
+        });
+        let realtime = Realtime::new(config).unwrap();
+
+        let subscription_config = SubscriptionConfig {
+            table: Some("posts".to_string()),
+            filter: Some("author_id=eq.1".to_string()),
+            ..Default::default()
+        };
+        assert_eq!(
+            realtime.build_topic(&subscription_config),
+            "realtime:public:posts:author_id=eq.1"
+        );
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[tokio::test]
+    async fn test_connection_pool_capacity_and_reuse() {
+        let pool = ConnectionPool::new(ConnectionPoolConfig {
+            max_connections: 2,
+            ..Default::default()
+        });
+
+        let stats = pool.get_stats().await;
+        assert_eq!(stats.total_connections, 2);
+        assert_eq!(stats.active_connections, 0);
+        assert_eq!(stats.available_connections, 0);
+
+        // Checked-out connections belong to the caller: dropping them instead of
+        // returning them never exhausts the pool
+        for _ in 0..5 {
+            drop(pool.get_connection().await.unwrap().unwrap());
+        }
+        let fresh = pool.get_connection().await.unwrap().unwrap();
+        assert_eq!(pool.get_stats().await.active_connections, 0);
+
+        // A fresh connection was never connected, so returning it drops it
+        pool.return_connection(fresh).await;
+        assert_eq!(pool.get_stats().await.active_connections, 0);
+
+        // At most `max_connections` connections are kept idle
+        let mut sent = Vec::new();
+        for _ in 0..3 {
+            let (connection, _) = recording_connection(true);
+            sent.push(Arc::clone(&connection.sent));
+            pool.return_connection(Box::new(connection)).await;
+        }
+        let stats = pool.get_stats().await;
+        assert_eq!(stats.active_connections, 2);
+        assert_eq!(stats.available_connections, 2);
+
+        // The most recently returned connection is reused first
+        let mut reused = pool.get_connection().await.unwrap().unwrap();
+        reused.send("ping").await.unwrap();
+        assert_eq!(sent[1].lock().unwrap().as_slice(), ["ping"]);
+        assert_eq!(pool.get_stats().await.active_connections, 1);
+
+        let empty = ConnectionPool::new(ConnectionPoolConfig {
+            max_connections: 0,
+            ..Default::default()
+        });
+        assert!(empty.get_connection().await.unwrap().is_none());
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[tokio::test]
+    async fn test_connection_pool_drops_stale_connections() {
+        let pool = ConnectionPool::new(ConnectionPoolConfig {
+            max_connections: 1,
+            ..Default::default()
+        });
+
+        let (connection, connected) = recording_connection(true);
+        pool.return_connection(Box::new(connection)).await;
+        // Closed while sitting idle in the pool
+        connected.store(false, Ordering::SeqCst);
+        assert_eq!(pool.get_stats().await.available_connections, 0);
+
+        let connection = pool.get_connection().await.unwrap().unwrap();
+        assert!(!connection.is_connected());
+        assert_eq!(pool.get_stats().await.active_connections, 0);
+
+        pool.close_all().await.unwrap();
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[tokio::test(flavor = "multi_thread", worker_threads = 4)]
+    async fn test_connection_pool_concurrent_get_and_return() {
+        let pool = Arc::new(ConnectionPool::new(ConnectionPoolConfig {
+            max_connections: 4,
+            ..Default::default()
+        }));
+        let acquired = Arc::new(AtomicUsize::new(0));
+
+        let tasks: Vec<_> = (0..16)
+            .map(|_| {
+                let pool = Arc::clone(&pool);
+                let acquired = Arc::clone(&acquired);
+                tokio::spawn(async move {
+                    for _ in 0..100 {
+                        if pool.get_connection().await.unwrap().is_some() {
+                            acquired.fetch_add(1, Ordering::SeqCst);
+                            let (connection, _) = recording_connection(true);
+                            pool.return_connection(Box::new(connection)).await;
+                        }
+                        let stats = pool.get_stats().await;
+                        assert!(stats.active_connections <= stats.max_connections);
+                        tokio::task::yield_now().await;
+                    }
+                })
+            })
+            .collect();
+        for task in tasks {
+            task.await.unwrap();
+        }
+
+        assert!(acquired.load(Ordering::SeqCst) > 0);
+        let stats = pool.get_stats().await;
+        assert_eq!(stats.active_connections, stats.available_connections);
+        assert!(stats.available_connections <= 4);
+
+        pool.close_all().await.unwrap();
+        let stats = pool.get_stats().await;
+        assert_eq!(stats.active_connections, 0);
+        assert_eq!(stats.available_connections, 0);
+    }
 }
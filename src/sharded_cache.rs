@@ -0,0 +1,343 @@
+//! Sharded in-memory cache with CLOCK eviction
+//!
+//! Entries are spread over independently locked shards. Lookups only take a shard
+//! read lock (recency bits are atomic), and eviction uses the CLOCK algorithm, an
+//! amortized O(1) approximation of LRU that prefers expired entries. Entry and byte
+//! limits are divided evenly between the shards.
+//!
+//! Expiry is tracked with wall-clock time, which keeps this usable on WASM.
+
+use std::{
+    collections::{hash_map::RandomState, HashMap},
+    hash::BuildHasher,
+    sync::{
+        atomic::{AtomicBool, Ordering},
+        RwLock, RwLockReadGuard, RwLockWriteGuard,
+    },
+    time::Duration,
+};
+use tracing::debug;
+
+/// Number of independently locked shards in a large cache
+const MAX_SHARDS: usize = 16;
+
+/// Bounded key-value cache shared between threads
+#[derive(Debug)]
+pub(crate) struct ShardedCache<V> {
+    shards: Box<[RwLock<CacheShard<V>>]>,
+    hasher: RandomState,
+    max_entries: usize,
+    max_bytes: usize,
+}
+
+/// One lock's worth of entries, arranged as a CLOCK ring
+#[derive(Debug)]
+struct CacheShard<V> {
+    index: HashMap<String, usize>,
+    slots: Vec<Option<CacheSlot<V>>>,
+    free: Vec<usize>,
+    hand: usize,
+    size_bytes: usize,
+}
+
+/// Stored value plus the bookkeeping updated on the read path
+#[derive(Debug)]
+struct CacheSlot<V> {
+    key: String,
+    value: V,
+    expires_at: Option<chrono::DateTime<chrono::Utc>>,
+    size_bytes: usize,
+    /// Set on every hit and cleared as the clock hand passes; gives a second chance
+    referenced: AtomicBool,
+}
+
+/// Outcome of a read-locked shard lookup
+enum Lookup<V> {
+    Hit(V),
+    Expired,
+    Miss,
+}
+
+fn read<T>(lock: &RwLock<T>) -> RwLockReadGuard<'_, T> {
+    lock.read().unwrap_or_else(|poisoned| poisoned.into_inner())
+}
+
+fn write<T>(lock: &RwLock<T>) -> RwLockWriteGuard<'_, T> {
+    lock.write()
+        .unwrap_or_else(|poisoned| poisoned.into_inner())
+}
+
+impl<V: Clone> ShardedCache<V> {
+    /// Cache holding at most `max_entries` entries and `max_bytes` bytes
+    ///
+    /// A `max_entries` of zero disables the cache.
+    pub(crate) fn new(max_entries: usize, max_bytes: usize) -> Self {
+        // Small caches use fewer shards so the per-shard entry limit stays meaningful
+        let shard_count = max_entries.clamp(1, MAX_SHARDS);
+        let shards = (0..shard_count)
+            .map(|_| RwLock::new(CacheShard::default()))
+            .collect();
+
+        Self {
+            shards,
+            hasher: RandomState::new(),
+            max_entries,
+            max_bytes,
+        }
+    }
+
+    fn shard(&self, key: &str) -> &RwLock<CacheShard<V>> {
+        let index = self.hasher.hash_one(key) as usize % self.shards.len();
+        &self.shards[index]
+    }
+
+    /// Per-shard share of the entry and byte limits
+    fn shard_limits(&self) -> (usize, usize) {
+        let shards = self.shards.len();
+        (
+            self.max_entries.div_ceil(shards).max(1),
+            self.max_bytes / shards,
+        )
+    }
+
+    /// The unexpired value stored under `key`
+    pub(crate) fn get(&self, key: &str) -> Option<V> {
+        let shard = self.shard(key);
+        let lookup = read(shard).lookup(key);
+
+        match lookup {
+            Lookup::Hit(value) => Some(value),
+            Lookup::Expired => {
+                let mut shard = write(shard);
+                // Another writer may have refreshed the entry in the meantime
+                if let Lookup::Hit(value) = shard.lookup(key) {
+                    return Some(value);
+                }
+                shard.remove(key);
+                None
+            }
+            Lookup::Miss => None,
+        }
+    }
+
+    /// Store `value` under `key`, replacing any previous value
+    ///
+    /// `size_bytes` counts against the byte budget; `ttl` of `None` keeps the entry
+    /// until it is evicted. Returns `false` if the value was not stored because the
+    /// cache is disabled or the value alone exceeds a shard's byte budget.
+    pub(crate) fn insert(
+        &self,
+        key: &str,
+        value: V,
+        size_bytes: usize,
+        ttl: Option<Duration>,
+    ) -> bool {
+        if self.max_entries == 0 {
+            return false;
+        }
+
+        let (max_entries, max_bytes) = self.shard_limits();
+        let mut shard = write(self.shard(key));
+
+        if size_bytes > max_bytes {
+            // Too large to ever fit; make sure no stale version lingers
+            shard.remove(key);
+            debug!(
+                "Entry for key {} ({} bytes) exceeds the cache budget",
+                key, size_bytes
+            );
+            return false;
+        }
+
+        let expires_at = ttl.map(|ttl| {
+            chrono::Duration::from_std(ttl)
+                .ok()
+                .and_then(|ttl| chrono::Utc::now().checked_add_signed(ttl))
+                .unwrap_or(chrono::DateTime::<chrono::Utc>::MAX_UTC)
+        });
+        shard.insert(
+            CacheSlot {
+                key: key.to_string(),
+                value,
+                expires_at,
+                size_bytes,
+                referenced: AtomicBool::new(false),
+            },
+            max_entries,
+            max_bytes,
+        );
+        true
+    }
+
+    /// Drop the entry stored under `key`, if any
+    pub(crate) fn remove(&self, key: &str) -> bool {
+        write(self.shard(key)).remove(key)
+    }
+
+    /// Drop every entry
+    pub(crate) fn clear(&self) {
+        for shard in self.shards.iter() {
+            write(shard).clear();
+        }
+    }
+
+    /// Number of entries and their total size in bytes
+    pub(crate) fn usage(&self) -> (usize, usize) {
+        self.shards.iter().fold((0, 0), |(entries, bytes), shard| {
+            let shard = read(shard);
+            (entries + shard.index.len(), bytes + shard.size_bytes)
+        })
+    }
+}
+
+impl<V> Default for CacheShard<V> {
+    fn default() -> Self {
+        Self {
+            index: HashMap::new(),
+            slots: Vec::new(),
+            free: Vec::new(),
+            hand: 0,
+            size_bytes: 0,
+        }
+    }
+}
+
+impl<V> CacheSlot<V> {
+    fn is_expired(&self) -> bool {
+        self.expires_at
+            .is_some_and(|expires_at| chrono::Utc::now() >= expires_at)
+    }
+}
+
+impl<V: Clone> CacheShard<V> {
+    fn lookup(&self, key: &str) -> Lookup<V> {
+        let Some(slot) = self
+            .index
+            .get(key)
+            .and_then(|&index| self.slots[index].as_ref())
+        else {
+            return Lookup::Miss;
+        };
+        if slot.is_expired() {
+            return Lookup::Expired;
+        }
+
+        slot.referenced.store(true, Ordering::Relaxed);
+        Lookup::Hit(slot.value.clone())
+    }
+}
+
+impl<V> CacheShard<V> {
+    fn insert(&mut self, slot: CacheSlot<V>, max_entries: usize, max_bytes: usize) {
+        self.remove(&slot.key);
+
+        while !self.index.is_empty()
+            && (self.index.len() >= max_entries || self.size_bytes + slot.size_bytes > max_bytes)
+        {
+            self.evict_one();
+        }
+
+        self.size_bytes += slot.size_bytes;
+        let key = slot.key.clone();
+        let index = match self.free.pop() {
+            Some(index) => {
+                self.slots[index] = Some(slot);
+                index
+            }
+            None => {
+                self.slots.push(Some(slot));
+                self.slots.len() - 1
+            }
+        };
+        self.index.insert(key, index);
+    }
+
+    fn remove(&mut self, key: &str) -> bool {
+        let Some(index) = self.index.remove(key) else {
+            return false;
+        };
+        if let Some(slot) = self.slots[index].take() {
+            self.size_bytes -= slot.size_bytes;
+        }
+        self.free.push(index);
+        true
+    }
+
+    /// Advance the clock hand to the first expired or unreferenced entry and evict it
+    fn evict_one(&mut self) {
+        // Two sweeps always suffice: the first clears every reference bit
+        for _ in 0..self.slots.len() * 2 {
+            let index = self.hand;
+            self.hand = (self.hand + 1) % self.slots.len();
+
+            let Some(slot) = &self.slots[index] else {
+                continue;
+            };
+            if !slot.is_expired() && slot.referenced.swap(false, Ordering::Relaxed) {
+                continue;
+            }
+
+            let key = slot.key.clone();
+            self.remove(&key);
+            debug!("Evicted cache entry: {}", key);
+            return;
+        }
+    }
+
+    fn clear(&mut self) {
+        *self = Self::default();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_evicts_unreferenced_entries_first() {
+        // Keep every key in one shard so the eviction order is observable
+        let mut shard = CacheShard::default();
+        let slot = |key: &str| CacheSlot {
+            key: key.to_string(),
+            value: (),
+            expires_at: None,
+            size_bytes: 1,
+            referenced: AtomicBool::new(false),
+        };
+
+        shard.insert(slot("a"), 2, usize::MAX);
+        shard.insert(slot("b"), 2, usize::MAX);
+        assert!(matches!(shard.lookup("a"), Lookup::Hit(_)));
+
+        // "a" was just read, so "b" is the eviction victim
+        shard.insert(slot("c"), 2, usize::MAX);
+        assert!(matches!(shard.lookup("a"), Lookup::Hit(_)));
+        assert!(matches!(shard.lookup("b"), Lookup::Miss));
+        assert!(matches!(shard.lookup("c"), Lookup::Hit(_)));
+        assert_eq!(shard.size_bytes, 2);
+    }
+
+    #[test]
+    fn test_expiry_budget_and_disabled_cache() {
+        let cache = ShardedCache::new(8, 64);
+
+        assert!(cache.insert("live", 1, 4, None));
+        assert!(cache.insert("dead", 2, 4, Some(Duration::ZERO)));
+        assert_eq!(cache.get("live"), Some(1));
+        assert_eq!(cache.get("dead"), None);
+
+        // Replacing an entry does not double-count its size
+        assert!(cache.insert("live", 3, 6, None));
+        assert_eq!(cache.usage(), (1, 6));
+
+        assert!(!cache.insert("huge", 4, 1024, None));
+        assert_eq!(cache.get("huge"), None);
+
+        assert!(cache.remove("live"));
+        assert_eq!(cache.usage(), (0, 0));
+
+        let disabled = ShardedCache::new(0, usize::MAX);
+        assert!(!disabled.insert("key", 1, 1, None));
+        assert_eq!(disabled.get("key"), None);
+    }
+}
@@ -0,0 +1,265 @@
+//! Coalescing of identical in-flight requests
+//!
+//! The first caller for a key (the leader) performs the request; callers that
+//! arrive while it is running wait for the leader's result instead of issuing
+//! their own. The entry is removed as soon as the leader finishes, so later
+//! callers always start a fresh request.
+//!
+//! Waiting is built on wakers only, which keeps this usable from any executor,
+//! including WASM.
+
+use crate::error::Result;
+use std::{
+    collections::HashMap,
+    future::Future,
+    pin::Pin,
+    sync::{Arc, Mutex, MutexGuard},
+    task::{Context, Poll, Waker},
+};
+use tracing::debug;
+
+/// Deduplicates concurrent requests that share a key
+#[derive(Debug)]
+pub(crate) struct SingleFlight<T> {
+    calls: Mutex<HashMap<String, Arc<Call<T>>>>,
+}
+
+#[derive(Debug)]
+struct Call<T> {
+    state: Mutex<CallState<T>>,
+}
+
+#[derive(Debug)]
+enum CallState<T> {
+    Running(Vec<Waker>),
+    Finished(Box<Result<T>>),
+    /// The leader was dropped before finishing
+    Abandoned,
+}
+
+fn lock<T>(mutex: &Mutex<T>) -> MutexGuard<'_, T> {
+    mutex
+        .lock()
+        .unwrap_or_else(|poisoned| poisoned.into_inner())
+}
+
+impl<T> Default for SingleFlight<T> {
+    fn default() -> Self {
+        Self {
+            calls: Mutex::new(HashMap::new()),
+        }
+    }
+}
+
+impl<T: Clone> SingleFlight<T> {
+    /// Run `request` unless an identical one is already in flight, in which case
+    /// wait for and share its result
+    ///
+    /// If the leader is cancelled, its waiters fall back to running their own
+    /// `request`.
+    pub(crate) async fn run<F>(&self, key: String, request: F) -> Result<T>
+    where
+        F: Future<Output = Result<T>>,
+    {
+        let (call, is_leader) = {
+            let mut calls = lock(&self.calls);
+            match calls.get(&key) {
+                Some(call) => (Arc::clone(call), false),
+                None => {
+                    let call = Arc::new(Call {
+                        state: Mutex::new(CallState::Running(Vec::new())),
+                    });
+                    calls.insert(key.clone(), Arc::clone(&call));
+                    (call, true)
+                }
+            }
+        };
+
+        if !is_leader {
+            debug!("Joining in-flight request: {}", key);
+            return match (Wait { call: &call }).await {
+                Some(result) => result,
+                None => request.await,
+            };
+        }
+
+        let mut leader = Leader {
+            flight: self,
+            key,
+            call,
+            finished: false,
+        };
+        let result = request.await;
+        leader.finish(&result);
+        result
+    }
+
+    /// Number of requests currently in flight
+    #[cfg(test)]
+    fn in_flight(&self) -> usize {
+        lock(&self.calls).len()
+    }
+}
+
+/// Publishes the leader's outcome, also when the leader is dropped mid-request
+struct Leader<'a, T> {
+    flight: &'a SingleFlight<T>,
+    key: String,
+    call: Arc<Call<T>>,
+    finished: bool,
+}
+
+impl<T> Leader<'_, T> {
+    fn publish(&mut self, outcome: CallState<T>) {
+        {
+            let mut calls = lock(&self.flight.calls);
+            if calls
+                .get(&self.key)
+                .is_some_and(|call| Arc::ptr_eq(call, &self.call))
+            {
+                calls.remove(&self.key);
+            }
+        }
+
+        let previous = std::mem::replace(&mut *lock(&self.call.state), outcome);
+        if let CallState::Running(wakers) = previous {
+            wakers.into_iter().for_each(Waker::wake);
+        }
+        self.finished = true;
+    }
+}
+
+impl<T: Clone> Leader<'_, T> {
+    fn finish(&mut self, result: &Result<T>) {
+        let shared = match result {
+            Ok(value) => Ok(value.clone()),
+            Err(error) => Err(error.duplicate()),
+        };
+        self.publish(CallState::Finished(Box::new(shared)));
+    }
+}
+
+impl<T> Drop for Leader<'_, T> {
+    fn drop(&mut self) {
+        if !self.finished {
+            self.publish(CallState::Abandoned);
+        }
+    }
+}
+
+/// Resolves with a copy of the leader's result, or `None` if it was abandoned
+struct Wait<'a, T> {
+    call: &'a Call<T>,
+}
+
+impl<T: Clone> Future for Wait<'_, T> {
+    type Output = Option<Result<T>>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        match &mut *lock(&self.call.state) {
+            CallState::Running(wakers) => {
+                if !wakers.iter().any(|waker| waker.will_wake(cx.waker())) {
+                    wakers.push(cx.waker().clone());
+                }
+                Poll::Pending
+            }
+            CallState::Finished(result) => Poll::Ready(Some(match &**result {
+                Ok(value) => Ok(value.clone()),
+                Err(error) => Err(error.duplicate()),
+            })),
+            CallState::Abandoned => Poll::Ready(None),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::error::Error;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+    use std::time::Duration;
+
+    #[tokio::test]
+    async fn test_concurrent_calls_share_one_request() {
+        let flight = Arc::new(SingleFlight::<u32>::default());
+        let requests = Arc::new(AtomicUsize::new(0));
+
+        let handles: Vec<_> = (0..8)
+            .map(|_| {
+                let flight = Arc::clone(&flight);
+                let requests = Arc::clone(&requests);
+                tokio::spawn(async move {
+                    flight
+                        .run("select".to_string(), async {
+                            requests.fetch_add(1, Ordering::SeqCst);
+                            tokio::time::sleep(Duration::from_millis(50)).await;
+                            Ok(7)
+                        })
+                        .await
+                })
+            })
+            .collect();
+
+        for handle in handles {
+            assert_eq!(handle.await.unwrap().unwrap(), 7);
+        }
+        assert_eq!(requests.load(Ordering::SeqCst), 1);
+        assert_eq!(flight.in_flight(), 0);
+    }
+
+    #[tokio::test]
+    async fn test_errors_are_shared_and_not_retained() {
+        let flight = Arc::new(SingleFlight::<u32>::default());
+
+        let leader = {
+            let flight = Arc::clone(&flight);
+            tokio::spawn(async move {
+                flight
+                    .run("rpc".to_string(), async {
+                        tokio::time::sleep(Duration::from_millis(50)).await;
+                        Err(Error::database("boom"))
+                    })
+                    .await
+            })
+        };
+        tokio::time::sleep(Duration::from_millis(10)).await;
+        let follower = flight.run("rpc".to_string(), async { Ok(1) }).await;
+
+        assert!(matches!(follower, Err(Error::Database { ref message, .. }) if message == "boom"));
+        assert!(leader.await.unwrap().is_err());
+
+        // Nothing is cached once the leader finished
+        assert_eq!(
+            flight
+                .run("rpc".to_string(), async { Ok(2) })
+                .await
+                .unwrap(),
+            2
+        );
+    }
+
+    #[tokio::test]
+    async fn test_waiters_recover_from_cancelled_leader() {
+        let flight = Arc::new(SingleFlight::<u32>::default());
+
+        let leader = {
+            let flight = Arc::clone(&flight);
+            tokio::spawn(async move {
+                flight
+                    .run("fn".to_string(), std::future::pending::<Result<u32>>())
+                    .await
+            })
+        };
+        tokio::time::sleep(Duration::from_millis(10)).await;
+
+        let follower = {
+            let flight = Arc::clone(&flight);
+            tokio::spawn(async move { flight.run("fn".to_string(), async { Ok(3) }).await })
+        };
+        tokio::time::sleep(Duration::from_millis(10)).await;
+        leader.abort();
+
+        assert_eq!(follower.await.unwrap().unwrap(), 3);
+        assert_eq!(flight.in_flight(), 0);
+    }
+}
@@ -1,10 +1,16 @@
 //! Storage module for Supabase file operations
 
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+use crate::error::{ErrorContext, HttpErrorContext};
 use crate::{
+    compression::SendCompressed,
     error::{Error, Result},
+    sharded_cache::ShardedCache,
     types::{SupabaseConfig, Timestamp},
 };
 use bytes::Bytes;
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+use bytes::BytesMut;
 
 #[cfg(target_arch = "wasm32")]
 use reqwest::Client as HttpClient;
@@ -44,11 +50,335 @@ async fn async_sleep(_duration: Duration) {
     // No-op for wasm32 without wasm feature (resumable uploads not fully supported)
 }
 
+/// Signed URLs reused by [`Storage::create_signed_url`] and
+/// [`Storage::create_signed_urls`], shared by all clones of a [`Storage`]
+///
+/// Entries are keyed by bucket and path and live in the crate's sharded CLOCK
+/// cache until their URL expires or they are evicted. URLs are signed for exactly
+/// the requested lifetime, so a cached URL is only handed out again to a request
+/// it still outlives.
+#[derive(Debug)]
+struct SignedUrlCache {
+    urls: ShardedCache<CachedSignedUrl>,
+}
+
+#[derive(Debug, Clone)]
+struct CachedSignedUrl {
+    signed_url: String,
+    expires_at: chrono::DateTime<chrono::Utc>,
+}
+
+impl SignedUrlCache {
+    fn new(max_entries: usize) -> Self {
+        Self {
+            // Bounded by entry count; signed URLs are small
+            urls: ShardedCache::new(max_entries, usize::MAX),
+        }
+    }
+
+    fn key(bucket_id: &str, path: &str) -> String {
+        // Bucket ids cannot contain '/', so the key is unambiguous
+        format!("{}/{}", bucket_id, path)
+    }
+
+    /// A cached URL that stays valid for at least `expires_in` more seconds
+    fn get(&self, bucket_id: &str, path: &str, expires_in: u32) -> Option<String> {
+        let cached = self.urls.get(&Self::key(bucket_id, path))?;
+        let needed = chrono::Duration::seconds(i64::from(expires_in));
+        (cached.expires_at - chrono::Utc::now() >= needed).then_some(cached.signed_url)
+    }
+
+    /// Remember `signed_url`, which the server signed for `expires_in` seconds
+    fn insert(&self, bucket_id: &str, path: &str, signed_url: String, expires_in: u32) {
+        let key = Self::key(bucket_id, path);
+        let lifetime = std::time::Duration::from_secs(u64::from(expires_in));
+        let size_bytes = key.len() + signed_url.len();
+        let cached = CachedSignedUrl {
+            signed_url,
+            expires_at: chrono::Utc::now() + chrono::Duration::seconds(i64::from(expires_in)),
+        };
+
+        self.urls.insert(&key, cached, size_bytes, Some(lifetime));
+    }
+
+    fn invalidate(&self, bucket_id: &str, path: &str) {
+        self.urls.remove(&Self::key(bucket_id, path));
+    }
+
+    fn clear(&self) {
+        self.urls.clear();
+    }
+}
+
+/// Identifies the contents of an upload's source file
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+struct SourceFingerprint {
+    size: u64,
+    /// Modification time in nanoseconds since the Unix epoch
+    modified: Option<u128>,
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl SourceFingerprint {
+    fn of(metadata: &std::fs::Metadata) -> Self {
+        Self {
+            size: metadata.len(),
+            modified: metadata
+                .modified()
+                .ok()
+                .and_then(|time| time.duration_since(std::time::UNIX_EPOCH).ok())
+                .map(|since_epoch| since_epoch.as_nanos()),
+        }
+    }
+}
+
+/// First line of a checkpoint file
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+#[derive(Debug, Serialize, Deserialize)]
+struct CheckpointHeader {
+    upload_id: String,
+    bucket_id: String,
+    object_path: String,
+    part_size: u64,
+    source: SourceFingerprint,
+}
+
+/// Append-only record of an upload's finished parts
+///
+/// The file holds a JSON header line followed by one JSON line per uploaded part,
+/// so recording a part costs one small append regardless of how many parts came
+/// before it. A line cut short by a crash is ignored when loading.
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+struct UploadCheckpoint {
+    path: std::path::PathBuf,
+    file: tokio::fs::File,
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl UploadCheckpoint {
+    /// Start a new checkpoint for `session`, replacing any previous one
+    async fn create(
+        path: &std::path::Path,
+        session: &UploadSession,
+        source: SourceFingerprint,
+    ) -> Result<Self> {
+        let header = CheckpointHeader {
+            upload_id: session.upload_id.clone(),
+            bucket_id: session.bucket_id.clone(),
+            object_path: session.object_path.clone(),
+            part_size: session.part_size,
+            source,
+        };
+        let mut line = serde_json::to_vec(&header)?;
+        line.push(b'\n');
+
+        // Write the header atomically so a crash never leaves a headerless file
+        let staging = path.with_extension("tmp");
+        let written = match tokio::fs::write(&staging, &line).await {
+            Ok(()) => tokio::fs::rename(&staging, path).await,
+            Err(e) => Err(e),
+        };
+        written.map_err(|e| Error::storage(format!("Failed to write upload checkpoint: {}", e)))?;
+
+        Self::append_to(path).await
+    }
+
+    /// Open an existing checkpoint to record further parts
+    async fn append_to(path: &std::path::Path) -> Result<Self> {
+        let file = tokio::fs::OpenOptions::new()
+            .append(true)
+            .open(path)
+            .await
+            .map_err(|e| Error::storage(format!("Failed to open upload checkpoint: {}", e)))?;
+        Ok(Self {
+            path: path.to_path_buf(),
+            file,
+        })
+    }
+
+    /// Read a checkpoint; `None` if it does not exist or has no valid header
+    async fn load(path: &std::path::Path) -> Result<Option<(CheckpointHeader, Vec<UploadedPart>)>> {
+        let contents = match tokio::fs::read(path).await {
+            Ok(contents) => contents,
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok(None),
+            Err(e) => {
+                return Err(Error::storage(format!(
+                    "Failed to read upload checkpoint: {}",
+                    e
+                )))
+            }
+        };
+
+        let mut lines = contents.split(|&byte| byte == b'\n');
+        let Some(header) = lines
+            .next()
+            .and_then(|line| serde_json::from_slice::<CheckpointHeader>(line).ok())
+        else {
+            return Ok(None);
+        };
+        let parts = lines
+            .filter_map(|line| serde_json::from_slice::<UploadedPart>(line).ok())
+            .collect();
+
+        Ok(Some((header, parts)))
+    }
+
+    /// Append a finished part
+    async fn record(&mut self, part: &UploadedPart) -> Result<()> {
+        use tokio::io::AsyncWriteExt;
+
+        let mut line = serde_json::to_vec(part)?;
+        line.push(b'\n');
+        // Flush so the part is in the file (not just tokio's write buffer) before
+        // the upload moves on
+        let written = match self.file.write_all(&line).await {
+            Ok(()) => self.file.flush().await,
+            Err(e) => Err(e),
+        };
+        written.map_err(|e| Error::storage(format!("Failed to update upload checkpoint: {}", e)))
+    }
+
+    /// Delete the checkpoint after the upload completed
+    async fn remove(self) {
+        drop(self.file);
+        if let Err(e) = tokio::fs::remove_file(&self.path).await {
+            warn!("Failed to remove upload checkpoint {:?}: {}", self.path, e);
+        }
+    }
+}
+
+/// Write every remaining chunk of `stream` to `writer`, returning the byte count
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+async fn write_stream<W>(stream: &mut DownloadStream, writer: &mut W) -> Result<u64>
+where
+    W: tokio::io::AsyncWrite + Unpin,
+{
+    use tokio::io::AsyncWriteExt;
+
+    let mut written = 0u64;
+    while let Some(chunk) = stream.next_chunk().await? {
+        writer
+            .write_all(&chunk)
+            .await
+            .map_err(|e| Error::storage(format!("Failed to write file: {}", e)))?;
+        written += chunk.len() as u64;
+    }
+    Ok(written)
+}
+
+/// Where the chunks of a resumable upload come from
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+enum ChunkSource {
+    /// Chunks are read from an open file into recycled buffers
+    File {
+        file: tokio::fs::File,
+        /// Offset the next read starts at
+        position: u64,
+        buffers: Vec<BytesMut>,
+        buffer_size: usize,
+    },
+    /// Chunks are slices of a memory-mapped file
+    #[cfg(feature = "mmap")]
+    Mapped(Bytes),
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl ChunkSource {
+    /// The `len` bytes starting at `offset`
+    async fn read(&mut self, offset: u64, len: usize) -> Result<Bytes> {
+        match self {
+            Self::File {
+                file,
+                position,
+                buffers,
+                buffer_size,
+            } => {
+                if offset != *position {
+                    use tokio::io::AsyncSeekExt;
+                    file.seek(std::io::SeekFrom::Start(offset))
+                        .await
+                        .map_err(|e| Error::storage(format!("Failed to seek file: {}", e)))?;
+                }
+                let buffer = buffers
+                    .pop()
+                    .unwrap_or_else(|| BytesMut::with_capacity(*buffer_size));
+                let chunk = read_chunk(file, buffer, len).await?;
+                *position = offset + len as u64;
+                Ok(chunk)
+            }
+            #[cfg(feature = "mmap")]
+            Self::Mapped(data) => {
+                let start = offset as usize;
+                Ok(data.slice(start..start + len))
+            }
+        }
+    }
+
+    /// Take back a chunk whose upload has finished
+    fn recycle(&mut self, chunk: Bytes) {
+        match self {
+            Self::File { buffers, .. } => {
+                if let Ok(buffer) = chunk.try_into_mut() {
+                    buffers.push(buffer);
+                }
+            }
+            #[cfg(feature = "mmap")]
+            Self::Mapped(_) => {}
+        }
+    }
+}
+
+/// Map `path` read-only and wrap the mapping in `Bytes`
+#[cfg(all(not(target_arch = "wasm32"), feature = "mmap"))]
+fn map_file(path: &std::path::Path) -> Result<Bytes> {
+    let file = std::fs::File::open(path)
+        .map_err(|e| Error::storage(format!("Failed to open file: {}", e)))?;
+
+    // SAFETY: the mapping is read-only; callers are told not to modify the file
+    // while it is being uploaded
+    let mmap = unsafe { memmap2::Mmap::map(&file) }
+        .map_err(|e| Error::storage(format!("Failed to map file: {}", e)))?;
+
+    #[cfg(unix)]
+    {
+        // Purely a read-ahead hint, so failure is harmless
+        let _ = mmap.advise(memmap2::Advice::Sequential);
+    }
+
+    Ok(Bytes::from_owner(mmap))
+}
+
+/// Read exactly `len` bytes from `file` into a recycled buffer
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+async fn read_chunk<R>(file: &mut R, mut buffer: BytesMut, len: usize) -> Result<Bytes>
+where
+    R: tokio::io::AsyncRead + Unpin,
+{
+    use tokio::io::AsyncReadExt;
+
+    buffer.clear();
+    buffer.reserve(len);
+    while buffer.len() < len {
+        let mut limited = (&mut *file).take((len - buffer.len()) as u64);
+        let read = limited
+            .read_buf(&mut buffer)
+            .await
+            .map_err(|e| Error::storage(format!("Failed to read file chunk: {}", e)))?;
+        if read == 0 {
+            return Err(Error::storage("File ended before the expected size"));
+        }
+    }
+
+    Ok(buffer.freeze())
+}
+
 /// Storage client for file operations
 #[derive(Debug, Clone)]
 pub struct Storage {
     http_client: Arc<HttpClient>,
     config: Arc<SupabaseConfig>,
+    signed_urls: Arc<SignedUrlCache>,
 }
 
 /// Storage bucket information
@@ -84,6 +414,15 @@ pub struct UploadResponse {
     pub id: Option<String>,
 }
 
+/// One entry of a [`Storage::create_signed_urls`] response
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct SignedUrl {
+    pub path: Option<String>,
+    #[serde(rename = "signedURL")]
+    pub signed_url: Option<String>,
+    pub error: Option<String>,
+}
+
 /// File options for upload
 #[derive(Debug, Clone, Default)]
 pub struct FileOptions {
@@ -153,6 +492,11 @@ pub struct ResumableUploadConfig {
     pub retry_delay: u64,
     /// Whether to verify uploaded chunks with checksums (default: true)
     pub verify_checksums: bool,
+    /// Number of chunks uploaded concurrently by `upload_large_file` (default: 4)
+    pub max_concurrent_parts: usize,
+    /// Sidecar file recording upload progress so `resume_large_file` can continue
+    /// an interrupted upload (default: none)
+    pub checkpoint_file: Option<std::path::PathBuf>,
 }
 
 impl Default for ResumableUploadConfig {
@@ -162,6 +506,8 @@ impl Default for ResumableUploadConfig {
             max_retries: 3,
             retry_delay: 1000,
             verify_checksums: true,
+            max_concurrent_parts: 4,
+            checkpoint_file: None,
         }
     }
 }
@@ -169,6 +515,205 @@ impl Default for ResumableUploadConfig {
 /// Progress callback for resumable uploads
 pub type UploadProgressCallback = Arc<dyn Fn(u64, u64) + Send + Sync>;
 
+/// Progress callback for downloads, called with the bytes written so far and the total
+pub type DownloadProgressCallback = Arc<dyn Fn(u64, u64) + Send + Sync>;
+
+/// Configuration for ranged parallel downloads
+#[derive(Debug, Clone)]
+pub struct RangedDownloadConfig {
+    /// Size of each ranged request (default: 8MB)
+    pub part_size: u64,
+    /// Number of ranges downloaded concurrently (default: 4)
+    pub max_concurrent_parts: usize,
+    /// Maximum attempts per range (default: 3)
+    pub max_retries: u32,
+    /// Retry delay in milliseconds (default: 1000)
+    pub retry_delay: u64,
+}
+
+impl Default for RangedDownloadConfig {
+    fn default() -> Self {
+        Self {
+            part_size: 8 * 1024 * 1024, // 8MB
+            max_concurrent_parts: 4,
+            max_retries: 3,
+            retry_delay: 1000,
+        }
+    }
+}
+
+/// Body of a download, yielded chunk by chunk as it arrives from the network
+///
+/// Implements [`Stream`](tokio_stream::Stream); [`next_chunk`](Self::next_chunk)
+/// offers the same without a stream extension trait. Memory use is bounded by
+/// the size of a single network chunk.
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+pub struct DownloadStream {
+    state: DownloadState,
+    total_size: Option<u64>,
+    partial: bool,
+    etag: Option<String>,
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+type PendingChunk = std::pin::Pin<
+    Box<
+        dyn std::future::Future<Output = (reqwest::Response, reqwest::Result<Option<Bytes>>)>
+            + Send,
+    >,
+>;
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+enum DownloadState {
+    Idle(reqwest::Response),
+    Reading(PendingChunk),
+    Done,
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl DownloadStream {
+    fn new(response: reqwest::Response) -> Self {
+        let partial = response.status() == reqwest::StatusCode::PARTIAL_CONTENT;
+        let total_size = match partial {
+            true => response
+                .headers()
+                .get(reqwest::header::CONTENT_RANGE)
+                .and_then(|value| value.to_str().ok())
+                .and_then(content_range_total),
+            false => response.content_length(),
+        };
+        let etag = response
+            .headers()
+            .get(reqwest::header::ETAG)
+            .and_then(|value| value.to_str().ok())
+            .map(str::to_string);
+
+        Self {
+            state: DownloadState::Idle(response),
+            total_size,
+            partial,
+            etag,
+        }
+    }
+
+    /// Whether the server answered with only the requested range
+    fn is_partial(&self) -> bool {
+        self.partial
+    }
+
+    /// Version of the object the body belongs to, when the server reported one
+    fn etag(&self) -> Option<&str> {
+        self.etag.as_deref()
+    }
+
+    /// Size of the whole object, when the server reported it
+    ///
+    /// For ranged downloads this is the object size, not the size of the range.
+    pub fn total_size(&self) -> Option<u64> {
+        self.total_size
+    }
+
+    /// The next chunk of the body, or `None` once it has been fully received
+    pub async fn next_chunk(&mut self) -> Result<Option<Bytes>> {
+        std::future::poll_fn(|cx| {
+            tokio_stream::Stream::poll_next(std::pin::Pin::new(&mut *self), cx)
+                .map(Option::transpose)
+        })
+        .await
+    }
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl tokio_stream::Stream for DownloadStream {
+    type Item = Result<Bytes>;
+
+    fn poll_next(
+        mut self: std::pin::Pin<&mut Self>,
+        cx: &mut std::task::Context<'_>,
+    ) -> std::task::Poll<Option<Self::Item>> {
+        use std::task::Poll;
+
+        loop {
+            match std::mem::replace(&mut self.state, DownloadState::Done) {
+                DownloadState::Idle(mut response) => {
+                    self.state = DownloadState::Reading(Box::pin(async move {
+                        let chunk = response.chunk().await;
+                        (response, chunk)
+                    }));
+                }
+                DownloadState::Reading(mut pending) => {
+                    return match pending.as_mut().poll(cx) {
+                        Poll::Pending => {
+                            self.state = DownloadState::Reading(pending);
+                            Poll::Pending
+                        }
+                        Poll::Ready((response, Ok(Some(chunk)))) => {
+                            self.state = DownloadState::Idle(response);
+                            Poll::Ready(Some(Ok(chunk)))
+                        }
+                        Poll::Ready((_, Ok(None))) => Poll::Ready(None),
+                        Poll::Ready((_, Err(e))) => Poll::Ready(Some(Err(e.into()))),
+                    };
+                }
+                DownloadState::Done => return Poll::Ready(None),
+            }
+        }
+    }
+}
+
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+impl std::fmt::Debug for DownloadStream {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("DownloadStream")
+            .field("total_size", &self.total_size)
+            .finish_non_exhaustive()
+    }
+}
+
+/// Object size from a `Content-Range` header such as `bytes 0-99/1234`
+#[cfg_attr(any(target_arch = "wasm32", not(feature = "native")), allow(dead_code))]
+fn content_range_total(value: &str) -> Option<u64> {
+    value.rsplit_once('/')?.1.trim().parse().ok()
+}
+
+/// `Range` header value for `length` bytes starting at `offset` (to the end if `None`)
+#[cfg_attr(any(target_arch = "wasm32", not(feature = "native")), allow(dead_code))]
+fn range_header(offset: u64, length: Option<u64>) -> String {
+    match length {
+        Some(length) => format!("bytes={}-{}", offset, offset + length.max(1) - 1),
+        None => format!("bytes={}-", offset),
+    }
+}
+
+/// Hidden sibling of `file_path` that a download is written to before it is
+/// renamed into place
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+fn download_staging_path(file_path: &std::path::Path) -> std::path::PathBuf {
+    let name = file_path
+        .file_name()
+        .map_or_else(|| "download".into(), |name| name.to_string_lossy());
+    file_path.with_file_name(format!(".{}.{}.part", name, uuid::Uuid::new_v4().simple()))
+}
+
+/// Error for a ranged download whose object was replaced after its first range
+///
+/// Carries status 412 so that retries can tell it apart from transient failures.
+#[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+fn object_changed_error(bucket_id: &str, path: &str) -> Error {
+    let mut context = ErrorContext::default();
+    context.http = Some(HttpErrorContext {
+        status_code: Some(reqwest::StatusCode::PRECONDITION_FAILED.as_u16()),
+        headers: None,
+        response_body: None,
+        url: None,
+        method: None,
+    });
+    Error::storage_with_context(
+        format!("{}/{} changed during the download", bucket_id, path),
+        context,
+    )
+}
+
 /// Advanced metadata for files
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct FileMetadata {
@@ -223,9 +768,14 @@ impl Storage {
     pub fn new(config: Arc<SupabaseConfig>, http_client: Arc<HttpClient>) -> Result<Self> {
         debug!("Initializing Storage module");
 
+        let signed_urls = Arc::new(SignedUrlCache::new(
+            config.storage_config.signed_url_cache_max_entries,
+        ));
+
         Ok(Self {
             http_client,
             config,
+            signed_urls,
         })
     }
 
@@ -242,7 +792,11 @@ impl Storage {
         debug!("Listing all storage buckets");
 
         let url = format!("{}/storage/v1/bucket", self.config.url);
-        let response = self.http_client.get(&url).send().await?;
+        let response = self
+            .http_client
+            .get(&url)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -264,7 +818,11 @@ impl Storage {
         debug!("Getting bucket info for: {}", bucket_id);
 
         let url = format!("{}/storage/v1/bucket/{}", self.config.url, bucket_id);
-        let response = self.http_client.get(&url).send().await?;
+        let response = self
+            .http_client
+            .get(&url)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -297,7 +855,7 @@ impl Storage {
             .post(&url)
             .header("Authorization", format!("Bearer {}", self.get_admin_key()))
             .json(&payload)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -330,7 +888,7 @@ impl Storage {
             .put(&url)
             .header("Authorization", format!("Bearer {}", self.get_admin_key()))
             .json(&payload)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -355,7 +913,7 @@ impl Storage {
             .http_client
             .delete(&url)
             .header("Authorization", format!("Bearer {}", self.get_admin_key()))
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -422,7 +980,9 @@ impl Storage {
             request = request.header("Authorization", format!("Bearer {}", token));
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -501,9 +1061,11 @@ impl Storage {
             self.config.url, bucket_id, path
         );
 
+        // Streaming the body avoids copying it into a Vec
+        let file_size = file_body.len() as u64;
         let mut form = multipart::Form::new().part(
             "file",
-            multipart::Part::bytes(file_body.to_vec()).file_name(path.to_string()),
+            multipart::Part::stream_with_length(file_body, file_size).file_name(path.to_string()),
         );
 
         if let Some(content_type) = options.content_type {
@@ -525,7 +1087,9 @@ impl Storage {
             request = request.header("x-upsert", "true");
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -597,7 +1161,9 @@ impl Storage {
             request = request.header("x-upsert", "true");
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -686,7 +1252,9 @@ impl Storage {
             request = request.header("Authorization", format!("Bearer {}", token));
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let error_msg = format!("Download failed with status: {}", response.status());
@@ -699,6 +1267,378 @@ impl Storage {
         Ok(bytes)
     }
 
+    /// Download a file as a stream of chunks
+    ///
+    /// Unlike [`download`](Self::download), the object is never held in memory as
+    /// a whole, so arbitrarily large files can be processed with flat memory use.
+    ///
+    /// # Examples
+    /// ```rust,no_run
+    /// # async fn example(storage: &supabase_lib_rs::storage::Storage) -> supabase_lib_rs::Result<()> {
+    /// let mut stream = storage.download_stream("videos", "raw/take-1.mov").await?;
+    /// let mut received = 0;
+    /// while let Some(chunk) = stream.next_chunk().await? {
+    ///     received += chunk.len();
+    /// }
+    /// println!("Received {} bytes", received);
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub async fn download_stream(&self, bucket_id: &str, path: &str) -> Result<DownloadStream> {
+        self.open_download(bucket_id, path, None, None).await
+    }
+
+    /// Download part of a file as a stream of chunks
+    ///
+    /// Requests `length` bytes starting at `offset` (or everything from `offset`
+    /// when `length` is `None`) with an HTTP `Range` header. Fails if the server
+    /// does not honour the range.
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub async fn download_range(
+        &self,
+        bucket_id: &str,
+        path: &str,
+        offset: u64,
+        length: Option<u64>,
+    ) -> Result<DownloadStream> {
+        let range = range_header(offset, length);
+        let stream = self
+            .open_download(bucket_id, path, Some(&range), None)
+            .await?;
+        if stream.is_partial() {
+            Ok(stream)
+        } else {
+            Err(Error::storage(
+                "Server ignored the Range header and returned the whole object",
+            ))
+        }
+    }
+
+    /// Download a file to `file_path`, fetching ranges of it in parallel
+    ///
+    /// The object is split into `part_size` ranges, up to `max_concurrent_parts`
+    /// of which are downloaded at once and written at their offsets. Every range
+    /// after the first is requested with `If-Match` on the first range's ETag, so
+    /// an object replaced mid-download fails the call instead of mixing two
+    /// versions. Servers that do not support ranges, or that answer a range
+    /// without the object's total size or a strong ETag, are handled by a single
+    /// sequential download of the whole object.
+    ///
+    /// Data is written to a hidden temporary file next to `file_path`, which
+    /// replaces `file_path` only once the whole object has arrived. On failure the
+    /// temporary file is removed and `file_path` is left untouched. Returns the
+    /// number of bytes written.
+    ///
+    /// # Examples
+    /// ```rust,no_run
+    /// use supabase_lib_rs::storage::RangedDownloadConfig;
+    ///
+    /// # async fn example(storage: &supabase_lib_rs::storage::Storage) -> supabase_lib_rs::Result<()> {
+    /// let written = storage
+    ///     .download_to_file(
+    ///         "videos",
+    ///         "raw/take-1.mov",
+    ///         "/tmp/take-1.mov",
+    ///         Some(RangedDownloadConfig::default()),
+    ///         None,
+    ///     )
+    ///     .await?;
+    /// println!("Wrote {} bytes", written);
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub async fn download_to_file<P: AsRef<std::path::Path>>(
+        &self,
+        bucket_id: &str,
+        path: &str,
+        file_path: P,
+        config: Option<RangedDownloadConfig>,
+        progress_callback: Option<DownloadProgressCallback>,
+    ) -> Result<u64> {
+        let file_path = file_path.as_ref();
+        debug!("Downloading {}/{} to {:?}", bucket_id, path, file_path);
+
+        let staging = download_staging_path(file_path);
+        let downloaded = match self
+            .download_to_staging(
+                bucket_id,
+                path,
+                &staging,
+                config.unwrap_or_default(),
+                progress_callback,
+            )
+            .await
+        {
+            Ok(written) => tokio::fs::rename(&staging, file_path)
+                .await
+                .map(|()| written)
+                .map_err(|e| Error::storage(format!("Failed to move download into place: {}", e))),
+            Err(e) => Err(e),
+        };
+        if downloaded.is_err() {
+            let _ = tokio::fs::remove_file(&staging).await;
+        }
+
+        let written = downloaded?;
+        info!("Downloaded {} bytes to {:?}", written, file_path);
+        Ok(written)
+    }
+
+    /// Body of [`download_to_file`](Self::download_to_file), writing to `staging`
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    async fn download_to_staging(
+        &self,
+        bucket_id: &str,
+        path: &str,
+        staging: &std::path::Path,
+        config: RangedDownloadConfig,
+        progress_callback: Option<DownloadProgressCallback>,
+    ) -> Result<u64> {
+        use tokio::io::AsyncWriteExt;
+
+        let part_size = config.part_size.max(1);
+
+        let mut file = tokio::fs::File::create(staging)
+            .await
+            .map_err(|e| Error::storage(format!("Failed to create file: {}", e)))?;
+
+        let range = range_header(0, Some(part_size));
+        let mut first = match self
+            .open_download(bucket_id, path, Some(&range), None)
+            .await
+        {
+            Ok(stream) => stream,
+            // The object is empty, so no range of it is satisfiable
+            Err(_) if self.is_empty_object(bucket_id, path).await? => return Ok(0),
+            Err(e) => return Err(e),
+        };
+
+        // If-Match only accepts strong validators
+        let etag = first
+            .etag()
+            .filter(|etag| !etag.starts_with("W/"))
+            .map(str::to_string);
+        let (total_size, etag) = match (first.is_partial(), first.total_size(), etag) {
+            (true, Some(total_size), Some(etag)) => (total_size, etag),
+            (partial, _, _) => {
+                if partial {
+                    // Without the total the object cannot be split into parts, and
+                    // without an ETag the parts cannot be pinned to one version; the
+                    // body is only the first part, so fetch the whole object instead
+                    drop(first);
+                    first = self.open_download(bucket_id, path, None, None).await?;
+                    if first.is_partial() {
+                        return Err(Error::storage(
+                            "Server returned a partial response to a plain download",
+                        ));
+                    }
+                }
+
+                // No usable range support: stream the whole body sequentially
+                let written = write_stream(&mut first, &mut file).await?;
+                file.flush()
+                    .await
+                    .map_err(|e| Error::storage(format!("Failed to write file: {}", e)))?;
+                if let Some(callback) = &progress_callback {
+                    callback(written, written);
+                }
+                return Ok(written);
+            }
+        };
+
+        file.set_len(total_size)
+            .await
+            .map_err(|e| Error::storage(format!("Failed to size file: {}", e)))?;
+        let first_length = std::cmp::min(part_size, total_size);
+        let written = write_stream(&mut first, &mut file).await?;
+        if written != first_length {
+            return Err(Error::storage(format!(
+                "Range 0 returned {} bytes, expected {}",
+                written, first_length
+            )));
+        }
+        file.flush()
+            .await
+            .map_err(|e| Error::storage(format!("Failed to write file: {}", e)))?;
+        drop(file);
+
+        let mut downloaded = written;
+        if let Some(callback) = &progress_callback {
+            callback(downloaded, total_size);
+        }
+
+        let mut offsets = (first_length..total_size).step_by(part_size as usize);
+        let mut downloads = tokio::task::JoinSet::new();
+        loop {
+            while downloads.len() < config.max_concurrent_parts.max(1) {
+                let Some(offset) = offsets.next() else {
+                    break;
+                };
+                let length = std::cmp::min(part_size, total_size - offset);
+                let storage = self.clone();
+                let (bucket_id, path) = (bucket_id.to_string(), path.to_string());
+                let (staging, etag, config) = (staging.to_path_buf(), etag.clone(), config.clone());
+                downloads.spawn(async move {
+                    storage
+                        .download_range_to_file(
+                            &bucket_id, &path, &staging, offset, length, &etag, &config,
+                        )
+                        .await
+                });
+            }
+
+            let Some(finished) = downloads.join_next().await else {
+                break;
+            };
+            let finished = finished
+                .map_err(|e| Error::storage(format!("Download task failed: {}", e)))
+                .and_then(|written| written);
+            match finished {
+                Ok(written) => downloaded += written,
+                Err(e) => {
+                    // Stop the other ranges before the caller removes the file
+                    downloads.shutdown().await;
+                    return Err(e);
+                }
+            }
+
+            if let Some(callback) = &progress_callback {
+                callback(downloaded, total_size);
+            }
+        }
+
+        Ok(downloaded)
+    }
+
+    /// Download one range of the version `etag` into its place in `file_path`,
+    /// retrying as configured
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[allow(clippy::too_many_arguments)]
+    async fn download_range_to_file(
+        &self,
+        bucket_id: &str,
+        path: &str,
+        file_path: &std::path::Path,
+        offset: u64,
+        length: u64,
+        etag: &str,
+        config: &RangedDownloadConfig,
+    ) -> Result<u64> {
+        use tokio::io::{AsyncSeekExt, AsyncWriteExt};
+
+        let mut attempts = 0;
+        loop {
+            attempts += 1;
+
+            let attempt = async {
+                let range = range_header(offset, Some(length));
+                let mut stream = self
+                    .open_download(bucket_id, path, Some(&range), Some(etag))
+                    .await?;
+                if !stream.is_partial() {
+                    return Err(Error::storage(
+                        "Server ignored the Range header and returned the whole object",
+                    ));
+                }
+                // Servers that ignore If-Match still report the replaced version
+                if stream.etag().is_some_and(|current| current != etag) {
+                    return Err(object_changed_error(bucket_id, path));
+                }
+
+                let mut file = tokio::fs::OpenOptions::new()
+                    .write(true)
+                    .open(file_path)
+                    .await
+                    .map_err(|e| Error::storage(format!("Failed to open file: {}", e)))?;
+                file.seek(std::io::SeekFrom::Start(offset))
+                    .await
+                    .map_err(|e| Error::storage(format!("Failed to seek file: {}", e)))?;
+
+                let written = write_stream(&mut stream, &mut file).await?;
+                file.flush()
+                    .await
+                    .map_err(|e| Error::storage(format!("Failed to write file: {}", e)))?;
+                if written != length {
+                    return Err(Error::storage(format!(
+                        "Range at {} returned {} bytes, expected {}",
+                        offset, written, length
+                    )));
+                }
+                Ok(written)
+            };
+
+            match attempt.await {
+                Ok(written) => return Ok(written),
+                // A replaced object fails every retry the same way
+                Err(e)
+                    if attempts < config.max_retries
+                        && e.status_code()
+                            != Some(reqwest::StatusCode::PRECONDITION_FAILED.as_u16()) =>
+                {
+                    warn!(
+                        "Download of range at {} failed (attempt {}), retrying: {}",
+                        offset, attempts, e
+                    );
+                    crate::metrics::record_retry(crate::metrics::Module::Storage);
+                    async_sleep(Duration::from_millis(config.retry_delay)).await;
+                }
+                Err(e) => return Err(e),
+            }
+        }
+    }
+
+    /// Start a download, optionally restricted to a `Range` of the version with
+    /// ETag `if_match`
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    async fn open_download(
+        &self,
+        bucket_id: &str,
+        path: &str,
+        range: Option<&str>,
+        if_match: Option<&str>,
+    ) -> Result<DownloadStream> {
+        debug!(
+            "Streaming file from bucket: {} at path: {} range: {:?}",
+            bucket_id, path, range
+        );
+
+        let url = format!(
+            "{}/storage/v1/object/{}/{}",
+            self.config.url, bucket_id, path
+        );
+
+        let mut request = self.http_client.get(&url);
+        if let Some(range) = range {
+            request = request.header(reqwest::header::RANGE, range);
+        }
+        if let Some(etag) = if_match {
+            request = request.header(reqwest::header::IF_MATCH, etag);
+        }
+
+        let response = request
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
+
+        if if_match.is_some() && response.status() == reqwest::StatusCode::PRECONDITION_FAILED {
+            return Err(object_changed_error(bucket_id, path));
+        }
+        if !response.status().is_success() {
+            let error_msg = format!("Download failed with status: {}", response.status());
+            return Err(Error::storage(error_msg));
+        }
+
+        Ok(DownloadStream::new(response))
+    }
+
+    /// Whether the object exists and has no content
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    async fn is_empty_object(&self, bucket_id: &str, path: &str) -> Result<bool> {
+        let mut stream = self.open_download(bucket_id, path, None, None).await?;
+        Ok(stream.total_size() == Some(0) || stream.next_chunk().await?.is_none())
+    }
+
     /// Delete a file
     pub async fn remove(&self, bucket_id: &str, paths: &[&str]) -> Result<()> {
         self.remove_with_auth(bucket_id, paths, None).await
@@ -750,13 +1690,19 @@ impl Storage {
             request = request.header("Authorization", format!("Bearer {}", token));
         }
 
-        let response = request.send().await?;
+        let response = request
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let error_msg = format!("Delete files failed with status: {}", response.status());
             return Err(Error::storage(error_msg));
         }
 
+        for path in paths {
+            self.signed_urls.invalidate(bucket_id, path);
+        }
+
         info!("Deleted {} files successfully", paths.len());
         Ok(())
     }
@@ -773,7 +1719,12 @@ impl Storage {
             "destinationKey": to_path
         });
 
-        let response = self.http_client.post(&url).json(&payload).send().await?;
+        let response = self
+            .http_client
+            .post(&url)
+            .json(&payload)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -784,6 +1735,8 @@ impl Storage {
             return Err(Error::storage(error_msg));
         }
 
+        self.signed_urls.invalidate(bucket_id, from_path);
+
         info!("Moved file successfully from {} to {}", from_path, to_path);
         Ok(())
     }
@@ -800,7 +1753,12 @@ impl Storage {
             "destinationKey": to_path
         });
 
-        let response = self.http_client.post(&url).json(&payload).send().await?;
+        let response = self
+            .http_client
+            .post(&url)
+            .json(&payload)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let status = response.status();
@@ -824,6 +1782,16 @@ impl Storage {
     }
 
     /// Get signed URL for private file access
+    ///
+    /// URLs are always signed for exactly `expires_in` seconds. When
+    /// [`StorageConfig::signed_url_cache_max_entries`] is non-zero, URLs without a
+    /// transform are cached per client, and a previously signed URL is returned
+    /// without a request only while it remains valid for at least `expires_in`
+    /// more seconds. The returned URL therefore never expires earlier than
+    /// requested, and a cached URL is only reused by requests asking for a
+    /// shorter lifetime than it has left.
+    ///
+    /// [`StorageConfig::signed_url_cache_max_entries`]: crate::types::StorageConfig::signed_url_cache_max_entries
     pub async fn create_signed_url(
         &self,
         bucket_id: &str,
@@ -836,6 +1804,14 @@ impl Storage {
             bucket_id, path, expires_in
         );
 
+        let cacheable = transform.is_none();
+        if cacheable {
+            if let Some(signed_url) = self.signed_urls.get(bucket_id, path, expires_in) {
+                debug!("Reusing cached signed URL for {}/{}", bucket_id, path);
+                return Ok(signed_url);
+            }
+        }
+
         let url = format!(
             "{}/storage/v1/object/sign/{}/{}",
             self.config.url, bucket_id, path
@@ -867,7 +1843,12 @@ impl Storage {
             payload["transform"] = serde_json::Value::Object(transform_params);
         }
 
-        let response = self.http_client.post(&url).json(&payload).send().await?;
+        let response = self
+            .http_client
+            .post(&url)
+            .json(&payload)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let error_msg = format!(
@@ -882,10 +1863,119 @@ impl Storage {
             .as_str()
             .ok_or_else(|| Error::storage("Invalid signed URL response"))?;
 
+        if cacheable {
+            self.signed_urls
+                .insert(bucket_id, path, signed_url.to_string(), expires_in);
+        }
+
         info!("Created signed URL successfully");
         Ok(signed_url.to_string())
     }
 
+    /// Get signed URLs for many files in one request
+    ///
+    /// Results are returned in the order of `paths`; a path the server could not
+    /// sign has its `error` set instead of `signed_url`. Paths with a cached URL
+    /// valid for at least `expires_in` more seconds are not sent, and no request
+    /// is made when all of them are cached; see
+    /// [`create_signed_url`](Self::create_signed_url) for how long cached URLs
+    /// are signed for.
+    ///
+    /// # Examples
+    /// ```rust,no_run
+    /// # async fn example(storage: &supabase_lib_rs::storage::Storage) -> supabase_lib_rs::Result<()> {
+    /// let urls = storage
+    ///     .create_signed_urls("avatars", &["a.png", "b.png"], 3600)
+    ///     .await?;
+    /// for url in urls {
+    ///     println!("{:?} -> {:?}", url.path, url.signed_url);
+    /// }
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub async fn create_signed_urls(
+        &self,
+        bucket_id: &str,
+        paths: &[&str],
+        expires_in: u32,
+    ) -> Result<Vec<SignedUrl>> {
+        debug!(
+            "Creating {} signed URLs for bucket: {} expires_in: {}",
+            paths.len(),
+            bucket_id,
+            expires_in
+        );
+
+        let mut results: Vec<Option<SignedUrl>> = paths
+            .iter()
+            .map(|path| {
+                self.signed_urls
+                    .get(bucket_id, path, expires_in)
+                    .map(|signed_url| SignedUrl {
+                        path: Some(path.to_string()),
+                        signed_url: Some(signed_url),
+                        error: None,
+                    })
+            })
+            .collect();
+        let missing: Vec<usize> = (0..paths.len())
+            .filter(|&index| results[index].is_none())
+            .collect();
+
+        if !missing.is_empty() {
+            let url = format!("{}/storage/v1/object/sign/{}", self.config.url, bucket_id);
+            let payload = serde_json::json!({
+                "expiresIn": expires_in,
+                "paths": missing.iter().map(|&index| paths[index]).collect::<Vec<_>>(),
+            });
+
+            let response = self
+                .http_client
+                .post(&url)
+                .json(&payload)
+                .send_compressed(&self.config.storage_config.compression)
+                .await?;
+
+            if !response.status().is_success() {
+                let error_msg = format!(
+                    "Create signed URLs failed with status: {}",
+                    response.status()
+                );
+                return Err(Error::storage(error_msg));
+            }
+
+            let signed: Vec<SignedUrl> = response.json().await?;
+            if signed.len() != missing.len() {
+                return Err(Error::storage(format!(
+                    "Expected {} signed URLs, got {}",
+                    missing.len(),
+                    signed.len()
+                )));
+            }
+
+            // The server answers in request order
+            for (index, entry) in missing.into_iter().zip(signed) {
+                if let (Some(signed_url), None) = (&entry.signed_url, &entry.error) {
+                    self.signed_urls.insert(
+                        bucket_id,
+                        paths[index],
+                        signed_url.clone(),
+                        expires_in,
+                    );
+                }
+                results[index] = Some(entry);
+            }
+        }
+
+        info!("Created {} signed URLs successfully", paths.len());
+        Ok(results.into_iter().flatten().collect())
+    }
+
+    /// Forget all cached signed URLs
+    pub fn clear_signed_url_cache(&self) {
+        self.signed_urls.clear();
+    }
+
     /// Get transformed image URL
     pub fn get_public_url_transformed(
         &self,
@@ -987,7 +2077,12 @@ impl Storage {
             "upsert": options.upsert
         });
 
-        let response = self.http_client.post(&url).json(&payload).send().await?;
+        let response = self
+            .http_client
+            .post(&url)
+            .json(&payload)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let error_msg = format!(
@@ -1049,7 +2144,7 @@ impl Storage {
             .header("Content-Type", "application/octet-stream")
             .header("X-Part-Number", part_number.to_string())
             .body(chunk_data)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -1105,7 +2200,12 @@ impl Storage {
             "parts": session.uploaded_parts
         });
 
-        let response = self.http_client.post(&url).json(&payload).send().await?;
+        let response = self
+            .http_client
+            .post(&url)
+            .json(&payload)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let error_msg = format!(
@@ -1124,6 +2224,8 @@ impl Storage {
     /// Upload a large file with automatic chunking and resume capability
     ///
     /// This is a high-level method that handles the entire resumable upload process.
+    /// Up to `max_concurrent_parts` chunks are uploaded at once while the next one
+    /// is read from disk, and chunk buffers are reused between parts.
     ///
     /// # Examples
     /// ```rust,no_run
@@ -1181,86 +2283,383 @@ impl Storage {
         }
 
         // Start resumable upload session
-        let mut session = self
+        let session = self
             .start_resumable_upload(bucket_id, path, total_size, Some(config.clone()), options)
             .await?;
 
+        let checkpoint = match &config.checkpoint_file {
+            Some(checkpoint_path) => Some(
+                UploadCheckpoint::create(
+                    checkpoint_path,
+                    &session,
+                    SourceFingerprint::of(&metadata),
+                )
+                .await?,
+            ),
+            None => None,
+        };
+
+        self.upload_remaining_parts(
+            session,
+            file_path.as_ref(),
+            &config,
+            progress_callback,
+            checkpoint,
+        )
+        .await
+    }
+
+    /// Continue an upload interrupted by a crash or network failure
+    ///
+    /// Requires [`ResumableUploadConfig::checkpoint_file`], which
+    /// [`upload_large_file`](Self::upload_large_file) keeps up to date as parts
+    /// complete. The session recorded there is looked up with
+    /// [`get_upload_session`](Self::get_upload_session); parts the server has
+    /// acknowledged are skipped and the rest are uploaded in parallel. If there is
+    /// no usable checkpoint (missing, for another file, or the session expired)
+    /// the upload starts over. The checkpoint is removed once the upload completes.
+    ///
+    /// # Examples
+    /// ```rust,no_run
+    /// use supabase_lib_rs::storage::ResumableUploadConfig;
+    ///
+    /// # async fn example(storage: &supabase_lib_rs::storage::Storage) -> supabase_lib_rs::Result<()> {
+    /// let config = ResumableUploadConfig {
+    ///     checkpoint_file: Some("/data/raw.mov.upload".into()),
+    ///     ..Default::default()
+    /// };
+    ///
+    /// // Safe to call again after a crash: finished parts are not re-sent
+    /// let response = storage
+    ///     .resume_large_file("videos", "raw.mov", "/data/raw.mov", Some(config), None, None)
+    ///     .await?;
+    /// println!("Upload completed: {}", response.key);
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    pub async fn resume_large_file<P: AsRef<std::path::Path>>(
+        &self,
+        bucket_id: &str,
+        path: &str,
+        file_path: P,
+        config: Option<ResumableUploadConfig>,
+        options: Option<FileOptions>,
+        progress_callback: Option<UploadProgressCallback>,
+    ) -> Result<UploadResponse> {
+        let mut config = config.unwrap_or_default();
+        let Some(checkpoint_path) = config.checkpoint_file.clone() else {
+            return Err(Error::invalid_input(
+                "resume_large_file requires ResumableUploadConfig::checkpoint_file",
+            ));
+        };
+
+        let metadata = tokio::fs::metadata(&file_path)
+            .await
+            .map_err(|e| Error::storage(format!("Failed to get file metadata: {}", e)))?;
+        let fingerprint = SourceFingerprint::of(&metadata);
+
+        let recorded = UploadCheckpoint::load(&checkpoint_path)
+            .await?
+            .filter(|(header, _)| {
+                header.bucket_id == bucket_id
+                    && header.object_path == path
+                    && header.source == fingerprint
+            });
+        let Some((header, recorded_parts)) = recorded else {
+            debug!("No usable upload checkpoint, starting a new upload");
+            return self
+                .upload_large_file(
+                    bucket_id,
+                    path,
+                    file_path,
+                    Some(config),
+                    options,
+                    progress_callback,
+                )
+                .await;
+        };
+
+        let mut session = match self.get_upload_session(&header.upload_id).await {
+            Ok(session) => session,
+            Err(e) => {
+                warn!(
+                    "Upload session {} can no longer be resumed, starting over: {}",
+                    header.upload_id, e
+                );
+                return self
+                    .upload_large_file(
+                        bucket_id,
+                        path,
+                        file_path,
+                        Some(config),
+                        options,
+                        progress_callback,
+                    )
+                    .await;
+            }
+        };
+
+        // The server's list is authoritative; the checkpoint fills in parts whose
+        // acknowledgement it has not reported yet
+        for part in recorded_parts {
+            if !session
+                .uploaded_parts
+                .iter()
+                .any(|uploaded| uploaded.part_number == part.part_number)
+            {
+                session.uploaded_parts.push(part);
+            }
+        }
+        session.bucket_id = header.bucket_id.clone();
+        session.object_path = header.object_path.clone();
+        session.total_size = fingerprint.size;
+        session.part_size = header.part_size;
+        config.chunk_size = header.part_size;
+
+        info!(
+            "Resuming upload session {} with {} of its parts already uploaded",
+            session.upload_id,
+            session.uploaded_parts.len()
+        );
+
+        let checkpoint = UploadCheckpoint::append_to(&checkpoint_path).await?;
+        self.upload_remaining_parts(
+            session,
+            file_path.as_ref(),
+            &config,
+            progress_callback,
+            Some(checkpoint),
+        )
+        .await
+    }
+
+    /// Upload the parts of `session` not yet in `uploaded_parts` from `file_path`
+    /// and complete the upload
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    async fn upload_remaining_parts(
+        &self,
+        mut session: UploadSession,
+        file_path: &std::path::Path,
+        config: &ResumableUploadConfig,
+        progress_callback: Option<UploadProgressCallback>,
+        mut checkpoint: Option<UploadCheckpoint>,
+    ) -> Result<UploadResponse> {
         // Open file for reading
-        let mut file = tokio::fs::File::open(&file_path)
+        let file = tokio::fs::File::open(file_path)
             .await
             .map_err(|e| Error::storage(format!("Failed to open file: {}", e)))?;
 
-        let mut uploaded_size = 0u64;
-        let mut part_number = 1u32;
+        let source = ChunkSource::File {
+            file,
+            position: 0,
+            buffers: Vec::with_capacity(config.max_concurrent_parts.max(1) + 1),
+            buffer_size: config.chunk_size as usize,
+        };
+        self.upload_parts(
+            &mut session,
+            source,
+            config,
+            progress_callback.as_ref(),
+            checkpoint.as_mut(),
+        )
+        .await?;
 
-        // Upload chunks
-        loop {
-            let remaining_size = total_size - uploaded_size;
-            if remaining_size == 0 {
-                break;
-            }
+        // Complete upload
+        let response = self.complete_resumable_upload(&session).await?;
 
-            let chunk_size = std::cmp::min(config.chunk_size, remaining_size);
-            let mut buffer = vec![0u8; chunk_size as usize];
+        if let Some(checkpoint) = checkpoint {
+            checkpoint.remove().await;
+        }
 
-            // Read chunk from file
-            use tokio::io::AsyncReadExt;
-            let bytes_read = file
-                .read_exact(&mut buffer)
-                .await
-                .map_err(|e| Error::storage(format!("Failed to read file chunk: {}", e)))?;
+        info!("Large file upload completed: {}", response.key);
+        Ok(response)
+    }
 
-            if bytes_read == 0 {
-                break;
+    /// Upload a file by memory-mapping it instead of reading it into memory
+    ///
+    /// Behaves like [`upload_large_file`](Self::upload_large_file), but each part
+    /// is a slice of the mapping, so no chunk is copied into a heap buffer and no
+    /// read call is made per chunk; pages are loaded by the kernel as they are
+    /// sent. Meant for write-once files: the file must not be truncated or
+    /// modified while the upload runs.
+    ///
+    /// # Examples
+    /// ```rust,no_run
+    /// # async fn example(storage: &supabase_lib_rs::storage::Storage) -> supabase_lib_rs::Result<()> {
+    /// let response = storage
+    ///     .upload_file_mapped("archive", "2024/backup.tar", "/data/backup.tar", None, None, None)
+    ///     .await?;
+    /// println!("Upload completed: {}", response.key);
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(all(not(target_arch = "wasm32"), feature = "mmap"))]
+    pub async fn upload_file_mapped<P: AsRef<std::path::Path>>(
+        &self,
+        bucket_id: &str,
+        path: &str,
+        file_path: P,
+        config: Option<ResumableUploadConfig>,
+        options: Option<FileOptions>,
+        progress_callback: Option<UploadProgressCallback>,
+    ) -> Result<UploadResponse> {
+        let config = config.unwrap_or_default();
+
+        debug!("Starting mapped file upload from: {:?}", file_path.as_ref());
+
+        let data = map_file(file_path.as_ref())?;
+        let total_size = data.len() as u64;
+
+        if total_size <= config.chunk_size {
+            let response = self.upload(bucket_id, path, data, options).await?;
+            if let Some(callback) = &progress_callback {
+                callback(total_size, total_size);
             }
+            return Ok(response);
+        }
 
-            buffer.truncate(bytes_read);
-            let chunk_data = Bytes::from(buffer);
+        let mut session = self
+            .start_resumable_upload(bucket_id, path, total_size, Some(config.clone()), options)
+            .await?;
 
-            // Upload chunk with retries
-            let mut attempts = 0;
-            let part = loop {
-                attempts += 1;
+        self.upload_parts(
+            &mut session,
+            ChunkSource::Mapped(data),
+            &config,
+            progress_callback.as_ref(),
+            None,
+        )
+        .await?;
 
-                match self
-                    .upload_chunk(&session, part_number, chunk_data.clone())
-                    .await
-                {
-                    Ok(part) => break part,
-                    Err(e) if attempts < config.max_retries => {
-                        warn!(
-                            "Upload chunk {} failed (attempt {}), retrying: {}",
-                            part_number, attempts, e
-                        );
-                        async_sleep(Duration::from_millis(config.retry_delay)).await;
-                        continue;
-                    }
-                    Err(e) => return Err(e),
-                }
-            };
+        let response = self.complete_resumable_upload(&session).await?;
 
-            session.uploaded_parts.push(part);
-            uploaded_size += chunk_size;
-            part_number += 1;
+        info!("Mapped file upload completed: {}", response.key);
+        Ok(response)
+    }
 
-            // Call progress callback
-            if let Some(callback) = &progress_callback {
+    /// Upload every part of `session` from `source` that is not already in its
+    /// `uploaded_parts`, keeping up to `max_concurrent_parts` uploads in flight
+    ///
+    /// The next chunk is fetched while uploads are running, and chunks are handed
+    /// back to the source once their upload has finished so buffers can be reused.
+    /// Each finished part is recorded in `checkpoint`. On return the session's
+    /// parts are sorted by part number.
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    async fn upload_parts(
+        &self,
+        session: &mut UploadSession,
+        mut source: ChunkSource,
+        config: &ResumableUploadConfig,
+        progress_callback: Option<&UploadProgressCallback>,
+        mut checkpoint: Option<&mut UploadCheckpoint>,
+    ) -> Result<()> {
+        let total_size = session.total_size;
+        let max_in_flight = config.max_concurrent_parts.max(1);
+        let done: std::collections::HashSet<u32> = session
+            .uploaded_parts
+            .iter()
+            .map(|part| part.part_number)
+            .collect();
+        let chunk_session = Arc::new(session.clone());
+        let mut uploads = tokio::task::JoinSet::new();
+        let mut next_chunk: Option<(u32, Bytes)> = None;
+        let mut read_size = 0u64;
+        let mut uploaded_size: u64 = session.uploaded_parts.iter().map(|part| part.size).sum();
+        let mut part_number = 1u32;
+
+        if uploaded_size > 0 {
+            if let Some(callback) = progress_callback {
                 callback(uploaded_size, total_size);
             }
+        }
+
+        loop {
+            while next_chunk.is_none() && read_size < total_size {
+                let chunk_size = std::cmp::min(config.chunk_size, total_size - read_size);
+                let offset = read_size;
+                let number = part_number;
+                read_size += chunk_size;
+                part_number += 1;
+
+                if done.contains(&number) {
+                    continue;
+                }
+                let chunk = source.read(offset, chunk_size as usize).await?;
+                next_chunk = Some((number, chunk));
+            }
+
+            if uploads.len() < max_in_flight {
+                if let Some((number, chunk)) = next_chunk.take() {
+                    let storage = self.clone();
+                    let session = Arc::clone(&chunk_session);
+                    let config = config.clone();
+                    uploads.spawn(async move {
+                        let part = storage
+                            .upload_chunk_with_retries(&session, number, chunk.clone(), &config)
+                            .await?;
+                        Ok::<_, Error>((part, chunk))
+                    });
+                    continue;
+                }
+            }
 
+            let Some(finished) = uploads.join_next().await else {
+                break;
+            };
+            let (part, chunk) =
+                finished.map_err(|e| Error::storage(format!("Upload task failed: {}", e)))??;
+
+            uploaded_size += part.size;
             debug!(
                 "Uploaded chunk {}, progress: {}/{}",
-                part_number - 1,
-                uploaded_size,
-                total_size
+                part.part_number, uploaded_size, total_size
             );
+            if let Some(checkpoint) = checkpoint.as_deref_mut() {
+                checkpoint.record(&part).await?;
+            }
+            session.uploaded_parts.push(part);
+            source.recycle(chunk);
+
+            // Call progress callback
+            if let Some(callback) = progress_callback {
+                callback(uploaded_size, total_size);
+            }
         }
 
-        // Complete upload
-        let response = self.complete_resumable_upload(&session).await?;
+        session.uploaded_parts.sort_by_key(|part| part.part_number);
+        Ok(())
+    }
 
-        info!("Large file upload completed: {}", response.key);
-        Ok(response)
+    /// Upload one chunk, retrying failed attempts as configured
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    async fn upload_chunk_with_retries(
+        &self,
+        session: &UploadSession,
+        part_number: u32,
+        chunk_data: Bytes,
+        config: &ResumableUploadConfig,
+    ) -> Result<UploadedPart> {
+        let mut attempts = 0;
+        loop {
+            attempts += 1;
+
+            match self
+                .upload_chunk(session, part_number, chunk_data.clone())
+                .await
+            {
+                Ok(part) => return Ok(part),
+                Err(e) if attempts < config.max_retries => {
+                    warn!(
+                        "Upload chunk {} failed (attempt {}), retrying: {}",
+                        part_number, attempts, e
+                    );
+                    crate::metrics::record_retry(crate::metrics::Module::Storage);
+                    async_sleep(Duration::from_millis(config.retry_delay)).await;
+                }
+                Err(e) => return Err(e),
+            }
+        }
     }
 
     /// Get resumable upload session status
@@ -1270,7 +2669,11 @@ impl Storage {
 
         let url = format!("{}/storage/v1/resumable/{}", self.config.url, upload_id);
 
-        let response = self.http_client.get(&url).send().await?;
+        let response = self
+            .http_client
+            .get(&url)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let error_msg = format!(
@@ -1291,7 +2694,11 @@ impl Storage {
 
         let url = format!("{}/storage/v1/resumable/{}", self.config.url, upload_id);
 
-        let response = self.http_client.delete(&url).send().await?;
+        let response = self
+            .http_client
+            .delete(&url)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let error_msg = format!(
@@ -1349,7 +2756,12 @@ impl Storage {
             self.config.url, bucket_id, path
         );
 
-        let response = self.http_client.put(&url).json(metadata).send().await?;
+        let response = self
+            .http_client
+            .put(&url)
+            .json(metadata)
+            .send_compressed(&self.config.storage_config.compression)
+            .await?;
 
         if !response.status().is_success() {
             let error_msg = format!(
@@ -1400,7 +2812,7 @@ impl Storage {
             .http_client
             .post(&url)
             .json(search_options)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -1456,7 +2868,7 @@ impl Storage {
             .header("Authorization", format!("Bearer {}", self.get_admin_key()))
             .header("apikey", self.get_admin_key())
             .json(&payload)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -1509,7 +2921,7 @@ impl Storage {
             .header("Authorization", format!("Bearer {}", self.get_admin_key()))
             .header("apikey", self.get_admin_key())
             .json(&payload)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -1552,7 +2964,7 @@ impl Storage {
             .header("Authorization", format!("Bearer {}", self.get_admin_key()))
             .header("apikey", self.get_admin_key())
             .json(&payload)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -1592,7 +3004,7 @@ impl Storage {
             .header("Authorization", format!("Bearer {}", self.get_admin_key()))
             .header("apikey", self.get_admin_key())
             .json(&payload)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -1662,7 +3074,7 @@ impl Storage {
             .header("Authorization", format!("Bearer {}", self.get_admin_key()))
             .header("apikey", self.get_admin_key())
             .json(&payload)
-            .send()
+            .send_compressed(&self.config.storage_config.compression)
             .await?;
 
         if !response.status().is_success() {
@@ -1772,3 +3184,398 @@ pub enum PolicyTemplate {
     /// Allow read-only access to users with specific role
     ReadOnlyForRole(String),
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    use crate::mock_server::{MockResponse, MockServer};
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_read_chunk_reuses_buffer() {
+        let mut file: &[u8] = b"abcdefgh";
+        let buffer = BytesMut::with_capacity(4);
+        let capacity_ptr = buffer.as_ptr();
+
+        let first = read_chunk(&mut file, buffer, 4).await.unwrap();
+        assert_eq!(&first[..], b"abcd");
+
+        // A uniquely owned chunk converts back into its original allocation
+        let buffer = first.try_into_mut().unwrap();
+        assert_eq!(buffer.as_ptr(), capacity_ptr);
+
+        let second = read_chunk(&mut file, buffer, 4).await.unwrap();
+        assert_eq!(&second[..], b"efgh");
+
+        let short = read_chunk(&mut file, BytesMut::new(), 1).await;
+        assert!(short.is_err());
+    }
+
+    #[test]
+    fn test_signed_url_cache() {
+        let cache = SignedUrlCache::new(1);
+        cache.insert("media", "a.png", "/sign/a".to_string(), 7200);
+
+        assert_eq!(
+            cache.get("media", "a.png", 3600).as_deref(),
+            Some("/sign/a")
+        );
+        // Never handed out for a request that would outlive it
+        assert!(cache.get("media", "a.png", 7200).is_none());
+        assert!(cache.get("other", "a.png", 3600).is_none());
+
+        // A single-entry cache keeps only the latest URL
+        cache.insert("media", "b.png", "/sign/b".to_string(), 7200);
+        assert!(cache.get("media", "a.png", 60).is_none());
+        assert!(cache.get("media", "b.png", 60).is_some());
+
+        cache.invalidate("media", "b.png");
+        assert!(cache.get("media", "b.png", 60).is_none());
+
+        let disabled = SignedUrlCache::new(0);
+        disabled.insert("media", "a.png", "/sign/a".to_string(), 3600);
+        assert!(disabled.get("media", "a.png", 60).is_none());
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[tokio::test]
+    async fn test_create_signed_urls_uses_cache() {
+        let mut config = SupabaseConfig {
+            url: "http://127.0.0.1:1".to_string(),
+            ..Default::default()
+        };
+        config.storage_config.signed_url_cache_max_entries = 16;
+        let storage = Storage::new(Arc::new(config), Arc::new(HttpClient::new())).unwrap();
+        storage
+            .signed_urls
+            .insert("media", "a.png", "/sign/a".to_string(), 7200);
+        storage
+            .signed_urls
+            .insert("media", "b.png", "/sign/b".to_string(), 7200);
+
+        // Fully cached: no request is sent to the unreachable server
+        let urls = storage
+            .create_signed_urls("media", &["b.png", "a.png"], 3600)
+            .await
+            .unwrap();
+        let signed: Vec<_> = urls.iter().map(|url| url.signed_url.as_deref()).collect();
+        assert_eq!(signed, vec![Some("/sign/b"), Some("/sign/a")]);
+        assert_eq!(
+            storage
+                .create_signed_url("media", "a.png", 3600, None)
+                .await
+                .unwrap(),
+            "/sign/a"
+        );
+
+        let result = storage
+            .create_signed_urls("media", &["a.png", "c.png"], 3600)
+            .await;
+        assert!(result.is_err());
+
+        storage.clear_signed_url_cache();
+        assert!(storage
+            .create_signed_url("media", "a.png", 3600, None)
+            .await
+            .is_err());
+    }
+
+    #[test]
+    fn test_range_headers() {
+        assert_eq!(range_header(0, Some(100)), "bytes=0-99");
+        assert_eq!(range_header(100, None), "bytes=100-");
+        assert_eq!(content_range_total("bytes 0-99/1234"), Some(1234));
+        assert_eq!(content_range_total("bytes 0-99/*"), None);
+        assert_eq!(content_range_total("bytes */0"), Some(0));
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_download_stream_reports_connection_errors() {
+        let config = Arc::new(SupabaseConfig {
+            url: "http://127.0.0.1:1".to_string(),
+            ..Default::default()
+        });
+        let storage = Storage::new(config, Arc::new(HttpClient::new())).unwrap();
+
+        assert!(storage.download_stream("bucket", "file").await.is_err());
+        assert!(storage
+            .download_range("bucket", "file", 10, Some(10))
+            .await
+            .is_err());
+    }
+
+    /// Serve `body` over HTTP, honouring single `Range` requests and `If-Match`
+    ///
+    /// Without `known_total` the `Content-Range` total is reported as `*`. With a
+    /// `replacement`, the object is overwritten by it after the first request.
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    fn serve_ranges(
+        body: &'static [u8],
+        known_total: bool,
+        replacement: Option<&'static [u8]>,
+    ) -> MockServer {
+        let requests = std::sync::atomic::AtomicUsize::new(0);
+        MockServer::start(move |request| {
+            let first = requests.fetch_add(1, std::sync::atomic::Ordering::SeqCst) == 0;
+            let (body, etag) = match replacement {
+                Some(replacement) if !first => (replacement, "\"v2\""),
+                _ => (body, "\"v1\""),
+            };
+            if request
+                .header("if-match")
+                .is_some_and(|expected| expected != etag)
+            {
+                return MockResponse::new(412);
+            }
+
+            let range = request
+                .header("range")
+                .and_then(|range| range.strip_prefix("bytes="))
+                .and_then(|range| range.split_once('-'))
+                .map(|(start, end)| {
+                    let start: usize = start.parse().unwrap();
+                    let end = end
+                        .parse::<usize>()
+                        .map_or(body.len(), |end| (end + 1).min(body.len()));
+                    (start, end)
+                });
+
+            match range {
+                Some((start, end)) => {
+                    let total = if known_total {
+                        body.len().to_string()
+                    } else {
+                        "*".to_string()
+                    };
+                    MockResponse::new(206)
+                        .header(
+                            "content-range",
+                            format!("bytes {}-{}/{}", start, end - 1, total),
+                        )
+                        .header("etag", etag)
+                        .body(&body[start..end])
+                }
+                None => MockResponse::new(200).header("etag", etag).body(body),
+            }
+        })
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_ranged_downloads() {
+        const BODY: &[u8] = b"the quick brown fox jumps over the lazy dog";
+
+        let server = serve_ranges(BODY, true, None);
+        let config = Arc::new(SupabaseConfig {
+            url: server.url().to_string(),
+            ..Default::default()
+        });
+        let storage = Storage::new(config, Arc::new(HttpClient::new())).unwrap();
+
+        let mut stream = storage
+            .download_range("bucket", "fox.txt", 4, Some(5))
+            .await
+            .unwrap();
+        assert_eq!(stream.total_size(), Some(BODY.len() as u64));
+        let mut range = Vec::new();
+        while let Some(chunk) = stream.next_chunk().await.unwrap() {
+            range.extend_from_slice(&chunk);
+        }
+        assert_eq!(range, b"quick");
+
+        let path = std::env::temp_dir().join(format!("supabase-range-{}", uuid::Uuid::new_v4()));
+        let progress = Arc::new(std::sync::Mutex::new(Vec::new()));
+        let recorded = Arc::clone(&progress);
+        let written = storage
+            .download_to_file(
+                "bucket",
+                "fox.txt",
+                &path,
+                Some(RangedDownloadConfig {
+                    part_size: 8,
+                    max_concurrent_parts: 3,
+                    ..Default::default()
+                }),
+                Some(Arc::new(move |done, total| {
+                    recorded.lock().unwrap().push((done, total))
+                })),
+            )
+            .await
+            .unwrap();
+
+        assert_eq!(written, BODY.len() as u64);
+        assert_eq!(std::fs::read(&path).unwrap(), BODY);
+        assert_eq!(
+            progress.lock().unwrap().last(),
+            Some(&(BODY.len() as u64, BODY.len() as u64))
+        );
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_download_to_file_without_range_total() {
+        const BODY: &[u8] = b"the quick brown fox jumps over the lazy dog";
+
+        let server = serve_ranges(BODY, false, None);
+        let config = Arc::new(SupabaseConfig {
+            url: server.url().to_string(),
+            ..Default::default()
+        });
+        let storage = Storage::new(config, Arc::new(HttpClient::new())).unwrap();
+
+        let path = std::env::temp_dir().join(format!("supabase-range-{}", uuid::Uuid::new_v4()));
+        let written = storage
+            .download_to_file(
+                "bucket",
+                "fox.txt",
+                &path,
+                Some(RangedDownloadConfig {
+                    part_size: 8,
+                    ..Default::default()
+                }),
+                None,
+            )
+            .await
+            .unwrap();
+
+        // The partial first response is discarded in favour of the whole object
+        assert_eq!(written, BODY.len() as u64);
+        assert_eq!(std::fs::read(&path).unwrap(), BODY);
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_download_to_file_fails_when_object_changes() {
+        const BODY: &[u8] = b"the quick brown fox jumps over the lazy dog";
+        const REPLACEMENT: &[u8] = b"THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG";
+
+        let server = serve_ranges(BODY, true, Some(REPLACEMENT));
+        let config = Arc::new(SupabaseConfig {
+            url: server.url().to_string(),
+            ..Default::default()
+        });
+        let storage = Storage::new(config, Arc::new(HttpClient::new())).unwrap();
+
+        let dir = std::env::temp_dir().join(format!("supabase-range-{}", uuid::Uuid::new_v4()));
+        std::fs::create_dir(&dir).unwrap();
+        let path = dir.join("fox.txt");
+        std::fs::write(&path, b"previous download").unwrap();
+
+        let result = storage
+            .download_to_file(
+                "bucket",
+                "fox.txt",
+                &path,
+                Some(RangedDownloadConfig {
+                    part_size: 8,
+                    ..Default::default()
+                }),
+                None,
+            )
+            .await;
+
+        // The later ranges no longer match the first one's ETag
+        let err = result.unwrap_err();
+        assert_eq!(err.status_code(), Some(412));
+        assert!(
+            err.to_string().contains("changed during the download"),
+            "{err}"
+        );
+        // The destination is untouched and the temporary file is gone
+        assert_eq!(std::fs::read(&path).unwrap(), b"previous download");
+        assert_eq!(std::fs::read_dir(&dir).unwrap().count(), 1);
+        std::fs::remove_dir_all(&dir).unwrap();
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_upload_checkpoint_round_trip() {
+        let path = std::env::temp_dir().join(format!("supabase-ckpt-{}", uuid::Uuid::new_v4()));
+        let session = UploadSession {
+            upload_id: "upload-1".to_string(),
+            part_size: 4,
+            total_size: 10,
+            uploaded_parts: Vec::new(),
+            bucket_id: "media".to_string(),
+            object_path: "clip.mp4".to_string(),
+            created_at: chrono::Utc::now(),
+            expires_at: chrono::Utc::now(),
+        };
+        let source = SourceFingerprint {
+            size: 10,
+            modified: Some(1),
+        };
+
+        let mut checkpoint = UploadCheckpoint::create(&path, &session, source)
+            .await
+            .unwrap();
+        for part_number in [2, 1] {
+            checkpoint
+                .record(&UploadedPart {
+                    part_number,
+                    etag: format!("etag-{}", part_number),
+                    size: 4,
+                })
+                .await
+                .unwrap();
+        }
+        drop(checkpoint);
+
+        // Simulate a crash in the middle of appending a part
+        {
+            use std::io::Write;
+            let mut file = std::fs::OpenOptions::new()
+                .append(true)
+                .open(&path)
+                .unwrap();
+            file.write_all(br#"{"part_number":3,"et"#).unwrap();
+        }
+
+        let (header, parts) = UploadCheckpoint::load(&path).await.unwrap().unwrap();
+        assert_eq!(header.upload_id, "upload-1");
+        assert_eq!(header.source, source);
+        let numbers: Vec<u32> = parts.iter().map(|part| part.part_number).collect();
+        assert_eq!(numbers, vec![2, 1]);
+
+        UploadCheckpoint::append_to(&path)
+            .await
+            .unwrap()
+            .remove()
+            .await;
+        assert!(UploadCheckpoint::load(&path).await.unwrap().is_none());
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "native"))]
+    #[tokio::test]
+    async fn test_resume_requires_checkpoint_file() {
+        let storage = Storage::new(
+            Arc::new(SupabaseConfig::default()),
+            Arc::new(HttpClient::new()),
+        )
+        .unwrap();
+
+        let result = storage
+            .resume_large_file("media", "clip.mp4", "/nonexistent", None, None, None)
+            .await;
+        assert!(matches!(result, Err(Error::InvalidInput { .. })));
+    }
+
+    #[cfg(all(not(target_arch = "wasm32"), feature = "mmap"))]
+    #[test]
+    fn test_map_file_slices_without_copying() {
+        let path = std::env::temp_dir().join(format!("supabase-mmap-{}", uuid::Uuid::new_v4()));
+        std::fs::write(&path, b"0123456789").unwrap();
+
+        let data = map_file(&path).unwrap();
+        let part = data.slice(4..8);
+        assert_eq!(&part[..], b"4567");
+        assert_eq!(part.as_ptr(), unsafe { data.as_ptr().add(4) });
+
+        drop((data, part));
+        std::fs::remove_file(&path).unwrap();
+    }
+}
@@ -22,6 +22,8 @@ pub struct SupabaseConfig {
     pub database_config: DatabaseConfig,
     /// Storage configuration
     pub storage_config: StorageConfig,
+    /// Edge Functions configuration
+    pub functions_config: FunctionsConfig,
 }
 
 /// HTTP client configuration
@@ -35,6 +37,18 @@ pub struct HttpConfig {
     pub max_redirects: usize,
     /// Custom headers to include in all requests
     pub default_headers: HashMap<String, String>,
+    /// HTTP versions the client may use
+    pub http_version: HttpVersion,
+    /// Let HTTP/2 flow-control windows grow with the measured bandwidth-delay product
+    pub http2_adaptive_window: bool,
+    /// Maximum idle connections kept per host (`None` keeps every idle connection)
+    pub pool_max_idle_per_host: Option<usize>,
+    /// Seconds an idle pooled connection is kept before being closed
+    pub pool_idle_timeout: u64,
+    /// TCP keepalive interval in seconds (0 disables keepalive probes)
+    pub tcp_keepalive: u64,
+    /// Seconds resolved host addresses are reused (0 resolves for every new connection)
+    pub dns_cache_ttl: u64,
 }
 
 impl Default for HttpConfig {
@@ -44,10 +58,28 @@ impl Default for HttpConfig {
             connect_timeout: 10,
             max_redirects: 10,
             default_headers: HashMap::new(),
+            http_version: HttpVersion::default(),
+            http2_adaptive_window: false,
+            pool_max_idle_per_host: None,
+            pool_idle_timeout: 90,
+            tcp_keepalive: 0,
+            dns_cache_ttl: 0,
         }
     }
 }
 
+/// HTTP protocol versions a client may use
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq, Hash)]
+pub enum HttpVersion {
+    /// HTTP/2 when the server offers it during the TLS handshake, HTTP/1.1 otherwise
+    #[default]
+    Negotiate,
+    /// HTTP/1.1 only
+    Http1Only,
+    /// HTTP/2 from the first byte, also over plain TCP; only for servers known to speak it
+    Http2PriorKnowledge,
+}
+
 /// Authentication configuration
 #[derive(Debug, Clone)]
 pub struct AuthConfig {
@@ -59,6 +91,8 @@ pub struct AuthConfig {
     pub persist_session: bool,
     /// Custom storage implementation
     pub storage_key: String,
+    /// Project JWT secret, used to verify HS256 access tokens locally
+    pub jwt_secret: Option<String>,
 }
 
 impl Default for AuthConfig {
@@ -68,6 +102,7 @@ impl Default for AuthConfig {
             refresh_threshold: 300, // 5 minutes
             persist_session: true,
             storage_key: "supabase.auth.token".to_string(),
+            jwt_secret: None,
         }
     }
 }
@@ -81,6 +116,17 @@ pub struct DatabaseConfig {
     pub max_retries: u32,
     /// Retry delay in milliseconds
     pub retry_delay: u64,
+    /// Maximum number of responses kept for `.cached()` queries
+    pub query_cache_max_entries: usize,
+    /// Maximum total size in bytes of responses kept for `.cached()` queries
+    ///
+    /// The budget is split evenly between up to 16 shards, and a response larger
+    /// than one shard's share is never cached (over 2 MiB with the 32 MiB default).
+    pub query_cache_max_bytes: usize,
+    /// Share one request between identical concurrent selects
+    pub coalesce_selects: bool,
+    /// Content encodings for REST requests and responses
+    pub compression: CompressionConfig,
 }
 
 impl Default for DatabaseConfig {
@@ -89,6 +135,10 @@ impl Default for DatabaseConfig {
             schema: "public".to_string(),
             max_retries: 3,
             retry_delay: 1000,
+            query_cache_max_entries: 256,
+            query_cache_max_bytes: 32 * 1024 * 1024, // 32 MiB
+            coalesce_selects: false,
+            compression: CompressionConfig::default(),
         }
     }
 }
@@ -102,6 +152,10 @@ pub struct StorageConfig {
     pub upload_timeout: u64,
     /// Maximum file size in bytes
     pub max_file_size: u64,
+    /// Maximum number of signed URLs kept for reuse (0, the default, disables the cache)
+    pub signed_url_cache_max_entries: usize,
+    /// Content encodings for Storage requests and responses
+    pub compression: CompressionConfig,
 }
 
 impl Default for StorageConfig {
@@ -110,6 +164,91 @@ impl Default for StorageConfig {
             default_bucket: None,
             upload_timeout: 300,             // 5 minutes
             max_file_size: 50 * 1024 * 1024, // 50MB
+            signed_url_cache_max_entries: 0,
+            compression: CompressionConfig::default(),
+        }
+    }
+}
+
+/// Edge Functions configuration
+#[derive(Debug, Clone, Default)]
+pub struct FunctionsConfig {
+    /// Content encodings for function invocations and their responses
+    pub compression: CompressionConfig,
+}
+
+/// Content encodings a module negotiates (requires the `compression` feature)
+///
+/// Responses in an offered encoding are decoded as they stream in, so streaming
+/// selects and downloads keep their bounded memory use. Requests carrying a
+/// `Range` header never offer an encoding, since ranges would then address the
+/// encoded bytes. Only JSON request bodies are compressed.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct CompressionConfig {
+    /// Encodings offered in `Accept-Encoding`, most preferred first (empty offers none)
+    pub accept: Vec<ContentEncoding>,
+    /// Encoding for JSON request bodies (`None` sends them as is)
+    pub request: Option<ContentEncoding>,
+    /// Request bodies smaller than this many bytes are sent as is
+    pub min_request_size: usize,
+}
+
+impl Default for CompressionConfig {
+    fn default() -> Self {
+        Self {
+            accept: Vec::new(),
+            request: None,
+            min_request_size: 1024,
+        }
+    }
+}
+
+impl CompressionConfig {
+    /// Offer zstd and gzip for responses and gzip request bodies over 1 KiB
+    pub fn enabled() -> Self {
+        Self {
+            accept: vec![ContentEncoding::Zstd, ContentEncoding::Gzip],
+            request: Some(ContentEncoding::Gzip),
+            ..Default::default()
+        }
+    }
+
+    /// Whether requests go out exactly as without compression support
+    pub fn is_disabled(&self) -> bool {
+        self.accept.is_empty() && self.request.is_none()
+    }
+}
+
+/// HTTP content codings supported for compression
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum ContentEncoding {
+    /// gzip (RFC 1952)
+    Gzip,
+    /// zlib-wrapped DEFLATE, as HTTP's `deflate` coding is defined
+    Deflate,
+    /// Zstandard (RFC 8878)
+    Zstd,
+}
+
+impl ContentEncoding {
+    /// Token used in `Accept-Encoding` and `Content-Encoding`
+    pub fn as_str(self) -> &'static str {
+        match self {
+            ContentEncoding::Gzip => "gzip",
+            ContentEncoding::Deflate => "deflate",
+            ContentEncoding::Zstd => "zstd",
+        }
+    }
+
+    /// Parse a `Content-Encoding` value naming a single supported coding
+    pub fn from_header(value: &str) -> Option<Self> {
+        match value.trim() {
+            v if v.eq_ignore_ascii_case("gzip") || v.eq_ignore_ascii_case("x-gzip") => {
+                Some(ContentEncoding::Gzip)
+            }
+            v if v.eq_ignore_ascii_case("deflate") => Some(ContentEncoding::Deflate),
+            v if v.eq_ignore_ascii_case("zstd") => Some(ContentEncoding::Zstd),
+            _ => None,
         }
     }
 }
@@ -182,6 +321,31 @@ pub enum FilterOperator {
     Adjacent,
 }
 
+impl FilterOperator {
+    /// PostgREST operator code, e.g. `eq` or `ilike`
+    pub fn as_str(&self) -> &'static str {
+        match self {
+            FilterOperator::Equal => "eq",
+            FilterOperator::NotEqual => "neq",
+            FilterOperator::GreaterThan => "gt",
+            FilterOperator::GreaterThanOrEqual => "gte",
+            FilterOperator::LessThan => "lt",
+            FilterOperator::LessThanOrEqual => "lte",
+            FilterOperator::Like => "like",
+            FilterOperator::ILike => "ilike",
+            FilterOperator::Is => "is",
+            FilterOperator::In => "in",
+            FilterOperator::Contains => "cs",
+            FilterOperator::ContainedBy => "cd",
+            FilterOperator::StrictlyLeft => "sl",
+            FilterOperator::StrictlyRight => "sr",
+            FilterOperator::NotExtendToRight => "nxr",
+            FilterOperator::NotExtendToLeft => "nxl",
+            FilterOperator::Adjacent => "adj",
+        }
+    }
+}
+
 /// Order direction for sorting
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub enum OrderDirection {
@@ -258,6 +422,8 @@ mod tests {
         let op = FilterOperator::Equal;
         let serialized = serde_json::to_string(&op).unwrap();
         assert_eq!(serialized, "\"eq\"");
+        assert_eq!(op.as_str(), "eq");
+        assert_eq!(FilterOperator::ILike.as_str(), "ilike");
     }
 
     #[test]
@@ -37,6 +37,7 @@ pub fn create_test_client_with_config(test_config: TestConfig) -> Client {
         auth_config: AuthConfig::default(),
         database_config: DatabaseConfig::default(),
         storage_config: StorageConfig::default(),
+        functions_config: FunctionsConfig::default(),
     };
 
     Client::new_with_config(config).expect("Failed to create test client")
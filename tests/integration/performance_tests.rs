@@ -40,12 +40,14 @@ async fn test_cache_config() {
         default_ttl: Duration::from_secs(900),
         enable_compression: false,
         cache_success_only: false,
+        max_bytes: 1024 * 1024,
     };
 
     assert_eq!(config.max_entries, 2000);
     assert_eq!(config.default_ttl, Duration::from_secs(900));
     assert!(!config.enable_compression);
     assert!(!config.cache_success_only);
+    assert_eq!(config.max_bytes, 1024 * 1024);
 }
 
 #[tokio::test]
@@ -56,6 +58,7 @@ async fn test_cache_config_default() {
     assert_eq!(config.default_ttl, Duration::from_secs(300));
     assert!(config.enable_compression);
     assert!(config.cache_success_only);
+    assert_eq!(config.max_bytes, 64 * 1024 * 1024);
 }
 
 #[tokio::test]
@@ -65,12 +68,14 @@ async fn test_batch_config() {
         flush_interval: Duration::from_millis(200),
         auto_batch: false,
         batch_timeout: Duration::from_secs(10),
+        max_in_flight: 4,
     };
 
     assert_eq!(config.max_batch_size, 100);
     assert_eq!(config.flush_interval, Duration::from_millis(200));
     assert!(!config.auto_batch);
     assert_eq!(config.batch_timeout, Duration::from_secs(10));
+    assert_eq!(config.max_in_flight, 4);
 }
 
 #[tokio::test]
@@ -81,6 +86,7 @@ async fn test_batch_config_default() {
     assert_eq!(config.flush_interval, Duration::from_millis(100));
     assert!(config.auto_batch);
     assert_eq!(config.batch_timeout, Duration::from_secs(5));
+    assert_eq!(config.max_in_flight, 8);
 }
 
 #[tokio::test]
@@ -136,6 +142,7 @@ async fn test_performance_metrics_structure() {
         active_connections: 5,
         cache_hit_ratio: 0.85,
         cache_entries: 150,
+        cache_bytes: 48_000,
         avg_response_time_ms: 45.7,
         total_requests: 1000,
         successful_requests: 950,
@@ -162,6 +169,7 @@ async fn test_performance_metrics_serialization() {
         active_connections: 3,
         cache_hit_ratio: 0.72,
         cache_entries: 200,
+        cache_bytes: 64_000,
         avg_response_time_ms: 35.2,
         total_requests: 500,
         successful_requests: 485,
@@ -66,6 +66,8 @@ async fn test_resumable_upload_config() {
         max_retries: 5,
         retry_delay: 500,
         verify_checksums: true,
+        max_concurrent_parts: 4,
+        checkpoint_file: None,
     };
 
     assert_eq!(config.chunk_size, 1024 * 1024);
@@ -79,6 +81,8 @@ async fn test_resumable_upload_config() {
     assert_eq!(default_config.max_retries, 3);
     assert_eq!(default_config.retry_delay, 1000);
     assert!(default_config.verify_checksums);
+    assert_eq!(default_config.max_concurrent_parts, 4);
+    assert!(default_config.checkpoint_file.is_none());
 }
 
 #[tokio::test]
@@ -213,6 +217,8 @@ async fn test_advanced_storage_workflow() {
         max_retries: 2,
         retry_delay: 100,
         verify_checksums: true,
+        max_concurrent_parts: 4,
+        checkpoint_file: None,
     };
 
     // 3. Setup search